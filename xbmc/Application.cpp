@@ -4742,7 +4742,8 @@ void CApplication::StopMusicScan()
 }
 
 void CApplication::StartVideoCleanup(bool userInitiated /* = true */,
-                                     const std::string& content /* = "" */)
+                                     const std::string& content /* = "" */,
+                                     bool dryRun /* = false */)
 {
   if (userInitiated && CVideoLibraryQueue::GetInstance().IsRunning())
     return;
@@ -4772,9 +4773,9 @@ void CApplication::StartVideoCleanup(bool userInitiated /* = true */,
       return;
   }
   if (userInitiated)
-    CVideoLibraryQueue::GetInstance().CleanLibraryModal(paths);
+    CVideoLibraryQueue::GetInstance().CleanLibraryModal(paths, dryRun);
   else
-    CVideoLibraryQueue::GetInstance().CleanLibrary(paths, true);
+    CVideoLibraryQueue::GetInstance().CleanLibrary(paths, true, nullptr, dryRun);
 }
 
 void CApplication::StartVideoScan(const std::string &strDirectory, bool userInitiated /* = true */, bool scanAll /* = false */)
@@ -4782,7 +4783,7 @@ void CApplication::StartVideoScan(const std::string &strDirectory, bool userInit
   CVideoLibraryQueue::GetInstance().ScanLibrary(strDirectory, scanAll, userInitiated);
 }
 
-void CApplication::StartMusicCleanup(bool userInitiated /* = true */)
+void CApplication::StartMusicCleanup(bool userInitiated /* = true */, bool dryRun /* = false */)
 {
   if (userInitiated && CMusicLibraryQueue::GetInstance().IsRunning())
     return;
@@ -4793,9 +4794,9 @@ void CApplication::StartMusicCleanup(bool userInitiated /* = true */)
      As cleaning is non-granular and does not offer many opportunities to update progress
      dialog rendering, do asynchronously with model dialog
     */
-    CMusicLibraryQueue::GetInstance().CleanLibrary(true);
+    CMusicLibraryQueue::GetInstance().CleanLibrary(true, dryRun);
   else
-    CMusicLibraryQueue::GetInstance().CleanLibrary(false);
+    CMusicLibraryQueue::GetInstance().CleanLibrary(false, dryRun);
 }
 
 void CApplication::StartMusicScan(const std::string &strDirectory, bool userInitiated /* = true */, int flags /* = 0 */)
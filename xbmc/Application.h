@@ -259,8 +259,9 @@ public:
    \brief Starts a video library cleanup.
    \param userInitiated Whether the action was initiated by the user (either via GUI or any other method) or not.  It is meant to hide or show dialogs.
    \param content Content type to clean, blank for everything
+   \param dryRun Only log what would be removed.
    */
-  void StartVideoCleanup(bool userInitiated = true, const std::string& content = "");
+  void StartVideoCleanup(bool userInitiated = true, const std::string& content = "", bool dryRun = false);
 
   /*!
    \brief Starts a video library update.
@@ -273,8 +274,9 @@ public:
   /*!
   \brief Starts a music library cleanup.
   \param userInitiated Whether the action was initiated by the user (either via GUI or any other method) or not.  It is meant to hide or show dialogs.
+  \param dryRun Only log what would be removed.
   */
-  void StartMusicCleanup(bool userInitiated = true);
+  void StartMusicCleanup(bool userInitiated = true, bool dryRun = false);
 
   /*!
    \brief Starts a music library update.
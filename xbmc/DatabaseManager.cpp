@@ -38,6 +38,9 @@ void CDatabaseManager::Initialize()
 
   m_dbStatus.clear();
 
+  // connections of the previous profile, and to databases about to be updated
+  m_connectionPool.Clear();
+
   CLog::Log(LOGDEBUG, "%s, updating databases...", __FUNCTION__);
 
   const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "dbwrappers/DatabaseConnectionPool.h"
 #include "threads/CriticalSection.h"
 
 #include <atomic>
@@ -51,6 +52,10 @@ public:
 
   bool IsUpgrading() const { return m_bIsUpgrading; }
 
+  /*! \brief Warm connections CDatabase::Open() and Close() share
+   */
+  CDatabaseConnectionPool& GetConnectionPool() { return m_connectionPool; }
+
 private:
   std::atomic<bool> m_bIsUpgrading;
 
@@ -62,4 +67,5 @@ private:
 
   CCriticalSection            m_section;     ///< Critical section protecting m_dbStatus.
   std::map<std::string, DB_STATUS> m_dbStatus;    ///< Our database status map.
+  CDatabaseConnectionPool     m_connectionPool;
 };
@@ -860,6 +860,14 @@ const infomap player_times[] =   {{ "seektime",         PLAYER_SEEKTIME },
 ///     @skinning_v17 **[New Infolabel]** \link Player_Process_videodecoder `Player.Process(videodecoder)`\endlink
 ///     <p>
 ///   }
+///   \table_row3{   <b>`Player.Process(videothreading)`</b>,
+///                  \anchor Player_Process_videothreading
+///                  _string_,
+///     @return The threading of the software video decoder of the currently playing video\, e.g. "frame x8".
+///     <p><hr>
+///     @skinning_v19 **[New Infolabel]** \link Player_Process_videothreading `Player.Process(videothreading)`\endlink
+///     <p>
+///   }
 ///   \table_row3{   <b>`Player.Process(deintmethod)`</b>,
 ///                  \anchor Player_Process_deintmethod
 ///                  _string_,
@@ -947,6 +955,7 @@ const infomap player_times[] =   {{ "seektime",         PLAYER_SEEKTIME },
 const infomap player_process[] =
 {
   { "videodecoder", PLAYER_PROCESS_VIDEODECODER },
+  { "videothreading", PLAYER_PROCESS_VIDEOTHREADING },
   { "deintmethod", PLAYER_PROCESS_DEINTMETHOD },
   { "pixformat", PLAYER_PROCESS_PIXELFORMAT },
   { "videowidth", PLAYER_PROCESS_VIDEOWIDTH },
@@ -232,6 +232,16 @@ CMediaManager& CServiceBroker::GetMediaManager()
   return g_application.m_ServiceManager->GetMediaManager();
 }
 
+CSmartPlaylistCache& CServiceBroker::GetSmartPlaylistCache()
+{
+  return g_application.m_ServiceManager->GetSmartPlaylistCache();
+}
+
+CAudioDecodeCache& CServiceBroker::GetAudioDecodeCache()
+{
+  return g_application.m_ServiceManager->GetAudioDecodeCache();
+}
+
 CGUIComponent* CServiceBroker::GetGUI()
 {
   return g_serviceBroker.m_pGUI;
@@ -56,6 +56,8 @@ class CAppInboundProtocol;
 class CSettingsComponent;
 class CDecoderFilterManager;
 class CMediaManager;
+class CSmartPlaylistCache;
+class CAudioDecodeCache;
 class CCPUInfo;
 class CLog;
 
@@ -118,6 +120,8 @@ public:
   static CDatabaseManager &GetDatabaseManager();
   static CEventLog &GetEventLog();
   static CMediaManager& GetMediaManager();
+  static CSmartPlaylistCache& GetSmartPlaylistCache();
+  static CAudioDecodeCache& GetAudioDecodeCache();
 
   static CGUIComponent* GetGUI();
   static void RegisterGUI(CGUIComponent *gui);
@@ -17,6 +17,7 @@
 #include "addons/binary-addons/BinaryAddonManager.h"
 #include "cores/DataCacheCore.h"
 #include "cores/RetroPlayer/guibridge/GUIGameRenderManager.h"
+#include "cores/paplayer/AudioDecodeCache.h"
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "favourites/FavouritesService.h"
 #include "games/GameServices.h"
@@ -26,6 +27,7 @@
 #include "interfaces/python/XBPython.h"
 #include "network/Network.h"
 #include "peripherals/Peripherals.h"
+#include "playlists/SmartPlaylistCache.h"
 #include "powermanagement/PowerManager.h"
 #include "profiles/ProfileManager.h"
 #include "pvr/PVRManager.h"
@@ -51,8 +53,10 @@ CServiceManager::~CServiceManager()
 bool CServiceManager::InitForTesting()
 {
   m_network.reset(new CNetwork());
+  m_dataCacheCore.reset(new CDataCacheCore());
 
   m_databaseManager.reset(new CDatabaseManager);
+  m_smartPlaylistCache.reset(new CSmartPlaylistCache);
 
   m_binaryAddonManager.reset(new ADDON::CBinaryAddonManager());
   m_addonMgr.reset(new ADDON::CAddonMgr());
@@ -74,7 +78,9 @@ void CServiceManager::DeinitTesting()
   m_fileExtensionProvider.reset();
   m_binaryAddonManager.reset();
   m_addonMgr.reset();
+  m_smartPlaylistCache.reset();
   m_databaseManager.reset();
+  m_dataCacheCore.reset();
   m_network.reset();
 }
 
@@ -100,6 +106,7 @@ bool CServiceManager::InitStageTwo(const CAppParamParser &params, const std::str
 {
   // Initialize the addon database (must be before the addon manager is init'd)
   m_databaseManager.reset(new CDatabaseManager);
+  m_smartPlaylistCache.reset(new CSmartPlaylistCache);
 
   m_binaryAddonManager.reset(new ADDON::CBinaryAddonManager()); /* Need to constructed before, GetRunningInstance() of binary CAddonDll need to call them */
   m_addonMgr.reset(new ADDON::CAddonMgr());
@@ -117,6 +124,7 @@ bool CServiceManager::InitStageTwo(const CAppParamParser &params, const std::str
   m_PVRManager.reset(new PVR::CPVRManager());
 
   m_dataCacheCore.reset(new CDataCacheCore());
+  m_audioDecodeCache.reset(new CAudioDecodeCache());
 
   m_binaryAddonCache.reset( new ADDON::CBinaryAddonCache());
   m_binaryAddonCache->Init();
@@ -200,6 +208,7 @@ void CServiceManager::DeinitStageTwo()
   m_serviceAddons.reset();
   m_favouritesService.reset();
   m_binaryAddonCache.reset();
+  m_audioDecodeCache.reset();
   m_dataCacheCore.reset();
   m_PVRManager.reset();
   m_vfsAddonCache.reset();
@@ -207,6 +216,7 @@ void CServiceManager::DeinitStageTwo()
   m_binaryAddonManager.reset();
   m_addonMgr.reset();
   m_Platform.reset();
+  m_smartPlaylistCache.reset();
   m_databaseManager.reset();
 
   m_mediaManager->Stop();
@@ -367,3 +377,13 @@ CMediaManager& CServiceManager::GetMediaManager()
 {
   return *m_mediaManager;
 }
+
+CSmartPlaylistCache& CServiceManager::GetSmartPlaylistCache()
+{
+  return *m_smartPlaylistCache;
+}
+
+CAudioDecodeCache& CServiceManager::GetAudioDecodeCache()
+{
+  return *m_audioDecodeCache;
+}
@@ -71,6 +71,8 @@ class CDatabaseManager;
 class CProfileManager;
 class CEventLog;
 class CMediaManager;
+class CSmartPlaylistCache;
+class CAudioDecodeCache;
 
 class CServiceManager
 {
@@ -125,6 +127,10 @@ public:
 
   CMediaManager& GetMediaManager();
 
+  CSmartPlaylistCache& GetSmartPlaylistCache();
+
+  CAudioDecodeCache& GetAudioDecodeCache();
+
 protected:
   struct delete_dataCacheCore
   {
@@ -168,4 +174,6 @@ protected:
   std::unique_ptr<CPlayerCoreFactory> m_playerCoreFactory;
   std::unique_ptr<CDatabaseManager> m_databaseManager;
   std::unique_ptr<CMediaManager> m_mediaManager;
+  std::unique_ptr<CSmartPlaylistCache> m_smartPlaylistCache;
+  std::unique_ptr<CAudioDecodeCache> m_audioDecodeCache;
 };
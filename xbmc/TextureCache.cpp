@@ -11,7 +11,12 @@
 #include "ServiceBroker.h"
 #include "TextureCacheJob.h"
 #include "URL.h"
+#include "XBDateTime.h"
+#include "dialogs/GUIDialogExtendedProgressBar.h"
 #include "filesystem/File.h"
+#include "guilib/GUIComponent.h"
+#include "guilib/GUIWindowManager.h"
+#include "guilib/LocalizeStrings.h"
 #include "guilib/Texture.h"
 #include "profiles/ProfileManager.h"
 #include "settings/AdvancedSettings.h"
@@ -24,6 +29,14 @@
 
 using namespace XFILE;
 
+namespace
+{
+// number of distinct textures whose use counts are kept in memory before writing
+const size_t useCountsBeforeUpdate = 100;
+// maximum time use counts are kept in memory before writing
+const unsigned int useCountFlushInterval = 60 * 1000;
+}
+
 CTextureCache &CTextureCache::GetInstance()
 {
   static CTextureCache s_cache;
@@ -45,7 +58,32 @@ void CTextureCache::Initialize()
 
 void CTextureCache::Deinitialize()
 {
+  // the precache job writes to the database, so wait for it to go away
+  unsigned int precacheJobId = 0;
+  {
+    CSingleLock lock(m_precacheSection);
+    if (m_precacheState)
+    {
+      m_precacheState->Cancel();
+      precacheJobId = m_precacheJobId;
+    }
+  }
+  if (precacheJobId)
+  {
+    CJobManager::GetInstance().CancelJob(precacheJobId);
+    while (true)
+    {
+      {
+        CSingleLock lock(m_precacheSection);
+        if (!m_precacheState)
+          break;
+      }
+      m_precacheEvent.WaitMSec(100);
+    }
+  }
+
   CancelJobs();
+  FlushUseCounts(true);
   CSingleLock lock(m_databaseSection);
   m_database.Close();
 }
@@ -227,17 +265,146 @@ bool CTextureCache::AddCachedTexture(const std::string &url, const CTextureDetai
   return m_database.AddCachedTexture(url, details);
 }
 
+bool CTextureCache::AddCachedTextures(const std::vector<std::pair<std::string, CTextureDetails>> &textures)
+{
+  CSingleLock lock(m_databaseSection);
+  m_database.BeginTransaction();
+  bool success = true;
+  for (const auto& texture : textures)
+    success &= m_database.AddCachedTexture(texture.first, texture.second);
+  return m_database.CommitTransaction() && success;
+}
+
+bool CTextureCache::PrecacheImages(std::vector<std::string> images, unsigned int parallelism,
+                                   unsigned int maxImagesPerSecond, bool showProgress)
+{
+  CSingleLock lock(m_precacheSection);
+  if (m_precacheState)
+    return false;
+
+  CGUIDialogProgressBarHandle* progressBar = nullptr;
+  if (showProgress)
+  {
+    CGUIDialogExtendedProgressBar* dialog = CServiceBroker::GetGUI()->GetWindowManager().GetWindow<CGUIDialogExtendedProgressBar>(WINDOW_DIALOG_EXT_PROGRESS);
+    if (dialog)
+      progressBar = dialog->GetHandle(g_localizeStrings.Get(39120));
+  }
+
+  CTexturePrecacheJob* job = new CTexturePrecacheJob(std::move(images), parallelism, maxImagesPerSecond, progressBar);
+  std::shared_ptr<CTexturePrecacheJob::CState> state = job->GetState();
+  m_precacheStatus = state->GetStatus();
+  // the job may be done before AddJob returns, OnPrecacheFinished waits for our lock
+  m_precacheJobId = CJobManager::GetInstance().AddJob(job, nullptr, CJob::PRIORITY_LOW);
+  if (m_precacheJobId == 0)
+  {
+    delete job;
+    return false;
+  }
+  m_precacheState = state;
+  m_precacheStatus.active = true;
+  return true;
+}
+
+void CTextureCache::CancelPrecache()
+{
+  CSingleLock lock(m_precacheSection);
+  if (m_precacheState)
+    m_precacheState->Cancel();
+}
+
+TexturePrecacheStatus CTextureCache::GetPrecacheStatus() const
+{
+  CSingleLock lock(m_precacheSection);
+  if (m_precacheState)
+  {
+    TexturePrecacheStatus status = m_precacheState->GetStatus();
+    status.active = true;
+    return status;
+  }
+  return m_precacheStatus;
+}
+
+void CTextureCache::OnPrecacheFinished(const std::shared_ptr<CTexturePrecacheJob::CState> &state)
+{
+  CSingleLock lock(m_precacheSection);
+  if (m_precacheState == state)
+  {
+    m_precacheStatus = state->GetStatus();
+    m_precacheStatus.active = false;
+    m_precacheState.reset();
+    m_precacheJobId = 0;
+  }
+  m_precacheEvent.Set();
+}
+
+bool CTextureCache::GetCachedURLs(const std::vector<std::string> &urls, std::set<std::string> &cached)
+{
+  std::vector<std::string> lookup;
+  lookup.reserve(urls.size());
+  for (const auto& url : urls)
+  {
+    if (url.empty())
+      continue;
+    if (IsCachedImage(url))
+      cached.insert(url);
+    else
+      lookup.push_back(url);
+  }
+
+  CSingleLock lock(m_databaseSection);
+  return m_database.GetCachedURLs(lookup, cached);
+}
+
+bool CTextureCache::StartCaching(const std::string &url)
+{
+  CSingleLock lock(m_processingSection);
+  return m_processinglist.insert(url).second;
+}
+
+void CTextureCache::EndCaching(const std::string &url)
+{
+  {
+    CSingleLock lock(m_processingSection);
+    m_processinglist.erase(url);
+  }
+  m_completeEvent.Set();
+}
+
 void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 {
-  static const size_t count_before_update = 100;
   CSingleLock lock(m_useCountSection);
-  m_useCounts.reserve(count_before_update);
-  m_useCounts.push_back(details);
-  if (m_useCounts.size() >= count_before_update)
+  if (m_useCounts.empty())
+    m_useCountFlushTime.Set(useCountFlushInterval);
+
+  TextureUseCount &useCount = m_useCounts[std::make_tuple(details.id, details.width, details.height)];
+  useCount.details = details;
+  useCount.count++;
+  useCount.lastUsed = CDateTime::GetUTCDateTime().GetAsDBDateTime();
+
+  if (m_useCounts.size() >= useCountsBeforeUpdate || m_useCountFlushTime.IsTimePast())
   {
-    AddJob(new CTextureUseCountJob(m_useCounts));
+    lock.Leave();
+    FlushUseCounts(false);
+  }
+}
+
+void CTextureCache::FlushUseCounts(bool wait)
+{
+  std::vector<TextureUseCount> useCounts;
+  {
+    CSingleLock lock(m_useCountSection);
+    useCounts.reserve(m_useCounts.size());
+    for (auto& useCount : m_useCounts)
+      useCounts.push_back(std::move(useCount.second));
     m_useCounts.clear();
   }
+  if (useCounts.empty())
+    return;
+
+  if (wait)
+    CTextureUseCountJob(std::move(useCounts)).DoWork();
+  else
+    AddJob(new CTextureUseCountJob(std::move(useCounts)));
 }
 
 bool CTextureCache::SetCachedTextureValid(const std::string &url, bool updateable)
@@ -9,11 +9,17 @@
 #pragma once
 
 #include "TextureDatabase.h"
+#include "TexturePrecacheJob.h"
 #include "threads/Event.h"
+#include "threads/SystemClock.h"
 #include "utils/JobManager.h"
 
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 class CURL;
@@ -136,6 +142,59 @@ public:
    */
   bool AddCachedTexture(const std::string &image, const CTextureDetails &details);
 
+  /*! \brief Add several images to the database in a single transaction
+   \param textures urls of the original images and their texture details
+   \return true if we successfully added all of them, false otherwise.
+   \sa AddCachedTexture
+   */
+  bool AddCachedTextures(const std::vector<std::pair<std::string, CTextureDetails>> &textures);
+
+  /*! \brief Cache a large number of images in the background
+   Only one precache run can be active at a time.
+   \param images urls of the images to cache
+   \param parallelism number of images to cache concurrently, 0 for the default
+   \param maxImagesPerSecond maximum number of images to start caching per second, 0 for no limit
+   \param showProgress whether to show progress in the extended progress bar
+   \return true if the run was started, false if another one is still active
+   \sa CTexturePrecacheJob
+   */
+  bool PrecacheImages(std::vector<std::string> images, unsigned int parallelism,
+                      unsigned int maxImagesPerSecond, bool showProgress);
+
+  /*! \brief Stop the active precache run, if any
+   */
+  void CancelPrecache();
+
+  /*! \brief Get the progress of the active, or else the last, precache run
+   */
+  TexturePrecacheStatus GetPrecacheStatus() const;
+
+  /*! \brief Called by a precache job when it is deleted, whether it ran or not
+   */
+  void OnPrecacheFinished(const std::shared_ptr<CTexturePrecacheJob::CState> &state);
+
+  /*! \brief Look up which of the given images are cached
+   Images that won't normally be cached (eg skin images) count as cached.
+   \param urls unwrapped urls of the images
+   \param cached [out] the urls of the images that are cached
+   \return true if the lookup succeeded, false otherwise
+   \sa HasCachedImage
+   */
+  bool GetCachedURLs(const std::vector<std::string> &urls, std::set<std::string> &cached);
+
+  /*! \brief Claim an image for caching, as CacheImage does
+   CacheImage waits for a claimed image instead of caching it too, so release the
+   claim once the image is in the database.
+   \param url unwrapped url of the image
+   \return true if the image was claimed, false if it is being cached already
+   \sa EndCaching
+   */
+  bool StartCaching(const std::string &url);
+
+  /*! \brief Release an image claimed with StartCaching
+   */
+  void EndCaching(const std::string &url);
+
   /*! \brief Export a (possibly) cached image to a file
    \param image url of the original image
    \param destination url of the destination image, excluding extension.
@@ -184,11 +243,18 @@ private:
   bool ClearCachedTexture(int textureID, std::string &cacheFile);
 
   /*! \brief Increment the use count of a texture
-   Stores locally before calling CTextureDatabase::IncrementUseCount via a CUseCountJob
-   \sa CUseCountJob, CTextureDatabase::IncrementUseCount
+   Uses are coalesced in memory and written by FlushUseCounts once enough
+   textures were used or the flush interval has passed.
+   \sa FlushUseCounts, CTextureDatabase::IncrementUseCount
    */
   void IncrementUseCount(const CTextureDetails &details);
 
+  /*! \brief Write the accumulated use counts to the database in a single transaction
+   \param wait whether to write them synchronously rather than via a CTextureUseCountJob
+   \sa CTextureUseCountJob
+   */
+  void FlushUseCounts(bool wait);
+
   /*! \brief Set a previously cached texture as valid in the database
    Thread-safe wrapper of CTextureDatabase::SetCachedTextureValid
    \param image url of the original image
@@ -213,7 +279,13 @@ private:
   std::set<std::string> m_processinglist; ///< currently processing list to avoid 2 jobs being processed at once
   CCriticalSection     m_processingSection;
   CEvent               m_completeEvent; ///< Set whenever a job has finished
-  std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
+  std::map<std::tuple<int, unsigned int, unsigned int>, TextureUseCount> m_useCounts; ///< Use count tracking, keyed by id and size
+  XbmcThreads::EndTime         m_useCountFlushTime; ///< when the use counts are written at the latest
   CCriticalSection             m_useCountSection;
+  std::shared_ptr<CTexturePrecacheJob::CState> m_precacheState; ///< state of the active precache run
+  unsigned int          m_precacheJobId = 0; ///< job id of the active precache run
+  TexturePrecacheStatus m_precacheStatus; ///< status of the last finished precache run
+  mutable CCriticalSection m_precacheSection;
+  CEvent                m_precacheEvent; ///< Set whenever a precache run has finished
 };
 
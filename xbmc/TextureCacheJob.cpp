@@ -94,7 +94,12 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     return true;
   }
 #endif
-  CBaseTexture *texture = LoadImage(image, width, height, additional_info, true);
+  // don't decode larger than what ends up in the cache, so decoders that can
+  // scale while decoding (jpeg) skip most of the work for large images
+  unsigned int loadWidth = width, loadHeight = height;
+  CPicture::GetMaxCacheSize(loadWidth, loadHeight);
+
+  CBaseTexture *texture = LoadImage(image, loadWidth, loadHeight, additional_info, true);
   if (texture)
   {
     if (texture->HasAlpha())
@@ -250,7 +255,7 @@ std::string CTextureCacheJob::GetImageHash(const std::string &url)
   return "";
 }
 
-CTextureUseCountJob::CTextureUseCountJob(const std::vector<CTextureDetails> &textures) : m_textures(textures)
+CTextureUseCountJob::CTextureUseCountJob(std::vector<TextureUseCount> textures) : m_textures(std::move(textures))
 {
 }
 
@@ -271,8 +276,8 @@ bool CTextureUseCountJob::DoWork()
   if (db.Open())
   {
     db.BeginTransaction();
-    for (std::vector<CTextureDetails>::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
-      db.IncrementUseCount(*i);
+    for (const auto& texture : m_textures)
+      db.IncrementUseCount(texture.details, texture.count, texture.lastUsed);
     db.CommitTransaction();
   }
   return true;
@@ -44,6 +44,21 @@ public:
   bool         updateable;
 };
 
+/*!
+ \ingroup textures
+ \brief Usage of a texture accumulated in memory before it is written to the database
+ */
+struct TextureUseCount
+{
+  CTextureDetails details;
+  unsigned int count = 0;   ///< number of uses since the last write
+  std::string lastUsed;     ///< UTC time of the last use, in database format
+  bool operator==(const TextureUseCount &right) const
+  {
+    return details == right.details && count == right.count && lastUsed == right.lastUsed;
+  };
+};
+
 /*!
  \ingroup textures
  \brief Job class for caching textures
@@ -116,16 +131,17 @@ private:
 };
 
 /* \brief Job class for storing the use count of textures
+ All updates are written in a single transaction.
  */
 class CTextureUseCountJob : public CJob
 {
 public:
-  explicit CTextureUseCountJob(const std::vector<CTextureDetails> &textures);
+  explicit CTextureUseCountJob(std::vector<TextureUseCount> textures);
 
   const char* GetType() const override { return "usecount"; };
   bool operator==(const CJob *job) const override;
   bool DoWork() override;
 
 private:
-  std::vector<CTextureDetails> m_textures;
+  std::vector<TextureUseCount> m_textures;
 };
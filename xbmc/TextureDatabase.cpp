@@ -147,7 +147,27 @@ CTextureDatabase::~CTextureDatabase() = default;
 
 bool CTextureDatabase::Open()
 {
-  return CDatabase::Open();
+  const bool wasOpen = IsOpen();
+  if (!CDatabase::Open())
+    return false;
+
+  // The texture database is written to while browsing (use counts, newly
+  // cached images). Write-ahead logging with synchronous=NORMAL only syncs on
+  // checkpoints instead of on every commit, which matters on SD cards.
+  if (!wasOpen && m_sqlite && m_pDS)
+  {
+    try
+    {
+      m_pDS->exec("PRAGMA journal_mode=WAL\n");
+      m_pDS->exec("PRAGMA wal_autocheckpoint=1000\n");
+      m_pDS->exec("PRAGMA temp_store=MEMORY\n");
+    }
+    catch (...)
+    {
+      CLog::Log(LOGWARNING, "%s - unable to enable write-ahead logging", __FUNCTION__);
+    }
+  }
+  return true;
 }
 
 void CTextureDatabase::CreateTables()
@@ -236,6 +256,12 @@ bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details)
   return ExecuteQuery(sql);
 }
 
+bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details, unsigned int count, const std::string &lastUsed)
+{
+  std::string sql = PrepareSQL("UPDATE sizes SET usecount=usecount+%u, lastusetime='%s' WHERE idtexture=%u AND width=%u AND height=%u", count, lastUsed.c_str(), details.id, details.width, details.height);
+  return ExecuteQuery(sql);
+}
+
 bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails &details)
 {
   try
@@ -269,6 +295,43 @@ bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails
   return false;
 }
 
+bool CTextureDatabase::GetCachedURLs(const std::vector<std::string> &urls, std::set<std::string> &cached)
+{
+  if (urls.empty())
+    return true;
+
+  try
+  {
+    if (!m_pDB)
+      return false;
+    if (!m_pDS)
+      return false;
+
+    std::string list;
+    for (const auto& url : urls)
+    {
+      if (!list.empty())
+        list += ",";
+      list += PrepareSQL("'%s'", url.c_str());
+    }
+
+    std::string sql = "SELECT url FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1) WHERE url IN (" + list + ")";
+    m_pDS->query(sql);
+    while (!m_pDS->eof())
+    {
+      cached.insert(m_pDS->fv(0).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed for %u urls", __FUNCTION__, static_cast<unsigned int>(urls.size()));
+  }
+  return false;
+}
+
 bool CTextureDatabase::GetTextures(CVariant &items, const Filter &filter)
 {
   try
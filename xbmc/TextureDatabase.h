@@ -12,6 +12,7 @@
 #include "dbwrappers/Database.h"
 #include "dbwrappers/DatabaseQuery.h"
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -63,12 +64,28 @@ public:
   bool Open() override;
 
   bool GetCachedTexture(const std::string &originalURL, CTextureDetails &details);
+
+  /*! \brief Look up which of the given urls have a cached texture
+   \param urls original urls of the textures
+   \param cached [out] the urls that have a cached texture are added to this
+   \return true if successful, false otherwise
+   \sa GetCachedTexture
+   */
+  bool GetCachedURLs(const std::vector<std::string> &urls, std::set<std::string> &cached);
   bool AddCachedTexture(const std::string &originalURL, const CTextureDetails &details);
   bool SetCachedTextureValid(const std::string &originalURL, bool updateable);
   bool ClearCachedTexture(const std::string &originalURL, std::string &cacheFile);
   bool ClearCachedTexture(int textureID, std::string &cacheFile);
   bool IncrementUseCount(const CTextureDetails &details);
 
+  /*! \brief Add several uses of a texture at once
+   \param details the texture
+   \param count number of uses to add
+   \param lastUsed UTC time of the last use in database format
+   \return true if successful, false otherwise
+   */
+  bool IncrementUseCount(const CTextureDetails &details, unsigned int count, const std::string &lastUsed);
+
   /*! \brief Invalidate a previously cached texture
    Invalidates the texture hash, and sets the texture update time to the current time so that
    next texture load it will be re-cached.
@@ -0,0 +1,291 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TexturePrecacheJob.h"
+
+#include "TextureCache.h"
+#include "TextureDatabase.h"
+#include "guilib/LocalizeStrings.h"
+#include "music/MusicDatabase.h"
+#include "threads/SingleLock.h"
+#include "utils/Stopwatch.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+#include "video/VideoDatabase.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+namespace
+{
+// number of cached images written to the texture database in one transaction
+const size_t kResultsPerTransaction = 50;
+// maximum time cached images wait to be written, CTextureCache::CacheImage waits for them
+const unsigned int kResultsFlushInterval = 1000;
+// number of images looked up in the texture database at once
+const size_t kImagesPerLookup = 100;
+}
+
+TexturePrecacheStatus CTexturePrecacheJob::CState::GetStatus() const
+{
+  CSingleLock lock(m_section);
+  return m_status;
+}
+
+CTexturePrecacheJob::CImageJob::CImageJob(std::shared_ptr<CPrecacheQueue> queue, const std::string& url)
+  : CTextureCacheJob(url),
+    m_queue(std::move(queue))
+{
+}
+
+CTexturePrecacheJob::CPrecacheQueue::CPrecacheQueue(std::shared_ptr<CState> state, unsigned int jobsAtOnce)
+  : CBatchJobQueue(jobsAtOnce),
+    m_state(std::move(state))
+{
+}
+
+CTexturePrecacheJob::CPrecacheQueue::~CPrecacheQueue()
+{
+  for (const auto& url : m_claimed)
+    CTextureCache::GetInstance().EndCaching(url);
+}
+
+void CTexturePrecacheJob::CPrecacheQueue::OnResult(CJob* job, bool success)
+{
+  const CTextureCacheJob* cacheJob = static_cast<const CTextureCacheJob*>(job);
+  bool release = false;
+  {
+    CSingleLock lock(m_resultSection);
+    if (m_claimed.erase(cacheJob->m_url) > 0)
+    {
+      if (success && m_finished)
+        CTextureCache::GetInstance().AddCachedTexture(cacheJob->m_url, cacheJob->m_details);
+      else if (success)
+        m_results.emplace_back(cacheJob->m_url, cacheJob->m_details);
+      release = !success || m_finished;
+    }
+  }
+  if (release)
+    CTextureCache::GetInstance().EndCaching(cacheJob->m_url);
+
+  {
+    CSingleLock lock(m_state->m_section);
+    if (success)
+      m_state->m_status.cached++;
+    else
+      m_state->m_status.failed++;
+    m_state->m_status.processed++;
+  }
+}
+
+CTexturePrecacheJob::CTexturePrecacheJob(std::vector<std::string> images,
+                                         unsigned int parallelism,
+                                         unsigned int maxImagesPerSecond,
+                                         CGUIDialogProgressBarHandle* progressBar /* = nullptr */)
+  : CProgressJob(progressBar),
+    m_images(std::move(images)),
+    m_parallelism(parallelism > 0 ? parallelism : DefaultParallelism),
+    m_maxImagesPerSecond(maxImagesPerSecond),
+    m_state(std::make_shared<CState>())
+{
+  m_state->m_status.total = m_images.size();
+}
+
+CTexturePrecacheJob::~CTexturePrecacheJob()
+{
+  // also when the job is deleted without having run
+  CTextureCache::GetInstance().OnPrecacheFinished(m_state);
+}
+
+bool CTexturePrecacheJob::operator==(const CJob* job) const
+{
+  // only a single precache run at a time
+  return strcmp(job->GetType(), GetType()) == 0;
+}
+
+std::vector<std::string> CTexturePrecacheJob::GetLibraryImages(bool video, bool music)
+{
+  std::vector<std::string> images;
+  if (video)
+  {
+    CVideoDatabase db;
+    if (db.Open())
+    {
+      db.GetArtURLs(images);
+      db.Close();
+    }
+  }
+  if (music)
+  {
+    CMusicDatabase db;
+    if (db.Open())
+    {
+      db.GetArtURLs(images);
+      db.Close();
+    }
+  }
+
+  // the same image may be used by both libraries
+  std::set<std::string> seen;
+  images.erase(std::remove_if(images.begin(), images.end(), [&seen](const std::string& image) {
+                 return image.empty() || !seen.insert(image).second;
+               }),
+               images.end());
+  return images;
+}
+
+bool CTexturePrecacheJob::IsAborted() const
+{
+  return m_state->IsCancelled() || IsCancelled();
+}
+
+void CTexturePrecacheJob::FlushResults(CPrecacheQueue& queue, bool force)
+{
+  std::vector<std::pair<std::string, CTextureDetails>> results;
+  {
+    CSingleLock lock(queue.m_resultSection);
+    if (queue.m_results.empty() ||
+        (!force && queue.m_results.size() < kResultsPerTransaction && !m_flushTime.IsTimePast()))
+      return;
+    results.swap(queue.m_results);
+  }
+  m_flushTime.Set(kResultsFlushInterval);
+
+  CTextureCache::GetInstance().AddCachedTextures(results);
+  for (const auto& result : results)
+    CTextureCache::GetInstance().EndCaching(result.first);
+}
+
+void CTexturePrecacheJob::UpdateProgress()
+{
+  TexturePrecacheStatus status = m_state->GetStatus();
+  SetProgress(status.processed, status.total);
+  SetText(StringUtils::Format(g_localizeStrings.Get(39121).c_str(), status.processed,
+                              status.total, status.imagesPerSecond));
+}
+
+bool CTexturePrecacheJob::DoWork()
+{
+  SetTitle(g_localizeStrings.Get(39120));
+
+  CStopWatch timer;
+  timer.StartZero();
+  m_flushTime.Set(kResultsFlushInterval);
+
+  {
+    CSingleLock lock(m_state->m_section);
+    m_state->m_status.active = true;
+  }
+
+  // shared with the image jobs, which may outlive this job when it is cancelled
+  std::shared_ptr<CPrecacheQueue> queue = std::make_shared<CPrecacheQueue>(m_state, m_parallelism);
+  const auto aborted = [this]() { return IsAborted(); };
+
+  unsigned int started = 0;
+  for (size_t first = 0; first < m_images.size() && !IsAborted(); first += kImagesPerLookup)
+  {
+    // look up whether the images are cached for a chunk of images at once
+    const size_t last = std::min(m_images.size(), first + kImagesPerLookup);
+    std::vector<std::string> urls;
+    urls.reserve(last - first);
+    for (size_t i = first; i < last; i++)
+      urls.push_back(CTextureUtils::UnwrapImageURL(m_images[i]));
+    std::set<std::string> cached;
+    CTextureCache::GetInstance().GetCachedURLs(urls, cached);
+
+    for (const auto& url : urls)
+    {
+      if (IsAborted())
+        break;
+
+      bool skip = url.empty() || cached.find(url) != cached.end();
+      if (!skip)
+      {
+        if (!queue->WaitForSlot(aborted, [this, &queue]() { FlushResults(*queue, false); }))
+          break;
+
+        // throttle the rate at which images are read from their sources
+        if (m_maxImagesPerSecond > 0)
+        {
+          const float due = static_cast<float>(started) / m_maxImagesPerSecond;
+          while (!IsAborted() && timer.GetElapsedSeconds() < due)
+            queue->WaitForCompletion(std::max(1, static_cast<int>((due - timer.GetElapsedSeconds()) * 1000)));
+        }
+        if (IsAborted())
+          break;
+
+        // an image that is being cached by someone else is left to them
+        if (!CTextureCache::GetInstance().StartCaching(url))
+          skip = true;
+        else
+        {
+          {
+            CSingleLock lock(queue->m_resultSection);
+            queue->m_claimed.insert(url);
+          }
+          if (queue->Add(new CImageJob(queue, url)))
+            started++;
+          else
+          {
+            {
+              CSingleLock lock(queue->m_resultSection);
+              queue->m_claimed.erase(url);
+            }
+            CTextureCache::GetInstance().EndCaching(url);
+            skip = true;
+          }
+        }
+      }
+
+      {
+        CSingleLock lock(m_state->m_section);
+        if (skip)
+          m_state->m_status.processed++;
+        m_state->m_status.elapsedMs = static_cast<unsigned int>(timer.GetElapsedMilliseconds());
+        if (m_state->m_status.elapsedMs > 0)
+          m_state->m_status.imagesPerSecond = m_state->m_status.cached * 1000.0f / m_state->m_status.elapsedMs;
+      }
+
+      FlushResults(*queue, false);
+      UpdateProgress();
+    }
+  }
+
+  // wait for the remaining images
+  queue->WaitForAll(aborted, [this, &queue]() {
+    FlushResults(*queue, false);
+    UpdateProgress();
+  });
+
+  // images that still finish are written as they come, the ones that were cancelled while
+  // running are released by the queue once their jobs are deleted
+  {
+    CSingleLock lock(queue->m_resultSection);
+    queue->m_finished = true;
+  }
+  queue->Finish(IsAborted());
+  FlushResults(*queue, true);
+
+  TexturePrecacheStatus status;
+  {
+    CSingleLock lock(m_state->m_section);
+    m_state->m_status.active = false;
+    m_state->m_status.elapsedMs = static_cast<unsigned int>(timer.GetElapsedMilliseconds());
+    if (m_state->m_status.elapsedMs > 0)
+      m_state->m_status.imagesPerSecond = m_state->m_status.cached * 1000.0f / m_state->m_status.elapsedMs;
+    status = m_state->m_status;
+  }
+  UpdateProgress();
+
+  CLog::Log(LOGINFO, "%s - cached %u of %u images (%u failed) in %.1fs, %.1f images/s%s",
+            __FUNCTION__, status.cached, status.total, status.failed, status.elapsedMs / 1000.0f,
+            status.imagesPerSecond, IsAborted() ? " (cancelled)" : "");
+
+  return !IsAborted();
+}
@@ -0,0 +1,150 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "TextureCacheJob.h"
+#include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
+#include "utils/BatchJobQueue.h"
+#include "utils/ProgressJob.h"
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CGUIDialogProgressBarHandle;
+
+/*!
+ \ingroup textures
+ \brief Progress information of a texture precache run
+ */
+struct TexturePrecacheStatus
+{
+  bool active = false;
+  unsigned int total = 0;       ///< number of images to process
+  unsigned int processed = 0;   ///< number of images processed so far
+  unsigned int cached = 0;      ///< number of images added to the cache
+  unsigned int failed = 0;      ///< number of images that couldn't be cached
+  unsigned int elapsedMs = 0;   ///< time spent so far
+  float imagesPerSecond = 0.0f; ///< overall throughput
+};
+
+/*!
+ \ingroup textures
+ \brief Job for caching a large number of images at once
+
+ Runs up to a given number of CTextureCacheJobs concurrently, optionally limited
+ to a maximum number of images started per second so that the sources aren't
+ saturated. Images that are cached already are looked up for many images at
+ once, and the results are written to the texture database in batches instead
+ of one transaction per image.
+
+ \sa CTextureCache::PrecacheImages
+ */
+class CTexturePrecacheJob : public CProgressJob
+{
+public:
+  /*!
+   \brief Status of a run and its cancel request, shared with CTextureCache so that it stays
+   valid whether or not the job manager has deleted the job
+   */
+  class CState
+  {
+  public:
+    TexturePrecacheStatus GetStatus() const;
+    void Cancel() { m_cancelled = true; }
+    bool IsCancelled() const { return m_cancelled; }
+
+  private:
+    friend class CTexturePrecacheJob;
+
+    std::atomic<bool> m_cancelled{false};
+    mutable CCriticalSection m_section;
+    TexturePrecacheStatus m_status;
+  };
+
+  /*!
+   \param images urls of the images to cache
+   \param parallelism number of images cached at once, 0 for the default
+   \param maxImagesPerSecond maximum number of images to start per second, 0 for no limit
+   \param progressBar progress bar to report progress to (optional)
+   */
+  CTexturePrecacheJob(std::vector<std::string> images,
+                      unsigned int parallelism,
+                      unsigned int maxImagesPerSecond,
+                      CGUIDialogProgressBarHandle* progressBar = nullptr);
+  ~CTexturePrecacheJob() override;
+
+  const char* GetType() const override { return "precacheimages"; }
+  bool operator==(const CJob* job) const override;
+  bool DoWork() override;
+
+  const std::shared_ptr<CState>& GetState() const { return m_state; }
+
+  /*! \brief Retrieve the urls of all artwork in the video and/or music library
+   \param video whether to include video library artwork
+   \param music whether to include music library artwork
+   \return urls of the artwork, without duplicates
+   */
+  static std::vector<std::string> GetLibraryImages(bool video, bool music);
+
+  static const unsigned int DefaultParallelism = 4;
+
+private:
+  class CPrecacheQueue;
+
+  /*!
+   \brief Caches an image of the run
+   */
+  class CImageJob : public CTextureCacheJob
+  {
+  public:
+    CImageJob(std::shared_ptr<CPrecacheQueue> queue, const std::string& url);
+
+  private:
+    std::shared_ptr<CPrecacheQueue> m_queue;
+  };
+
+  /*!
+   \brief Runs the image jobs and collects their results, shared with the image jobs
+   Images are claimed in the processing list of CTextureCache while they are cached, and released
+   once they are written to the texture database, so that CTextureCache::CacheImage waits for them.
+   */
+  class CPrecacheQueue : public CBatchJobQueue
+  {
+  public:
+    CPrecacheQueue(std::shared_ptr<CState> state, unsigned int jobsAtOnce);
+    /*! releases the images of jobs that were cancelled while running, as the queue only goes
+        away once those jobs have finished */
+    ~CPrecacheQueue() override;
+
+    std::shared_ptr<CState> m_state;
+
+    CCriticalSection m_resultSection;
+    std::set<std::string> m_claimed; ///< images being cached
+    std::vector<std::pair<std::string, CTextureDetails>> m_results; ///< cached but not yet written
+    bool m_finished = false; ///< the run is over, results are written as they come
+
+  protected:
+    void OnResult(CJob* job, bool success) override;
+  };
+
+  bool IsAborted() const;
+  void FlushResults(CPrecacheQueue& queue, bool force);
+  void UpdateProgress();
+
+  std::vector<std::string> m_images;
+  unsigned int m_parallelism;
+  unsigned int m_maxImagesPerSecond;
+  std::shared_ptr<CState> m_state;
+  XbmcThreads::EndTime m_flushTime; ///< when the results are written at the latest
+};
@@ -1360,6 +1360,49 @@ void CUtil::DeleteDirectoryCache(const std::string &prefix)
   }
 }
 
+unsigned int CUtil::DeleteOldCacheFiles(const std::string& path,
+                                        const std::string& mask,
+                                        unsigned int maxFiles,
+                                        unsigned int maxAgeDays)
+{
+  CFileItemList items;
+  if (!XFILE::CDirectory::GetDirectory(path, items, mask, DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE))
+    return 0;
+
+  std::vector<CFileItemPtr> files;
+  for (const auto& item : items)
+  {
+    if (!item->m_bIsFolder)
+      files.push_back(item);
+  }
+
+  // most recently modified first
+  std::sort(files.begin(), files.end(), [](const CFileItemPtr& a, const CFileItemPtr& b) {
+    return a->m_dateTime > b->m_dateTime;
+  });
+
+  CDateTime oldest;
+  if (maxAgeDays > 0)
+    oldest = CDateTime::GetCurrentDateTime() - CDateTimeSpan(maxAgeDays, 0, 0, 0);
+
+  unsigned int deleted = 0;
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    if (i >= maxFiles ||
+        (oldest.IsValid() && files[i]->m_dateTime.IsValid() && files[i]->m_dateTime < oldest))
+    {
+      if (XFILE::CFile::Delete(files[i]->GetPath()))
+        deleted++;
+    }
+  }
+
+  if (deleted > 0)
+    CLog::Log(LOGDEBUG, "%s - deleted %u of %u files in %s", __FUNCTION__, deleted,
+              static_cast<unsigned int>(files.size()), path.c_str());
+
+  return deleted;
+}
+
 
 void CUtil::GetRecursiveListing(const std::string& strPath, CFileItemList& items, const std::string& strMask, unsigned int flags /* = DIR_FLAG_DEFAULTS */)
 {
@@ -131,6 +131,19 @@ public:
   static int GetMatchingSource(const std::string& strPath, VECSOURCES& VECSOURCES, bool& bIsSourceName);
   static std::string TranslateSpecialSource(const std::string &strSpecial);
   static void DeleteDirectoryCache(const std::string &prefix = "");
+  /*!
+   \brief Delete the files of a cache directory beyond the most recently modified ones,
+          and those that weren't modified for a number of days
+   \param path the cache directory
+   \param mask file extensions of the cache files, e.g. ".idx"
+   \param maxFiles number of files to keep
+   \param maxAgeDays age of the files to keep, 0 to keep files of any age
+   \return number of files deleted
+   */
+  static unsigned int DeleteOldCacheFiles(const std::string& path,
+                                          const std::string& mask,
+                                          unsigned int maxFiles,
+                                          unsigned int maxAgeDays);
   static void DeleteMusicDatabaseDirectoryCache();
   static void DeleteVideoDatabaseDirectoryCache();
   static std::string MusicPlaylistsLocation();
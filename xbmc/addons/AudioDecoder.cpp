@@ -68,13 +68,12 @@ int CAudioDecoder::ReadPCM(uint8_t* buffer, int size, int* actualsize)
   return m_struct.toAddon.read_pcm(&m_struct, buffer, size, actualsize);
 }
 
-bool CAudioDecoder::Seek(int64_t time)
+int64_t CAudioDecoder::Seek(int64_t time)
 {
   if (!m_struct.toAddon.seek)
-    return false;
+    return -1;
 
-  m_struct.toAddon.seek(&m_struct, time);
-  return true;
+  return m_struct.toAddon.seek(&m_struct, time);
 }
 
 bool CAudioDecoder::Load(const std::string& fileName,
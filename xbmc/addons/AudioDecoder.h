@@ -35,7 +35,7 @@ namespace ADDON
     bool CreateDecoder();
     bool Init(const CFileItem& file, unsigned int filecache) override;
     int ReadPCM(uint8_t* buffer, int size, int* actualsize) override;
-    bool Seek(int64_t time) override;
+    int64_t Seek(int64_t time) override;
     bool CanInit() override { return true; }
     bool Load(const std::string& strFileName,
                       MUSIC_INFO::CMusicInfoTag& tag,
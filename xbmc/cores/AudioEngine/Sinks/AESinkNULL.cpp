@@ -0,0 +1,164 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AESinkNULL.h"
+
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/XTimeUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+namespace
+{
+// amount of audio the device buffers, like the period of a sound card
+constexpr double NULL_BUFFER_SECONDS = 0.1;
+constexpr unsigned int NULL_PERIOD_MS = 20;
+
+const unsigned int NullSampleRates[] = {32000, 44100, 48000, 88200, 96000, 176400, 192000};
+} // namespace
+
+CAESinkNULL::~CAESinkNULL()
+{
+  Deinitialize();
+}
+
+void CAESinkNULL::Register()
+{
+  AE::AESinkRegEntry entry;
+  entry.sinkName = "NULL";
+  entry.createFunc = CAESinkNULL::Create;
+  entry.enumerateFunc = CAESinkNULL::EnumerateDevicesEx;
+  AE::CAESinkFactory::RegisterSink(entry);
+}
+
+IAESink* CAESinkNULL::Create(std::string& device, AEAudioFormat& desiredFormat)
+{
+  IAESink* sink = new CAESinkNULL();
+  if (sink->Initialize(desiredFormat, device))
+    return sink;
+
+  delete sink;
+  return nullptr;
+}
+
+bool CAESinkNULL::Initialize(AEAudioFormat& format, std::string& device)
+{
+  if (format.m_dataFormat == AE_FMT_RAW)
+  {
+    CLog::Log(LOGERROR, "CAESinkNULL::Initialize - passthrough is not supported");
+    return false;
+  }
+
+  m_realtime = !StringUtils::EqualsNoCase(device, "unlimited");
+
+  format.m_dataFormat = AE_FMT_FLOAT;
+  format.m_frameSize = format.m_channelLayout.Count() * (CAEUtil::DataFormatToBits(AE_FMT_FLOAT) >> 3);
+  format.m_frames = format.m_sampleRate * NULL_PERIOD_MS / 1000;
+  m_format = format;
+
+  m_start = 0;
+  m_framesBuffered = 0;
+  m_framesConsumed = 0;
+
+  CLog::Log(LOGDEBUG, "CAESinkNULL::Initialize - %s, %u Hz, %u channels",
+            m_realtime ? "real time" : "unlimited", format.m_sampleRate,
+            format.m_channelLayout.Count());
+
+  return true;
+}
+
+void CAESinkNULL::Deinitialize()
+{
+  m_start = 0;
+  m_framesBuffered = 0;
+}
+
+double CAESinkNULL::GetCacheTotal()
+{
+  return m_realtime ? NULL_BUFFER_SECONDS : 0.0;
+}
+
+double CAESinkNULL::GetBufferedSeconds() const
+{
+  if (!m_realtime || m_start == 0 || m_format.m_sampleRate == 0)
+    return 0.0;
+
+  const double written = static_cast<double>(m_framesBuffered) / m_format.m_sampleRate;
+  const double played = static_cast<double>(CurrentHostCounter() - m_start) / CurrentHostFrequency();
+
+  return std::max(0.0, written - played);
+}
+
+void CAESinkNULL::GetDelay(AEDelayStatus& status)
+{
+  status.SetDelay(GetBufferedSeconds());
+}
+
+unsigned int CAESinkNULL::AddPackets(uint8_t** data, unsigned int frames, unsigned int offset)
+{
+  if (m_realtime)
+  {
+    // the buffer ran empty, start over like a device after an underrun
+    if (m_start == 0 || GetBufferedSeconds() <= 0.0)
+    {
+      m_start = CurrentHostCounter();
+      m_framesBuffered = 0;
+    }
+
+    // block until there is room for the packet, as a sound card would
+    const double packetSeconds = static_cast<double>(frames) / m_format.m_sampleRate;
+    const double wait = GetBufferedSeconds() + packetSeconds - NULL_BUFFER_SECONDS;
+    if (wait > 0.0)
+      KODI::TIME::Sleep(static_cast<unsigned int>(wait * 1000));
+
+    m_framesBuffered += frames;
+  }
+
+  m_framesConsumed += frames;
+  return frames;
+}
+
+void CAESinkNULL::AddPause(unsigned int millis)
+{
+  if (m_realtime)
+    KODI::TIME::Sleep(millis);
+}
+
+void CAESinkNULL::Drain()
+{
+  if (m_realtime)
+    KODI::TIME::Sleep(static_cast<unsigned int>(GetBufferedSeconds() * 1000));
+
+  m_start = 0;
+  m_framesBuffered = 0;
+}
+
+void CAESinkNULL::EnumerateDevicesEx(AEDeviceInfoList& list, bool force)
+{
+  CAEDeviceInfo info;
+  info.m_deviceType = AE_DEVTYPE_PCM;
+  info.m_channels = AE_CH_LAYOUT_7_1;
+  info.m_sampleRates.assign(NullSampleRates,
+                            NullSampleRates + sizeof(NullSampleRates) / sizeof(*NullSampleRates));
+  info.m_dataFormats.push_back(AE_FMT_FLOAT);
+  info.m_wantsIECPassthrough = false;
+
+  info.m_deviceName = "null";
+  info.m_displayName = "Null";
+  info.m_displayNameExtra = "Discard audio";
+  list.push_back(info);
+
+  info.m_deviceName = "unlimited";
+  info.m_displayName = "Null (unlimited)";
+  info.m_displayNameExtra = "Discard audio as fast as possible";
+  list.push_back(info);
+}
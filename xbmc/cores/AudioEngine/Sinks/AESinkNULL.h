@@ -0,0 +1,61 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AESink.h"
+#include "cores/AudioEngine/Utils/AEDeviceInfo.h"
+
+#include <atomic>
+#include <stdint.h>
+
+/*!
+ * \brief Sink that discards all audio
+ *
+ * The "null" device consumes audio in real time, like a sound card with a
+ * small buffer, so that playback stays in sync on machines without audio
+ * hardware. The "unlimited" device consumes audio as fast as it is delivered,
+ * for measuring the throughput of the pipeline in front of it.
+ *
+ * Select it with KODI_AE_SINK=NULL.
+ */
+class CAESinkNULL : public IAESink
+{
+public:
+  const char* GetName() override { return "null"; }
+
+  CAESinkNULL() = default;
+  ~CAESinkNULL() override;
+
+  static void Register();
+  static IAESink* Create(std::string& device, AEAudioFormat& desiredFormat);
+  static void EnumerateDevicesEx(AEDeviceInfoList& list, bool force = false);
+
+  bool Initialize(AEAudioFormat& format, std::string& device) override;
+  void Deinitialize() override;
+
+  double GetCacheTotal() override;
+  void GetDelay(AEDelayStatus& status) override;
+  unsigned int AddPackets(uint8_t** data, unsigned int frames, unsigned int offset) override;
+  void AddPause(unsigned int millis) override;
+  void Drain() override;
+
+  /*!
+   * \brief Total number of frames consumed since Initialize
+   */
+  uint64_t GetFramesConsumed() const { return m_framesConsumed; }
+
+private:
+  double GetBufferedSeconds() const;
+
+  AEAudioFormat m_format;
+  bool m_realtime = true;
+  int64_t m_start = 0; // host counter of the first frame of the buffer
+  uint64_t m_framesBuffered = 0; // frames written since m_start
+  std::atomic<uint64_t> m_framesConsumed{0};
+};
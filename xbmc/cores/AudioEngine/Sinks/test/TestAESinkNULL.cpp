@@ -0,0 +1,94 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "threads/SystemClock.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+std::unique_ptr<IAESink> CreateSink(const std::string& deviceName, AEAudioFormat& format)
+{
+  CAESinkNULL::Register();
+
+  format.m_dataFormat = AE_FMT_S16NE;
+  format.m_sampleRate = 48000;
+  format.m_channelLayout = AE_CH_LAYOUT_2_0;
+
+  std::string device = "NULL:" + deviceName;
+  return std::unique_ptr<IAESink>(AE::CAESinkFactory::Create(device, format));
+}
+} // namespace
+
+TEST(TestAESinkNULL, Enumerate)
+{
+  AEDeviceInfoList list;
+  CAESinkNULL::EnumerateDevicesEx(list);
+
+  ASSERT_EQ(2U, list.size());
+  EXPECT_EQ("null", list[0].m_deviceName);
+  EXPECT_EQ("unlimited", list[1].m_deviceName);
+}
+
+TEST(TestAESinkNULL, Unlimited)
+{
+  AEAudioFormat format;
+  std::unique_ptr<IAESink> sink = CreateSink("unlimited", format);
+  ASSERT_NE(nullptr, sink);
+
+  // the sink decides the format
+  EXPECT_EQ(AE_FMT_FLOAT, format.m_dataFormat);
+  EXPECT_EQ(2 * sizeof(float), format.m_frameSize);
+  EXPECT_EQ(0.0, sink->GetCacheTotal());
+
+  std::vector<uint8_t> buffer(format.m_frames * format.m_frameSize);
+  uint8_t* data[] = {buffer.data()};
+
+  // a minute of audio is consumed without waiting
+  const unsigned int start = XbmcThreads::SystemClockMillis();
+  for (unsigned int frames = 0; frames < 60 * format.m_sampleRate; frames += format.m_frames)
+    ASSERT_EQ(format.m_frames, sink->AddPackets(data, format.m_frames, 0));
+  EXPECT_LT(XbmcThreads::SystemClockMillis() - start, 1000U);
+
+  AEDelayStatus status;
+  sink->GetDelay(status);
+  EXPECT_EQ(0.0, status.delay);
+  EXPECT_EQ(60 * format.m_sampleRate / format.m_frames * format.m_frames,
+            static_cast<CAESinkNULL*>(sink.get())->GetFramesConsumed());
+}
+
+TEST(TestAESinkNULL, RealTime)
+{
+  AEAudioFormat format;
+  std::unique_ptr<IAESink> sink = CreateSink("null", format);
+  ASSERT_NE(nullptr, sink);
+
+  std::vector<uint8_t> buffer(format.m_frames * format.m_frameSize);
+  uint8_t* data[] = {buffer.data()};
+
+  // half a second of audio has to block for about the part that doesn't fit
+  // into the buffer
+  const unsigned int start = XbmcThreads::SystemClockMillis();
+  for (unsigned int frames = 0; frames < format.m_sampleRate / 2; frames += format.m_frames)
+    ASSERT_EQ(format.m_frames, sink->AddPackets(data, format.m_frames, 0));
+  const unsigned int elapsed = XbmcThreads::SystemClockMillis() - start;
+
+  EXPECT_GE(elapsed, 300U);
+  EXPECT_LT(elapsed, 1000U);
+
+  AEDelayStatus status;
+  sink->GetDelay(status);
+  EXPECT_GT(status.delay, 0.0);
+  EXPECT_LE(status.delay, sink->GetCacheTotal() + 0.05);
+}
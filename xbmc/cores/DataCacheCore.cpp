@@ -94,6 +94,20 @@ bool CDataCacheCore::IsVideoHwDecoder()
   return m_playerVideoInfo.isHwDecoder;
 }
 
+void CDataCacheCore::SetVideoDecoderThreading(std::string threading)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.decoderThreading = threading;
+}
+
+std::string CDataCacheCore::GetVideoDecoderThreading()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decoderThreading;
+}
+
 
 void CDataCacheCore::SetVideoDeintMethod(std::string method)
 {
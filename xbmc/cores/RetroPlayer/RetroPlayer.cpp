@@ -48,6 +48,8 @@
 #include "utils/log.h"
 #include "windowing/WinSystem.h"
 
+#include <cinttypes>
+
 using namespace KODI;
 using namespace GAME;
 using namespace RETRO;
@@ -213,7 +215,7 @@ bool CRetroPlayer::CloseFile(bool reopen /* = false */)
 
   if (m_gameClient && m_gameServices.GameSettings().AutosaveEnabled())
   {
-    std::string savePath = m_playback->CreateSavestate();
+    std::string savePath = m_playback->CreateSavestate(true);
     if (!savePath.empty())
       CLog::Log(LOGDEBUG, "RetroPlayer[SAVE]: Saved state to %s",
                 CURL::GetRedacted(savePath).c_str());
@@ -221,8 +223,14 @@ bool CRetroPlayer::CloseFile(bool reopen /* = false */)
       CLog::Log(LOGDEBUG, "RetroPlayer[SAVE]: Failed to save state at close");
   }
 
+  // Savestates are written in the background, make sure they're on disk
+  // before the game is unloaded
+  CSavestateDatabase::WaitForPendingWrites();
+
   m_playback.reset();
 
+  PrintGameLoopStalls();
+
   if (m_gameClient)
     m_gameClient->CloseFile();
 
@@ -436,7 +444,7 @@ std::string CRetroPlayer::GetPlayerState()
 
   if (m_autoSave)
   {
-    savestatePath = m_playback->CreateSavestate();
+    savestatePath = m_playback->CreateSavestate(true);
     if (savestatePath.empty())
     {
       CLog::Log(LOGDEBUG, "RetroPlayer[SAVE]: Continuing without saving");
@@ -526,7 +534,8 @@ bool CRetroPlayer::IsAutoSaveEnabled() const
 
 std::string CRetroPlayer::CreateSavestate()
 {
-  return m_playback->CreateSavestate();
+  // Autosaves don't wait for the write, the game loop keeps running meanwhile
+  return m_playback->CreateSavestate(false);
 }
 
 void CRetroPlayer::SetSpeedInternal(double speed)
@@ -552,7 +561,8 @@ void CRetroPlayer::CreatePlayback(bool bRestoreState)
   if (m_gameClient->RequiresGameLoop())
   {
     m_playback->Deinitialize();
-    m_playback.reset(new CReversiblePlayback(m_gameClient.get(), m_gameClient->GetFrameRate(),
+    m_playback.reset(new CReversiblePlayback(m_gameClient.get(), *m_processInfo,
+                                             m_gameClient->GetFrameRate(),
                                              m_gameClient->GetSerializeSize()));
   }
   else
@@ -627,3 +637,30 @@ void CRetroPlayer::PrintGameInfo(const CFileItem& file) const
     CLog::Log(LOGDEBUG, "RetroPlayer[PLAYER]: ---------------------------------------");
   }
 }
+
+void CRetroPlayer::PrintGameLoopStalls() const
+{
+  if (!m_processInfo)
+    return;
+
+  const GameLoopStallHistogram stalls = m_processInfo->GetGameLoopStalls();
+
+  uint64_t frames = 0;
+  std::string buckets;
+  for (unsigned int i = 0; i < GameLoopStallHistogram::BUCKET_COUNT; i++)
+  {
+    frames += stalls.counts[i];
+
+    const unsigned int limitUs = GameLoopStallHistogram::GetBucketLimitUs(i);
+    if (limitUs != 0)
+      buckets += StringUtils::Format(" <%uus: %" PRIu64 ",", limitUs, stalls.counts[i]);
+    else
+      buckets += StringUtils::Format(" more: %" PRIu64, stalls.counts[i]);
+  }
+
+  if (frames == 0)
+    return;
+
+  CLog::Log(LOGDEBUG, "RetroPlayer[SAVE]: Game loop stalls over %" PRIu64 " frames:%s, max %uus",
+            frames, buckets.c_str(), stalls.maxStallUs);
+}
@@ -110,6 +110,11 @@ private:
    */
   void PrintGameInfo(const CFileItem& file) const;
 
+  /**
+   * \brief Dump the time the game loop was blocked by savestates to the debug log.
+   */
+  void PrintGameLoopStalls() const;
+
   uint64_t GetTime();
   uint64_t GetTotalTime();
 
@@ -28,6 +28,12 @@ public:
   virtual ~IAutoSaveCallback() = default;
 
   virtual bool IsAutoSaveEnabled() const = 0;
+
+  /*!
+   * \brief Create a savestate that is written in the background
+   *
+   * \return The path of the savestate, which may not exist yet
+   */
   virtual std::string CreateSavestate() = 0;
 };
 
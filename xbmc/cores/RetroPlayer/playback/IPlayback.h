@@ -37,7 +37,9 @@ public:
   virtual void PauseAsync() = 0; // Pauses after the following frame
 
   // Savestates
-  virtual std::string CreateSavestate() = 0; // Returns the path of savestate on success
+  // Returns the path of the savestate on success. Unless waitForWrite is set, the savestate is
+  // written in the background and the file may not exist yet, or not at all if writing fails.
+  virtual std::string CreateSavestate(bool waitForWrite) = 0;
   virtual bool LoadSavestate(const std::string& path) = 0;
 };
 } // namespace RETRO
@@ -9,14 +9,16 @@
 #include "ReversiblePlayback.h"
 
 #include "ServiceBroker.h"
+#include "cores/RetroPlayer/process/RPProcessInfo.h"
 #include "cores/RetroPlayer/savestates/ISavestate.h"
 #include "cores/RetroPlayer/savestates/SavestateDatabase.h"
-#include "cores/RetroPlayer/streams/memory/DeltaPairMemoryStream.h"
+#include "cores/RetroPlayer/streams/memory/BlockDeltaMemoryStream.h"
 #include "games/GameServices.h"
 #include "games/GameSettings.h"
 #include "games/addons/GameClient.h"
 #include "threads/SingleLock.h"
 #include "utils/MathUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
 
 #include <algorithm>
@@ -27,9 +29,11 @@ using namespace RETRO;
 #define REWIND_FACTOR 0.25 // Rewind at 25% of gameplay speed
 
 CReversiblePlayback::CReversiblePlayback(GAME::CGameClient* gameClient,
+                                         CRPProcessInfo& processInfo,
                                          double fps,
                                          size_t serializeSize)
   : m_gameClient(gameClient),
+    m_processInfo(processInfo),
     m_gameLoop(this, fps),
     m_savestateDatabase(new CSavestateDatabase),
     m_totalFrameCount(0),
@@ -108,7 +112,7 @@ void CReversiblePlayback::PauseAsync()
   m_gameLoop.PauseAsync();
 }
 
-std::string CReversiblePlayback::CreateSavestate()
+std::string CReversiblePlayback::CreateSavestate(bool waitForWrite)
 {
   const size_t memorySize = m_gameClient->SerializeSize();
 
@@ -143,25 +147,43 @@ std::string CReversiblePlayback::CreateSavestate()
   savestate->SetGameClientID(gameClientId);
   savestate->SetGameClientVersion(gameClientVersion);
 
-  uint8_t* memoryData = savestate->GetMemoryBuffer(memorySize);
+  // Only the memory is copied here, the savestate is serialized, compressed
+  // and written on a worker thread
+  std::vector<uint8_t> memoryData = m_savestateDatabase->GetSnapshotBuffer(memorySize);
 
+  const uint8_t* currentFrame = nullptr;
   {
     CSingleLock lock(m_mutex);
-    if (m_memoryStream && m_memoryStream->CurrentFrame() != nullptr)
-    {
-      std::memcpy(memoryData, m_memoryStream->CurrentFrame(), memorySize);
-    }
-    else
+    WaitForSnapshot();
+    if (m_memoryStream)
+      currentFrame = m_memoryStream->CurrentFrame();
+
+    // The stream is left alone while the frame is copied, so the game loop
+    // doesn't have to wait for the copy
+    if (currentFrame != nullptr)
     {
-      lock.Leave();
-      if (!m_gameClient->Serialize(memoryData, memorySize))
-        return "";
+      m_snapshotPending = true;
+      m_snapshotDone.Reset();
     }
   }
 
-  savestate->Finalize();
+  if (currentFrame != nullptr)
+  {
+    std::memcpy(memoryData.data(), currentFrame, memorySize);
 
-  if (!m_savestateDatabase->AddSavestate(m_gameClient->GetGamePath(), *savestate))
+    CSingleLock lock(m_mutex);
+    m_snapshotPending = false;
+    m_snapshotDone.Set();
+  }
+  else if (!m_gameClient->Serialize(memoryData.data(), memorySize))
+  {
+    return "";
+  }
+
+  m_savestateDatabase->AddSavestateAsync(m_gameClient->GetGamePath(), std::move(savestate),
+                                         std::move(memoryData));
+
+  if (waitForWrite && !CSavestateDatabase::WaitForSavestate(m_gameClient->GetGamePath()))
     return "";
 
   return m_gameClient->GetGamePath();
@@ -183,6 +205,7 @@ bool CReversiblePlayback::LoadSavestate(const std::string& path)
   {
     {
       CSingleLock lock(m_mutex);
+      WaitForSnapshot();
       if (m_memoryStream)
       {
         m_memoryStream->SetFrameCounter(savestate->TimestampFrames());
@@ -217,9 +240,16 @@ void CReversiblePlayback::RewindEvent()
 
 void CReversiblePlayback::AddFrame()
 {
+  const int64_t waitStart = CurrentHostCounter();
+
   CSingleLock lock(m_mutex);
 
-  if (m_memoryStream)
+  m_processInfo.AddGameLoopStall(
+      static_cast<unsigned int>((CurrentHostCounter() - waitStart) * 1000000 / CurrentHostFrequency()));
+
+  // The frame is left out of the rewind history if a savestate is copying
+  // the current frame
+  if (m_memoryStream && !m_snapshotPending)
   {
     if (m_gameClient->Serialize(m_memoryStream->BeginFrame(), m_memoryStream->FrameSize()))
     {
@@ -234,6 +264,7 @@ void CReversiblePlayback::AddFrame()
 void CReversiblePlayback::RewindFrames(uint64_t frames)
 {
   CSingleLock lock(m_mutex);
+  WaitForSnapshot();
 
   if (m_memoryStream)
   {
@@ -248,6 +279,7 @@ void CReversiblePlayback::RewindFrames(uint64_t frames)
 void CReversiblePlayback::AdvanceFrames(uint64_t frames)
 {
   CSingleLock lock(m_mutex);
+  WaitForSnapshot();
 
   if (m_memoryStream)
   {
@@ -288,6 +320,7 @@ void CReversiblePlayback::Notify(const Observable& obs, const ObservableMessage
 void CReversiblePlayback::UpdateMemoryStream()
 {
   CSingleLock lock(m_mutex);
+  WaitForSnapshot();
 
   bool bRewindEnabled = false;
 
@@ -306,7 +339,7 @@ void CReversiblePlayback::UpdateMemoryStream()
 
     if (!m_memoryStream)
     {
-      m_memoryStream.reset(new CDeltaPairMemoryStream);
+      m_memoryStream.reset(new CBlockDeltaMemoryStream);
       m_memoryStream->Init(m_gameClient->SerializeSize(), frameCount);
     }
 
@@ -327,3 +360,13 @@ void CReversiblePlayback::UpdateMemoryStream()
     m_cacheTimeMs = 0;
   }
 }
+
+void CReversiblePlayback::WaitForSnapshot()
+{
+  // Called with m_mutex held
+  while (m_snapshotPending)
+  {
+    CSingleExit exit(m_mutex);
+    m_snapshotDone.Wait();
+  }
+}
@@ -11,6 +11,7 @@
 #include "GameLoop.h"
 #include "IPlayback.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "utils/Observer.h"
 
 #include <memory>
@@ -26,13 +27,17 @@ class CGameClient;
 
 namespace RETRO
 {
+class CRPProcessInfo;
 class CSavestateDatabase;
 class IMemoryStream;
 
 class CReversiblePlayback : public IPlayback, public IGameLoopCallback, public Observer
 {
 public:
-  CReversiblePlayback(GAME::CGameClient* gameClient, double fps, size_t serializeSize);
+  CReversiblePlayback(GAME::CGameClient* gameClient,
+                      CRPProcessInfo& processInfo,
+                      double fps,
+                      size_t serializeSize);
 
   ~CReversiblePlayback() override;
 
@@ -48,7 +53,7 @@ public:
   double GetSpeed() const override;
   void SetSpeed(double speedFactor) override;
   void PauseAsync() override;
-  std::string CreateSavestate() override;
+  std::string CreateSavestate(bool waitForWrite) override;
   bool LoadSavestate(const std::string& path) override;
 
   // implementation of IGameLoopCallback
@@ -64,9 +69,11 @@ private:
   void AdvanceFrames(uint64_t frames);
   void UpdatePlaybackStats();
   void UpdateMemoryStream();
+  void WaitForSnapshot();
 
-  // Construction parameter
+  // Construction parameters
   GAME::CGameClient* const m_gameClient;
+  CRPProcessInfo& m_processInfo;
 
   // Gameplay functionality
   CGameLoop m_gameLoop;
@@ -75,6 +82,8 @@ private:
 
   // Savestate functionality
   std::unique_ptr<CSavestateDatabase> m_savestateDatabase;
+  bool m_snapshotPending = false; // current frame is being copied, don't modify the stream
+  CEvent m_snapshotDone{true, true};
 
   // Playback stats
   uint64_t m_totalFrameCount;
@@ -29,6 +29,24 @@ extern "C"
 using namespace KODI;
 using namespace RETRO;
 
+namespace
+{
+// Upper bounds of the game loop stall buckets, in microseconds
+const unsigned int STALL_BUCKET_LIMITS_US[] = {100, 500, 1000, 2000, 5000, 10000, 20000};
+
+static_assert(sizeof(STALL_BUCKET_LIMITS_US) / sizeof(STALL_BUCKET_LIMITS_US[0]) + 1 ==
+                  GameLoopStallHistogram::BUCKET_COUNT,
+              "Bucket limits don't match the bucket count");
+} // namespace
+
+unsigned int GameLoopStallHistogram::GetBucketLimitUs(unsigned int bucket)
+{
+  if (bucket + 1 < BUCKET_COUNT)
+    return STALL_BUCKET_LIMITS_US[bucket];
+
+  return 0;
+}
+
 CreateRPProcessControl CRPProcessInfo::m_processControl = nullptr;
 std::vector<std::unique_ptr<IRendererFactory>> CRPProcessInfo::m_rendererFactories;
 CCriticalSection CRPProcessInfo::m_createSection;
@@ -168,6 +186,10 @@ void CRPProcessInfo::ResetInfo()
     m_dataCache->SetVideoRender(false); //! @todo
     m_dataCache->SetPlayTimes(0, 0, 0, 0);
   }
+
+  for (auto& count : m_stallCounts)
+    count = 0;
+  m_maxStallUs = 0;
 }
 
 bool CRPProcessInfo::HasScalingMethod(SCALINGMETHOD scalingMethod) const
@@ -241,3 +263,33 @@ void CRPProcessInfo::SetPlayTimes(time_t start, int64_t current, int64_t min, in
   if (m_dataCache != nullptr)
     m_dataCache->SetPlayTimes(start, current, min, max);
 }
+
+//******************************************************************************
+// savestate info
+//******************************************************************************
+void CRPProcessInfo::AddGameLoopStall(unsigned int stallUs)
+{
+  unsigned int bucket = 0;
+  while (bucket + 1 < GameLoopStallHistogram::BUCKET_COUNT &&
+         stallUs >= STALL_BUCKET_LIMITS_US[bucket])
+    bucket++;
+
+  m_stallCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+
+  unsigned int maxStallUs = m_maxStallUs.load(std::memory_order_relaxed);
+  while (stallUs > maxStallUs &&
+         !m_maxStallUs.compare_exchange_weak(maxStallUs, stallUs, std::memory_order_relaxed))
+  {
+  }
+}
+
+GameLoopStallHistogram CRPProcessInfo::GetGameLoopStalls() const
+{
+  GameLoopStallHistogram histogram;
+
+  for (unsigned int i = 0; i < GameLoopStallHistogram::BUCKET_COUNT; i++)
+    histogram.counts[i] = m_stallCounts[i].load(std::memory_order_relaxed);
+  histogram.maxStallUs = m_maxStallUs.load(std::memory_order_relaxed);
+
+  return histogram;
+}
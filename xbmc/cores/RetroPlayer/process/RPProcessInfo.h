@@ -12,7 +12,9 @@
 #include "cores/RetroPlayer/RetroPlayerTypes.h"
 #include "threads/CriticalSection.h"
 
+#include <atomic>
 #include <memory>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -70,6 +72,24 @@ public:
   virtual RenderBufferPoolVector CreateBufferPools(CRenderContext& context) = 0;
 };
 
+/*!
+ * \brief Histogram of the time the game loop was blocked by savestate creation
+ */
+struct GameLoopStallHistogram
+{
+  static const unsigned int BUCKET_COUNT = 8;
+
+  /*!
+   * \brief Get the upper bound of a bucket in microseconds
+   *
+   * The last bucket has no upper bound and returns 0.
+   */
+  static unsigned int GetBucketLimitUs(unsigned int bucket);
+
+  uint64_t counts[BUCKET_COUNT] = {};
+  unsigned int maxStallUs = 0;
+};
+
 /*!
  * \brief Player process info
  */
@@ -164,6 +184,21 @@ public:
   void SetPlayTimes(time_t start, int64_t current, int64_t min, int64_t max);
   ///}
 
+  /// @name Savestate info
+  ///{
+  /*!
+   * \brief Record the time the game loop waited for a savestate snapshot
+   *
+   * Called from the game loop every frame, so this doesn't lock.
+   */
+  void AddGameLoopStall(unsigned int stallUs);
+
+  /*!
+   * \brief Get the game loop stalls recorded since the last ResetInfo()
+   */
+  GameLoopStallHistogram GetGameLoopStalls() const;
+  ///}
+
 protected:
   /*!
    * \brief Constructor
@@ -195,6 +230,10 @@ private:
   // Rendering parameters
   std::unique_ptr<CRenderContext> m_renderContext;
   SCALINGMETHOD m_defaultScalingMethod = SCALINGMETHOD::AUTO;
+
+  // Savestate parameters
+  std::atomic<uint64_t> m_stallCounts[GameLoopStallHistogram::BUCKET_COUNT] = {};
+  std::atomic<unsigned int> m_maxStallUs{0};
 };
 
 } // namespace RETRO
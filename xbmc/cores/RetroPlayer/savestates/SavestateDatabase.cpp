@@ -12,41 +12,114 @@
 #include "SavestateUtils.h"
 #include "URL.h"
 #include "filesystem/File.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 
+#include <cstring>
+#include <map>
+
+#include <zlib.h>
+
 using namespace KODI;
 using namespace RETRO;
 
-CSavestateDatabase::CSavestateDatabase() = default;
+namespace
+{
+/*!
+ * \brief Header of compressed savestates
+ *
+ * The magic is followed by the uncompressed size as a 64-bit little-endian
+ * integer and the zlib stream. Savestates without the magic are read as
+ * uncompressed FlatBuffers.
+ */
+const char COMPRESSED_MAGIC[4] = {'R', 'P', 'Z', '1'};
+const size_t COMPRESSED_HEADER_SIZE = sizeof(COMPRESSED_MAGIC) + sizeof(uint64_t);
+
+/*!
+ * \brief Number of snapshot buffers kept for reuse
+ */
+const size_t MAX_POOLED_SNAPSHOTS = 2;
 
-std::unique_ptr<ISavestate> CSavestateDatabase::CreateSavestate()
+/*!
+ * \brief Savestates queued for writing, per path
+ */
+struct PendingWrite
 {
-  std::unique_ptr<ISavestate> savestate;
+  uint64_t latestSequence = 0;
+  unsigned int count = 0;
+};
 
-  savestate.reset(new CSavestateFlatBuffer);
+CCriticalSection pendingSection;
+std::map<std::string, PendingWrite> pendingWrites;
+std::map<std::string, bool> writeResults; // Result of the newest savestate of a path
+uint64_t nextSequence = 0;
+CEvent writeFinished;
 
-  return savestate;
+bool Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& compressed)
+{
+  uLongf compressedSize = compressBound(static_cast<uLong>(size));
+  compressed.resize(COMPRESSED_HEADER_SIZE + compressedSize);
+
+  std::memcpy(compressed.data(), COMPRESSED_MAGIC, sizeof(COMPRESSED_MAGIC));
+  uint64_t uncompressedSize = static_cast<uint64_t>(size);
+  for (size_t i = 0; i < sizeof(uint64_t); i++)
+    compressed[sizeof(COMPRESSED_MAGIC) + i] = static_cast<uint8_t>(uncompressedSize >> (i * 8));
+
+  // Emulator memory compresses well even at the fastest level
+  if (compress2(compressed.data() + COMPRESSED_HEADER_SIZE, &compressedSize, data,
+                static_cast<uLong>(size), Z_BEST_SPEED) != Z_OK)
+    return false;
+
+  compressed.resize(COMPRESSED_HEADER_SIZE + compressedSize);
+  return true;
 }
 
-bool CSavestateDatabase::AddSavestate(const std::string& gamePath, const ISavestate& save)
+bool Decompress(std::vector<uint8_t>& data)
 {
-  bool bSuccess = false;
+  if (data.size() < COMPRESSED_HEADER_SIZE ||
+      std::memcmp(data.data(), COMPRESSED_MAGIC, sizeof(COMPRESSED_MAGIC)) != 0)
+    return true; // Not compressed
 
-  const std::string savestatePath = CSavestateUtils::MakePath(gamePath);
+  uint64_t uncompressedSize = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); i++)
+    uncompressedSize |= static_cast<uint64_t>(data[sizeof(COMPRESSED_MAGIC) + i]) << (i * 8);
 
-  CLog::Log(LOGDEBUG, "Saving savestate to %s", CURL::GetRedacted(savestatePath).c_str());
+  std::vector<uint8_t> uncompressed(static_cast<size_t>(uncompressedSize));
+  uLongf destSize = static_cast<uLongf>(uncompressedSize);
+  if (uncompress(uncompressed.data(), &destSize, data.data() + COMPRESSED_HEADER_SIZE,
+                 static_cast<uLong>(data.size() - COMPRESSED_HEADER_SIZE)) != Z_OK ||
+      destSize != uncompressedSize)
+    return false;
+
+  data = std::move(uncompressed);
+  return true;
+}
+
+bool WriteSavestate(const std::string& savestatePath, const ISavestate& save)
+{
+  bool bSuccess = false;
 
   const uint8_t* data = nullptr;
   size_t size = 0;
   if (save.Serialize(data, size))
   {
+    std::vector<uint8_t> compressed;
+    if (Compress(data, size, compressed))
+    {
+      data = compressed.data();
+      size = compressed.size();
+    }
+
     XFILE::CFile file;
-    if (file.OpenForWrite(savestatePath))
+    if (file.OpenForWrite(savestatePath, true))
     {
       const ssize_t written = file.Write(data, size);
       if (written == static_cast<ssize_t>(size))
       {
-        CLog::Log(LOGDEBUG, "Wrote savestate of %u bytes", size);
+        CLog::Log(LOGDEBUG, "Wrote savestate of %u bytes", static_cast<unsigned int>(size));
         bSuccess = true;
       }
     }
@@ -57,6 +130,211 @@ bool CSavestateDatabase::AddSavestate(const std::string& gamePath, const ISavest
   return bSuccess;
 }
 
+void WaitForPendingWrite(const std::string& savestatePath)
+{
+  while (true)
+  {
+    {
+      CSingleLock lock(pendingSection);
+      if (pendingWrites.find(savestatePath) == pendingWrites.end())
+        break;
+    }
+    writeFinished.WaitMSec(100);
+  }
+}
+} // namespace
+
+class CSavestateDatabase::CSnapshotPool
+{
+public:
+  std::vector<uint8_t> Get(size_t size)
+  {
+    std::vector<uint8_t> buffer;
+    {
+      CSingleLock lock(m_section);
+      if (!m_buffers.empty())
+      {
+        buffer = std::move(m_buffers.back());
+        m_buffers.pop_back();
+      }
+    }
+    buffer.resize(size);
+    return buffer;
+  }
+
+  void Return(std::vector<uint8_t> buffer)
+  {
+    CSingleLock lock(m_section);
+    if (m_buffers.size() < MAX_POOLED_SNAPSHOTS)
+      m_buffers.emplace_back(std::move(buffer));
+  }
+
+private:
+  CCriticalSection m_section;
+  std::vector<std::vector<uint8_t>> m_buffers;
+};
+
+class CSavestateDatabase::CWriteJob : public CJob
+{
+public:
+  CWriteJob(std::string savestatePath,
+            std::unique_ptr<ISavestate> save,
+            std::vector<uint8_t> memory,
+            std::shared_ptr<CSnapshotPool> pool,
+            uint64_t sequence)
+    : m_savestatePath(std::move(savestatePath)),
+      m_save(std::move(save)),
+      m_memory(std::move(memory)),
+      m_pool(std::move(pool)),
+      m_sequence(sequence)
+  {
+  }
+
+  ~CWriteJob() override
+  {
+    m_pool->Return(std::move(m_memory));
+
+    // Also reached if the job is cancelled before it runs
+    CSingleLock lock(pendingSection);
+    auto it = pendingWrites.find(m_savestatePath);
+    if (it != pendingWrites.end())
+    {
+      if (it->second.latestSequence == m_sequence && !m_done)
+        writeResults[m_savestatePath] = false;
+      if (--it->second.count == 0)
+        pendingWrites.erase(it);
+    }
+    writeFinished.Set();
+  }
+
+  const char* GetType() const override { return "savestate"; }
+
+  bool DoWork() override
+  {
+    {
+      CSingleLock lock(pendingSection);
+      auto it = pendingWrites.find(m_savestatePath);
+      if (it != pendingWrites.end() && it->second.latestSequence != m_sequence)
+      {
+        CLog::Log(LOGDEBUG, "Skipping savestate, a newer one is queued");
+        return true;
+      }
+    }
+
+    std::memcpy(m_save->GetMemoryBuffer(m_memory.size()), m_memory.data(), m_memory.size());
+    m_save->Finalize();
+
+    // Writes are serialized so that an older savestate can't overwrite a
+    // newer one of the same game
+    bool bSuccess;
+    {
+      CSingleLock lock(m_writeSection);
+      bSuccess = WriteSavestate(m_savestatePath, *m_save);
+    }
+    if (!bSuccess)
+      CLog::Log(LOGERROR, "Failed to write savestate %s",
+                CURL::GetRedacted(m_savestatePath).c_str());
+
+    CSingleLock lock(pendingSection);
+    writeResults[m_savestatePath] = bSuccess;
+    m_done = true;
+
+    return bSuccess;
+  }
+
+private:
+  const std::string m_savestatePath;
+  std::unique_ptr<ISavestate> m_save;
+  std::vector<uint8_t> m_memory;
+  const std::shared_ptr<CSnapshotPool> m_pool;
+  const uint64_t m_sequence;
+  bool m_done = false;
+
+  static CCriticalSection m_writeSection;
+};
+
+CCriticalSection CSavestateDatabase::CWriteJob::m_writeSection;
+
+CSavestateDatabase::CSavestateDatabase() : m_snapshotPool(std::make_shared<CSnapshotPool>())
+{
+}
+
+std::unique_ptr<ISavestate> CSavestateDatabase::CreateSavestate()
+{
+  std::unique_ptr<ISavestate> savestate;
+
+  savestate.reset(new CSavestateFlatBuffer);
+
+  return savestate;
+}
+
+bool CSavestateDatabase::AddSavestate(const std::string& gamePath, const ISavestate& save)
+{
+  const std::string savestatePath = CSavestateUtils::MakePath(gamePath);
+
+  CLog::Log(LOGDEBUG, "Saving savestate to %s", CURL::GetRedacted(savestatePath).c_str());
+
+  // Don't race with a queued savestate of the same game
+  WaitForPendingWrite(savestatePath);
+
+  return WriteSavestate(savestatePath, save);
+}
+
+std::vector<uint8_t> CSavestateDatabase::GetSnapshotBuffer(size_t size)
+{
+  return m_snapshotPool->Get(size);
+}
+
+void CSavestateDatabase::AddSavestateAsync(const std::string& gamePath,
+                                           std::unique_ptr<ISavestate> save,
+                                           std::vector<uint8_t> memory)
+{
+  const std::string savestatePath = CSavestateUtils::MakePath(gamePath);
+
+  CLog::Log(LOGDEBUG, "Queuing savestate for %s", CURL::GetRedacted(savestatePath).c_str());
+
+  uint64_t sequence;
+  {
+    CSingleLock lock(pendingSection);
+    PendingWrite& pending = pendingWrites[savestatePath];
+    pending.latestSequence = sequence = nextSequence++;
+    pending.count++;
+  }
+
+  CWriteJob* job =
+      new CWriteJob(savestatePath, std::move(save), std::move(memory), m_snapshotPool, sequence);
+  if (CJobManager::GetInstance().AddJob(job, nullptr, CJob::PRIORITY_NORMAL) == 0)
+  {
+    // Job manager isn't running, write from the calling thread
+    job->DoWork();
+    delete job;
+  }
+}
+
+bool CSavestateDatabase::WaitForSavestate(const std::string& gamePath)
+{
+  const std::string savestatePath = CSavestateUtils::MakePath(gamePath);
+
+  WaitForPendingWrite(savestatePath);
+
+  CSingleLock lock(pendingSection);
+  auto it = writeResults.find(savestatePath);
+  return it != writeResults.end() && it->second;
+}
+
+void CSavestateDatabase::WaitForPendingWrites()
+{
+  while (true)
+  {
+    {
+      CSingleLock lock(pendingSection);
+      if (pendingWrites.empty())
+        break;
+    }
+    writeFinished.WaitMSec(100);
+  }
+}
+
 bool CSavestateDatabase::GetSavestate(const std::string& gamePath, ISavestate& save)
 {
   bool bSuccess = false;
@@ -65,6 +343,8 @@ bool CSavestateDatabase::GetSavestate(const std::string& gamePath, ISavestate& s
 
   CLog::Log(LOGDEBUG, "Loading savestate from %s", CURL::GetRedacted(savestatePath).c_str());
 
+  WaitForPendingWrite(savestatePath);
+
   std::vector<uint8_t> savestateData;
 
   XFILE::CFile savestateFile;
@@ -91,6 +371,13 @@ bool CSavestateDatabase::GetSavestate(const std::string& gamePath, ISavestate& s
     CLog::Log(LOGERROR, "Failed to open savestate file %s",
               CURL::GetRedacted(savestatePath).c_str());
 
+  if (!savestateData.empty() && !Decompress(savestateData))
+  {
+    CLog::Log(LOGERROR, "Failed to decompress savestate %s",
+              CURL::GetRedacted(savestatePath).c_str());
+    savestateData.clear();
+  }
+
   if (!savestateData.empty())
     bSuccess = save.Deserialize(std::move(savestateData));
 
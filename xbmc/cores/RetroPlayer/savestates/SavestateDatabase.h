@@ -9,7 +9,9 @@
 #pragma once
 
 #include <memory>
+#include <stdint.h>
 #include <string>
+#include <vector>
 
 class CFileItemList;
 
@@ -29,6 +31,48 @@ public:
 
   bool AddSavestate(const std::string& gamePath, const ISavestate& save);
 
+  /*!
+   * \brief Get a buffer for a snapshot of the emulator's memory
+   *
+   * Buffers are recycled after their savestate has been written, so taking
+   * a snapshot doesn't allocate once the first savestate has been created.
+   *
+   * \param size The size of the emulator's memory
+   *
+   * \return A buffer of the given size
+   */
+  std::vector<uint8_t> GetSnapshotBuffer(size_t size);
+
+  /*!
+   * \brief Add a savestate without blocking the caller
+   *
+   * The memory snapshot is copied into the savestate, which is then
+   * finalized, compressed and written on a worker thread. If several
+   * savestates are queued for the same game, only the newest is written.
+   *
+   * \param gamePath The path of the game
+   * \param save The savestate, with everything except the memory set
+   * \param memory The snapshot, from GetSnapshotBuffer()
+   */
+  void AddSavestateAsync(const std::string& gamePath,
+                         std::unique_ptr<ISavestate> save,
+                         std::vector<uint8_t> memory);
+
+  /*!
+   * \brief Wait until the savestates of a game added by AddSavestateAsync() are written
+   *
+   * \param gamePath The path of the game
+   *
+   * \return True if the newest savestate of the game was written, false if
+   *         compressing or writing it failed
+   */
+  static bool WaitForSavestate(const std::string& gamePath);
+
+  /*!
+   * \brief Wait until all savestates added by AddSavestateAsync() are written
+   */
+  static void WaitForPendingWrites();
+
   bool GetSavestate(const std::string& gamePath, ISavestate& save);
 
   bool GetSavestatesNav(CFileItemList& items,
@@ -40,6 +84,12 @@ public:
   bool DeleteSavestate(const std::string& path);
 
   bool ClearSavestatesOfGame(const std::string& gamePath, const std::string& gameClient = "");
+
+private:
+  class CSnapshotPool;
+  class CWriteJob;
+
+  std::shared_ptr<CSnapshotPool> m_snapshotPool;
 };
 } // namespace RETRO
 } // namespace KODI
@@ -0,0 +1,404 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "BlockDeltaMemoryStream.h"
+
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) || (defined(__arm__) && defined(HAS_NEON))
+#include <arm_neon.h>
+#endif
+
+using namespace KODI;
+using namespace RETRO;
+
+namespace
+{
+// Per changed block: block index, word mask and up to BLOCK_WORDS words
+constexpr size_t BLOCK_HEADER_WORDS = 2;
+
+// Per record: number of changed blocks
+constexpr size_t RECORD_HEADER_WORDS = 1;
+
+// Arena size relative to the size of the uncompressed history. Most games
+// change only a few percent of their state per frame.
+constexpr size_t ARENA_RATIO = 16;
+
+constexpr size_t MAX_ARENA_SIZE = 256 * 1024 * 1024;
+
+// The arena starts at this size, or the size of two worst case records, and
+// grows as the history fills up
+constexpr size_t INITIAL_ARENA_SIZE = 1024 * 1024;
+
+/*!
+ * \brief Check if a full block differs between two frames
+ */
+bool BlockChanged(const uint32_t* current, const uint32_t* next)
+{
+  static_assert(CBlockDeltaMemoryStream::BLOCK_WORDS == 16, "SIMD compare assumes 64 byte blocks");
+
+#if defined(__SSE2__)
+  const __m128i* a = reinterpret_cast<const __m128i*>(current);
+  const __m128i* b = reinterpret_cast<const __m128i*>(next);
+
+  __m128i diff = _mm_xor_si128(_mm_loadu_si128(a), _mm_loadu_si128(b));
+  diff = _mm_or_si128(diff, _mm_xor_si128(_mm_loadu_si128(a + 1), _mm_loadu_si128(b + 1)));
+  diff = _mm_or_si128(diff, _mm_xor_si128(_mm_loadu_si128(a + 2), _mm_loadu_si128(b + 2)));
+  diff = _mm_or_si128(diff, _mm_xor_si128(_mm_loadu_si128(a + 3), _mm_loadu_si128(b + 3)));
+
+  return _mm_movemask_epi8(_mm_cmpeq_epi32(diff, _mm_setzero_si128())) != 0xFFFF;
+#elif defined(__aarch64__) || (defined(__arm__) && defined(HAS_NEON))
+  uint32x4_t diff = veorq_u32(vld1q_u32(current), vld1q_u32(next));
+  diff = vorrq_u32(diff, veorq_u32(vld1q_u32(current + 4), vld1q_u32(next + 4)));
+  diff = vorrq_u32(diff, veorq_u32(vld1q_u32(current + 8), vld1q_u32(next + 8)));
+  diff = vorrq_u32(diff, veorq_u32(vld1q_u32(current + 12), vld1q_u32(next + 12)));
+
+#if defined(__aarch64__)
+  return vmaxvq_u32(diff) != 0;
+#else
+  const uint32x2_t folded = vorr_u32(vget_low_u32(diff), vget_high_u32(diff));
+  return (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) != 0;
+#endif
+#else
+  uint32_t diff = 0;
+  for (size_t i = 0; i < CBlockDeltaMemoryStream::BLOCK_WORDS; i++)
+    diff |= current[i] ^ next[i];
+  return diff != 0;
+#endif
+}
+
+/*!
+ * \brief Write the non-zero XOR words of a block
+ *
+ * \return The number of words written, or 0 if the block is unchanged
+ */
+size_t EncodeBlock(const uint32_t* current,
+                   const uint32_t* next,
+                   size_t wordCount,
+                   uint32_t blockIndex,
+                   uint32_t* out)
+{
+  uint32_t mask = 0;
+  uint32_t* words = out + BLOCK_HEADER_WORDS;
+
+  for (size_t i = 0; i < wordCount; i++)
+  {
+    const uint32_t xorVal = current[i] ^ next[i];
+    if (xorVal)
+    {
+      mask |= 1 << i;
+      *words++ = xorVal;
+    }
+  }
+
+  if (mask == 0)
+    return 0;
+
+  out[0] = blockIndex;
+  out[1] = mask;
+
+  return words - out;
+}
+} // namespace
+
+void CBlockDeltaMemoryStream::Init(size_t frameSize, uint64_t maxFrameCount)
+{
+  CLinearMemoryStream::Init(frameSize, maxFrameCount);
+
+  AllocateArena();
+}
+
+void CBlockDeltaMemoryStream::Reset()
+{
+  CLinearMemoryStream::Reset();
+
+  m_rewindBuffer.clear();
+  m_arena.reset();
+  m_arenaSize = 0;
+  m_maxArenaSize = 0;
+  m_writePos = 0;
+  m_deltaBytes = 0;
+  m_bHistoryLimited = false;
+}
+
+void CBlockDeltaMemoryStream::SetMaxFrameCount(uint64_t maxFrameCount)
+{
+  CLinearMemoryStream::SetMaxFrameCount(maxFrameCount);
+
+  if (m_paddedFrameSize == 0)
+    return;
+
+  // A larger limit lets the arena grow further. Shrinking the arena discards
+  // the history, so only do it if the arena is above the new limit.
+  const size_t maxArenaSize = GetArenaSize(maxFrameCount);
+  if (m_arena && m_arenaSize <= maxArenaSize)
+  {
+    m_maxArenaSize = maxArenaSize;
+    m_bHistoryLimited = false;
+  }
+  else
+  {
+    m_rewindBuffer.clear();
+    m_deltaBytes = 0;
+    AllocateArena();
+  }
+}
+
+uint64_t CBlockDeltaMemoryStream::PastFramesAvailable() const
+{
+  return static_cast<uint64_t>(m_rewindBuffer.size());
+}
+
+uint64_t CBlockDeltaMemoryStream::RewindFrames(uint64_t frameCount)
+{
+  uint64_t rewound;
+
+  for (rewound = 0; rewound < frameCount; rewound++)
+  {
+    if (m_rewindBuffer.empty())
+      break;
+
+    const MemoryFrame& frame = m_rewindBuffer.back();
+    const uint32_t* record = reinterpret_cast<const uint32_t*>(m_arena.get() + frame.offset);
+
+    uint32_t* currentFrame = m_currentFrame.get();
+
+    const uint32_t blockCount = *record++;
+    for (uint32_t block = 0; block < blockCount; block++)
+    {
+      uint32_t* dest = currentFrame + record[0] * BLOCK_WORDS;
+      uint32_t mask = record[1];
+      record += BLOCK_HEADER_WORDS;
+
+      for (size_t i = 0; mask != 0; i++, mask >>= 1)
+      {
+        if (mask & 1)
+          dest[i] ^= *record++;
+      }
+    }
+
+    // Restore frame history
+    m_currentFrameHistory = frame.frameHistoryCount;
+
+    m_deltaBytes -= frame.size;
+    m_writePos = frame.offset;
+    m_rewindBuffer.pop_back();
+  }
+
+  if (m_rewindBuffer.empty())
+    m_writePos = 0;
+
+  return rewound;
+}
+
+void CBlockDeltaMemoryStream::SubmitFrameInternal()
+{
+  if (!m_arena)
+    AllocateArena();
+
+  if (!m_arena)
+  {
+    // No history is kept, bring the new frame forward
+    std::swap(m_currentFrame, m_nextFrame);
+    m_bHasNextFrame = false;
+    return;
+  }
+
+  const size_t offset = Reserve(MaxRecordSize());
+
+  uint32_t* record = reinterpret_cast<uint32_t*>(m_arena.get() + offset);
+  uint32_t* out = record + RECORD_HEADER_WORDS;
+
+  const uint32_t* currentFrame = m_currentFrame.get();
+  const uint32_t* nextFrame = m_nextFrame.get();
+
+  const size_t frameWords = FrameWords();
+  const size_t fullBlocks = frameWords / BLOCK_WORDS;
+
+  uint32_t blockCount = 0;
+  for (size_t block = 0; block < fullBlocks; block++)
+  {
+    const size_t pos = block * BLOCK_WORDS;
+    if (BlockChanged(currentFrame + pos, nextFrame + pos))
+    {
+      out += EncodeBlock(currentFrame + pos, nextFrame + pos, BLOCK_WORDS, block, out);
+      blockCount++;
+    }
+  }
+
+  // Remaining words that don't fill a block
+  const size_t tailWords = frameWords % BLOCK_WORDS;
+  if (tailWords != 0)
+  {
+    const size_t pos = fullBlocks * BLOCK_WORDS;
+    const size_t written =
+        EncodeBlock(currentFrame + pos, nextFrame + pos, tailWords, fullBlocks, out);
+    if (written != 0)
+    {
+      out += written;
+      blockCount++;
+    }
+  }
+
+  *record = blockCount;
+
+  MemoryFrame frame;
+  frame.offset = offset;
+  frame.size = (out - record) * sizeof(uint32_t);
+  frame.frameHistoryCount = m_currentFrameHistory++;
+
+  m_rewindBuffer.emplace_back(frame);
+  m_writePos = offset + frame.size;
+  m_deltaBytes += frame.size;
+
+  // Delta is generated, bring the new frame forward (m_nextFrame is now disposable)
+  std::swap(m_currentFrame, m_nextFrame);
+
+  m_bHasNextFrame = false;
+
+  if (PastFramesAvailable() + 1 > MaxFrameCount())
+    CullPastFrames(1);
+}
+
+void CBlockDeltaMemoryStream::CullPastFrames(uint64_t frameCount)
+{
+  for (uint64_t removedCount = 0; removedCount < frameCount; removedCount++)
+  {
+    if (m_rewindBuffer.empty())
+    {
+      CLog::Log(LOGDEBUG,
+                "CBlockDeltaMemoryStream: Tried to cull %u frames too many. Check your math!",
+                static_cast<unsigned int>(frameCount - removedCount));
+      break;
+    }
+    m_deltaBytes -= m_rewindBuffer.front().size;
+    m_rewindBuffer.pop_front();
+  }
+
+  if (m_rewindBuffer.empty())
+    m_writePos = 0;
+}
+
+size_t CBlockDeltaMemoryStream::FrameWords() const
+{
+  return m_paddedFrameSize / sizeof(uint32_t);
+}
+
+size_t CBlockDeltaMemoryStream::MaxRecordSize() const
+{
+  const size_t blockCount = (FrameWords() + BLOCK_WORDS - 1) / BLOCK_WORDS;
+  return (RECORD_HEADER_WORDS + blockCount * (BLOCK_HEADER_WORDS + BLOCK_WORDS)) *
+         sizeof(uint32_t);
+}
+
+size_t CBlockDeltaMemoryStream::GetArenaSize(uint64_t maxFrameCount) const
+{
+  if (maxFrameCount == 0)
+    return 0;
+
+  const uint64_t historySize = maxFrameCount * m_paddedFrameSize / ARENA_RATIO;
+
+  // Always room for one worst case record while the previous one is kept
+  const size_t minSize = 2 * MaxRecordSize();
+
+  return std::max(minSize, static_cast<size_t>(std::min<uint64_t>(historySize, MAX_ARENA_SIZE)));
+}
+
+void CBlockDeltaMemoryStream::AllocateArena()
+{
+  m_maxArenaSize = GetArenaSize(m_maxFrames);
+  m_arenaSize = m_maxArenaSize > 0 ? std::min(m_maxArenaSize, std::max(2 * MaxRecordSize(),
+                                                                       INITIAL_ARENA_SIZE))
+                                   : 0;
+  m_arena.reset(m_arenaSize > 0 ? new uint8_t[m_arenaSize] : nullptr);
+  m_writePos = 0;
+  m_bHistoryLimited = false;
+
+  if (m_arenaSize > 0)
+    CLog::Log(LOGDEBUG,
+              "CBlockDeltaMemoryStream: Allocated %u KiB of up to %u KiB for %u frames of %u bytes",
+              static_cast<unsigned int>(m_arenaSize / 1024),
+              static_cast<unsigned int>(m_maxArenaSize / 1024),
+              static_cast<unsigned int>(m_maxFrames), static_cast<unsigned int>(m_paddedFrameSize));
+}
+
+bool CBlockDeltaMemoryStream::GrowArena()
+{
+  if (m_arenaSize >= m_maxArenaSize)
+    return false;
+
+  const size_t arenaSize = std::min(m_maxArenaSize, 2 * m_arenaSize);
+  std::unique_ptr<uint8_t[]> arena(new uint8_t[arenaSize]);
+
+  // Copy the records oldest first to the start of the new arena
+  size_t writePos = 0;
+  for (MemoryFrame& frame : m_rewindBuffer)
+  {
+    std::memcpy(arena.get() + writePos, m_arena.get() + frame.offset, frame.size);
+    frame.offset = writePos;
+    writePos += frame.size;
+  }
+
+  m_arena = std::move(arena);
+  m_arenaSize = arenaSize;
+  m_writePos = writePos;
+
+  CLog::Log(LOGDEBUG, "CBlockDeltaMemoryStream: Grew arena to %u KiB for %u frames",
+            static_cast<unsigned int>(m_arenaSize / 1024),
+            static_cast<unsigned int>(m_rewindBuffer.size()));
+
+  return true;
+}
+
+size_t CBlockDeltaMemoryStream::Reserve(size_t size)
+{
+  while (true)
+  {
+    // Records are contiguous. If the record doesn't fit before the end of the
+    // arena, the tail is skipped and the record is written at the start.
+    const bool bWrap = m_writePos + size > m_arenaSize;
+    const size_t offset = bWrap ? 0 : m_writePos;
+
+    if (m_rewindBuffer.empty())
+      return offset;
+
+    // Frames are stored oldest first, starting right after the write position,
+    // so drop frames from the front until the front no longer overlaps
+    const MemoryFrame& front = m_rewindBuffer.front();
+    bool bOverlaps = front.offset < offset + size && offset < front.offset + front.size;
+    if (bWrap)
+      bOverlaps |= front.offset >= m_writePos;
+
+    if (!bOverlaps)
+      return offset;
+
+    // Make room by growing the arena before giving up history
+    if (GrowArena())
+      continue;
+
+    if (!m_bHistoryLimited)
+    {
+      m_bHistoryLimited = true;
+      CLog::Log(LOGINFO,
+                "CBlockDeltaMemoryStream: Rewind history limited to %u of %u frames, deltas "
+                "average %u bytes for a state of %u bytes",
+                static_cast<unsigned int>(m_rewindBuffer.size()),
+                static_cast<unsigned int>(m_maxFrames),
+                static_cast<unsigned int>(m_deltaBytes / m_rewindBuffer.size()),
+                static_cast<unsigned int>(m_paddedFrameSize));
+    }
+
+    m_deltaBytes -= front.size;
+    m_rewindBuffer.pop_front();
+  }
+}
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "LinearMemoryStream.h"
+
+#include <deque>
+#include <memory>
+
+namespace KODI
+{
+namespace RETRO
+{
+/*!
+ * \brief Implementation of a linear memory stream using block-based XOR deltas
+ *
+ * The save state is split into blocks of 16 words. Changed blocks are found
+ * by comparing whole blocks with SIMD instructions, and only the non-zero XOR
+ * words of a changed block are stored, together with a bitmask of their
+ * positions. This keeps unchanged regions free and the rewind loop linear.
+ *
+ * Deltas are written into a ring arena instead of one heap allocation per
+ * frame. The arena starts small and is doubled when it runs out of room, up
+ * to 1/16 of the size of the uncompressed history. When it is full at that
+ * size the oldest frames are dropped, so fewer than MaxFrameCount() frames
+ * may be available if the game changes a lot of state per frame.
+ */
+class CBlockDeltaMemoryStream : public CLinearMemoryStream
+{
+public:
+  CBlockDeltaMemoryStream() = default;
+
+  ~CBlockDeltaMemoryStream() override = default;
+
+  // implementation of IMemoryStream via CLinearMemoryStream
+  void Init(size_t frameSize, uint64_t maxFrameCount) override;
+  void Reset() override;
+  void SetMaxFrameCount(uint64_t maxFrameCount) override;
+  uint64_t PastFramesAvailable() const override;
+  uint64_t RewindFrames(uint64_t frameCount) override;
+
+  /*!
+   * \brief Number of bytes used by the deltas of all past frames
+   */
+  size_t DeltaBytes() const { return m_deltaBytes; }
+
+  /*!
+   * \brief Current size of the ring arena in bytes
+   */
+  size_t ArenaSize() const { return m_arenaSize; }
+
+  /*!
+   * \brief Size in bytes the ring arena can grow to
+   */
+  size_t MaxArenaSize() const { return m_maxArenaSize; }
+
+  static constexpr size_t BLOCK_WORDS = 16;
+
+protected:
+  // implementation of CLinearMemoryStream
+  void SubmitFrameInternal() override;
+  void CullPastFrames(uint64_t frameCount) override;
+
+private:
+  struct MemoryFrame
+  {
+    size_t offset; // Position of the delta record in the arena
+    size_t size; // Size of the delta record in bytes
+    uint64_t frameHistoryCount;
+  };
+
+  size_t FrameWords() const;
+  size_t MaxRecordSize() const;
+  size_t GetArenaSize(uint64_t maxFrameCount) const;
+  void AllocateArena();
+
+  /*!
+   * \brief Double the size of the arena, keeping the history
+   *
+   * \return False if the arena is at its maximum size
+   */
+  bool GrowArena();
+
+  /*!
+   * \brief Get a location in the arena where a record of the given size can
+   *        be written, dropping the oldest frames to make room
+   */
+  size_t Reserve(size_t size);
+
+  std::unique_ptr<uint8_t[]> m_arena;
+  size_t m_arenaSize = 0;
+  size_t m_maxArenaSize = 0;
+  bool m_bHistoryLimited = false; // Frames were dropped because the arena is full
+  size_t m_writePos = 0;
+  size_t m_deltaBytes = 0;
+
+  std::deque<MemoryFrame> m_rewindBuffer;
+};
+} // namespace RETRO
+} // namespace KODI
@@ -0,0 +1,275 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/RetroPlayer/streams/memory/BlockDeltaMemoryStream.h"
+#include "cores/RetroPlayer/streams/memory/DeltaPairMemoryStream.h"
+#include "utils/Stopwatch.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace KODI;
+using namespace RETRO;
+
+namespace
+{
+/*!
+ * \brief Simulates a game that changes a few scattered regions of its state
+ *        every frame
+ */
+class CFakeGameState
+{
+public:
+  explicit CFakeGameState(size_t size) : m_state(size)
+  {
+    for (size_t i = 0; i < size; i++)
+      m_state[i] = static_cast<uint8_t>(Random());
+  }
+
+  void RunFrame(size_t changedBytes)
+  {
+    for (size_t i = 0; i < changedBytes; i++)
+      m_state[Random() % m_state.size()] = static_cast<uint8_t>(Random());
+  }
+
+  const std::vector<uint8_t>& State() const { return m_state; }
+
+private:
+  uint32_t Random()
+  {
+    m_seed = m_seed * 1103515245 + 12345;
+    return m_seed >> 8;
+  }
+
+  std::vector<uint8_t> m_state;
+  uint32_t m_seed = 12345;
+};
+
+void SubmitState(IMemoryStream& stream, const std::vector<uint8_t>& state)
+{
+  uint8_t* frame = stream.BeginFrame();
+  ASSERT_NE(nullptr, frame);
+  std::memcpy(frame, state.data(), state.size());
+  stream.SubmitFrame();
+}
+
+void TestRewind(IMemoryStream& stream, size_t frameSize)
+{
+  const uint64_t frameCount = 32;
+  stream.Init(frameSize, frameCount);
+
+  CFakeGameState game(frameSize);
+  std::vector<std::vector<uint8_t>> history;
+
+  for (unsigned int i = 0; i < 48; i++)
+  {
+    game.RunFrame(i % 8 == 0 ? 0 : 64);
+    history.push_back(game.State());
+    SubmitState(stream, game.State());
+  }
+
+  ASSERT_EQ(frameCount - 1, stream.PastFramesAvailable());
+  ASSERT_EQ(0, std::memcmp(stream.CurrentFrame(), history.back().data(), frameSize));
+
+  // Rewind one frame at a time and compare with the recorded states
+  for (uint64_t i = 1; i < frameCount; i++)
+  {
+    ASSERT_EQ(1u, stream.RewindFrames(1));
+    const std::vector<uint8_t>& expected = history[history.size() - 1 - i];
+    ASSERT_EQ(0, std::memcmp(stream.CurrentFrame(), expected.data(), frameSize)) << "frame " << i;
+  }
+
+  EXPECT_EQ(0u, stream.PastFramesAvailable());
+  EXPECT_EQ(0u, stream.RewindFrames(1));
+
+  // Play on from the rewound state
+  game.RunFrame(64);
+  SubmitState(stream, game.State());
+  EXPECT_EQ(1u, stream.PastFramesAvailable());
+  EXPECT_EQ(0, std::memcmp(stream.CurrentFrame(), game.State().data(), frameSize));
+}
+
+size_t ChangedWords(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b)
+{
+  size_t changed = 0;
+  for (size_t i = 0; i < a.size(); i += sizeof(uint32_t))
+  {
+    const size_t length = std::min(sizeof(uint32_t), a.size() - i);
+    if (std::memcmp(a.data() + i, b.data() + i, length) != 0)
+      changed++;
+  }
+  return changed;
+}
+
+/*!
+ * \param storedBytes Returns the number of bytes held by the stream, if known
+ */
+void Benchmark(IMemoryStream& stream,
+               const char* name,
+               size_t frameSize,
+               size_t changedBytes,
+               const std::function<size_t()>& storedBytes = nullptr)
+{
+  const uint64_t frameCount = 600;
+  stream.Init(frameSize, frameCount);
+
+  CFakeGameState game(frameSize);
+
+  CStopWatch timer;
+  double submitMs = 0.0;
+  size_t changedWords = 0;
+  for (uint64_t i = 0; i < frameCount; i++)
+  {
+    std::vector<uint8_t> previous = game.State();
+    game.RunFrame(changedBytes);
+    changedWords += ChangedWords(previous, game.State());
+
+    timer.StartZero();
+    SubmitState(stream, game.State());
+    submitMs += timer.GetElapsedMilliseconds();
+  }
+
+  const uint64_t pastFrames = stream.PastFramesAvailable();
+  const size_t bytes = storedBytes ? storedBytes() : 0;
+
+  timer.StartZero();
+  const uint64_t rewound = stream.RewindFrames(pastFrames);
+  const double rewindMs = timer.GetElapsedMilliseconds();
+
+  printf("%s: %u KiB state, %.1f words changed/frame, %u frames kept, ", name,
+         static_cast<unsigned int>(frameSize / 1024),
+         static_cast<double>(changedWords) / frameCount, static_cast<unsigned int>(pastFrames));
+  if (bytes > 0 && pastFrames > 0)
+    printf("%.1f bytes/frame, ", static_cast<double>(bytes) / pastFrames);
+  printf("submit %.3f ms/frame, rewind %.3f ms/frame\n", submitMs / frameCount,
+         rewound > 0 ? rewindMs / rewound : 0.0);
+}
+} // namespace
+
+TEST(TestMemoryStream, DeltaPairRewind)
+{
+  CDeltaPairMemoryStream stream;
+  TestRewind(stream, 64 * 1024);
+}
+
+TEST(TestMemoryStream, BlockDeltaRewind)
+{
+  CBlockDeltaMemoryStream stream;
+  TestRewind(stream, 64 * 1024);
+}
+
+TEST(TestMemoryStream, BlockDeltaUnalignedSize)
+{
+  // Size isn't a multiple of the block size
+  CBlockDeltaMemoryStream stream;
+  TestRewind(stream, 64 * 1024 + 27);
+}
+
+TEST(TestMemoryStream, BlockDeltaArenaWrap)
+{
+  // Change the whole state every frame so the arena runs out of room
+  const size_t frameSize = 4096;
+  CBlockDeltaMemoryStream stream;
+  stream.Init(frameSize, 10000);
+
+  CFakeGameState game(frameSize);
+  std::vector<std::vector<uint8_t>> history;
+  for (unsigned int i = 0; i < 1000; i++)
+  {
+    game.RunFrame(frameSize);
+    history.push_back(game.State());
+    SubmitState(stream, game.State());
+    ASSERT_LE(stream.DeltaBytes(), stream.ArenaSize());
+  }
+
+  const uint64_t pastFrames = stream.PastFramesAvailable();
+  ASSERT_GT(pastFrames, 0u);
+  ASSERT_LT(pastFrames, 999u);
+
+  ASSERT_EQ(pastFrames, stream.RewindFrames(pastFrames));
+  const std::vector<uint8_t>& expected = history[history.size() - 1 - pastFrames];
+  EXPECT_EQ(0, std::memcmp(stream.CurrentFrame(), expected.data(), frameSize));
+}
+
+TEST(TestMemoryStream, BlockDeltaArenaGrowth)
+{
+  // The arena only grows as far as the history needs
+  const size_t frameSize = 4096;
+  CBlockDeltaMemoryStream stream;
+  stream.Init(frameSize, 10000);
+  const size_t initialSize = stream.ArenaSize();
+  ASSERT_LT(initialSize, stream.MaxArenaSize());
+
+  CFakeGameState game(frameSize);
+  for (unsigned int i = 0; i < 1000; i++)
+    SubmitState(stream, game.State());
+  EXPECT_EQ(initialSize, stream.ArenaSize());
+  EXPECT_EQ(999u, stream.PastFramesAvailable());
+
+  std::vector<std::vector<uint8_t>> history;
+  for (unsigned int i = 0; i < 1000; i++)
+  {
+    game.RunFrame(frameSize);
+    history.push_back(game.State());
+    SubmitState(stream, game.State());
+  }
+  EXPECT_EQ(stream.MaxArenaSize(), stream.ArenaSize());
+
+  // The history survives the moves to a larger arena
+  const uint64_t pastFrames = stream.PastFramesAvailable();
+  ASSERT_GT(pastFrames, 0u);
+  ASSERT_EQ(pastFrames, stream.RewindFrames(pastFrames));
+  const std::vector<uint8_t>& expected = history[history.size() - 1 - pastFrames];
+  EXPECT_EQ(0, std::memcmp(stream.CurrentFrame(), expected.data(), frameSize));
+}
+
+TEST(TestMemoryStream, BlockDeltaSize)
+{
+  const size_t frameSize = 256 * 1024;
+  CBlockDeltaMemoryStream stream;
+  stream.Init(frameSize, 16);
+
+  CFakeGameState game(frameSize);
+  SubmitState(stream, game.State());
+
+  // An unchanged frame only stores the record header
+  SubmitState(stream, game.State());
+  EXPECT_EQ(sizeof(uint32_t), stream.DeltaBytes());
+
+  // A single changed byte stores one block header and one word
+  game.RunFrame(1);
+  SubmitState(stream, game.State());
+  EXPECT_LE(stream.DeltaBytes(), 6 * sizeof(uint32_t));
+}
+
+TEST(TestMemoryStream, DISABLED_RewindBenchmark)
+{
+  // Roughly the savestate sizes of PS1 and N64 cores
+  const size_t sizes[] = {2 * 1024 * 1024, 16 * 1024 * 1024};
+
+  for (size_t frameSize : sizes)
+  {
+    for (size_t changedBytes : {256, 16384})
+    {
+      {
+        CDeltaPairMemoryStream stream;
+        Benchmark(stream, "DeltaPair", frameSize, changedBytes);
+      }
+      {
+        CBlockDeltaMemoryStream stream;
+        Benchmark(stream, "BlockDelta", frameSize, changedBytes,
+                  [&stream]() { return stream.DeltaBytes(); });
+      }
+    }
+  }
+}
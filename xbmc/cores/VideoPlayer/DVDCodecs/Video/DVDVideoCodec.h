@@ -83,6 +83,7 @@ private:
 #define DVP_FLAG_INTERLACED         0x00000008  //< Set to indicate that this frame is interlaced
 #define DVP_FLAG_DROPPED            0x00000010  //< indicate that this picture has been dropped in decoder stage, will have no data
 
+#define DVD_CODEC_CTRL_KEYFRAMES    0x00800000  //< decode key frames only, e.g. for thumbnails
 #define DVD_CODEC_CTRL_SKIPDEINT    0x01000000  //< request to skip a deinterlacing cycle, if possible
 #define DVD_CODEC_CTRL_NO_POSTPROC  0x02000000  //< see GetCodecStats
 #define DVD_CODEC_CTRL_HURRY        0x04000000  //< see GetCodecStats
@@ -226,6 +227,10 @@ public:
    *                  this packet is going to be dropped. decoder is free to use it
    *                  for decoding
    *
+   * DVD_CODEC_CTRL_KEYFRAMES :
+   *                  only key frames are wanted, the decoder may skip all
+   *                  other frames
+   *
    */
   virtual void SetCodecControl(int flags) {}
 
@@ -879,8 +879,8 @@ bool CDVDVideoCodecAndroidMediaCodec::AddData(const DemuxPacket &packet)
           return true;
         }
 
+        // the converted packet is copied straight into the input buffer below
         iSize = m_bitstream->GetConvertSize();
-        pData = m_bitstream->GetConvertBuffer();
       }
 
       if (m_state == MEDIACODEC_STATE_FLUSHED)
@@ -943,7 +943,10 @@ bool CDVDVideoCodecAndroidMediaCodec::AddData(const DemuxPacket &packet)
           }
 
           default:
-            memcpy(dst_ptr, pData, iSize);
+            if (m_bitstream)
+              m_bitstream->CopyConvertBuffer(dst_ptr, iSize);
+            else
+              memcpy(dst_ptr, pData, iSize);
             break;
         }
       }
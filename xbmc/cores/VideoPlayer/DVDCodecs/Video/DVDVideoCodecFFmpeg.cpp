@@ -23,6 +23,7 @@
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "system.h"
@@ -314,6 +315,7 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg(CProcessInfo &processInfo)
 
 CDVDVideoCodecFFmpeg::~CDVDVideoCodecFFmpeg()
 {
+  ClearThreadingPackets();
   Dispose();
 }
 
@@ -366,19 +368,32 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     if (m_decoderState == STATE_NONE)
     {
       m_decoderState = STATE_HW_SINGLE;
+      m_threading.Init((pCodec->capabilities & AV_CODEC_CAP_FRAME_THREADS) != 0,
+                       (pCodec->capabilities & AV_CODEC_CAP_SLICE_THREADS) != 0,
+                       hints.width, hints.height, m_processInfo.IsRealtimeStream(),
+                       CServiceBroker::GetCPUInfo()->GetCPUCount());
+      m_processInfo.SetVideoDecoderThreading("");
     }
     else
     {
-      int num_threads = CServiceBroker::GetCPUInfo()->GetCPUCount() * 3 / 2;
-      num_threads = std::max(1, std::min(num_threads, 16));
-      m_pCodecContext->thread_count = num_threads;
+      if (m_threading.GetType() == VideoCodecThreadingType::FRAME)
+        m_pCodecContext->thread_type = FF_THREAD_FRAME;
+      else if (m_threading.GetType() == VideoCodecThreadingType::SLICE)
+        m_pCodecContext->thread_type = FF_THREAD_SLICE;
+      m_pCodecContext->thread_count = m_threading.GetCount();
       m_pCodecContext->thread_safe_callbacks = 1;
       m_decoderState = STATE_SW_MULTI;
-      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open frame threaded with %d threads", num_threads);
+      m_threadingOpened = m_threading.GetDescription();
+      m_processInfo.SetVideoDecoderThreading(m_threadingOpened);
+      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open with threading %s (%s)",
+                m_threading.GetDescription().c_str(), m_threading.GetReason().c_str());
     }
   }
   else
+  {
     m_decoderState = STATE_SW_SINGLE;
+    m_processInfo.SetVideoDecoderThreading("none");
+  }
 
   // if we don't do this, then some codecs seem to fail.
   m_pCodecContext->coded_height = hints.height;
@@ -555,6 +570,23 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
     Reset();
   }
 
+  // the decoder with the new threading is fed the packets from the keyframe
+  // on first, the packet is sent again afterwards
+  if (!m_threadingPackets.empty() && !m_threadingChanged)
+  {
+    ThreadingPacket& prime = m_threadingPackets.front();
+    m_pCodecContext->reordered_opaque = prime.opaque;
+    if (avcodec_send_packet(m_pCodecContext, prime.pkt) == AVERROR(EAGAIN))
+      return false;
+    av_packet_free(&prime.pkt);
+    m_threadingPackets.pop_front();
+    return false;
+  }
+
+  // the old decoder is being drained, the packet goes to the new one
+  if (m_threadingDrain)
+    return false;
+
   if (packet.recoveryPoint)
     m_started = true;
 
@@ -591,6 +623,23 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
     }
   }
 
+  // keep the packets until the change of threading finds a keyframe
+  if (m_threadingChanged && !ret)
+  {
+    AVPacket* copy = av_packet_alloc();
+    if (copy && av_packet_ref(copy, &avpkt) == 0)
+    {
+      m_threadingPackets.push_back({copy, m_pCodecContext->reordered_opaque});
+      if (m_threadingPackets.size() > MAX_THREADING_PACKETS)
+      {
+        av_packet_free(&m_threadingPackets.front().pkt);
+        m_threadingPackets.pop_front();
+      }
+    }
+    else
+      av_packet_free(&copy);
+  }
+
   m_iLastKeyframe++;
   // put a limit on convergence count to avoid huge mem usage on streams without keyframes
   if (m_iLastKeyframe > 300)
@@ -647,7 +696,7 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   }
 
   // process ffmpeg
-  if (m_codecControlFlags & DVD_CODEC_CTRL_DRAIN)
+  if ((m_codecControlFlags & DVD_CODEC_CTRL_DRAIN) || m_threadingDrain)
   {
     AVPacket avpkt;
     av_init_packet(&avpkt);
@@ -699,6 +748,10 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
         else
           return VC_PICTURE;
       }
+      else if (m_threadingDrain)
+      {
+        return ApplyThreading();
+      }
       else
       {
         m_eof = true;
@@ -706,6 +759,10 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
         return VC_EOF;
       }
     }
+    else if (m_threadingDrain)
+    {
+      return ApplyThreading();
+    }
     else
     {
       m_eof = true;
@@ -726,6 +783,21 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   // here we got a frame
   int64_t framePTS = m_pDecodedFrame->best_effort_timestamp;
 
+  // the old decoder output these frames before the threading was changed
+  if (m_threadingSkipPts != AV_NOPTS_VALUE)
+  {
+    if (framePTS != AV_NOPTS_VALUE && framePTS <= m_threadingSkipPts)
+    {
+      av_frame_unref(m_pDecodedFrame);
+      return VC_BUFFER;
+    }
+    m_threadingSkipPts = AV_NOPTS_VALUE;
+  }
+  if (framePTS != AV_NOPTS_VALUE &&
+      (m_lastFramePts == AV_NOPTS_VALUE || framePTS > m_lastFramePts))
+    m_lastFramePts = framePTS;
+
+  bool dropped = false;
   if (m_pCodecContext->skip_frame > AVDISCARD_DEFAULT)
   {
     if (m_dropCtrl.m_state == CDropControl::VALID &&
@@ -733,6 +805,7 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
         framePTS != AV_NOPTS_VALUE &&
         framePTS > (m_dropCtrl.m_lastPTS + m_dropCtrl.m_diffPTS * 1.5))
     {
+      dropped = true;
       m_droppedFrames++;
       if (m_interlaced)
         m_droppedFrames++;
@@ -744,6 +817,46 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   {
     m_started = true;
     m_iLastKeyframe = m_pCodecContext->has_b_frames + 2;
+    // a frame threaded decoder returns the keyframe thread_count packets late
+    if (m_pCodecContext->active_thread_type == FF_THREAD_FRAME)
+      m_iLastKeyframe += m_pCodecContext->thread_count;
+
+    // a pending change of threading is applied at the keyframe: the old
+    // decoder is drained and the new one starts again from its packet
+    if (m_threadingChanged && !m_threadingDrain)
+    {
+      auto it = std::find_if(m_threadingPackets.begin(), m_threadingPackets.end(),
+                             [this](const ThreadingPacket& p) {
+                               return p.pkt->pts != AV_NOPTS_VALUE &&
+                                      p.pkt->pts == m_pDecodedFrame->pts;
+                             });
+      if (it != m_threadingPackets.end())
+      {
+        for (auto old = m_threadingPackets.begin(); old != it; ++old)
+          av_packet_free(&old->pkt);
+        m_threadingPackets.erase(m_threadingPackets.begin(), it);
+        m_threadingDrain = true;
+      }
+    }
+  }
+
+  // the statistics keep being fed back while a change waits for a keyframe,
+  // the latest decision is the one applied
+  bool priming = !m_threadingChanged && !m_threadingPackets.empty();
+  if (m_decoderState == STATE_SW_MULTI && !m_threadingDrain && !priming)
+  {
+    int queued, discard, free;
+    m_processInfo.GetRenderBuffers(queued, discard, free);
+    bool hurry = (m_codecControlFlags & (DVD_CODEC_CTRL_HURRY | DVD_CODEC_CTRL_DROP)) != 0;
+
+    if (m_threading.Process(dropped, hurry, queued))
+    {
+      CLog::Log(LOGINFO, "CDVDVideoCodecFFmpeg - changing threading to %s (%s)",
+                m_threading.GetDescription().c_str(), m_threading.GetReason().c_str());
+      m_threadingChanged = m_threading.GetDescription() != m_threadingOpened;
+      if (!m_threadingChanged)
+        ClearThreadingPackets();
+    }
   }
   if (m_pDecodedFrame->interlaced_frame)
     m_interlaced = true;
@@ -875,6 +988,21 @@ bool CDVDVideoCodecFFmpeg::SetPictureParams(VideoPicture* pVideoPicture)
 
 void CDVDVideoCodecFFmpeg::Reset()
 {
+  ClearThreadingPackets();
+  m_threadingDrain = false;
+  m_threadingSkipPts = AV_NOPTS_VALUE;
+  m_lastFramePts = AV_NOPTS_VALUE;
+
+  // a change of threading that hasn't found a keyframe yet costs nothing
+  // when the decoder is flushed anyway
+  if (m_threadingChanged && m_decoderState == STATE_SW_MULTI)
+  {
+    m_threadingChanged = false;
+    Reopen();
+    if (!m_pCodecContext)
+      return;
+  }
+
   m_started = false;
   m_startedInput = false;
   m_interlaced = false;
@@ -894,6 +1022,33 @@ void CDVDVideoCodecFFmpeg::Reset()
   m_dropCtrl.Reset(false);
 }
 
+CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::ApplyThreading()
+{
+  // the old decoder is drained, everything it output is skipped when the new
+  // one decodes the kept packets again
+  m_threadingDrain = false;
+  m_threadingChanged = false;
+  m_threadingSkipPts = m_lastFramePts;
+
+  Reopen();
+  if (!m_pCodecContext)
+  {
+    ClearThreadingPackets();
+    return VC_ERROR;
+  }
+
+  // the filters were closed with the old decoder
+  m_filters = "";
+  return VC_BUFFER;
+}
+
+void CDVDVideoCodecFFmpeg::ClearThreadingPackets()
+{
+  for (auto& packet : m_threadingPackets)
+    av_packet_free(&packet.pkt);
+  m_threadingPackets.clear();
+}
+
 void CDVDVideoCodecFFmpeg::Reopen()
 {
   Dispose();
@@ -1277,7 +1432,13 @@ void CDVDVideoCodecFFmpeg::SetCodecControl(int flags)
     else
       m_requestSkipDeint = false;
 
-    if (bDrop)
+    if (flags & DVD_CODEC_CTRL_KEYFRAMES)
+    {
+      m_pCodecContext->skip_frame = AVDISCARD_NONKEY;
+      m_pCodecContext->skip_idct = AVDISCARD_DEFAULT;
+      m_pCodecContext->skip_loop_filter = AVDISCARD_DEFAULT;
+    }
+    else if (bDrop)
     {
       m_pCodecContext->skip_frame = AVDISCARD_NONREF;
       m_pCodecContext->skip_idct = AVDISCARD_NONREF;
@@ -12,6 +12,8 @@
 #include "cores/VideoPlayer/DVDStreamInfo.h"
 #include "DVDVideoCodec.h"
 #include "DVDVideoPPFFmpeg.h"
+#include "VideoCodecThreading.h"
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -57,6 +59,8 @@ protected:
   bool SetPictureParams(VideoPicture* pVideoPicture);
 
   bool HasHardware() { return m_pHardware != nullptr; };
+  VCReturn ApplyThreading();
+  void ClearThreadingPackets();
   void SetHardware(IHardwareDecoder *hardware);
 
   AVFrame* m_pFrame = nullptr;;
@@ -99,6 +103,23 @@ protected:
   CDVDStreamInfo m_hints;
   CDVDCodecOptions m_options;
 
+  CVideoCodecThreading m_threading;
+  std::string m_threadingOpened;
+  bool m_threadingChanged = false;
+  bool m_threadingDrain = false;
+  int64_t m_threadingSkipPts = AV_NOPTS_VALUE;
+  int64_t m_lastFramePts = AV_NOPTS_VALUE;
+
+  // packets sent while a change of threading waits for a keyframe, after the
+  // change the new decoder is primed with the ones from the keyframe on
+  struct ThreadingPacket
+  {
+    AVPacket* pkt;
+    int64_t opaque;
+  };
+  std::deque<ThreadingPacket> m_threadingPackets;
+  static const size_t MAX_THREADING_PACKETS = 64;
+
   struct CDropControl
   {
     CDropControl();
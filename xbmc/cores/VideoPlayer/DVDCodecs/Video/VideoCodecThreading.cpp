@@ -0,0 +1,158 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoCodecThreading.h"
+
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <stdint.h>
+
+const int CVideoCodecThreading::WINDOW_FRAMES;
+const int CVideoCodecThreading::MAX_THREADS;
+
+namespace
+{
+// ratio of late frames in a window that asks for more threads
+const float LATE_RATIO = 0.02f;
+// average number of frames in the render queue the decoder is considered ahead with
+const float QUEUE_AHEAD = 2.0f;
+// windows the decoder has to be ahead before threads are given back
+const int CALM_WINDOWS = 6;
+// windows skipped after a change, so the new setting can settle
+const int COOLDOWN_WINDOWS = 2;
+// frame threads for live streams, each thread adds one frame of latency
+const int REALTIME_FRAME_THREADS = 4;
+} // namespace
+
+void CVideoCodecThreading::Init(bool frameThreads, bool sliceThreads, int width, int height, bool realtime, int cpuCount)
+{
+  cpuCount = std::max(1, cpuCount);
+
+  m_frameThreads = frameThreads;
+  m_realtime = realtime;
+  m_maxCount = std::max(1, std::min(cpuCount * 3 / 2, MAX_THREADS));
+
+  // SD and HD don't profit from more threads than there are CPUs, UHD may
+  // still gain from oversubscription while threads wait on references
+  const int64_t pixels = static_cast<int64_t>(width) * height;
+  int count;
+  if (pixels <= 0)
+    count = cpuCount;
+  else if (pixels <= 1024 * 576)
+    count = std::min(cpuCount, 4);
+  else if (pixels <= 2048 * 1152)
+    count = std::min(cpuCount, 8);
+  else
+    count = m_maxCount;
+
+  if (realtime && sliceThreads)
+    m_type = VideoCodecThreadingType::SLICE;
+  else if (frameThreads)
+  {
+    m_type = VideoCodecThreadingType::FRAME;
+    if (realtime)
+      count = std::min(count, REALTIME_FRAME_THREADS);
+  }
+  else if (sliceThreads)
+    m_type = VideoCodecThreadingType::SLICE;
+  else
+    m_type = VideoCodecThreadingType::NONE;
+
+  m_count = std::min(count, m_maxCount);
+  if (m_count <= 1)
+  {
+    m_type = VideoCodecThreadingType::NONE;
+    m_count = 1;
+  }
+  m_initialCount = m_count;
+  m_reason = realtime ? "live stream" : "resolution";
+
+  m_frames = 0;
+  m_late = 0;
+  m_queuedSum = 0;
+  m_cooldown = 0;
+  m_calm = 0;
+}
+
+bool CVideoCodecThreading::Process(bool dropped, bool hurry, int renderQueued)
+{
+  m_frames++;
+  if (dropped || hurry)
+    m_late++;
+  m_queuedSum += renderQueued;
+
+  if (m_frames < WINDOW_FRAMES)
+    return false;
+
+  const int late = m_late;
+  const float lateRatio = static_cast<float>(m_late) / m_frames;
+  const float queued = static_cast<float>(m_queuedSum) / m_frames;
+  m_frames = 0;
+  m_late = 0;
+  m_queuedSum = 0;
+
+  if (m_type == VideoCodecThreadingType::NONE)
+    return false;
+
+  if (m_cooldown > 0)
+  {
+    m_cooldown--;
+    return false;
+  }
+
+  if (lateRatio > LATE_RATIO && queued < QUEUE_AHEAD)
+  {
+    m_calm = 0;
+
+    // slices may not be available in the stream, frames always are
+    if (m_type == VideoCodecThreadingType::SLICE && m_frameThreads)
+    {
+      m_type = VideoCodecThreadingType::FRAME;
+      if (m_realtime)
+        m_count = std::min(m_count, REALTIME_FRAME_THREADS);
+    }
+    else if (m_count < m_maxCount)
+      m_count = std::min(m_maxCount, m_count + std::max(1, m_count / 2));
+    else
+      return false;
+
+    m_reason = StringUtils::Format("%.0f%% late frames", lateRatio * 100);
+    m_cooldown = COOLDOWN_WINDOWS;
+    return true;
+  }
+
+  if (late == 0 && queued >= QUEUE_AHEAD && m_count > m_initialCount)
+  {
+    if (++m_calm >= CALM_WINDOWS)
+    {
+      m_count = std::max(m_initialCount, m_count * 2 / 3);
+      m_reason = "decoder ahead of renderer";
+      m_calm = 0;
+      m_cooldown = COOLDOWN_WINDOWS;
+      return true;
+    }
+  }
+  else
+    m_calm = 0;
+
+  return false;
+}
+
+std::string CVideoCodecThreading::GetDescription() const
+{
+  switch (m_type)
+  {
+    case VideoCodecThreadingType::FRAME:
+      return StringUtils::Format("frame x%d", m_count);
+    case VideoCodecThreadingType::SLICE:
+      return StringUtils::Format("slice x%d", m_count);
+    default:
+      return "none";
+  }
+}
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+
+enum class VideoCodecThreadingType
+{
+  NONE,
+  SLICE,
+  FRAME
+};
+
+/*!
+ * \brief Chooses the threading of a software video decoder
+ *
+ * Frame threading scales best but delays the output by one frame per thread
+ * and needs a decoded frame per thread, so the thread count is chosen by
+ * resolution instead of by the number of CPUs alone. During playback the
+ * statistics of the decoder are fed back, and more threads are requested if
+ * the decoder does not keep up. Once the decoder has been comfortably ahead
+ * of the renderer for a while, the extra threads are given back.
+ *
+ * FFmpeg can't change the threading of an open decoder, so the decoder applies
+ * a change at the next keyframe by draining the old decoder and feeding the
+ * packets from the keyframe on to a new one, or when it is flushed first.
+ */
+class CVideoCodecThreading
+{
+public:
+  /*!
+   * \brief Choose the initial threading
+   *
+   * \param frameThreads The decoder supports frame threading
+   * \param sliceThreads The decoder supports slice threading
+   * \param width Coded width of the video, 0 if unknown
+   * \param height Coded height of the video, 0 if unknown
+   * \param realtime The stream is live, latency matters more than throughput
+   * \param cpuCount Number of CPUs
+   */
+  void Init(bool frameThreads, bool sliceThreads, int width, int height, bool realtime, int cpuCount);
+
+  /*!
+   * \brief Feed back the state of one decoded frame
+   *
+   * \param dropped The decoder skipped or dropped frames before this one
+   * \param hurry The player asked the decoder to hurry or drop
+   * \param renderQueued Number of frames waiting in the render queue
+   *
+   * \return True if the threading changed and the decoder should be reopened
+   *         at the next keyframe
+   */
+  bool Process(bool dropped, bool hurry, int renderQueued);
+
+  VideoCodecThreadingType GetType() const { return m_type; }
+  int GetCount() const { return m_count; }
+
+  /*!
+   * \brief Description for the codec info, e.g. "frame x8"
+   */
+  std::string GetDescription() const;
+
+  /*!
+   * \brief Reason for the last change, for logging
+   */
+  const std::string& GetReason() const { return m_reason; }
+
+  static const int WINDOW_FRAMES = 250;
+  static const int MAX_THREADS = 16;
+
+private:
+  VideoCodecThreadingType m_type = VideoCodecThreadingType::NONE;
+  int m_count = 1;
+  int m_initialCount = 1;
+  int m_maxCount = 1;
+  bool m_frameThreads = false;
+  bool m_realtime = false;
+  std::string m_reason;
+
+  // statistics of the current window
+  int m_frames = 0;
+  int m_late = 0;
+  int m_queuedSum = 0;
+
+  int m_cooldown = 0; // windows to skip after a change
+  int m_calm = 0; // windows in a row without late frames and a full render queue
+};
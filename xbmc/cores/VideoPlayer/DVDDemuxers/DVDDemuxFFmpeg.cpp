@@ -11,6 +11,7 @@
 #include "DVDDemuxUtils.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DVDInputStreams/DVDInputStreamFFmpeg.h"
+#include "DVDInputStreams/DVDInputStreamFile.h"
 #include "ServiceBroker.h"
 #include "URL.h"
 #include "commons/Exception.h"
@@ -30,6 +31,7 @@
 #include "utils/log.h"
 #include "Util.h"
 
+#include <cinttypes>
 #include <sstream>
 #include <utility>
 
@@ -210,6 +212,8 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool fileinf
   m_speed = DVD_PLAYSPEED_NORMAL;
   m_program = UINT_MAX;
   m_seekToKeyFrame = false;
+  m_probeCached = false;
+  m_keyframeStream = -1;
 
   const AVIOInterruptCB int_cb = { interrupt_cb, this };
 
@@ -509,17 +513,51 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool fileinf
   m_bAVI = strcmp(m_pFormatContext->iformat->name, "avi") == 0;
   m_bSup = strcmp(m_pFormatContext->iformat->name, "sup") == 0;
 
+  // mpeg transport and program streams have no index, seeking by time
+  // bisects the file. remember where the keyframes are instead.
+  if (m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) && !m_pInput->IsRealtime() &&
+      (strcmp(m_pFormatContext->iformat->name, "mpegts") == 0 ||
+       strcmp(m_pFormatContext->iformat->name, "mpeg") == 0))
+  {
+    m_keyframeIndex.reset(new CKeyframeIndex(strFile));
+    m_keyframeIndex->Load();
+  }
+
   if (m_streaminfo)
   {
     /* to speed up dvd switches, only analyse very short */
     if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
       av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
 
-    CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
+    // restore the result of a previous probe of the same file, so that
+    // probing only needs to read the first few packets
+    std::string probeKey;
+    std::shared_ptr<CDVDInputStreamFile> inputFile =
+        std::dynamic_pointer_cast<CDVDInputStreamFile>(m_pInput);
+    if (inputFile && !m_pInput->IsRealtime() && !m_checkTransportStream)
+    {
+      struct __stat64 st;
+      if (inputFile->Stat(&st) == 0 && st.st_size > 0)
+        probeKey = CDemuxProbeCache::GetKey(strFile, st.st_size, st.st_mtime);
+    }
+    const bool useProbeCache = !probeKey.empty();
+    m_probeCached = useProbeCache && CDemuxProbeCache::GetInstance().Apply(probeKey, m_pFormatContext);
+    if (m_probeCached)
+    {
+      av_opt_set_int(m_pFormatContext, "probesize", 64 * 1024, 0);
+      av_opt_set_int(m_pFormatContext, "analyzeduration", 100000, 0);
+      m_pFormatContext->fps_probe_size = 0;
+    }
+
+    CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting%s", __FUNCTION__,
+              m_probeCached ? " (cached)" : "");
+    const unsigned int probeStart = XbmcThreads::SystemClockMillis();
     int iErr = avformat_find_stream_info(m_pFormatContext, NULL);
     if (iErr < 0)
     {
       CLog::Log(LOGWARNING,"could not find codec parameters for %s", CURL::GetRedacted(strFile).c_str());
+      if (m_probeCached)
+        CDemuxProbeCache::GetInstance().Remove(probeKey);
       if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD) ||
           m_pInput->IsStreamType(DVDSTREAM_TYPE_BLURAY) ||
           (m_pFormatContext->nb_streams == 1 &&
@@ -534,7 +572,10 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool fileinf
         return false;
       }
     }
-    CLog::Log(LOGDEBUG, "%s - av_find_stream_info finished", __FUNCTION__);
+    else if (useProbeCache && !m_probeCached)
+      CDemuxProbeCache::GetInstance().Store(probeKey, m_pFormatContext);
+    CLog::Log(LOGDEBUG, "%s - av_find_stream_info finished in %u ms", __FUNCTION__,
+              XbmcThreads::SystemClockMillis() - probeStart);
 
     // print some extra information
     av_dump_format(m_pFormatContext, 0, CURL::GetRedacted(strFile).c_str(), 0);
@@ -644,6 +685,12 @@ void CDVDDemuxFFmpeg::Dispose()
   m_pkt.result = -1;
   av_packet_unref(&m_pkt.pkt);
 
+  if (m_keyframeIndex)
+  {
+    m_keyframeIndex->Save();
+    m_keyframeIndex.reset();
+  }
+
   if (m_pFormatContext)
   {
     if (m_ioContext && m_pFormatContext->pb && m_pFormatContext->pb != m_ioContext)
@@ -1081,6 +1128,17 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
 
         CDVDDemuxUtils::StoreSideData(pPacket, &m_pkt.pkt);
 
+        if (m_keyframeIndex && (m_pkt.pkt.flags & AV_PKT_FLAG_KEY) && m_pkt.pkt.pos >= 0 &&
+            stream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO)
+        {
+          if (m_keyframeStream < 0)
+            m_keyframeStream = m_pkt.pkt.stream_index;
+
+          const int64_t pts = m_pkt.pkt.pts != AV_NOPTS_VALUE ? m_pkt.pkt.pts : m_pkt.pkt.dts;
+          if (m_keyframeStream == m_pkt.pkt.stream_index && pts != AV_NOPTS_VALUE)
+            m_keyframeIndex->Add(GetKeyframeTime(stream, pts), m_pkt.pkt.pos);
+        }
+
         CDVDInputStream::IDisplayTime* inputStream = m_pInput->GetIDisplayTime();
         if (inputStream)
         {
@@ -1236,7 +1294,23 @@ bool CDVDDemuxFFmpeg::SeekTime(double time, bool backwards, double* startpts)
   int ret;
   {
     CSingleLock lock(m_critSection);
-    ret = av_seek_frame(m_pFormatContext, m_seekStream, seek_pts, backwards ? AVSEEK_FLAG_BACKWARD : 0);
+
+    KeyframeIndexEntry keyframe;
+    if (m_keyframeIndex && m_keyframeIndex->Lookup(static_cast<int64_t>(time), backwards, keyframe))
+    {
+      ret = av_seek_frame(m_pFormatContext, -1, keyframe.pos, AVSEEK_FLAG_BYTE);
+      if (ret >= 0)
+      {
+        m_seekToKeyFrame = true;
+        CLog::Log(LOGDEBUG, "%s - seek to keyframe at %" PRId64 " ms, pos %" PRId64, __FUNCTION__,
+                  keyframe.timeMs, keyframe.pos);
+      }
+    }
+    else
+      ret = -1;
+
+    if (ret < 0)
+      ret = av_seek_frame(m_pFormatContext, m_seekStream, seek_pts, backwards ? AVSEEK_FLAG_BACKWARD : 0);
 
     if (ret < 0)
     {
@@ -1292,6 +1366,48 @@ bool CDVDDemuxFFmpeg::SeekTime(double time, bool backwards, double* startpts)
     return false;
 }
 
+int64_t CDVDDemuxFFmpeg::GetKeyframeTime(const AVStream* stream, int64_t pts) const
+{
+  // relative to the start time like the timestamps of the packets, the index
+  // is used with the same time as SeekTime gets
+  int64_t start = 0;
+  if (m_checkTransportStream)
+    start = static_cast<int64_t>(m_startTime * stream->time_base.den / stream->time_base.num);
+  else if (m_pFormatContext->start_time != static_cast<int64_t>(AV_NOPTS_VALUE))
+    start = av_rescale_q(m_pFormatContext->start_time, AV_TIME_BASE_Q, stream->time_base);
+
+  int64_t time = pts - start;
+
+  // mpeg timestamps have 33 bits and wrap after 26.5 hours, which can happen in
+  // the middle of a recording. keyframes never are far before the start.
+  if (stream->pts_wrap_bits > 0 && stream->pts_wrap_bits < 63)
+  {
+    const int64_t wrap = INT64_C(1) << stream->pts_wrap_bits;
+    if (time < -wrap / 2)
+      time += wrap;
+  }
+
+  return av_rescale(time, 1000 * stream->time_base.num, stream->time_base.den);
+}
+
+void CDVDDemuxFFmpeg::SaveKeyframeIndex(bool complete)
+{
+  CSingleLock lock(m_critSection);
+
+  if (!m_keyframeIndex)
+    return;
+
+  if (complete)
+    m_keyframeIndex->SetComplete();
+
+  m_keyframeIndex->Save();
+}
+
+bool CDVDDemuxFFmpeg::HasCompleteKeyframeIndex() const
+{
+  return m_keyframeIndex && m_keyframeIndex->IsComplete();
+}
+
 bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
 {
   CSingleLock lock(m_critSection);
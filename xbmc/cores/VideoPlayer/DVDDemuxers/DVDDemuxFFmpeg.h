@@ -9,6 +9,7 @@
 #pragma once
 
 #include "DVDDemux.h"
+#include "KeyframeIndex.h"
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
 #include <map>
@@ -111,6 +112,28 @@ public:
 
   bool Aborted();
 
+  /*!
+   * \brief Check if the streams were restored from the probe cache
+   */
+  bool IsProbeCached() const { return m_probeCached; }
+
+  /*!
+   * \brief Store the keyframes seen so far in the keyframe index of the file
+   *
+   * \param complete True if every packet of the file was read
+   */
+  void SaveKeyframeIndex(bool complete);
+
+  /*!
+   * \brief Check if keyframes of the file are indexed for seeking
+   */
+  bool HasKeyframeIndex() const { return m_keyframeIndex != nullptr; }
+
+  /*!
+   * \brief Check if the file has a keyframe index covering the whole file
+   */
+  bool HasCompleteKeyframeIndex() const;
+
   AVFormatContext* m_pFormatContext;
   std::shared_ptr<CDVDInputStream> m_pInput;
 
@@ -130,6 +153,7 @@ protected:
   void ResetVideoStreams();
   AVDictionary* GetFFMpegOptionsFromInput();
   double ConvertTimestamp(int64_t pts, int den, int num);
+  int64_t GetKeyframeTime(const AVStream* stream, int64_t pts) const;
   void UpdateCurrentPTS();
   bool IsProgramChange();
   unsigned int HLSSelectProgram();
@@ -171,6 +195,9 @@ protected:
   bool m_streaminfo;
   bool m_reopen = false;
   bool m_checkTransportStream;
+  bool m_probeCached = false;
+  std::unique_ptr<CKeyframeIndex> m_keyframeIndex;
+  int m_keyframeStream = -1;
   int m_displayTime = 0;
   double m_dtsAtDisplayTime;
   bool m_seekToKeyFrame = false;
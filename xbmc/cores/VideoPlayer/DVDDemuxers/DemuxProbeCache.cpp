@@ -0,0 +1,403 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxProbeCache.h"
+
+#include "URL.h"
+#include "Util.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/Digest.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <cinttypes>
+#include <cstring>
+#include <type_traits>
+
+using KODI::UTILITY::CDigest;
+
+namespace
+{
+const char* PROBE_CACHE_PATH = "special://temp/probecache/";
+
+// Bump when StreamParameters or the file layout change
+const uint32_t PROBE_CACHE_VERSION = 2;
+const uint32_t PROBE_CACHE_MAGIC = 0x4B505243; // "KPRC"
+
+// Number of entries kept in memory, the rest are loaded from disk on demand
+const size_t MAX_MEMORY_ENTRIES = 64;
+
+// Files kept on disk, the most recently written first
+const unsigned int MAX_DISK_ENTRIES = 1000;
+const unsigned int MAX_DISK_AGE_DAYS = 90;
+
+// Extradata larger than this is not worth caching
+const uint32_t MAX_EXTRADATA_SIZE = 1024 * 1024;
+
+class CReader
+{
+public:
+  explicit CReader(const std::vector<uint8_t>& data) : m_data(data) {}
+
+  template<typename T>
+  bool Read(T& value)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "Only plain types can be read");
+    if (m_pos + sizeof(T) > m_data.size())
+      return false;
+    std::memcpy(&value, m_data.data() + m_pos, sizeof(T));
+    m_pos += sizeof(T);
+    return true;
+  }
+
+  bool Read(std::vector<uint8_t>& value, uint32_t size)
+  {
+    if (m_pos + size > m_data.size())
+      return false;
+    value.assign(m_data.begin() + m_pos, m_data.begin() + m_pos + size);
+    m_pos += size;
+    return true;
+  }
+
+private:
+  const std::vector<uint8_t>& m_data;
+  size_t m_pos = 0;
+};
+
+template<typename T>
+void Write(std::vector<uint8_t>& data, const T& value)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Only plain types can be written");
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+  data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+} // namespace
+
+CDemuxProbeCache& CDemuxProbeCache::GetInstance()
+{
+  static CDemuxProbeCache probeCache;
+  return probeCache;
+}
+
+std::string CDemuxProbeCache::GetKey(const std::string& path, int64_t size, int64_t mtime)
+{
+  // the path goes last, it may contain the separator itself
+  return StringUtils::Format("%" PRId64 "|%" PRId64 "|%s", size, mtime, path.c_str());
+}
+
+std::string CDemuxProbeCache::GetPath(const std::string& key)
+{
+  const size_t pos = key.find('|', key.find('|') + 1);
+  return pos != std::string::npos ? key.substr(pos + 1) : key;
+}
+
+std::string CDemuxProbeCache::GetCachePath(const std::string& key)
+{
+  return PROBE_CACHE_PATH + CDigest::Calculate(CDigest::Type::MD5, key) + ".probe";
+}
+
+bool CDemuxProbeCache::Apply(const std::string& key, AVFormatContext* context)
+{
+  Entry entry;
+  {
+    CSingleLock lock(m_section);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+      entry = it->second;
+  }
+
+  if (entry.key.empty())
+  {
+    if (!Load(key, entry))
+    {
+      CSingleLock lock(m_section);
+      m_stats.misses++;
+      return false;
+    }
+    Insert(entry);
+  }
+
+  // The header of the file must describe the same streams
+  bool bMatch = context->nb_streams == entry.streams.size();
+  for (unsigned int i = 0; bMatch && i < context->nb_streams; i++)
+  {
+    const AVCodecParameters* codecpar = context->streams[i]->codecpar;
+    bMatch = codecpar->codec_type == entry.streams[i].codecType &&
+             codecpar->codec_id == entry.streams[i].codecId;
+  }
+
+  if (!bMatch)
+  {
+    CLog::Log(LOGDEBUG, "%s - cached streams don't match %s", __FUNCTION__,
+              CURL::GetRedacted(GetPath(key)).c_str());
+    Remove(key);
+    CSingleLock lock(m_section);
+    m_stats.misses++;
+    return false;
+  }
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    AVStream* stream = context->streams[i];
+    AVCodecParameters* codecpar = stream->codecpar;
+    const StreamParameters& params = entry.streams[i];
+
+    codecpar->codec_tag = params.codecTag;
+    codecpar->format = params.format;
+    codecpar->bit_rate = params.bitRate;
+    codecpar->bits_per_coded_sample = params.bitsPerCodedSample;
+    codecpar->bits_per_raw_sample = params.bitsPerRawSample;
+    codecpar->profile = params.profile;
+    codecpar->level = params.level;
+    codecpar->width = params.width;
+    codecpar->height = params.height;
+    codecpar->sample_aspect_ratio = params.sampleAspectRatio;
+    codecpar->field_order = params.fieldOrder;
+    codecpar->color_range = params.colorRange;
+    codecpar->color_primaries = params.colorPrimaries;
+    codecpar->color_trc = params.colorTrc;
+    codecpar->color_space = params.colorSpace;
+    codecpar->chroma_location = params.chromaLocation;
+    codecpar->channel_layout = params.channelLayout;
+    codecpar->channels = params.channels;
+    codecpar->sample_rate = params.sampleRate;
+    codecpar->block_align = params.blockAlign;
+    codecpar->frame_size = params.frameSize;
+
+    if (codecpar->extradata_size == 0 && !entry.extradata[i].empty())
+    {
+      const size_t size = entry.extradata[i].size();
+      codecpar->extradata = static_cast<uint8_t*>(av_mallocz(size + AV_INPUT_BUFFER_PADDING_SIZE));
+      if (codecpar->extradata)
+      {
+        std::memcpy(codecpar->extradata, entry.extradata[i].data(), size);
+        codecpar->extradata_size = static_cast<int>(size);
+      }
+    }
+
+    stream->avg_frame_rate = params.avgFrameRate;
+    stream->r_frame_rate = params.rFrameRate;
+    if (stream->duration == AV_NOPTS_VALUE)
+      stream->duration = params.duration;
+    if (stream->start_time == AV_NOPTS_VALUE)
+      stream->start_time = params.startTime;
+  }
+
+  if (context->duration == AV_NOPTS_VALUE)
+    context->duration = entry.duration;
+  if (context->start_time == AV_NOPTS_VALUE)
+    context->start_time = entry.startTime;
+  if (context->bit_rate == 0)
+    context->bit_rate = entry.bitRate;
+
+  CSingleLock lock(m_section);
+  m_stats.hits++;
+
+  return true;
+}
+
+void CDemuxProbeCache::Store(const std::string& key, const AVFormatContext* context)
+{
+  if (context->nb_streams == 0)
+    return;
+
+  Entry entry;
+  entry.key = key;
+
+  entry.duration = context->duration;
+  entry.startTime = context->start_time;
+  entry.bitRate = context->bit_rate;
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const AVStream* stream = context->streams[i];
+    const AVCodecParameters* codecpar = stream->codecpar;
+
+    StreamParameters params;
+    std::memset(&params, 0, sizeof(params));
+
+    params.codecType = codecpar->codec_type;
+    params.codecId = codecpar->codec_id;
+    params.codecTag = codecpar->codec_tag;
+    params.format = codecpar->format;
+    params.bitRate = codecpar->bit_rate;
+    params.bitsPerCodedSample = codecpar->bits_per_coded_sample;
+    params.bitsPerRawSample = codecpar->bits_per_raw_sample;
+    params.profile = codecpar->profile;
+    params.level = codecpar->level;
+    params.width = codecpar->width;
+    params.height = codecpar->height;
+    params.sampleAspectRatio = codecpar->sample_aspect_ratio;
+    params.fieldOrder = codecpar->field_order;
+    params.colorRange = codecpar->color_range;
+    params.colorPrimaries = codecpar->color_primaries;
+    params.colorTrc = codecpar->color_trc;
+    params.colorSpace = codecpar->color_space;
+    params.chromaLocation = codecpar->chroma_location;
+    params.channelLayout = codecpar->channel_layout;
+    params.channels = codecpar->channels;
+    params.sampleRate = codecpar->sample_rate;
+    params.blockAlign = codecpar->block_align;
+    params.frameSize = codecpar->frame_size;
+    params.avgFrameRate = stream->avg_frame_rate;
+    params.rFrameRate = stream->r_frame_rate;
+    params.duration = stream->duration;
+    params.startTime = stream->start_time;
+
+    entry.streams.push_back(params);
+
+    if (codecpar->extradata_size > 0 &&
+        static_cast<uint32_t>(codecpar->extradata_size) <= MAX_EXTRADATA_SIZE)
+      entry.extradata.emplace_back(codecpar->extradata,
+                                   codecpar->extradata + codecpar->extradata_size);
+    else
+      entry.extradata.emplace_back();
+  }
+
+  if (!Save(entry))
+    CLog::Log(LOGDEBUG, "%s - failed to write probe cache for %s", __FUNCTION__,
+              CURL::GetRedacted(GetPath(key)).c_str());
+
+  Insert(std::move(entry));
+}
+
+void CDemuxProbeCache::Remove(const std::string& key)
+{
+  {
+    CSingleLock lock(m_section);
+    m_entries.erase(key);
+  }
+
+  XFILE::CFile::Delete(GetCachePath(key));
+}
+
+void CDemuxProbeCache::AddTimeToFirstFrame(bool cached, unsigned int timeMs)
+{
+  CSingleLock lock(m_section);
+  if (cached)
+  {
+    m_totalCachedMs += timeMs;
+    m_stats.avgTimeToFirstFrameCachedMs = static_cast<unsigned int>(m_totalCachedMs / ++m_cachedCount);
+  }
+  else
+  {
+    m_totalUncachedMs += timeMs;
+    m_stats.avgTimeToFirstFrameUncachedMs =
+        static_cast<unsigned int>(m_totalUncachedMs / ++m_uncachedCount);
+  }
+}
+
+DemuxProbeCacheStats CDemuxProbeCache::GetStats() const
+{
+  CSingleLock lock(m_section);
+  return m_stats;
+}
+
+void CDemuxProbeCache::Insert(Entry entry)
+{
+  CSingleLock lock(m_section);
+
+  const std::string key = entry.key;
+  if (m_entries.find(key) == m_entries.end())
+    m_order.push_back(key);
+  m_entries[key] = std::move(entry);
+
+  while (m_order.size() > MAX_MEMORY_ENTRIES)
+  {
+    m_entries.erase(m_order.front());
+    m_order.pop_front();
+  }
+}
+
+bool CDemuxProbeCache::Load(const std::string& key, Entry& entry)
+{
+  const std::string cachePath = GetCachePath(key);
+  if (!XFILE::CFile::Exists(cachePath))
+    return false;
+
+  XFILE::auto_buffer buffer;
+  if (XFILE::CFile().LoadFile(cachePath, buffer) <= 0)
+    return false;
+
+  const std::vector<uint8_t> data(buffer.get(), buffer.get() + buffer.size());
+  CReader reader(data);
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t avformatVersion = 0;
+  uint32_t keySize = 0;
+  std::vector<uint8_t> storedKey;
+  if (!reader.Read(magic) || magic != PROBE_CACHE_MAGIC || !reader.Read(version) ||
+      version != PROBE_CACHE_VERSION || !reader.Read(avformatVersion) ||
+      avformatVersion != LIBAVFORMAT_VERSION_INT || !reader.Read(keySize) ||
+      !reader.Read(storedKey, keySize) || std::string(storedKey.begin(), storedKey.end()) != key)
+    return false;
+
+  uint32_t streamCount = 0;
+  if (!reader.Read(entry.duration) || !reader.Read(entry.startTime) || !reader.Read(entry.bitRate) ||
+      !reader.Read(streamCount))
+    return false;
+
+  for (uint32_t i = 0; i < streamCount; i++)
+  {
+    StreamParameters params;
+    uint32_t extradataSize = 0;
+    std::vector<uint8_t> extradata;
+    if (!reader.Read(params) || !reader.Read(extradataSize) ||
+        extradataSize > MAX_EXTRADATA_SIZE || !reader.Read(extradata, extradataSize))
+      return false;
+
+    entry.streams.push_back(params);
+    entry.extradata.emplace_back(std::move(extradata));
+  }
+
+  entry.key = key;
+  return true;
+}
+
+bool CDemuxProbeCache::Save(const Entry& entry)
+{
+  std::vector<uint8_t> data;
+
+  Write(data, PROBE_CACHE_MAGIC);
+  Write(data, PROBE_CACHE_VERSION);
+  Write(data, static_cast<uint32_t>(LIBAVFORMAT_VERSION_INT));
+  Write(data, static_cast<uint32_t>(entry.key.size()));
+  data.insert(data.end(), entry.key.begin(), entry.key.end());
+  Write(data, entry.duration);
+  Write(data, entry.startTime);
+  Write(data, entry.bitRate);
+  Write(data, static_cast<uint32_t>(entry.streams.size()));
+
+  for (size_t i = 0; i < entry.streams.size(); i++)
+  {
+    Write(data, entry.streams[i]);
+    Write(data, static_cast<uint32_t>(entry.extradata[i].size()));
+    data.insert(data.end(), entry.extradata[i].begin(), entry.extradata[i].end());
+  }
+
+  if (!XFILE::CDirectory::Exists(PROBE_CACHE_PATH) && !XFILE::CDirectory::Create(PROBE_CACHE_PATH))
+    return false;
+
+  // entries are written when a file is probed for the first time, which is
+  // when the directory grows
+  CleanCache();
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(GetCachePath(entry.key), true))
+    return false;
+
+  return file.Write(data.data(), data.size()) == static_cast<ssize_t>(data.size());
+}
+
+void CDemuxProbeCache::CleanCache()
+{
+  CUtil::DeleteOldCacheFiles(PROBE_CACHE_PATH, ".probe", MAX_DISK_ENTRIES - 1, MAX_DISK_AGE_DAYS);
+}
@@ -0,0 +1,150 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <deque>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+/*!
+ * \brief Statistics of demuxer opens with and without a cached probe result
+ */
+struct DemuxProbeCacheStats
+{
+  unsigned int hits = 0;
+  unsigned int misses = 0;
+  unsigned int avgTimeToFirstFrameCachedMs = 0;
+  unsigned int avgTimeToFirstFrameUncachedMs = 0;
+};
+
+/*!
+ * \brief Cache of the stream parameters found by avformat_find_stream_info
+ *
+ * Entries are keyed by path, size and modification time of the file, and are
+ * kept in memory and in special://temp/probecache/ so they survive restarts.
+ * Only the most recently written files are kept on disk.
+ * When an entry exists, the codec parameters, extradata and frame rates of
+ * all streams are restored before probing, which lets the probe stop after
+ * a few packets instead of analysing several seconds of the file.
+ */
+class CDemuxProbeCache
+{
+public:
+  static CDemuxProbeCache& GetInstance();
+
+  /*!
+   * \brief Get the key of the entry of a file
+   *
+   * The caller passes the size and modification time, it usually has the
+   * file open already and can get them without another stat by path.
+   */
+  static std::string GetKey(const std::string& path, int64_t size, int64_t mtime);
+
+  /*!
+   * \brief Restore cached stream parameters into an opened format context
+   *
+   * \param key The key of the file, see GetKey()
+   * \param context Format context after avformat_open_input()
+   *
+   * \return True if an entry was found and matched the streams of the file
+   */
+  bool Apply(const std::string& key, AVFormatContext* context);
+
+  /*!
+   * \brief Store the stream parameters of a fully probed format context
+   */
+  void Store(const std::string& key, const AVFormatContext* context);
+
+  /*!
+   * \brief Remove the entry of a file, e.g. when probing with it failed
+   */
+  void Remove(const std::string& key);
+
+  /*!
+   * \brief Record the time from opening a file to its first frame
+   *
+   * \param cached True if the probe result came from the cache
+   * \param timeMs Time to first frame in milliseconds
+   */
+  void AddTimeToFirstFrame(bool cached, unsigned int timeMs);
+
+  DemuxProbeCacheStats GetStats() const;
+
+private:
+  CDemuxProbeCache() = default;
+  CDemuxProbeCache(const CDemuxProbeCache&) = delete;
+  CDemuxProbeCache& operator=(const CDemuxProbeCache&) = delete;
+
+  struct StreamParameters
+  {
+    AVMediaType codecType;
+    AVCodecID codecId;
+    uint32_t codecTag;
+    int format;
+    int64_t bitRate;
+    int bitsPerCodedSample;
+    int bitsPerRawSample;
+    int profile;
+    int level;
+    int width;
+    int height;
+    AVRational sampleAspectRatio;
+    AVFieldOrder fieldOrder;
+    AVColorRange colorRange;
+    AVColorPrimaries colorPrimaries;
+    AVColorTransferCharacteristic colorTrc;
+    AVColorSpace colorSpace;
+    AVChromaLocation chromaLocation;
+    uint64_t channelLayout;
+    int channels;
+    int sampleRate;
+    int blockAlign;
+    int frameSize;
+    AVRational avgFrameRate;
+    AVRational rFrameRate;
+    int64_t duration;
+    int64_t startTime;
+  };
+
+  struct Entry
+  {
+    std::string key;
+    int64_t duration;
+    int64_t startTime;
+    int64_t bitRate;
+    std::vector<StreamParameters> streams;
+    std::vector<std::vector<uint8_t>> extradata;
+  };
+
+  static std::string GetPath(const std::string& key);
+  static std::string GetCachePath(const std::string& key);
+  static void CleanCache();
+  static bool Load(const std::string& key, Entry& entry);
+  static bool Save(const Entry& entry);
+
+  void Insert(Entry entry);
+
+  mutable CCriticalSection m_section;
+  std::map<std::string, Entry> m_entries;
+  std::deque<std::string> m_order; // insertion order, oldest first
+
+  DemuxProbeCacheStats m_stats;
+  uint64_t m_totalCachedMs = 0;
+  uint64_t m_totalUncachedMs = 0;
+  unsigned int m_cachedCount = 0;
+  unsigned int m_uncachedCount = 0;
+};
@@ -0,0 +1,233 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "KeyframeIndex.h"
+
+#include "URL.h"
+#include "Util.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/Digest.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+using KODI::UTILITY::CDigest;
+
+namespace
+{
+const char* KEYFRAME_INDEX_PATH = "special://temp/keyframes/";
+
+const uint32_t KEYFRAME_INDEX_MAGIC = 0x4B4B4649; // "KKFI"
+const uint32_t KEYFRAME_INDEX_VERSION = 2;
+
+// indexes that are kept, the most recently written first
+const unsigned int KEYFRAME_INDEX_MAX_FILES = 500;
+const unsigned int KEYFRAME_INDEX_MAX_AGE_DAYS = 90;
+
+struct KeyframeIndexHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t complete;
+  uint32_t count;
+};
+
+bool CompareTime(const KeyframeIndexEntry& entry, int64_t timeMs)
+{
+  return entry.timeMs < timeMs;
+}
+} // namespace
+
+CKeyframeIndex::CKeyframeIndex(std::string path) : m_path(std::move(path))
+{
+}
+
+bool CKeyframeIndex::GetCachePath(std::string& cachePath) const
+{
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(m_path, &st) != 0 || st.st_size <= 0)
+    return false;
+
+  const std::string key = StringUtils::Format("%s|%" PRId64 "|%" PRId64, m_path.c_str(),
+                                              static_cast<int64_t>(st.st_size),
+                                              static_cast<int64_t>(st.st_mtime));
+  cachePath = KEYFRAME_INDEX_PATH + CDigest::Calculate(CDigest::Type::MD5, key) + ".idx";
+  return true;
+}
+
+bool CKeyframeIndex::Read(const std::string& cachePath,
+                          std::vector<KeyframeIndexEntry>& entries,
+                          bool& complete) const
+{
+  if (!XFILE::CFile::Exists(cachePath))
+    return false;
+
+  XFILE::auto_buffer buffer;
+  if (XFILE::CFile().LoadFile(cachePath, buffer) < static_cast<ssize_t>(sizeof(KeyframeIndexHeader)))
+    return false;
+
+  KeyframeIndexHeader header;
+  std::memcpy(&header, buffer.get(), sizeof(header));
+  if (header.magic != KEYFRAME_INDEX_MAGIC || header.version != KEYFRAME_INDEX_VERSION ||
+      buffer.size() != sizeof(header) + header.count * sizeof(KeyframeIndexEntry))
+    return false;
+
+  entries.resize(header.count);
+  std::memcpy(entries.data(), buffer.get() + sizeof(header), header.count * sizeof(KeyframeIndexEntry));
+  complete = header.complete != 0;
+
+  return true;
+}
+
+bool CKeyframeIndex::Load()
+{
+  std::string cachePath;
+  if (!GetCachePath(cachePath))
+    return false;
+
+  std::vector<KeyframeIndexEntry> entries;
+  bool complete = false;
+  if (!Read(cachePath, entries, complete))
+    return false;
+
+  Merge(entries);
+  m_complete = m_complete || complete;
+
+  CLog::Log(LOGDEBUG, "CKeyframeIndex::Load - %u keyframes%s for %s",
+            static_cast<unsigned int>(m_entries.size()), m_complete ? " (complete)" : "",
+            CURL::GetRedacted(m_path).c_str());
+
+  return true;
+}
+
+bool CKeyframeIndex::Save()
+{
+  if (!m_dirty || m_entries.empty())
+    return true;
+
+  std::string cachePath;
+  if (!GetCachePath(cachePath))
+    return false;
+
+  // another instance may have indexed other parts of the file
+  std::vector<KeyframeIndexEntry> entries;
+  bool complete = false;
+  if (Read(cachePath, entries, complete))
+  {
+    Merge(entries);
+    m_complete = m_complete || complete;
+  }
+
+  if (!XFILE::CDirectory::Exists(KEYFRAME_INDEX_PATH) &&
+      !XFILE::CDirectory::Create(KEYFRAME_INDEX_PATH))
+    return false;
+
+  KeyframeIndexHeader header;
+  header.magic = KEYFRAME_INDEX_MAGIC;
+  header.version = KEYFRAME_INDEX_VERSION;
+  header.complete = m_complete ? 1 : 0;
+  header.count = static_cast<uint32_t>(m_entries.size());
+
+  const bool created = !XFILE::CFile::Exists(cachePath);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(cachePath, true))
+    return false;
+
+  const ssize_t size = m_entries.size() * sizeof(KeyframeIndexEntry);
+  if (file.Write(&header, sizeof(header)) != static_cast<ssize_t>(sizeof(header)) ||
+      file.Write(m_entries.data(), size) != size)
+    return false;
+  file.Close();
+
+  m_dirty = false;
+
+  // the directory only grows when a file is indexed for the first time
+  if (created)
+    CleanCache();
+
+  return true;
+}
+
+bool CKeyframeIndex::Remove()
+{
+  std::string cachePath;
+  if (!GetCachePath(cachePath))
+    return false;
+
+  return !XFILE::CFile::Exists(cachePath) || XFILE::CFile::Delete(cachePath);
+}
+
+void CKeyframeIndex::CleanCache()
+{
+  CUtil::DeleteOldCacheFiles(KEYFRAME_INDEX_PATH, ".idx", KEYFRAME_INDEX_MAX_FILES,
+                             KEYFRAME_INDEX_MAX_AGE_DAYS);
+}
+
+void CKeyframeIndex::Add(int64_t timeMs, int64_t pos)
+{
+  if (timeMs < 0 || pos < 0)
+    return;
+
+  // keyframes usually arrive in order, so this is an append
+  auto it = std::lower_bound(m_entries.begin(), m_entries.end(), timeMs, CompareTime);
+  if (it != m_entries.end() && (it->timeMs == timeMs || it->pos == pos))
+    return;
+  if (it != m_entries.begin() && std::prev(it)->pos == pos)
+    return;
+
+  m_entries.insert(it, KeyframeIndexEntry{timeMs, pos});
+  m_dirty = true;
+}
+
+bool CKeyframeIndex::Lookup(int64_t timeMs, bool backwards, KeyframeIndexEntry& entry) const
+{
+  std::vector<KeyframeIndexEntry>::const_iterator it;
+
+  if (backwards)
+  {
+    // first keyframe after the requested time
+    auto next = std::upper_bound(m_entries.begin(), m_entries.end(), timeMs,
+                                 [](int64_t time, const KeyframeIndexEntry& e) { return time < e.timeMs; });
+    if (next == m_entries.begin())
+      return false;
+
+    it = std::prev(next);
+
+    // the keyframe must be followed by a close one, otherwise there may be
+    // keyframes in between that haven't been indexed yet
+    if (!m_complete && (next == m_entries.end() || next->timeMs - it->timeMs > MAX_GAP_MS))
+      return false;
+  }
+  else
+  {
+    it = std::lower_bound(m_entries.begin(), m_entries.end(), timeMs, CompareTime);
+    if (it == m_entries.end())
+      return false;
+
+    // likewise the keyframe must be preceded by a close one
+    if (!m_complete && it->timeMs != timeMs &&
+        (it == m_entries.begin() || it->timeMs - std::prev(it)->timeMs > MAX_GAP_MS))
+      return false;
+  }
+
+  entry = *it;
+  return true;
+}
+
+void CKeyframeIndex::Merge(const std::vector<KeyframeIndexEntry>& entries)
+{
+  const bool dirty = m_dirty;
+  for (const auto& entry : entries)
+    Add(entry.timeMs, entry.pos);
+  m_dirty = dirty;
+}
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct KeyframeIndexEntry
+{
+  int64_t timeMs; // presentation time relative to the start time of the file
+  int64_t pos; // byte offset of the packet
+};
+
+/*!
+ * \brief Index of video keyframes of a file, used to seek by byte offset
+ *
+ * Formats like MPEG-TS have no index of their own, so seeking by time makes
+ * libavformat bisect the file, which is slow over SMB or HTTP. The index is
+ * filled with the keyframes read during playback, or by a full scan with
+ * CKeyframeIndexJob, and stored in special://temp/keyframes/ keyed by path,
+ * size and modification time of the file. Only the most recently written
+ * indexes are kept, see CleanCache().
+ */
+class CKeyframeIndex
+{
+public:
+  explicit CKeyframeIndex(std::string path);
+
+  /*!
+   * \brief Load the stored index of the file, if any
+   */
+  bool Load();
+
+  /*!
+   * \brief Store the index, merged with the stored index of the file
+   */
+  bool Save();
+
+  /*!
+   * \brief Delete the stored index of the file
+   */
+  bool Remove();
+
+  void Add(int64_t timeMs, int64_t pos);
+
+  /*!
+   * \brief Find the keyframe to seek to for the given time
+   *
+   * Unless the index is complete, only keyframes inside a region that was
+   * indexed without gaps are returned, so that a seek never skips a keyframe
+   * that wasn't indexed yet.
+   *
+   * \param timeMs Time relative to the start time of the file
+   * \param backwards Find the last keyframe at or before the time, otherwise
+   *                  the first one at or after it
+   * \return True if a suitable keyframe was found
+   */
+  bool Lookup(int64_t timeMs, bool backwards, KeyframeIndexEntry& entry) const;
+
+  /*!
+   * \brief Mark the index as containing every keyframe of the file
+   */
+  void SetComplete() { m_complete = true; m_dirty = true; }
+  bool IsComplete() const { return m_complete; }
+
+  size_t Size() const { return m_entries.size(); }
+
+  /*!
+   * \brief Largest distance between two keyframes that are considered
+   *        adjacent in an incomplete index
+   */
+  static const int64_t MAX_GAP_MS = 10000;
+
+  /*!
+   * \brief Delete the stored indexes beyond the most recently written ones,
+   *        and those that weren't written for a long time
+   */
+  static void CleanCache();
+
+private:
+  bool GetCachePath(std::string& cachePath) const;
+  bool Read(const std::string& cachePath, std::vector<KeyframeIndexEntry>& entries, bool& complete) const;
+  void Merge(const std::vector<KeyframeIndexEntry>& entries);
+
+  const std::string m_path;
+  std::vector<KeyframeIndexEntry> m_entries; // sorted by time
+  bool m_complete = false;
+  bool m_dirty = false;
+};
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "KeyframeIndexJob.h"
+
+#include "DVDDemuxFFmpeg.h"
+#include "DVDDemuxUtils.h"
+#include "DVDInputStreams/DVDInputStreamFile.h"
+#include "URL.h"
+#include "filesystem/IFile.h"
+#include "utils/log.h"
+
+#include <cstring>
+#include <memory>
+
+CKeyframeIndexJob::CKeyframeIndexJob(const CFileItem& item) : m_item(item)
+{
+}
+
+bool CKeyframeIndexJob::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(), GetType()) != 0)
+    return false;
+
+  const CKeyframeIndexJob* indexJob = dynamic_cast<const CKeyframeIndexJob*>(job);
+  return indexJob && indexJob->m_item.GetDynPath() == m_item.GetDynPath();
+}
+
+bool CKeyframeIndexJob::DoWork()
+{
+  const std::string path = CURL::GetRedacted(m_item.GetDynPath());
+
+  std::shared_ptr<CDVDInputStreamFile> input = std::make_shared<CDVDInputStreamFile>(
+      m_item, XFILE::READ_TRUNCATED | XFILE::READ_CHUNKED);
+  if (!input->Open())
+    return false;
+
+  CDVDDemuxFFmpeg demuxer;
+  if (!demuxer.Open(input, false))
+    return false;
+
+  if (!demuxer.HasKeyframeIndex() || demuxer.HasCompleteKeyframeIndex())
+    return true;
+
+  CLog::Log(LOGDEBUG, "CKeyframeIndexJob::DoWork - indexing %s", path.c_str());
+
+  const int64_t length = input->GetLength();
+  unsigned int packets = 0;
+
+  // the demuxer returns no packet at the end of the file
+  DemuxPacket* packet;
+  while ((packet = demuxer.Read()) != nullptr)
+  {
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+    if (++packets % 1000 == 0 && length > 0)
+    {
+      const int64_t pos = input->Seek(0, SEEK_CUR);
+      if (ShouldCancel(static_cast<unsigned int>(pos / 1024), static_cast<unsigned int>(length / 1024)))
+      {
+        // keep what was found so far
+        demuxer.SaveKeyframeIndex(false);
+        return false;
+      }
+    }
+  }
+
+  const bool complete = input->IsEOF();
+  demuxer.SaveKeyframeIndex(complete);
+
+  CLog::Log(LOGDEBUG, "CKeyframeIndexJob::DoWork - indexing %s %s after %u packets",
+            path.c_str(), complete ? "finished" : "stopped", packets);
+
+  return complete;
+}
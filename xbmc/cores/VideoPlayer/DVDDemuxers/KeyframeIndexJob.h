@@ -0,0 +1,32 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "FileItem.h"
+#include "utils/Job.h"
+
+/*!
+ * \brief Job reading a whole file to build a complete keyframe index
+ *
+ * Only files handled by CKeyframeIndex are read. Scanning is optional, see
+ * the video/keyframeindexscan advanced setting.
+ */
+class CKeyframeIndexJob : public CJob
+{
+public:
+  explicit CKeyframeIndexJob(const CFileItem& item);
+  ~CKeyframeIndexJob() override = default;
+
+  const char* GetType() const override { return "keyframeindex"; }
+  bool operator==(const CJob* job) const override;
+  bool DoWork() override;
+
+private:
+  CFileItem m_item;
+};
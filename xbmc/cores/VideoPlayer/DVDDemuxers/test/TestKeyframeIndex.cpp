@@ -0,0 +1,334 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDDemuxers/KeyframeIndex.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStreamFile.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "filesystem/File.h"
+#include "filesystem/IFile.h"
+#include "filesystem/SpecialProtocol.h"
+#include "test/TestUtils.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr int FRAME_RATE = 25;
+constexpr int GOP_SIZE = 12;
+constexpr int DURATION_SEC = 60;
+constexpr int64_t GOP_DURATION_MS = GOP_SIZE * 1000 / FRAME_RATE;
+
+/*!
+ * \brief Input stream counting the bytes read by the demuxer
+ */
+class CCountingInputStream : public CDVDInputStreamFile
+{
+public:
+  explicit CCountingInputStream(const CFileItem& item)
+    : CDVDInputStreamFile(item, XFILE::READ_TRUNCATED | XFILE::READ_CHUNKED)
+  {
+  }
+
+  int Read(uint8_t* buf, int buf_size) override
+  {
+    const int ret = CDVDInputStreamFile::Read(buf, buf_size);
+    if (ret > 0)
+      m_bytesRead += ret;
+    return ret;
+  }
+
+  int64_t m_bytesRead = 0;
+};
+
+/*!
+ * \brief Build an MPEG-2 video frame that is only valid as far as the parser
+ *        is concerned: headers followed by a padded slice
+ */
+std::vector<uint8_t> CreateFrame(int frame, bool keyframe)
+{
+  std::vector<uint8_t> data;
+
+  if (keyframe)
+  {
+    // sequence header: 320x240, 1:1, 25 fps
+    const uint8_t sequence[] = {0x00, 0x00, 0x01, 0xB3, 0x14, 0x00, 0xF0, 0x13,
+                                0xFF, 0xFF, 0xE0, 0x80};
+    // closed group of pictures
+    const uint8_t gop[] = {0x00, 0x00, 0x01, 0xB8, 0x00, 0x08, 0x00, 0x40};
+    data.insert(data.end(), sequence, sequence + sizeof(sequence));
+    data.insert(data.end(), gop, gop + sizeof(gop));
+  }
+
+  const int temporalReference = frame % GOP_SIZE;
+  const uint8_t codingType = keyframe ? 1 : 2;
+  const uint8_t picture[] = {0x00,
+                             0x00,
+                             0x01,
+                             0x00,
+                             static_cast<uint8_t>(temporalReference >> 2),
+                             static_cast<uint8_t>((temporalReference & 3) << 6 | codingType << 3 | 0x07),
+                             0xFF,
+                             0xF8,
+                             static_cast<uint8_t>(keyframe ? 0x00 : 0x80)};
+  data.insert(data.end(), picture, picture + sizeof(picture));
+
+  const uint8_t slice[] = {0x00, 0x00, 0x01, 0x01};
+  data.insert(data.end(), slice, slice + sizeof(slice));
+  data.resize(data.size() + (keyframe ? 16384 : 2048), 0xAA);
+
+  return data;
+}
+
+bool CreateTransportStream(const std::string& path)
+{
+  AVFormatContext* context = nullptr;
+  if (avformat_alloc_output_context2(&context, nullptr, "mpegts", path.c_str()) < 0)
+    return false;
+
+  AVStream* stream = avformat_new_stream(context, nullptr);
+  stream->time_base = AVRational{1, 90000};
+  stream->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+  stream->codecpar->codec_id = AV_CODEC_ID_MPEG2VIDEO;
+  stream->codecpar->width = 320;
+  stream->codecpar->height = 240;
+
+  bool ok = avio_open(&context->pb, path.c_str(), AVIO_FLAG_WRITE) >= 0 &&
+            avformat_write_header(context, nullptr) >= 0;
+
+  for (int frame = 0; ok && frame < DURATION_SEC * FRAME_RATE; frame++)
+  {
+    const bool keyframe = frame % GOP_SIZE == 0;
+    std::vector<uint8_t> data = CreateFrame(frame, keyframe);
+
+    AVPacket pkt;
+    av_init_packet(&pkt);
+    pkt.data = data.data();
+    pkt.size = static_cast<int>(data.size());
+    pkt.stream_index = stream->index;
+    pkt.pts = pkt.dts = av_rescale_q(frame, AVRational{1, FRAME_RATE}, stream->time_base);
+    pkt.flags = keyframe ? AV_PKT_FLAG_KEY : 0;
+
+    ok = av_write_frame(context, &pkt) >= 0;
+  }
+
+  if (ok)
+    ok = av_write_trailer(context) >= 0;
+
+  avio_closep(&context->pb);
+  avformat_free_context(context);
+
+  return ok;
+}
+
+/*!
+ * \brief Seek and read up to the first video packet
+ *
+ * \return Time of the first packet after the seek in ms, or -1 on failure
+ */
+int64_t SeekAndRead(CDVDDemuxFFmpeg& demuxer, int64_t timeMs)
+{
+  if (!demuxer.SeekTime(static_cast<double>(timeMs), true))
+    return -1;
+
+  for (int i = 0; i < 1000; i++)
+  {
+    DemuxPacket* packet = demuxer.Read();
+    if (!packet)
+      return -1;
+
+    const double pts = packet->pts != DVD_NOPTS_VALUE ? packet->pts : packet->dts;
+    const bool valid = packet->iSize > 0 && pts != DVD_NOPTS_VALUE;
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+    if (valid)
+      return static_cast<int64_t>(DVD_TIME_TO_MSEC(pts));
+  }
+
+  return -1;
+}
+} // namespace
+
+TEST(TestKeyframeIndex, Lookup)
+{
+  CKeyframeIndex index("");
+
+  index.Add(2000, 4000);
+  index.Add(0, 0);
+  index.Add(1000, 2000);
+  index.Add(1000, 2000);
+  EXPECT_EQ(3U, index.Size());
+
+  KeyframeIndexEntry entry;
+  EXPECT_TRUE(index.Lookup(1500, true, entry));
+  EXPECT_EQ(1000, entry.timeMs);
+  EXPECT_EQ(2000, entry.pos);
+
+  EXPECT_TRUE(index.Lookup(1000, true, entry));
+  EXPECT_EQ(1000, entry.timeMs);
+
+  // nothing known after the last keyframe
+  EXPECT_FALSE(index.Lookup(2500, true, entry));
+
+  index.SetComplete();
+  EXPECT_TRUE(index.Lookup(2500, true, entry));
+  EXPECT_EQ(2000, entry.timeMs);
+}
+
+TEST(TestKeyframeIndex, LookupForward)
+{
+  CKeyframeIndex index("");
+
+  index.Add(1000, 2000);
+  index.Add(2000, 4000);
+
+  KeyframeIndexEntry entry;
+  EXPECT_TRUE(index.Lookup(1500, false, entry));
+  EXPECT_EQ(2000, entry.timeMs);
+  EXPECT_EQ(4000, entry.pos);
+
+  EXPECT_TRUE(index.Lookup(1000, false, entry));
+  EXPECT_EQ(1000, entry.timeMs);
+
+  // nothing known before the first keyframe and after the last one
+  EXPECT_FALSE(index.Lookup(500, false, entry));
+  EXPECT_FALSE(index.Lookup(2500, false, entry));
+
+  index.SetComplete();
+  EXPECT_TRUE(index.Lookup(500, false, entry));
+  EXPECT_EQ(1000, entry.timeMs);
+  EXPECT_FALSE(index.Lookup(2500, false, entry));
+}
+
+TEST(TestKeyframeIndex, Gap)
+{
+  CKeyframeIndex index("");
+
+  index.Add(0, 0);
+  index.Add(1000, 2000);
+  index.Add(1000 + CKeyframeIndex::MAX_GAP_MS + 1, 50000);
+  index.Add(2000 + CKeyframeIndex::MAX_GAP_MS + 1, 52000);
+
+  KeyframeIndexEntry entry;
+  EXPECT_TRUE(index.Lookup(500, true, entry));
+  EXPECT_FALSE(index.Lookup(5000, true, entry));
+  EXPECT_TRUE(index.Lookup(1500 + CKeyframeIndex::MAX_GAP_MS, true, entry));
+  EXPECT_EQ(50000, entry.pos);
+}
+
+TEST(TestKeyframeIndex, SaveLoad)
+{
+  XFILE::CFile* file;
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(".ts"));
+  const char data[] = "keyframe index";
+  EXPECT_EQ(static_cast<ssize_t>(sizeof(data)), file->Write(data, sizeof(data)));
+  file->Close();
+
+  const std::string path = XBMC_TEMPFILEPATH(file);
+  {
+    CKeyframeIndex index(path);
+    index.Add(0, 0);
+    index.Add(1000, 2000);
+    EXPECT_TRUE(index.Save());
+  }
+  {
+    // stored entries are merged with the ones of another instance
+    CKeyframeIndex index(path);
+    index.Add(2000, 4000);
+    EXPECT_TRUE(index.Save());
+  }
+
+  CKeyframeIndex index(path);
+  EXPECT_TRUE(index.Load());
+  EXPECT_EQ(3U, index.Size());
+  EXPECT_FALSE(index.IsComplete());
+
+  KeyframeIndexEntry entry;
+  EXPECT_TRUE(index.Lookup(1999, true, entry));
+  EXPECT_EQ(2000, entry.pos);
+
+  EXPECT_TRUE(index.Remove());
+  EXPECT_FALSE(CKeyframeIndex(path).Load());
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestKeyframeIndex, SeekTransportStream)
+{
+  const std::string path = "special://temp/keyframeindex.ts";
+  ASSERT_TRUE(CreateTransportStream(CSpecialProtocol::TranslatePath(path)));
+  // an index left by an earlier run would be used for the first measurement
+  CKeyframeIndex(path).Remove();
+
+  const CFileItem item(path, false);
+
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int64_t> distribution(0, (DURATION_SEC - 1) * 1000);
+  std::vector<int64_t> targets;
+  for (int i = 0; i < 50; i++)
+    targets.push_back(distribution(generator));
+
+  auto measure = [&](bool indexed, int64_t& bytesPerSeek) {
+    std::shared_ptr<CCountingInputStream> input = std::make_shared<CCountingInputStream>(item);
+    ASSERT_TRUE(input->Open());
+
+    CDVDDemuxFFmpeg demuxer;
+    ASSERT_TRUE(demuxer.Open(input, false));
+    ASSERT_TRUE(demuxer.HasKeyframeIndex());
+    if (indexed)
+      ASSERT_TRUE(demuxer.HasCompleteKeyframeIndex());
+
+    ASSERT_GE(SeekAndRead(demuxer, 0), 0);
+
+    const int64_t bytesBefore = input->m_bytesRead;
+    for (int64_t target : targets)
+    {
+      const int64_t time = SeekAndRead(demuxer, target);
+      ASSERT_GE(time, 0) << "seek to " << target;
+      if (indexed)
+      {
+        // the index seeks to the last keyframe at or before the target
+        EXPECT_LE(time, target + 1000 / FRAME_RATE);
+        EXPECT_GT(time, target - GOP_DURATION_MS - 1000 / FRAME_RATE);
+      }
+    }
+    bytesPerSeek = (input->m_bytesRead - bytesBefore) / static_cast<int64_t>(targets.size());
+
+    if (!indexed)
+    {
+      // read the whole file once so that every keyframe is indexed
+      ASSERT_GE(SeekAndRead(demuxer, 0), 0);
+      DemuxPacket* packet;
+      while ((packet = demuxer.Read()) != nullptr)
+        CDVDDemuxUtils::FreeDemuxPacket(packet);
+      demuxer.SaveKeyframeIndex(input->IsEOF());
+    }
+  };
+
+  int64_t bisectBytes = 0;
+  int64_t indexedBytes = 0;
+  measure(false, bisectBytes);
+  measure(true, indexedBytes);
+
+  RecordProperty("BytesPerSeekWithoutIndex", static_cast<int>(bisectBytes));
+  RecordProperty("BytesPerSeekWithIndex", static_cast<int>(indexedBytes));
+  EXPECT_LE(indexedBytes, bisectBytes);
+
+  CKeyframeIndex(path).Remove();
+  XFILE::CFile::Delete(path);
+}
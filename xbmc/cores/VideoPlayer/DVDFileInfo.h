@@ -14,6 +14,7 @@
 
 class CFileItem;
 class CDVDDemux;
+class CDVDThumbExtractor;
 class CStreamDetails;
 class CStreamDetailSubtitle;
 class CDVDInputStream;
@@ -28,6 +29,13 @@ public:
                            CStreamDetails *pStreamDetails,
                            int64_t pos);
 
+  // Same as above, reusing the decoder of an extractor that is used for many files
+  static bool ExtractThumb(CDVDThumbExtractor& extractor,
+                           const CFileItem& fileItem,
+                           CTextureDetails &details,
+                           CStreamDetails *pStreamDetails,
+                           int64_t pos);
+
   // Probe the files streams and store the info in the VideoInfoTag
   static bool GetFileStreamDetails(CFileItem *pItem);
   static bool DemuxerToStreamDetails(std::shared_ptr<CDVDInputStream> pInputStream, CDVDDemux *pDemux, CStreamDetails &details, const std::string &path = "");
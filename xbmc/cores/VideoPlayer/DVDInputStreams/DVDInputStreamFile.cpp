@@ -184,3 +184,11 @@ void CDVDInputStreamFile::SetReadRate(unsigned rate)
   if(m_pFile->IoControl(IOCTRL_CACHE_SETRATE, &maxrate) >= 0)
     CLog::Log(LOGDEBUG, "CDVDInputStreamFile::SetReadRate - set cache throttle rate to %u bytes per second", maxrate);
 }
+
+int CDVDInputStreamFile::Stat(struct __stat64* buffer)
+{
+  if (m_pFile && m_pFile->Stat(buffer) == 0)
+    return 0;
+
+  return CFile::Stat(m_item.GetDynPath(), buffer);
+}
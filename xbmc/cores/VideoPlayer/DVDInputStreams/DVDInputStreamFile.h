@@ -9,6 +9,7 @@
 #pragma once
 
 #include "DVDInputStream.h"
+#include "PlatformDefs.h" // for __stat64
 
 class CDVDInputStreamFile : public CDVDInputStream
 {
@@ -26,6 +27,14 @@ public:
   void SetReadRate(unsigned rate) override;
   bool GetCacheStatus(XFILE::SCacheStatus *status) override;
 
+  /*!
+   * \brief Stat the open file, which saves a round trip on network filesystems
+   *        compared to a stat by path
+   *
+   * Falls back to a stat by path if the filesystem can't stat an open file.
+   */
+  int Stat(struct __stat64* buffer);
+
 protected:
   XFILE::CFile* m_pFile = nullptr;
   bool m_eof = false;
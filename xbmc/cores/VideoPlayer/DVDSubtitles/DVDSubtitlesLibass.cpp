@@ -20,6 +20,18 @@
 #include "utils/log.h"
 #include "windowing/GraphicContext.h"
 
+#include <string.h>
+
+namespace
+{
+// video frames rendered ahead of the render thread
+const int LOOKAHEAD_FRAMES = 8;
+// requests further apart are a seek, not the next frame
+const int MAX_INTERVAL_MS = 200;
+// a cached frame matches a request within this distance
+const int TOLERANCE_MS = 1;
+} // namespace
+
 static void libass_log(int level, const char *fmt, va_list args, void *data)
 {
   if(level >= 5)
@@ -28,7 +40,20 @@ static void libass_log(int level, const char *fmt, va_list args, void *data)
   CLog::Log(LOGDEBUG, "CDVDSubtitlesLibass: [ass] %s", log.c_str());
 }
 
+bool CDVDSubtitlesLibass::SRenderParams::operator==(const SRenderParams& right) const
+{
+  return frameWidth == right.frameWidth &&
+         frameHeight == right.frameHeight &&
+         videoWidth == right.videoWidth &&
+         videoHeight == right.videoHeight &&
+         sourceWidth == right.sourceWidth &&
+         sourceHeight == right.sourceHeight &&
+         useMargin == right.useMargin &&
+         position == right.position;
+}
+
 CDVDSubtitlesLibass::CDVDSubtitlesLibass()
+  : CThread("LibassLookahead")
 {
   //Setting the font directory to the temp dir(where mkv fonts are extracted to)
   std::string strPath = "special://temp/fonts/";
@@ -73,6 +98,10 @@ CDVDSubtitlesLibass::CDVDSubtitlesLibass()
 
 CDVDSubtitlesLibass::~CDVDSubtitlesLibass()
 {
+  StopThread();
+  if (m_hits + m_misses > 0)
+    CLog::Log(LOGDEBUG, "CDVDSubtitlesLibass: look-ahead served %u of %u frames", m_hits, m_hits + m_misses);
+
   if(m_track)
     ass_free_track(m_track);
   ass_renderer_done(m_renderer);
@@ -93,6 +122,7 @@ bool CDVDSubtitlesLibass::DecodeHeader(char* data, int size)
   }
 
   ass_process_codec_private(m_track, data, size);
+  ClearCache(0);
   return true;
 }
 
@@ -107,6 +137,7 @@ bool CDVDSubtitlesLibass::DecodeDemuxPkt(const char* data, int size, double star
 
   //! @bug libass isn't const correct
   ass_process_chunk(m_track, const_cast<char*>(data), size, DVD_TIME_TO_MSEC(start), DVD_TIME_TO_MSEC(duration));
+  ClearCache(DVD_TIME_TO_MSEC(start));
   return true;
 }
 
@@ -125,29 +156,181 @@ bool CDVDSubtitlesLibass::CreateTrack(char* buf, size_t size)
   if(m_track == NULL)
     return false;
 
+  ClearCache(0);
   return true;
 }
 
 ASS_Image* CDVDSubtitlesLibass::RenderImage(int frameWidth, int frameHeight, int videoWidth, int videoHeight, int sourceWidth, int sourceHeight,
                                             double pts, int useMargin, double position, int *changes)
 {
-  CSingleLock lock(m_section);
-  if(!m_renderer || !m_track)
+  SRenderParams params;
+  params.frameWidth = frameWidth;
+  params.frameHeight = frameHeight;
+  params.videoWidth = videoWidth;
+  params.videoHeight = videoHeight;
+  params.sourceWidth = sourceWidth;
+  params.sourceHeight = sourceHeight;
+  params.useMargin = useMargin;
+  params.position = position;
+
+  const int64_t time = DVD_TIME_TO_MSEC(pts);
+  std::shared_ptr<SFrame> frame;
+  unsigned int version;
   {
-    CLog::Log(LOGERROR, "CDVDSubtitlesLibass: %s - Missing ASS structs(m_track or m_renderer)", __FUNCTION__);
-    return NULL;
+    CSingleLock lock(m_cacheSection);
+    if (params != m_params)
+    {
+      m_params = params;
+      m_cache.clear();
+    }
+
+    // the distance between two video frames predicts the next requests
+    const double interval = pts - m_lastPts;
+    if (interval > 0 && interval < DVD_MSEC_TO_TIME(MAX_INTERVAL_MS))
+      m_interval = interval;
+    else if (interval != 0)
+      m_cache.clear();
+    m_lastPts = pts;
+
+    m_cache.erase(m_cache.begin(), m_cache.lower_bound(time - TOLERANCE_MS));
+    auto it = m_cache.begin();
+    if (it != m_cache.end() && it->first <= time + TOLERANCE_MS)
+    {
+      frame = it->second;
+      m_hits++;
+    }
+    version = m_version;
+  }
+
+  if (!frame)
+  {
+    frame = Render(params, time);
+    if (!frame)
+    {
+      CLog::Log(LOGERROR, "CDVDSubtitlesLibass: %s - Missing ASS structs(m_track or m_renderer)", __FUNCTION__);
+      return NULL;
+    }
+
+    CSingleLock lock(m_cacheSection);
+    m_misses++;
+    if (params == m_params && version == m_version)
+      m_cache[time] = frame;
   }
 
-  double sar = (double)sourceWidth / sourceHeight;
-  double dar = (double)videoWidth / videoHeight;
-  ass_set_frame_size(m_renderer, frameWidth, frameHeight);
-  int topmargin = (frameHeight - videoHeight) / 2;
-  int leftmargin = (frameWidth - videoWidth) / 2;
+  if (!IsRunning())
+    Create();
+  m_lookaheadEvent.Set();
+
+  if (changes)
+    *changes = frame == m_current ? 0 : 2;
+  m_current = frame;
+
+  if (m_current->images.empty())
+    return NULL;
+  return &m_current->images.front();
+}
+
+std::shared_ptr<CDVDSubtitlesLibass::SFrame> CDVDSubtitlesLibass::Render(const SRenderParams& params, int64_t time)
+{
+  CSingleLock lock(m_section);
+  if(!m_renderer || !m_track)
+    return nullptr;
+
+  double sar = (double)params.sourceWidth / params.sourceHeight;
+  double dar = (double)params.videoWidth / params.videoHeight;
+  ass_set_frame_size(m_renderer, params.frameWidth, params.frameHeight);
+  int topmargin = (params.frameHeight - params.videoHeight) / 2;
+  int leftmargin = (params.frameWidth - params.videoWidth) / 2;
   ass_set_margins(m_renderer, topmargin, topmargin, leftmargin, leftmargin);
-  ass_set_use_margins(m_renderer, useMargin);
-  ass_set_line_position(m_renderer, position);
+  ass_set_use_margins(m_renderer, params.useMargin);
+  ass_set_line_position(m_renderer, params.position);
   ass_set_aspect_ratio(m_renderer, dar, sar);
-  return ass_render_frame(m_renderer, m_track, DVD_TIME_TO_MSEC(pts), changes);
+
+  int changes = 0;
+  ASS_Image* images = ass_render_frame(m_renderer, m_track, time, &changes);
+  if (changes == 0 && m_renderedFrame && params == m_renderedParams)
+    return m_renderedFrame;
+
+  // the images of libass are only valid until the next pass, keep a copy
+  size_t count = 0;
+  size_t size = 0;
+  for (ASS_Image* img = images; img; img = img->next)
+  {
+    count++;
+    size += img->w * img->h;
+  }
+
+  std::shared_ptr<SFrame> frame = std::make_shared<SFrame>();
+  frame->images.reserve(count);
+  frame->bitmaps.resize(size);
+
+  unsigned char* bitmap = frame->bitmaps.data();
+  for (ASS_Image* img = images; img; img = img->next)
+  {
+    ASS_Image copy = *img;
+    copy.bitmap = bitmap;
+    copy.stride = img->w;
+    copy.next = nullptr;
+    for (int y = 0; y < img->h; y++)
+      memcpy(bitmap + y * img->w, img->bitmap + y * img->stride, img->w);
+    bitmap += img->w * img->h;
+    frame->images.push_back(copy);
+  }
+  for (size_t i = 1; i < frame->images.size(); i++)
+    frame->images[i - 1].next = &frame->images[i];
+
+  m_renderedParams = params;
+  m_renderedFrame = frame;
+  return frame;
+}
+
+void CDVDSubtitlesLibass::ClearCache(int64_t from)
+{
+  CSingleLock lock(m_cacheSection);
+  m_cache.erase(m_cache.lower_bound(from), m_cache.end());
+  m_version++;
+}
+
+void CDVDSubtitlesLibass::Process()
+{
+  while (!m_bStop)
+  {
+    AbortableWait(m_lookaheadEvent, 100);
+
+    while (!m_bStop)
+    {
+      SRenderParams params;
+      int64_t time = -1;
+      unsigned int version;
+      {
+        CSingleLock lock(m_cacheSection);
+        if (m_interval <= 0)
+          break;
+
+        for (int i = 1; i <= LOOKAHEAD_FRAMES && time < 0; i++)
+        {
+          const int64_t next = DVD_TIME_TO_MSEC(m_lastPts + i * m_interval);
+          auto it = m_cache.lower_bound(next - TOLERANCE_MS);
+          if (it == m_cache.end() || it->first > next + TOLERANCE_MS)
+            time = next;
+        }
+        if (time < 0)
+          break;
+
+        params = m_params;
+        version = m_version;
+      }
+
+      std::shared_ptr<SFrame> frame = Render(params, time);
+      if (!frame)
+        break;
+
+      // the request may have moved on while rendering, the next round will tell
+      CSingleLock lock(m_cacheSection);
+      if (params == m_params && version == m_version && time >= DVD_TIME_TO_MSEC(m_lastPts))
+        m_cache[time] = frame;
+    }
+  }
 }
 
 ASS_Event* CDVDSubtitlesLibass::GetEvents()
@@ -10,17 +10,40 @@
 
 #include "DVDResource.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <vector>
 
 #include <ass/ass.h>
 
 /** Wrapper for Libass **/
 
-class CDVDSubtitlesLibass : public IDVDResourceCounted<CDVDSubtitlesLibass>
+/*!
+ * \brief Rendering of ASS subtitles with a look-ahead cache
+ *
+ * Once subtitles are rendered for a video frame, a worker thread renders the
+ * subtitles of the next frames with the same frame and video size, so heavily
+ * typeset subtitles don't cost the render thread a libass pass per frame.
+ * The images of a pass are copied into a cached frame; when libass reports no
+ * change against the previous pass the previous frame is reused, which also
+ * lets the overlay renderer keep its texture.
+ */
+class CDVDSubtitlesLibass : public IDVDResourceCounted<CDVDSubtitlesLibass>, private CThread
 {
 public:
   CDVDSubtitlesLibass();
   ~CDVDSubtitlesLibass() override;
 
+  /*!
+   * \brief Get the subtitle images at a time
+   *
+   * The images stay valid until the next call. changes is 0 if the images
+   * are the ones of the previous call.
+   */
   ASS_Image* RenderImage(int frameWidth, int frameHeight, int videoWidth, int videoHeight, int sourceWidth, int sourceHeight,
                          double pts, int useMargin = 0, double position = 0.0, int* changes = NULL);
   ASS_Event* GetEvents();
@@ -31,10 +54,56 @@ public:
   bool DecodeDemuxPkt(const char* data, int size, double start, double duration);
   bool CreateTrack(char* buf, size_t size);
 
+protected:
+  void Process() override;
+
 private:
+  struct SRenderParams
+  {
+    bool operator==(const SRenderParams& right) const;
+    bool operator!=(const SRenderParams& right) const { return !(*this == right); }
+
+    int frameWidth = 0;
+    int frameHeight = 0;
+    int videoWidth = 0;
+    int videoHeight = 0;
+    int sourceWidth = 0;
+    int sourceHeight = 0;
+    int useMargin = 0;
+    double position = 0.0;
+  };
+
+  /*!
+   * \brief Copy of the image list of a libass pass
+   */
+  struct SFrame
+  {
+    std::vector<ASS_Image> images;
+    std::vector<unsigned char> bitmaps;
+  };
+
+  std::shared_ptr<SFrame> Render(const SRenderParams& params, int64_t time);
+  void ClearCache(int64_t from);
+
   ASS_Library* m_library = nullptr;
   ASS_Track* m_track = nullptr;
   ASS_Renderer* m_renderer = nullptr;
   CCriticalSection m_section;
+
+  // protected by m_section, the last libass pass
+  SRenderParams m_renderedParams;
+  std::shared_ptr<SFrame> m_renderedFrame;
+
+  // look-ahead, protected by m_cacheSection
+  CCriticalSection m_cacheSection;
+  SRenderParams m_params;
+  std::map<int64_t, std::shared_ptr<SFrame>> m_cache;
+  std::shared_ptr<SFrame> m_current;
+  unsigned int m_version = 0; // changes when the track changes
+  double m_lastPts = 0.0;
+  double m_interval = 0.0;
+  unsigned int m_hits = 0;
+  unsigned int m_misses = 0;
+  CEvent m_lookaheadEvent;
 };
 
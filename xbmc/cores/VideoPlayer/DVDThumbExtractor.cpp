@@ -0,0 +1,276 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDThumbExtractor.h"
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "TextureCache.h"
+#include "URL.h"
+#include "pictures/Picture.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/log.h"
+
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodec.h"
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "Process/ProcessInfo.h"
+
+#include <algorithm>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+}
+
+namespace
+{
+int DegreeToOrientation(int degrees)
+{
+  switch (degrees)
+  {
+    case 90:
+      return 5;
+    case 180:
+      return 2;
+    case 270:
+      return 7;
+    default:
+      return 0;
+  }
+}
+} // namespace
+
+CDVDThumbExtractor::CDVDThumbExtractor() = default;
+
+CDVDThumbExtractor::~CDVDThumbExtractor()
+{
+  Close();
+  CloseCodec();
+}
+
+bool CDVDThumbExtractor::Open(const CFileItem& fileItem)
+{
+  Close();
+
+  m_redactPath = CURL::GetRedacted(fileItem.GetPath());
+
+  CFileItem item(fileItem);
+  item.SetMimeTypeForInternetFile();
+  m_inputStream = CDVDFactoryInputStream::CreateInputStream(nullptr, item);
+  if (!m_inputStream)
+  {
+    CLog::Log(LOGERROR, "InputStream: Error creating stream for %s", m_redactPath.c_str());
+    return false;
+  }
+
+  if (!m_inputStream->Open())
+  {
+    CLog::Log(LOGERROR, "InputStream: Error opening, %s", m_redactPath.c_str());
+    m_inputStream.reset();
+    return false;
+  }
+
+  try
+  {
+    m_demuxer.reset(CDVDFactoryDemuxer::CreateDemuxer(m_inputStream, true));
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - Exception thrown when opening demuxer", __FUNCTION__);
+  }
+
+  if (!m_demuxer)
+  {
+    CLog::Log(LOGERROR, "%s - Error creating demuxer", __FUNCTION__);
+    m_inputStream.reset();
+    return false;
+  }
+
+  return true;
+}
+
+void CDVDThumbExtractor::Close()
+{
+  m_demuxer.reset();
+  m_inputStream.reset();
+  m_videoStream = -1;
+  m_demuxerId = -1;
+  m_streamSelected = false;
+}
+
+int CDVDThumbExtractor::GetStreamLength() const
+{
+  return m_demuxer ? m_demuxer->GetStreamLength() : 0;
+}
+
+int CDVDThumbExtractor::GetChapterCount() const
+{
+  return m_demuxer ? m_demuxer->GetChapterCount() : 0;
+}
+
+int64_t CDVDThumbExtractor::GetChapterPos(int chapter) const
+{
+  return m_demuxer ? m_demuxer->GetChapterPos(chapter) * 1000 : 0;
+}
+
+bool CDVDThumbExtractor::OpenCodec()
+{
+  CDVDStreamInfo hint(*m_demuxer->GetStream(m_demuxerId, m_videoStream), true);
+  hint.codecOptions = CODEC_FORCE_SOFTWARE;
+
+  // the ids of the stream don't matter to the decoder
+  if (m_codec && m_hints.Equal(hint, CDVDStreamInfo::COMPARE_EXTRADATA))
+  {
+    m_codec->Reset();
+    return true;
+  }
+
+  CloseCodec();
+
+  m_processInfo.reset(CProcessInfo::CreateInstance());
+  std::vector<AVPixelFormat> pixFmts;
+  pixFmts.push_back(AV_PIX_FMT_YUV420P);
+  m_processInfo->SetPixFormats(pixFmts);
+
+  m_codec.reset(CDVDFactoryCodec::CreateVideoCodec(hint, *m_processInfo));
+  if (!m_codec)
+    return false;
+
+  m_codec->SetCodecControl(DVD_CODEC_CTRL_KEYFRAMES);
+  m_hints.Assign(hint, true);
+  return true;
+}
+
+void CDVDThumbExtractor::CloseCodec()
+{
+  m_codec.reset();
+  m_processInfo.reset();
+  m_hints.Clear();
+  sws_freeContext(m_swsContext);
+  m_swsContext = nullptr;
+}
+
+bool CDVDThumbExtractor::Extract(int64_t pos, CTextureDetails& details)
+{
+  m_packetsTried = 0;
+  if (!m_demuxer)
+    return false;
+
+  if (!m_streamSelected)
+  {
+    m_streamSelected = true;
+    for (CDemuxStream* pStream : m_demuxer->GetStreams())
+    {
+      if (pStream)
+      {
+        // ignore if it's a picture attachment (e.g. jpeg artwork)
+        if (pStream->type == STREAM_VIDEO && !(pStream->flags & AV_DISPOSITION_ATTACHED_PIC))
+        {
+          m_videoStream = pStream->uniqueId;
+          m_demuxerId = pStream->demuxerId;
+        }
+        else
+          m_demuxer->EnableStream(pStream->demuxerId, pStream->uniqueId, false);
+      }
+    }
+
+    if (m_videoStream != -1 && !OpenCodec())
+      m_videoStream = -1;
+  }
+  else if (m_videoStream != -1)
+    m_codec->Reset();
+
+  if (m_videoStream == -1)
+    return false;
+
+  int nTotalLen = m_demuxer->GetStreamLength();
+  int64_t nSeekTo = (pos == -1) ? nTotalLen / 3 : pos;
+
+  CLog::Log(LOGDEBUG, "%s - seeking to pos %lldms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, m_redactPath.c_str());
+  if (!m_demuxer->SeekTime(static_cast<double>(nSeekTo), true))
+    return false;
+
+  CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
+  VideoPicture picture = {};
+
+  // num streams * 160 frames, should get a valid frame, if not abort.
+  int abort_index = m_demuxer->GetNrOfStreams() * 160;
+  do
+  {
+    DemuxPacket* pPacket = m_demuxer->Read();
+    m_packetsTried++;
+
+    if (!pPacket)
+      break;
+
+    if (pPacket->iStreamId != m_videoStream)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+      continue;
+    }
+
+    m_codec->AddData(*pPacket);
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+    iDecoderState = CDVDVideoCodec::VC_NONE;
+    while (iDecoderState == CDVDVideoCodec::VC_NONE)
+    {
+      iDecoderState = m_codec->GetPicture(&picture);
+    }
+
+    if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
+    {
+      if (!(picture.iFlags & DVP_FLAG_DROPPED))
+        break;
+    }
+
+  } while (abort_index--);
+
+  if (iDecoderState != CDVDVideoCodec::VC_PICTURE || (picture.iFlags & DVP_FLAG_DROPPED))
+  {
+    CLog::Log(LOGDEBUG, "%s - decode failed in %s after %d packets.", __FUNCTION__, m_redactPath.c_str(), m_packetsTried);
+    return false;
+  }
+
+  unsigned int nWidth = std::min(picture.iDisplayWidth, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
+  double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+  if (m_hints.forced_aspect && m_hints.aspect != 0)
+    aspect = m_hints.aspect;
+  unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
+
+  m_swsContext = sws_getCachedContext(m_swsContext, picture.iWidth, picture.iHeight, AV_PIX_FMT_YUV420P,
+                                      nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+  if (!m_swsContext)
+    return false;
+
+  uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
+  uint8_t *planes[YuvImage::MAX_PLANES];
+  int stride[YuvImage::MAX_PLANES];
+  picture.videoBuffer->GetPlanes(planes);
+  picture.videoBuffer->GetStrides(stride);
+  uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
+  int srcStride[] = { stride[0], stride[1], stride[2], 0 };
+  uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+  int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
+  int orientation = DegreeToOrientation(m_hints.orientation);
+  sws_scale(m_swsContext, src, srcStride, 0, picture.iHeight, dst, dstStride);
+
+  details.width = nWidth;
+  details.height = nHeight;
+  CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
+  av_free(pOutBuf);
+
+  return true;
+}
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "DVDStreamInfo.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+class CDVDDemux;
+class CDVDInputStream;
+class CDVDVideoCodec;
+class CFileItem;
+class CProcessInfo;
+class CTextureDetails;
+struct SwsContext;
+
+/*!
+ * \brief Extracts thumbnails from video files, reusable across files
+ *
+ * The decoder and the scaler are kept when the next file is opened and only
+ * recreated if the video stream differs, so extracting from many files of the
+ * same kind, e.g. recordings, skips the decoder setup. Only key frames are
+ * decoded, starting at the key frame before the requested position.
+ *
+ * An instance must not be used by more than one thread at a time.
+ */
+class CDVDThumbExtractor
+{
+public:
+  CDVDThumbExtractor();
+  ~CDVDThumbExtractor();
+
+  /*!
+   * \brief Open the input stream and demuxer of a file, closes the previous one
+   */
+  bool Open(const CFileItem& item);
+
+  /*!
+   * \brief Close the file, the decoder and the scaler are kept
+   */
+  void Close();
+
+  std::shared_ptr<CDVDInputStream> GetInputStream() const { return m_inputStream; }
+  CDVDDemux* GetDemuxer() const { return m_demuxer.get(); }
+
+  /*!
+   * \brief Length of the opened file in ms
+   */
+  int GetStreamLength() const;
+
+  int GetChapterCount() const;
+
+  /*!
+   * \brief Start of a chapter in ms, chapters are counted from 1
+   */
+  int64_t GetChapterPos(int chapter) const;
+
+  /*!
+   * \brief Decode the key frame at or before a position and cache it
+   *
+   * \param pos Position in ms, -1 for a third of the length
+   * \param[in,out] details The cache file to write to, width and height are set
+   * \return True if a thumbnail was written
+   */
+  bool Extract(int64_t pos, CTextureDetails& details);
+
+  /*!
+   * \brief Number of packets read by the last Extract call
+   */
+  int GetPacketsTried() const { return m_packetsTried; }
+
+private:
+  CDVDThumbExtractor(const CDVDThumbExtractor&) = delete;
+  CDVDThumbExtractor& operator=(const CDVDThumbExtractor&) = delete;
+
+  bool OpenCodec();
+  void CloseCodec();
+
+  std::string m_redactPath;
+  std::shared_ptr<CDVDInputStream> m_inputStream;
+  std::unique_ptr<CDVDDemux> m_demuxer;
+  int m_videoStream = -1;
+  int64_t m_demuxerId = -1;
+  bool m_streamSelected = false;
+  int m_packetsTried = 0;
+
+  // kept across files
+  std::unique_ptr<CProcessInfo> m_processInfo;
+  std::unique_ptr<CDVDVideoCodec> m_codec;
+  CDVDStreamInfo m_hints;
+  SwsContext* m_swsContext = nullptr;
+};
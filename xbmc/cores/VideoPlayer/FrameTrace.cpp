@@ -0,0 +1,234 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FrameTrace.h"
+
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "filesystem/File.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <map>
+
+const unsigned int CFrameTrace::RING_SIZE;
+std::atomic<bool> CFrameTrace::m_enabled{false};
+
+namespace
+{
+const char* STAGE_NAMES[] = {"demux", "decoder_in", "decoder_out",
+                             "add_picture", "prepare_render", "present"};
+
+static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) ==
+                  static_cast<size_t>(FrameTraceStage::MAX),
+              "missing stage name");
+
+CVariant MakeEvent(const char* name, const char* phase, double ts, FrameTraceStage stage)
+{
+  CVariant event(CVariant::VariantTypeObject);
+  event["name"] = name;
+  event["cat"] = "frame";
+  event["ph"] = phase;
+  event["ts"] = ts;
+  event["pid"] = 1;
+  event["tid"] = static_cast<int>(stage) + 1;
+  return event;
+}
+} // namespace
+
+CFrameTrace& CFrameTrace::GetInstance()
+{
+  static CFrameTrace instance;
+  return instance;
+}
+
+void CFrameTrace::Start()
+{
+  m_enabled.store(false, std::memory_order_release);
+
+  if (!m_slots)
+    m_slots.reset(new Slot[RING_SIZE]);
+
+  for (unsigned int i = 0; i < RING_SIZE; i++)
+    m_slots[i].sequence.store(0, std::memory_order_relaxed);
+  m_writeIndex.store(0, std::memory_order_relaxed);
+
+  m_enabled.store(true, std::memory_order_release);
+
+  CLog::Log(LOGINFO, "CFrameTrace::Start - tracing %u events", RING_SIZE);
+}
+
+void CFrameTrace::Stop()
+{
+  m_enabled.store(false, std::memory_order_release);
+
+  CLog::Log(LOGINFO, "CFrameTrace::Stop - recorded %" PRIu64 " events",
+            m_writeIndex.load(std::memory_order_relaxed));
+}
+
+void CFrameTrace::Record(FrameTraceStage stage, double pts)
+{
+  if (pts == DVD_NOPTS_VALUE || !m_slots)
+    return;
+
+  const int64_t time = CurrentHostCounter();
+  const uint64_t index = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = m_slots[index & (RING_SIZE - 1)];
+
+  slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.time.store(time, std::memory_order_relaxed);
+  slot.id.store(static_cast<int64_t>(pts), std::memory_order_relaxed);
+  slot.stage.store(static_cast<int>(stage), std::memory_order_relaxed);
+  slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+std::vector<FrameTraceEvent> CFrameTrace::GetEvents() const
+{
+  std::vector<FrameTraceEvent> events;
+  if (!m_slots)
+    return events;
+
+  const uint64_t end = m_writeIndex.load(std::memory_order_acquire);
+  const uint64_t begin = end > RING_SIZE ? end - RING_SIZE : 0;
+  events.reserve(end - begin);
+
+  for (uint64_t index = begin; index < end; index++)
+  {
+    const Slot& slot = m_slots[index & (RING_SIZE - 1)];
+
+    // skip slots that are being written or were overwritten meanwhile
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != 2 * index + 2)
+      continue;
+
+    FrameTraceEvent event;
+    event.time = slot.time.load(std::memory_order_relaxed);
+    event.id = slot.id.load(std::memory_order_relaxed);
+    event.stage = static_cast<FrameTraceStage>(slot.stage.load(std::memory_order_relaxed));
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+      continue;
+
+    events.push_back(event);
+  }
+
+  // the write index is taken before the time, so threads may race slightly
+  std::stable_sort(events.begin(), events.end(),
+                   [](const FrameTraceEvent& a, const FrameTraceEvent& b) { return a.time < b.time; });
+
+  return events;
+}
+
+bool CFrameTrace::Export(std::string& json, bool compact) const
+{
+  const std::vector<FrameTraceEvent> events = GetEvents();
+  const double frequency = static_cast<double>(CurrentHostFrequency());
+  const int64_t start = events.empty() ? 0 : events.front().time;
+  auto toMicroseconds = [start, frequency](int64_t time) {
+    return (time - start) * 1000000.0 / frequency;
+  };
+
+  CVariant trace(CVariant::VariantTypeObject);
+  trace["displayTimeUnit"] = "ms";
+  CVariant& traceEvents = trace["traceEvents"];
+  traceEvents = CVariant(CVariant::VariantTypeArray);
+
+  for (int i = 0; i < static_cast<int>(FrameTraceStage::MAX); i++)
+  {
+    const FrameTraceStage stage = static_cast<FrameTraceStage>(i);
+    CVariant name = MakeEvent("thread_name", "M", 0, stage);
+    name["args"]["name"] = GetStageName(stage);
+    traceEvents.push_back(name);
+  }
+
+  // a pts can show up again after a seek, so a frame ends as soon as a stage
+  // is seen that does not follow the last one
+  struct Frame
+  {
+    int64_t id;
+    std::vector<const FrameTraceEvent*> events;
+  };
+  std::vector<Frame> frames;
+  std::map<int64_t, size_t> open;
+
+  for (const auto& event : events)
+  {
+    auto it = open.find(event.id);
+    if (it == open.end() || frames[it->second].events.back()->stage > event.stage)
+    {
+      frames.push_back(Frame{event.id, {}});
+      open[event.id] = frames.size() - 1;
+      it = open.find(event.id);
+    }
+    frames[it->second].events.push_back(&event);
+
+    CVariant instant = MakeEvent(GetStageName(event.stage), "i", toMicroseconds(event.time),
+                                 event.stage);
+    instant["s"] = "t";
+    instant["args"]["pts"] = event.id / static_cast<double>(DVD_TIME_BASE);
+    traceEvents.push_back(instant);
+  }
+
+  for (size_t i = 0; i < frames.size(); i++)
+  {
+    const Frame& frame = frames[i];
+    const FrameTraceEvent* first = frame.events.front();
+    const FrameTraceEvent* last = frame.events.back();
+    const std::string id = std::to_string(i);
+
+    CVariant begin = MakeEvent("frame", "b", toMicroseconds(first->time), first->stage);
+    begin["id"] = id;
+    begin["args"]["pts"] = frame.id / static_cast<double>(DVD_TIME_BASE);
+    traceEvents.push_back(begin);
+
+    for (const auto event : frame.events)
+    {
+      CVariant step = MakeEvent(GetStageName(event->stage), "n", toMicroseconds(event->time),
+                                event->stage);
+      step["id"] = id;
+      traceEvents.push_back(step);
+    }
+
+    CVariant end = MakeEvent("frame", "e", toMicroseconds(last->time), last->stage);
+    end["id"] = id;
+    end["args"]["latency_ms"] = (last->time - first->time) * 1000.0 / frequency;
+    traceEvents.push_back(end);
+  }
+
+  return CJSONVariantWriter::Write(trace, json, compact);
+}
+
+bool CFrameTrace::Export(const std::string& path) const
+{
+  std::string json;
+  if (!Export(json, true))
+    return false;
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) ||
+      file.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CFrameTrace::Export - failed to write %s", path.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGINFO, "CFrameTrace::Export - wrote frame trace to %s", path.c_str());
+  return true;
+}
+
+const char* CFrameTrace::GetStageName(FrameTraceStage stage)
+{
+  if (stage < FrameTraceStage::DEMUX || stage >= FrameTraceStage::MAX)
+    return "unknown";
+  return STAGE_NAMES[static_cast<int>(stage)];
+}
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+enum class FrameTraceStage
+{
+  DEMUX = 0,
+  DECODER_IN,
+  DECODER_OUT,
+  ADD_PICTURE,
+  PREPARE_RENDER,
+  PRESENT,
+  MAX
+};
+
+struct FrameTraceEvent
+{
+  int64_t time; // host counter
+  int64_t id; // pts of the frame in DVD time units
+  FrameTraceStage stage;
+};
+
+/*!
+ * \brief Records the way of each video frame through the player
+ *
+ * Events are keyed by the pts of the frame, which is the only identifier
+ * that is carried from the demux packet through the decoder to the render
+ * buffer. They are written to a fixed size ring without taking locks, older
+ * events are overwritten when it is full. While tracing is stopped, a trace
+ * point costs a single atomic load.
+ *
+ * Started, stopped and exported with the FrameTrace() builtin. The export
+ * is Chrome trace event JSON, open it in chrome://tracing or Perfetto.
+ */
+class CFrameTrace
+{
+public:
+  static CFrameTrace& GetInstance();
+
+  static bool IsEnabled() { return m_enabled.load(std::memory_order_acquire); }
+
+  /*!
+   * \brief Record a stage of a frame if tracing is enabled
+   */
+  static void Trace(FrameTraceStage stage, double pts)
+  {
+    if (IsEnabled())
+      GetInstance().Record(stage, pts);
+  }
+
+  /*!
+   * \brief Clear the ring and start recording
+   */
+  void Start();
+  void Stop();
+
+  void Record(FrameTraceStage stage, double pts);
+
+  /*!
+   * \brief Get the events currently in the ring, oldest first
+   */
+  std::vector<FrameTraceEvent> GetEvents() const;
+
+  /*!
+   * \brief Write the events in Chrome trace event format
+   *
+   * Every stage gets its own track, and each frame is an async slice from its
+   * first to its last recorded stage.
+   */
+  bool Export(const std::string& path) const;
+  bool Export(std::string& json, bool compact) const;
+
+  static const char* GetStageName(FrameTraceStage stage);
+
+  static const unsigned int RING_SIZE = 1 << 16;
+
+private:
+  CFrameTrace() = default;
+  CFrameTrace(const CFrameTrace&) = delete;
+  CFrameTrace& operator=(const CFrameTrace&) = delete;
+
+  struct Slot
+  {
+    std::atomic<uint64_t> sequence; // 2 * index + 1 while written, 2 * index + 2 when done
+    std::atomic<int64_t> time;
+    std::atomic<int64_t> id;
+    std::atomic<int> stage;
+  };
+
+  static std::atomic<bool> m_enabled;
+
+  std::unique_ptr<Slot[]> m_slots;
+  std::atomic<uint64_t> m_writeIndex{0};
+};
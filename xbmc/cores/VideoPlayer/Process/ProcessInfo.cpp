@@ -64,6 +64,7 @@ void CProcessInfo::ResetVideoCodecInfo()
 
   m_videoIsHWDecoder = false;
   m_videoDecoderName = "unknown";
+  m_videoDecoderThreading.clear();
   m_videoDeintMethod = "unknown";
   m_videoPixelFormat = "unknown";
   m_videoStereoMode.clear();
@@ -80,6 +81,7 @@ void CProcessInfo::ResetVideoCodecInfo()
   if (m_dataCache)
   {
     m_dataCache->SetVideoDecoderName(m_videoDecoderName, m_videoIsHWDecoder);
+    m_dataCache->SetVideoDecoderThreading(m_videoDecoderThreading);
     m_dataCache->SetVideoDeintMethod(m_videoDeintMethod);
     m_dataCache->SetVideoPixelFormat(m_videoPixelFormat);
     m_dataCache->SetVideoDimensions(m_videoWidth, m_videoHeight);
@@ -108,6 +110,23 @@ std::string CProcessInfo::GetVideoDecoderName()
   return m_videoDecoderName;
 }
 
+void CProcessInfo::SetVideoDecoderThreading(const std::string &threading)
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  m_videoDecoderThreading = threading;
+
+  if (m_dataCache)
+    m_dataCache->SetVideoDecoderThreading(m_videoDecoderThreading);
+}
+
+std::string CProcessInfo::GetVideoDecoderThreading()
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  return m_videoDecoderThreading;
+}
+
 bool CProcessInfo::IsVideoHwDecoder()
 {
   CSingleLock lock(m_videoCodecSection);
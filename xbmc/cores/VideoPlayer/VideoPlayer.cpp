@@ -23,8 +23,11 @@
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
 #include "DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "DVDDemuxers/DemuxProbeCache.h"
+#include "DVDDemuxers/KeyframeIndexJob.h"
 
 #include "DVDFileInfo.h"
+#include "FrameTrace.h"
 
 #include "utils/LangCodeExpander.h"
 #include "input/Key.h"
@@ -853,6 +856,16 @@ bool CVideoPlayer::OpenDemuxStream()
 
   m_offset_pts = 0;
 
+  // index the keyframes of the whole file in the background, so that seeking
+  // doesn't depend on which parts were played before
+  CDVDDemuxFFmpeg* demuxer = dynamic_cast<CDVDDemuxFFmpeg*>(m_pDemuxer);
+  if (demuxer && demuxer->HasKeyframeIndex() && !demuxer->HasCompleteKeyframeIndex() &&
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoKeyframeIndexScan)
+  {
+    const CFileItem item(m_pInputStream->GetFileName(), false);
+    CJobManager::GetInstance().AddJob(new CKeyframeIndexJob(item), nullptr, CJob::PRIORITY_LOW);
+  }
+
   return true;
 }
 
@@ -1195,6 +1208,13 @@ void CVideoPlayer::Prepare()
   m_CurrentAudio.lastdts = DVD_NOPTS_VALUE;
   m_CurrentVideo.lastdts = DVD_NOPTS_VALUE;
 
+  {
+    CSingleLock lock(m_StateSection);
+    m_openTime = XbmcThreads::SystemClockMillis();
+    m_timeToFirstFrame = 0;
+    m_probeCached = false;
+  }
+
   IPlayerCallback *cb = &m_callback;
   CFileItem fileItem = m_item;
   m_outboundEvents->Submit([=]() {
@@ -1661,6 +1681,9 @@ void CVideoPlayer::ProcessVideoData(CDemuxStream* pStream, DemuxPacket* pPacket)
   if (CheckSceneSkip(m_CurrentVideo))
     drop = true;
 
+  CFrameTrace::Trace(FrameTraceStage::DEMUX,
+                     pPacket->pts != DVD_NOPTS_VALUE ? pPacket->pts : pPacket->dts);
+
   m_VideoPlayerVideo->SendMessage(new CDVDMsgDemuxerPacket(pPacket, drop));
   m_CurrentVideo.packets++;
 }
@@ -1997,6 +2020,8 @@ void CVideoPlayer::HandlePlaySpeed()
           cb->OnAVStarted(fileItem);
         });
         m_State.streamsReady = true;
+
+        UpdateTimeToFirstFrame();
       }
     }
     else
@@ -2496,6 +2521,13 @@ void CVideoPlayer::HandleMessages()
       m_item = msg.GetItem();
       m_playerOptions = msg.GetOptions();
 
+      {
+        CSingleLock lock(m_StateSection);
+        m_openTime = XbmcThreads::SystemClockMillis();
+        m_timeToFirstFrame = 0;
+        m_probeCached = false;
+      }
+
       m_processInfo->SetPlayTimes(0,0,0,0);
 
       m_outboundEvents->Submit([this]() {
@@ -3163,12 +3195,37 @@ void CVideoPlayer::GetGeneralInfo(std::string& strGeneralInfo)
         strBuf += StringUtils::Format(" %d msec", DVD_TIME_TO_MSEC(m_State.cache_delay));
     }
 
+    if (m_timeToFirstFrame > 0)
+    {
+      const DemuxProbeCacheStats stats = CDemuxProbeCache::GetInstance().GetStats();
+      strBuf += StringUtils::Format(" start:%u ms%s (avg cached:%u ms uncached:%u ms)",
+                                    m_timeToFirstFrame, m_probeCached ? " cached" : "",
+                                    stats.avgTimeToFirstFrameCachedMs,
+                                    stats.avgTimeToFirstFrameUncachedMs);
+    }
+
     strGeneralInfo = StringUtils::Format("Player: a/v:% 6.3f, %s"
                                          , dDiff
                                          , strBuf.c_str());
   }
 }
 
+void CVideoPlayer::UpdateTimeToFirstFrame()
+{
+  // the probe cache only applies to files opened by the ffmpeg demuxer
+  CDVDDemuxFFmpeg* demuxer = dynamic_cast<CDVDDemuxFFmpeg*>(m_pDemuxer);
+
+  CSingleLock lock(m_StateSection);
+  m_timeToFirstFrame = XbmcThreads::SystemClockMillis() - m_openTime;
+  m_probeCached = demuxer && demuxer->IsProbeCached();
+
+  CLog::Log(LOGDEBUG, "CVideoPlayer::UpdateTimeToFirstFrame - first frame after %u ms%s",
+            m_timeToFirstFrame, m_probeCached ? " (cached probe)" : "");
+
+  if (demuxer && m_pInputStream && m_pInputStream->IsStreamType(DVDSTREAM_TYPE_FILE))
+    CDemuxProbeCache::GetInstance().AddTimeToFirstFrame(m_probeCached, m_timeToFirstFrame);
+}
+
 void CVideoPlayer::SeekPercentage(float iPercent)
 {
   int64_t iTotalTime = m_processInfo->GetMaxTime();
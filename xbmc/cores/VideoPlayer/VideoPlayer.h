@@ -428,6 +428,7 @@ protected:
 
   void UpdatePlayState(double timeout);
   void GetGeneralInfo(std::string& strVideoInfo);
+  void UpdateTimeToFirstFrame();
   int64_t GetUpdatedTime();
   int64_t GetTime();
   float GetPercentage();
@@ -448,6 +449,11 @@ protected:
   ECacheState  m_caching;
   XbmcThreads::EndTime m_cachingTimer;
 
+  // time from opening the file to the first frame, protected by m_StateSection
+  unsigned int m_openTime = 0;
+  unsigned int m_timeToFirstFrame = 0;
+  bool m_probeCached = false;
+
   std::unique_ptr<CProcessInfo> m_processInfo;
 
   CCurrentStream m_CurrentAudio;
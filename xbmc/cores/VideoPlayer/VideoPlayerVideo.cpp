@@ -11,6 +11,7 @@
 #include "DVDCodecs/DVDCodecUtils.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "FrameTrace.h"
 #include "ServiceBroker.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
@@ -559,6 +560,9 @@ void CVideoPlayerVideo::Process()
         codecControl |= DVD_CODEC_CTRL_ROTATE;
       m_pVideoCodec->SetCodecControl(codecControl);
 
+      CFrameTrace::Trace(FrameTraceStage::DECODER_IN,
+                         pPacket->pts != DVD_NOPTS_VALUE ? pPacket->pts : pPacket->dts);
+
       if (m_pVideoCodec->AddData(*pPacket))
       {
         // buffer packets so we can recover should decoder flush for some reason
@@ -726,6 +730,8 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
     if (m_speed != 0)
       pts += m_picture.iDuration * m_speed / abs(m_speed);
 
+    CFrameTrace::Trace(FrameTraceStage::DECODER_OUT, m_picture.pts);
+
     m_outputSate = OutputPicture(&m_picture);
 
     if (m_outputSate == OUTPUT_AGAIN)
@@ -945,6 +951,10 @@ std::string CVideoPlayerVideo::GetPlayerInfo()
   else
     s << ", pc:none";
 
+  std::string threading = m_processInfo.GetVideoDecoderThreading();
+  if (!threading.empty())
+    s << ", thr:" << threading;
+
   return s.str();
 }
 
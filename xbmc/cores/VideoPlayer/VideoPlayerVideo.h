@@ -71,6 +71,7 @@ public:
   double GetOutputDelay() override; /* returns the expected delay, from that a packet is put in queue */
   std::string GetPlayerInfo() override;
   int GetVideoBitrate() override;
+  int GetDroppedFrames() const { return m_iDroppedFrames; }
   void SetSpeed(int iSpeed) override;
 
   // classes
@@ -94,6 +94,7 @@ CLinuxRendererGL::CPictureBuffer::CPictureBuffer()
   memset(&fields, 0, sizeof(fields));
   memset(&image , 0, sizeof(image));
   memset(&pbo   , 0, sizeof(pbo));
+  memset(&pboPlane, 0, sizeof(pboPlane));
   videoBuffer = nullptr;
   loaded = false;
 }
@@ -289,11 +290,29 @@ void CLinuxRendererGL::AddVideoPicture(const VideoPicture &picture, int index)
   buf.lightMetadata = picture.lightMetadata;
   if (picture.hasLightMetadata && picture.lightMetadata.MaxCLL)
     buf.hasLightMetadata = picture.hasLightMetadata;
+
+  // persistently mapped pbos can be filled right here on the decoder thread,
+  // which leaves only the transfer to the textures to the render thread
+  CSingleLock lock(m_pboLock);
+  if (buf.pboPersistent && !buf.pboFence && buf.videoBuffer->GetFormat() == m_format)
+  {
+    CopyVideoBuffer(buf);
+    buf.pboStaged = true;
+  }
 }
 
 void CLinuxRendererGL::ReleaseBuffer(int idx)
 {
   CPictureBuffer &buf = m_buffers[idx];
+
+  // the transfer is long done by now, make the buffer writable for the next
+  // picture that is added
+  if (buf.pboFence)
+  {
+    CSingleLock lock(m_pboLock);
+    WaitPbo(buf);
+  }
+
   if (buf.videoBuffer)
   {
     buf.videoBuffer->Release();
@@ -949,6 +968,15 @@ void CLinuxRendererGL::LoadShaders(int field)
   }
   else
     m_pboUsed = false;
+
+  m_pboPersistent = false;
+#ifdef GL_MAP_PERSISTENT_BIT
+  if (m_pboUsed && CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_buffer_storage"))
+  {
+    CLog::Log(LOGINFO, "GL: Using GL_ARB_buffer_storage");
+    m_pboPersistent = true;
+  }
+#endif
 }
 
 void CLinuxRendererGL::UnInit()
@@ -1739,6 +1767,8 @@ GLint CLinuxRendererGL::GetInternalFormat(GLint format, int bpp)
 
 bool CLinuxRendererGL::CreateTexture(int index)
 {
+  CSingleLock lock(m_pboLock);
+
   if (m_format == AV_PIX_FMT_NV12)
     return CreateNV12Texture(index);
   else if (m_format == AV_PIX_FMT_YUYV422 ||
@@ -1750,9 +1780,16 @@ bool CLinuxRendererGL::CreateTexture(int index)
 
 void CLinuxRendererGL::DeleteTexture(int index)
 {
+  CSingleLock lock(m_pboLock);
+
   CPictureBuffer& buf = m_buffers[index];
   buf.loaded = false;
 
+  WaitPbo(buf);
+  buf.pboPersistent = false;
+  buf.pboStaged = false;
+  memset(buf.pboPlane, 0, sizeof(buf.pboPlane));
+
   if (m_format == AV_PIX_FMT_NV12)
     DeleteNV12Texture(index);
   else if (m_format == AV_PIX_FMT_YUYV422 ||
@@ -1769,39 +1806,40 @@ bool CLinuxRendererGL::UploadTexture(int index)
 
   bool ret = true;
 
-  if (!m_buffers[index].loaded)
+  CPictureBuffer& buf = m_buffers[index];
+
+  if (!buf.loaded)
   {
     ret = false;
 
-    YuvImage &dst = m_buffers[index].image;
-    YuvImage src;
-    m_buffers[index].videoBuffer->GetPlanes(src.plane);
-    m_buffers[index].videoBuffer->GetStrides(src.stride);
+    // the buffer is queued, so AddVideoPicture is done with it
+    if (!buf.pboStaged)
+    {
+      UnBindPbo(buf);
+      WaitPbo(buf);
+      CopyVideoBuffer(buf);
+    }
+    buf.pboStaged = false;
 
-    UnBindPbo(m_buffers[index]);
+    BindPbo(buf);
 
     if (m_format == AV_PIX_FMT_NV12)
-    {
-      CVideoBuffer::CopyNV12Picture(&dst, &src);
-      BindPbo(m_buffers[index]);
       ret = UploadNV12Texture(index);
-    }
     else if (m_format == AV_PIX_FMT_YUYV422 ||
              m_format == AV_PIX_FMT_UYVY422)
-    {
-      CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
-      BindPbo(m_buffers[index]);
       ret = UploadYUV422PackedTexture(index);
-    }
     else
-    {
-      CVideoBuffer::CopyPicture(&dst, &src);
-      BindPbo(m_buffers[index]);
       ret = UploadYV12Texture(index);
+
+    if (buf.pboPersistent)
+    {
+      // the planes must not be written until the transfer is complete
+      buf.pboFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      UnBindPbo(buf);
     }
 
     if (ret)
-      m_buffers[index].loaded = true;
+      buf.loaded = true;
   }
 
   if (ret)
@@ -1871,12 +1909,11 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
 
     for (int i = 0; i < 3; i++)
     {
-      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo[i]);
-      glBufferData(GL_PIXEL_UNPACK_BUFFER, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW);
-      void* pboPtr = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+      uint8_t* pboPtr = CreatePbo(pbo[i], im.planesize[i]);
       if (pboPtr)
       {
-        im.plane[i] = (uint8_t*) pboPtr + PBO_OFFSET;
+        im.plane[i] = pboPtr + PBO_OFFSET;
+        buf.pboPlane[i] = im.plane[i];
         memset(im.plane[i], 0, im.planesize[i]);
       }
       else
@@ -1907,6 +1944,8 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
       im.plane[i] = new uint8_t[im.planesize[i]];
   }
 
+  buf.pboPersistent = pboSetup && m_pboPersistent;
+
   for(int f = 0;f<MAX_FIELDS;f++)
   {
     for(p = 0;p<YuvImage::MAX_PLANES;p++)
@@ -2177,12 +2216,11 @@ bool CLinuxRendererGL::CreateNV12Texture(int index)
 
     for (int i = 0; i < 2; i++)
     {
-      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo[i]);
-      glBufferData(GL_PIXEL_UNPACK_BUFFER, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW);
-      void* pboPtr = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+      uint8_t* pboPtr = CreatePbo(pbo[i], im.planesize[i]);
       if (pboPtr)
       {
-        im.plane[i] = (uint8_t*)pboPtr + PBO_OFFSET;
+        im.plane[i] = pboPtr + PBO_OFFSET;
+        buf.pboPlane[i] = im.plane[i];
         memset(im.plane[i], 0, im.planesize[i]);
       }
       else
@@ -2213,6 +2251,8 @@ bool CLinuxRendererGL::CreateNV12Texture(int index)
       im.plane[i] = new uint8_t[im.planesize[i]];
   }
 
+  buf.pboPersistent = pboSetup && m_pboPersistent;
+
   for(int f = 0;f<MAX_FIELDS;f++)
   {
     for(int p = 0;p<2;p++)
@@ -2443,12 +2483,11 @@ bool CLinuxRendererGL::CreateYUV422PackedTexture(int index)
     pboSetup = true;
     glGenBuffers(1, pbo);
 
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo[0]);
-    glBufferData(GL_PIXEL_UNPACK_BUFFER, im.planesize[0] + PBO_OFFSET, 0, GL_STREAM_DRAW);
-    void* pboPtr = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+    uint8_t* pboPtr = CreatePbo(pbo[0], im.planesize[0]);
     if (pboPtr)
     {
-      im.plane[0] = (uint8_t*)pboPtr + PBO_OFFSET;
+      im.plane[0] = pboPtr + PBO_OFFSET;
+      buf.pboPlane[0] = im.plane[0];
       memset(im.plane[0], 0, im.planesize[0]);
     }
     else
@@ -2473,6 +2512,8 @@ bool CLinuxRendererGL::CreateYUV422PackedTexture(int index)
     im.plane[0] = new uint8_t[im.planesize[0]];
   }
 
+  buf.pboPersistent = pboSetup && m_pboPersistent;
+
   for(int f = 0;f<MAX_FIELDS;f++)
   {
     if (!glIsTexture(buf.fields[f][0].id))
@@ -2616,6 +2657,17 @@ bool CLinuxRendererGL::Supports(ESCALINGMETHOD method)
 
 void CLinuxRendererGL::BindPbo(CPictureBuffer& buff)
 {
+  if (buff.pboPersistent)
+  {
+    // buffers stay mapped, the planes only have to point into the pbos
+    for (int plane = 0; plane < YuvImage::MAX_PLANES; plane++)
+    {
+      if (buff.pbo[plane])
+        buff.image.plane[plane] = (uint8_t*)PBO_OFFSET;
+    }
+    return;
+  }
+
   bool pbo = false;
   for(int plane = 0; plane < YuvImage::MAX_PLANES; plane++)
   {
@@ -2633,6 +2685,16 @@ void CLinuxRendererGL::BindPbo(CPictureBuffer& buff)
 
 void CLinuxRendererGL::UnBindPbo(CPictureBuffer& buff)
 {
+  if (buff.pboPersistent)
+  {
+    for (int plane = 0; plane < YuvImage::MAX_PLANES; plane++)
+    {
+      if (buff.pbo[plane])
+        buff.image.plane[plane] = buff.pboPlane[plane];
+    }
+    return;
+  }
+
   bool pbo = false;
   for(int plane = 0; plane < YuvImage::MAX_PLANES; plane++)
   {
@@ -2648,6 +2710,54 @@ void CLinuxRendererGL::UnBindPbo(CPictureBuffer& buff)
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 }
 
+uint8_t* CLinuxRendererGL::CreatePbo(GLuint pbo, unsigned int size)
+{
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+
+#ifdef GL_MAP_PERSISTENT_BIT
+  if (m_pboPersistent)
+  {
+    // immutable storage that stays mapped, so that it can be written from
+    // any thread without map/unmap and without orphaning the buffer
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size + PBO_OFFSET, nullptr, flags);
+    return static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size + PBO_OFFSET, flags));
+  }
+#endif
+
+  glBufferData(GL_PIXEL_UNPACK_BUFFER, size + PBO_OFFSET, 0, GL_STREAM_DRAW);
+  return static_cast<uint8_t*>(glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+}
+
+void CLinuxRendererGL::WaitPbo(CPictureBuffer& buff)
+{
+  if (!buff.pboFence)
+    return;
+
+  // 100ms, the transfer usually finished several frames ago
+  if (glClientWaitSync(buff.pboFence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000) == GL_TIMEOUT_EXPIRED)
+    CLog::Log(LOGWARNING, "CLinuxRendererGL::WaitPbo - timeout waiting for texture upload");
+
+  glDeleteSync(buff.pboFence);
+  buff.pboFence = nullptr;
+}
+
+void CLinuxRendererGL::CopyVideoBuffer(CPictureBuffer& buff)
+{
+  YuvImage &dst = buff.image;
+  YuvImage src;
+  buff.videoBuffer->GetPlanes(src.plane);
+  buff.videoBuffer->GetStrides(src.stride);
+
+  if (m_format == AV_PIX_FMT_NV12)
+    CVideoBuffer::CopyNV12Picture(&dst, &src);
+  else if (m_format == AV_PIX_FMT_YUYV422 ||
+           m_format == AV_PIX_FMT_UYVY422)
+    CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
+  else
+    CVideoBuffer::CopyPicture(&dst, &src);
+}
+
 CRenderInfo CLinuxRendererGL::GetRenderInfo()
 {
   CRenderInfo info;
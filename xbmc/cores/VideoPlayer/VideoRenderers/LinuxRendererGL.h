@@ -20,6 +20,7 @@
 #include "windowing/GraphicContext.h"
 #include "BaseRenderer.h"
 #include "ColorManager.h"
+#include "threads/CriticalSection.h"
 #include "threads/Event.h"
 #include "VideoShaders/ShaderFormats.h"
 #include "utils/Geometry.h"
@@ -136,6 +137,9 @@ protected:
 
   void BindPbo(CPictureBuffer& buff);
   void UnBindPbo(CPictureBuffer& buff);
+  uint8_t* CreatePbo(GLuint pbo, unsigned int size);
+  void WaitPbo(CPictureBuffer& buff);
+  void CopyVideoBuffer(CPictureBuffer& buff);
   void LoadPlane(CYuvPlane& plane, int type,
                  unsigned width,  unsigned height,
                  int stride, int bpp, void* data);
@@ -190,6 +194,10 @@ protected:
     CYuvPlane fields[MAX_FIELDS][YuvImage::MAX_PLANES];
     YuvImage image;
     GLuint pbo[3]; // one pbo for 3 planes
+    uint8_t* pboPlane[3]; // mapping of the planes if the pbos are persistent
+    bool pboPersistent = false;
+    bool pboStaged = false; // picture was copied to the pbos by AddVideoPicture
+    GLsync pboFence = nullptr; // transfer from the pbos to the textures
 
     CVideoBuffer *videoBuffer;
     bool loaded;
@@ -222,6 +230,8 @@ protected:
   float m_clearColour = 0.0f;
   bool m_pboSupported = true;
   bool m_pboUsed = false;
+  bool m_pboPersistent = false;
+  CCriticalSection m_pboLock;
   bool m_nonLinStretch = false;
   bool m_nonLinStretchGui = false;
   float m_pixelRatio = 0.0f;
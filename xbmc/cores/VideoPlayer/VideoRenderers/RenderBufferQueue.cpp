@@ -0,0 +1,191 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "RenderBufferQueue.h"
+
+#include "utils/TimeUtils.h"
+
+const int CRenderBufferQueue::CAPACITY;
+
+namespace
+{
+const int STATE_BITS = 8;
+const uint64_t STATE_MASK = (1 << STATE_BITS) - 1;
+
+unsigned int StateFlag(RenderBufferState state)
+{
+  return 1u << static_cast<unsigned int>(state);
+}
+} // namespace
+
+CRenderBufferQueue::CRenderBufferQueue()
+  : m_sequence(0)
+{
+  for (auto& slot : m_slots)
+    slot.store(Pack(0, RenderBufferState::UNUSED), std::memory_order_relaxed);
+}
+
+uint64_t CRenderBufferQueue::Pack(uint64_t sequence, RenderBufferState state)
+{
+  return (sequence << STATE_BITS) | static_cast<uint64_t>(state);
+}
+
+RenderBufferState CRenderBufferQueue::StateOf(uint64_t slot)
+{
+  return static_cast<RenderBufferState>(slot & STATE_MASK);
+}
+
+void CRenderBufferQueue::Reset(int size, int renderIndex)
+{
+  for (int i = 0; i < CAPACITY; i++)
+  {
+    RenderBufferState state = RenderBufferState::UNUSED;
+    if (i == renderIndex)
+      state = RenderBufferState::RENDERING;
+    else if (i < size)
+      state = RenderBufferState::FREE;
+
+    const uint64_t sequence = m_sequence.fetch_add(1, std::memory_order_relaxed);
+    m_slots[i].store(Pack(sequence, state), std::memory_order_release);
+  }
+}
+
+bool CRenderBufferQueue::Transition(int index, unsigned int fromStates, RenderBufferState to)
+{
+  if (index < 0 || index >= CAPACITY)
+    return false;
+
+  const uint64_t sequence = m_sequence.fetch_add(1, std::memory_order_relaxed);
+  uint64_t slot = m_slots[index].load(std::memory_order_acquire);
+  do
+  {
+    if (!(fromStates & StateFlag(StateOf(slot))))
+      return false;
+  } while (!m_slots[index].compare_exchange_weak(slot, Pack(sequence, to),
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_acquire));
+  return true;
+}
+
+int CRenderBufferQueue::GetFree() const
+{
+  int indices[CAPACITY];
+  if (Get(RenderBufferState::FREE, indices) == 0)
+    return -1;
+  return indices[0];
+}
+
+bool CRenderBufferQueue::Queue(int index)
+{
+  return Transition(index, StateFlag(RenderBufferState::FREE), RenderBufferState::QUEUED);
+}
+
+bool CRenderBufferQueue::Render(int index)
+{
+  return Transition(index, StateFlag(RenderBufferState::QUEUED), RenderBufferState::RENDERING);
+}
+
+bool CRenderBufferQueue::Discard(int index)
+{
+  return Transition(index,
+                    StateFlag(RenderBufferState::QUEUED) | StateFlag(RenderBufferState::RENDERING),
+                    RenderBufferState::DISCARDED);
+}
+
+int CRenderBufferQueue::DiscardQueued()
+{
+  int indices[CAPACITY];
+  const int count = Get(RenderBufferState::QUEUED, indices);
+
+  int discarded = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (Transition(indices[i], StateFlag(RenderBufferState::QUEUED), RenderBufferState::DISCARDED))
+      discarded++;
+  }
+  return discarded;
+}
+
+bool CRenderBufferQueue::Release(int index)
+{
+  return Transition(index, StateFlag(RenderBufferState::DISCARDED), RenderBufferState::FREE);
+}
+
+int CRenderBufferQueue::Get(RenderBufferState state, int (&indices)[CAPACITY]) const
+{
+  uint64_t sequences[CAPACITY];
+  int count = 0;
+
+  for (int i = 0; i < CAPACITY; i++)
+  {
+    const uint64_t slot = m_slots[i].load(std::memory_order_acquire);
+    if (StateOf(slot) != state)
+      continue;
+
+    // insertion sort by sequence, there are only a handful of buffers
+    const uint64_t sequence = slot >> STATE_BITS;
+    int pos = count;
+    while (pos > 0 && sequences[pos - 1] > sequence)
+    {
+      sequences[pos] = sequences[pos - 1];
+      indices[pos] = indices[pos - 1];
+      pos--;
+    }
+    sequences[pos] = sequence;
+    indices[pos] = i;
+    count++;
+  }
+  return count;
+}
+
+int CRenderBufferQueue::Count(RenderBufferState state) const
+{
+  int count = 0;
+  for (const auto& slot : m_slots)
+  {
+    if (StateOf(slot.load(std::memory_order_acquire)) == state)
+      count++;
+  }
+  return count;
+}
+
+CRenderQueueWait::CRenderQueueWait()
+  : m_count(0),
+    m_totalUs(0),
+    m_maxUs(0)
+{
+}
+
+void CRenderQueueWait::Add(int64_t ticks)
+{
+  if (ticks < 0)
+    ticks = 0;
+
+  const uint64_t us = static_cast<uint64_t>(ticks * 1000000 / CurrentHostFrequency());
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_totalUs.fetch_add(us, std::memory_order_relaxed);
+
+  uint64_t max = m_maxUs.load(std::memory_order_relaxed);
+  while (us > max && !m_maxUs.compare_exchange_weak(max, us, std::memory_order_relaxed))
+    ;
+}
+
+void CRenderQueueWait::Reset()
+{
+  m_count = 0;
+  m_totalUs = 0;
+  m_maxUs = 0;
+}
+
+void CRenderQueueWait::Get(unsigned int& count, double& averageMs, double& maxMs) const
+{
+  const uint64_t waits = m_count.load(std::memory_order_relaxed);
+  count = static_cast<unsigned int>(waits);
+  averageMs = waits > 0 ? m_totalUs.load(std::memory_order_relaxed) / 1000.0 / waits : 0.0;
+  maxMs = m_maxUs.load(std::memory_order_relaxed) / 1000.0;
+}
@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+enum class RenderBufferState
+{
+  UNUSED = 0,
+  FREE,
+  QUEUED,
+  RENDERING,
+  DISCARDED
+};
+
+/*!
+ * \brief Lock free queue of the render buffer indices
+ *
+ * Every buffer slot carries its state and a sequence number in a single
+ * atomic word. A buffer moves from one state to the next with a compare and
+ * swap, so the decoder and the render thread never take a lock to hand over
+ * a buffer, and a transition that lost a race, e.g. a frame discarded by the
+ * player while the renderer picks it, simply fails. The sequence number keeps
+ * the free and the queued buffers in the order they entered their state.
+ *
+ * The swap into QUEUED releases and the reads of the render thread acquire,
+ * so data written to a buffer before Queue() is visible to the renderer once
+ * it sees the buffer queued.
+ *
+ * Reset() is not atomic against the other calls, callers serialize it with
+ * Queue().
+ */
+class CRenderBufferQueue
+{
+public:
+  static const int CAPACITY = 8;
+
+  CRenderBufferQueue();
+
+  /*!
+   * \brief Make buffers [0, size) available, all free except the one rendering
+   */
+  void Reset(int size, int renderIndex);
+
+  /*!
+   * \brief The oldest free buffer, -1 if there is none
+   */
+  int GetFree() const;
+
+  /*!
+   * \brief Hand over a free buffer to the renderer
+   * \return False if the buffer was not free anymore, e.g. after a flush
+   */
+  bool Queue(int index);
+
+  /*!
+   * \brief Take over a queued buffer for rendering
+   * \return False if the buffer was discarded in the meantime
+   */
+  bool Render(int index);
+
+  /*!
+   * \brief Discard a queued or rendering buffer
+   */
+  bool Discard(int index);
+
+  /*!
+   * \brief Discard all queued buffers
+   * \return Number of discarded buffers
+   */
+  int DiscardQueued();
+
+  /*!
+   * \brief Return a discarded buffer to the free buffers
+   */
+  bool Release(int index);
+
+  /*!
+   * \brief Buffers in a state, oldest first
+   * \return Number of buffers written to indices
+   */
+  int Get(RenderBufferState state, int (&indices)[CAPACITY]) const;
+
+  int Count(RenderBufferState state) const;
+
+private:
+  bool Transition(int index, unsigned int fromStates, RenderBufferState to);
+
+  static uint64_t Pack(uint64_t sequence, RenderBufferState state);
+  static RenderBufferState StateOf(uint64_t slot);
+
+  std::atomic<uint64_t> m_slots[CAPACITY];
+  std::atomic<uint64_t> m_sequence;
+};
+
+/*!
+ * \brief Wait times of one side of the render queue
+ */
+class CRenderQueueWait
+{
+public:
+  CRenderQueueWait();
+
+  /*!
+   * \brief Add a wait measured with CurrentHostCounter()
+   */
+  void Add(int64_t ticks);
+  void Reset();
+
+  /*!
+   * \brief Number of waits, their average and longest duration in ms
+   */
+  void Get(unsigned int& count, double& averageMs, double& maxMs) const;
+
+private:
+  std::atomic<uint64_t> m_count;
+  std::atomic<uint64_t> m_totalUs;
+  std::atomic<uint64_t> m_maxUs;
+};
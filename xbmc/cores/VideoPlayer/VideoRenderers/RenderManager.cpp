@@ -13,6 +13,7 @@
 #include "RenderFactory.h"
 #include "RenderFlags.h"
 #include "ServiceBroker.h"
+#include "cores/VideoPlayer/FrameTrace.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "messaging/ApplicationMessenger.h"
 #include "settings/AdvancedSettings.h"
@@ -22,6 +23,7 @@
 #include "threads/SingleLock.h"
 #include "utils/MathUtils.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 #include "windowing/GraphicContext.h"
@@ -205,13 +207,12 @@ bool CRenderManager::Configure()
     m_playerPort->UpdateGuiRender(true);
     m_playerPort->UpdateVideoRender(!m_pRenderer->IsGuiLayer());
 
-    m_queued.clear();
-    m_discard.clear();
-    m_free.clear();
     m_presentsource = 0;
     m_presentsourcePast = -1;
-    for (int i=1; i < m_QueueSize; i++)
-      m_free.push_back(i);
+    m_bufferQueue.Reset(m_QueueSize, m_presentsource);
+    m_bufferEvent.Set();
+    m_decoderWait.Reset();
+    m_renderWait.Reset();
 
     m_bRenderGUI = true;
     m_bTriggerUpdateResolution = true;
@@ -298,9 +299,11 @@ void CRenderManager::FrameMove()
     CheckEnableClockSync();
   }
   {
+    const int64_t waitStart = CurrentHostCounter();
     CSingleLock lock2(m_presentlock);
+    m_renderWait.Add(CurrentHostCounter() - waitStart);
 
-    if (m_queued.empty())
+    if (m_bufferQueue.Count(RenderBufferState::QUEUED) == 0)
     {
       m_presentstep = PRESENT_IDLE;
     }
@@ -319,21 +322,23 @@ void CRenderManager::FrameMove()
     }
 
     // release all previous
-    for (std::deque<int>::iterator it = m_discard.begin(); it != m_discard.end(); )
+    int discarded[CRenderBufferQueue::CAPACITY];
+    const int count = m_bufferQueue.Get(RenderBufferState::DISCARDED, discarded);
+    bool released = false;
+    for (int i = 0; i < count; i++)
     {
       // renderer may want to keep the frame for postprocessing
-      if (!m_pRenderer->NeedBuffer(*it) || !m_bRenderGUI)
+      if (!m_pRenderer->NeedBuffer(discarded[i]) || !m_bRenderGUI)
       {
-        m_pRenderer->ReleaseBuffer(*it);
-        m_overlays.Release(*it);
-        m_free.push_back(*it);
-        it = m_discard.erase(it);
+        m_pRenderer->ReleaseBuffer(discarded[i]);
+        m_overlays.Release(discarded[i]);
+        released |= m_bufferQueue.Release(discarded[i]);
       }
-      else
-        ++it;
     }
+    if (released)
+      m_bufferEvent.Set();
 
-    m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
+    UpdateRenderBuffers();
     m_bRenderGUI = true;
   }
 
@@ -391,6 +396,13 @@ void CRenderManager::UnInit()
 
   CSingleLock lock(m_statelock);
 
+  unsigned int decoderWaits, renderWaits;
+  double decoderAvg, decoderMax, renderAvg, renderMax;
+  m_decoderWait.Get(decoderWaits, decoderAvg, decoderMax);
+  m_renderWait.Get(renderWaits, renderAvg, renderMax);
+  CLog::Log(LOGDEBUG, "%s - queue waits decoder: %u avg %.3fms max %.3fms, renderer: %u avg %.3fms max %.3fms",
+            __FUNCTION__, decoderWaits, decoderAvg, decoderMax, renderWaits, renderAvg, renderMax);
+
   m_overlays.Flush();
   m_debugRenderer.Flush();
 
@@ -427,14 +439,11 @@ bool CRenderManager::Flush(bool wait, bool saveBuffers)
 
       if (!m_pRenderer->Flush(saveBuffers))
       {
-        m_queued.clear();
-        m_discard.clear();
-        m_free.clear();
         m_presentsource = 0;
         m_presentsourcePast = -1;
         m_presentstep = PRESENT_IDLE;
-        for (int i = 1; i < m_QueueSize; i++)
-          m_free.push_back(i);
+        m_bufferQueue.Reset(m_QueueSize, m_presentsource);
+        m_bufferEvent.Set();
       }
 
       m_flushEvent.Set();
@@ -726,7 +735,12 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 
       double refreshrate, clockspeed;
       int missedvblanks;
+      unsigned int waits;
+      double decoderAvg, decoderMax, renderAvg, renderMax;
+      m_decoderWait.Get(waits, decoderAvg, decoderMax);
+      m_renderWait.Get(waits, renderAvg, renderMax);
       vsync = StringUtils::Format("VSyncOff: %.1f latency: %.3f  ", m_clockSync.m_syncOffset / 1000, DVD_TIME_TO_MSEC(m_displayLatency) / 1000.0f);
+      vsync += StringUtils::Format("wait dec: %.2f/%.2f ren: %.2f/%.2f  ", decoderAvg, decoderMax, renderAvg, renderMax);
       if (m_dvdClock.GetClockInfo(missedvblanks, clockspeed, refreshrate))
       {
         vsync += StringUtils::Format("VSync: refresh:%.3f missed:%i speed:%.3f%%",
@@ -746,10 +760,14 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 
   SPresent& m = m_Queue[m_presentsource];
 
-  { CSingleLock lock(m_presentlock);
+  { const int64_t waitStart = CurrentHostCounter();
+    CSingleLock lock(m_presentlock);
+    m_renderWait.Add(CurrentHostCounter() - waitStart);
 
     if (m_presentstep == PRESENT_FRAME)
     {
+      CFrameTrace::Trace(FrameTraceStage::PRESENT, m.pts);
+
       if (m.presentmethod == PRESENT_METHOD_BOB)
         m_presentstep = PRESENT_FRAME2;
       else
@@ -760,7 +778,7 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 
     if (m_presentstep == PRESENT_IDLE)
     {
-      if (!m_queued.empty())
+      if (m_bufferQueue.Count(RenderBufferState::QUEUED) > 0)
         m_presentstep = PRESENT_READY;
     }
 
@@ -898,20 +916,15 @@ void CRenderManager::ToggleDebug()
 
 bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::atomic_bool& bStop, EINTERLACEMETHOD deintMethod, bool wait)
 {
-  CSingleLock lock(m_presentlock);
+  // the picture is copied into the renderer without holding m_presentlock,
+  // m_datalock serializes it with flushes, the render thread doesn't take it
+  CSingleLock datalock(m_datalock);
 
-  if (m_free.empty())
+  int index = m_bufferQueue.GetFree();
+  if (index < 0 || !m_pRenderer)
     return false;
 
-  int index = m_free.front();
-
-  {
-    CSingleLock lock(m_datalock);
-    if (!m_pRenderer)
-      return false;
-
-    m_pRenderer->AddVideoPicture(picture, index);
-  }
+  m_pRenderer->AddVideoPicture(picture, index);
 
 
   // set fieldsync if picture is interlaced
@@ -958,9 +971,16 @@ bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::
   m.presentfield = displayField;
   m.presentmethod = presentmethod;
   m.pts = picture.pts;
-  m_queued.push_back(m_free.front());
-  m_free.pop_front();
-  m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
+  CFrameTrace::Trace(FrameTraceStage::ADD_PICTURE, m.pts);
+  if (!m_bufferQueue.Queue(index))
+    return false;
+  datalock.Leave();
+
+  UpdateRenderBuffers();
+
+  const int64_t waitStart = CurrentHostCounter();
+  CSingleLock lock(m_presentlock);
+  m_decoderWait.Add(CurrentHostCounter() - waitStart);
 
   // signal to any waiters to check state
   if (m_presentstep == PRESENT_IDLE)
@@ -993,12 +1013,10 @@ bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::
 
 void CRenderManager::AddOverlay(CDVDOverlay* o, double pts)
 {
-  int idx;
-  { CSingleLock lock(m_presentlock);
-    if (m_free.empty())
-      return;
-    idx = m_free.front();
-  }
+  int idx = m_bufferQueue.GetFree();
+  if (idx < 0)
+    return;
+
   CSingleLock lock(m_datalock);
   m_overlays.AddOverlay(o, pts, idx);
 }
@@ -1023,56 +1041,65 @@ bool CRenderManager::Supports(ESCALINGMETHOD method)
 
 int CRenderManager::WaitForBuffer(volatile std::atomic_bool&bStop, int timeout)
 {
-  CSingleLock lock(m_presentlock);
-
-  // check if gui is active and discard buffer if not
-  // this keeps videoplayer going
-  if (!m_bRenderGUI || !g_application.GetRenderGUI())
   {
-    m_bRenderGUI = false;
-    double presenttime = 0;
-    double clock = m_dvdClock.GetClock();
-    if (!m_queued.empty())
+    CSingleLock lock(m_presentlock);
+
+    // check if gui is active and discard buffer if not
+    // this keeps videoplayer going
+    if (!m_bRenderGUI || !g_application.GetRenderGUI())
     {
-      int idx = m_queued.front();
-      presenttime = m_Queue[idx].pts;
+      m_bRenderGUI = false;
+      double presenttime = 0;
+      double clock = m_dvdClock.GetClock();
+      int queued[CRenderBufferQueue::CAPACITY];
+      if (m_bufferQueue.Get(RenderBufferState::QUEUED, queued) > 0)
+        presenttime = m_Queue[queued[0]].pts;
+      else
+        presenttime = clock + 0.02;
+
+      int sleeptime = static_cast<int>((presenttime - clock) * 1000);
+      if (sleeptime < 0)
+        sleeptime = 0;
+      sleeptime = std::min(sleeptime, 20);
+      m_presentevent.wait(lock, sleeptime);
+      DiscardBuffer();
+      return 0;
     }
-    else
-      presenttime = clock + 0.02;
-
-    int sleeptime = static_cast<int>((presenttime - clock) * 1000);
-    if (sleeptime < 0)
-      sleeptime = 0;
-    sleeptime = std::min(sleeptime, 20);
-    m_presentevent.wait(lock, sleeptime);
-    DiscardBuffer();
-    return 0;
   }
 
   XbmcThreads::EndTime endtime(timeout);
-  while(m_free.empty())
+  int index = m_bufferQueue.GetFree();
+  if (index < 0)
   {
-    m_presentevent.wait(lock, std::min(50, timeout));
-    if (endtime.IsTimePast() || bStop)
+    const int64_t waitStart = CurrentHostCounter();
+    while ((index = m_bufferQueue.GetFree()) < 0)
     {
-      if (timeout != 0 && !bStop)
+      m_bufferEvent.WaitMSec(std::min(50, timeout));
+      if (endtime.IsTimePast() || bStop)
       {
-        CLog::Log(LOGWARNING, "CRenderManager::WaitForBuffer - timeout waiting for buffer");
+        m_decoderWait.Add(CurrentHostCounter() - waitStart);
+        if (timeout != 0 && !bStop)
+        {
+          CLog::Log(LOGWARNING, "CRenderManager::WaitForBuffer - timeout waiting for buffer");
+        }
+        return -1;
       }
-      return -1;
     }
+    m_decoderWait.Add(CurrentHostCounter() - waitStart);
   }
 
   // make sure overlay buffer is released, this won't happen on AddOverlay
-  m_overlays.Release(m_free.front());
+  m_overlays.Release(index);
 
   // return buffer level
-  return m_queued.size() + m_discard.size();
+  return m_bufferQueue.Count(RenderBufferState::QUEUED) + m_bufferQueue.Count(RenderBufferState::DISCARDED);
 }
 
 void CRenderManager::PrepareNextRender()
 {
-  if (m_queued.empty())
+  int queued[CRenderBufferQueue::CAPACITY];
+  const int count = m_bufferQueue.Get(RenderBufferState::QUEUED, queued);
+  if (count == 0)
   {
     CLog::Log(LOGERROR, "CRenderManager::PrepareNextRender - asked to prepare with nothing available");
     m_presentstep = PRESENT_IDLE;
@@ -1090,7 +1117,7 @@ void CRenderManager::PrepareNextRender()
 
   double renderPts = frameOnScreen + m_displayLatency;
 
-  double nextFramePts = m_Queue[m_queued.front()].pts;
+  double nextFramePts = m_Queue[queued[0]].pts;
   if (m_dvdClock.GetClockSpeed() < 0)
     nextFramePts = renderPts;
 
@@ -1120,7 +1147,7 @@ void CRenderManager::PrepareNextRender()
   bool combined = false;
   if (m_presentsourcePast >= 0)
   {
-    m_discard.push_back(m_presentsourcePast);
+    m_bufferQueue.Discard(m_presentsourcePast);
     m_presentsourcePast = -1;
     combined = true;
   }
@@ -1128,32 +1155,39 @@ void CRenderManager::PrepareNextRender()
   if (renderPts >= nextFramePts || m_forceNext)
   {
     // see if any future queued frames are already due
-    auto iter = m_queued.begin();
-    int idx = *iter;
-    ++iter;
-    while (iter != m_queued.end())
+    int pos = 0;
+    for (int i = 1; i < count; i++)
     {
       // the slot for rendering in time is [pts .. (pts +  x * frametime)]
       // renderer/drivers have internal queues, being slightly late here does not mean that
       // we are really late. The likelihood that we recover decreases the greater m_lateframes
       // get. Skipping a frame is easier than having decoder dropping one (lateframes > 10)
       double x = (m_lateframes <= 6) ? 0.98 : 0;
-      if (renderPts < m_Queue[*iter].pts + x * frametime)
+      if (renderPts < m_Queue[queued[i]].pts + x * frametime)
         break;
-      idx = *iter;
-      ++iter;
+      pos = i;
     }
+    int idx = queued[pos];
 
-    // skip late frames
-    while (m_queued.front() != idx)
+    // skip late frames, a frame discarded by the player in the meantime is gone already
+    for (int i = 0; i < pos; i++)
     {
+      if (!m_bufferQueue.Render(queued[i]))
+        continue;
+
       if (m_presentsourcePast >= 0)
       {
-        m_discard.push_back(m_presentsourcePast);
+        m_bufferQueue.Discard(m_presentsourcePast);
         m_QueueSkip++;
       }
-      m_presentsourcePast = m_queued.front();
-      m_queued.pop_front();
+      m_presentsourcePast = queued[i];
+    }
+
+    if (!m_bufferQueue.Render(idx))
+    {
+      m_presentstep = PRESENT_IDLE;
+      m_presentevent.notifyAll();
+      return;
     }
 
     int lateframes = static_cast<int>((renderPts - m_Queue[idx].pts) * m_fps / DVD_TIME_BASE);
@@ -1163,35 +1197,38 @@ void CRenderManager::PrepareNextRender()
       m_lateframes = 0;
 
     m_presentstep = PRESENT_FLIP;
-    m_discard.push_back(m_presentsource);
+    m_bufferQueue.Discard(m_presentsource);
     m_presentsource = idx;
-    m_queued.pop_front();
     m_presentpts = m_Queue[idx].pts - m_displayLatency;
+    CFrameTrace::Trace(FrameTraceStage::PREPARE_RENDER, m_Queue[idx].pts);
     m_presentevent.notifyAll();
 
-    m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
+    UpdateRenderBuffers();
   }
   else if (!combined && renderPts > (nextFramePts - frametime))
   {
+    if (!m_bufferQueue.Render(queued[0]))
+    {
+      m_presentstep = PRESENT_IDLE;
+      m_presentevent.notifyAll();
+      return;
+    }
+
     m_lateframes = 0;
     m_presentstep = PRESENT_FLIP;
     m_presentsourcePast = m_presentsource;
-    m_presentsource = m_queued.front();
-    m_queued.pop_front();
+    m_presentsource = queued[0];
     m_presentpts = m_Queue[m_presentsource].pts - m_displayLatency - frametime / 2;
+    CFrameTrace::Trace(FrameTraceStage::PREPARE_RENDER, m_Queue[m_presentsource].pts);
     m_presentevent.notifyAll();
   }
 }
 
 void CRenderManager::DiscardBuffer()
 {
-  CSingleLock lock2(m_presentlock);
+  m_bufferQueue.DiscardQueued();
 
-  while(!m_queued.empty())
-  {
-    m_discard.push_back(m_queued.front());
-    m_queued.pop_front();
-  }
+  CSingleLock lock2(m_presentlock);
 
   if(m_presentstep == PRESENT_READY)
     m_presentstep = PRESENT_IDLE;
@@ -1200,14 +1237,20 @@ void CRenderManager::DiscardBuffer()
 
 bool CRenderManager::GetStats(int &lateframes, double &pts, int &queued, int &discard)
 {
-  CSingleLock lock(m_presentlock);
   lateframes = m_lateframes / 10;
   pts = m_presentpts;
-  queued = m_queued.size();
-  discard  = m_discard.size();
+  queued = m_bufferQueue.Count(RenderBufferState::QUEUED);
+  discard  = m_bufferQueue.Count(RenderBufferState::DISCARDED);
   return true;
 }
 
+void CRenderManager::UpdateRenderBuffers()
+{
+  m_playerPort->UpdateRenderBuffers(m_bufferQueue.Count(RenderBufferState::QUEUED),
+                                    m_bufferQueue.Count(RenderBufferState::DISCARDED),
+                                    m_bufferQueue.Count(RenderBufferState::FREE));
+}
+
 void CRenderManager::CheckEnableClockSync()
 {
   // refresh rate can be a multiple of video fps
@@ -12,6 +12,7 @@
 #include "DebugRenderer.h"
 #include "cores/VideoPlayer/VideoRenderers/BaseRenderer.h"
 #include "cores/VideoPlayer/VideoRenderers/OverlayRenderer.h"
+#include "cores/VideoPlayer/VideoRenderers/RenderBufferQueue.h"
 #include "cores/VideoSettings.h"
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
@@ -19,7 +20,6 @@
 #include "windowing/Resolution.h"
 
 #include <atomic>
-#include <deque>
 #include <list>
 #include <map>
 
@@ -121,6 +121,7 @@ protected:
   void PresentBlend(bool clear, DWORD flags, DWORD alpha);
 
   void PrepareNextRender();
+  void UpdateRenderBuffers();
   bool IsPresenting();
   bool IsGuiLayer();
 
@@ -187,9 +188,14 @@ protected:
     EPRESENTMETHOD presentmethod;
   } m_Queue[NUM_BUFFERS];
 
-  std::deque<int> m_free;
-  std::deque<int> m_queued;
-  std::deque<int> m_discard;
+  static_assert(NUM_BUFFERS <= CRenderBufferQueue::CAPACITY, "render buffer queue too small");
+
+  // buffers move between free, queued, rendering and discarded without
+  // m_presentlock, the lock only guards the present state below
+  CRenderBufferQueue m_bufferQueue;
+  CEvent m_bufferEvent;
+  CRenderQueueWait m_decoderWait;
+  CRenderQueueWait m_renderWait;
 
   std::unique_ptr<VideoPicture> m_pConfigPicture;
   unsigned int m_width = 0;
@@ -201,8 +207,8 @@ protected:
   int m_NumberBuffers = 0;
   std::string m_stereomode;
 
-  int m_lateframes = -1;
-  double m_presentpts = 0.0;
+  std::atomic_int m_lateframes = {-1};
+  std::atomic<double> m_presentpts = {0.0};
   EPRESENTSTEP m_presentstep = PRESENT_IDLE;
   XbmcThreads::EndTime m_presentTimer;
   bool m_forceNext = false;
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "RendererNull.h"
+
+#include "RenderFactory.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodec.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <cstdlib>
+
+std::atomic<unsigned int> CRendererNull::m_renderedFrames{0};
+
+CRendererNull::~CRendererNull()
+{
+  UnInit();
+}
+
+CBaseRenderer* CRendererNull::Create(CVideoBuffer* buffer)
+{
+  return new CRendererNull();
+}
+
+void CRendererNull::Register()
+{
+  VIDEOPLAYER::CRendererFactory::RegisterRenderer("null", CRendererNull::Create);
+}
+
+bool CRendererNull::IsSelected()
+{
+  const char* renderer = getenv("KODI_RENDERER");
+  return renderer && StringUtils::EqualsNoCase(renderer, "null");
+}
+
+bool CRendererNull::Configure(const VideoPicture& picture, float fps, unsigned int orientation)
+{
+  m_sourceWidth = picture.iWidth;
+  m_sourceHeight = picture.iHeight;
+  m_renderOrientation = orientation;
+  m_fps = fps;
+  m_format = picture.videoBuffer ? picture.videoBuffer->GetFormat() : AV_PIX_FMT_NONE;
+  m_bConfigured = true;
+
+  CLog::Log(LOGDEBUG, "CRendererNull::Configure - %ux%u, %.3f fps", m_sourceWidth, m_sourceHeight,
+            fps);
+
+  return true;
+}
+
+void CRendererNull::AddVideoPicture(const VideoPicture& picture, int index)
+{
+  ReleaseBuffer(index);
+
+  m_buffers[index] = picture.videoBuffer;
+  if (m_buffers[index])
+    m_buffers[index]->Acquire();
+}
+
+void CRendererNull::UnInit()
+{
+  Flush(false);
+  m_bConfigured = false;
+}
+
+bool CRendererNull::Flush(bool saveBuffers)
+{
+  if (!saveBuffers)
+  {
+    for (int i = 0; i < NUM_BUFFERS; i++)
+      ReleaseBuffer(i);
+  }
+
+  return saveBuffers;
+}
+
+void CRendererNull::ReleaseBuffer(int idx)
+{
+  if (m_buffers[idx])
+  {
+    m_buffers[idx]->Release();
+    m_buffers[idx] = nullptr;
+  }
+}
+
+CRenderInfo CRendererNull::GetRenderInfo()
+{
+  CRenderInfo info;
+  info.max_buffer_size = NUM_BUFFERS;
+  return info;
+}
+
+void CRendererNull::RenderUpdate(
+    int index, int index2, bool clear, unsigned int flags, unsigned int alpha)
+{
+  if (m_buffers[index])
+    m_renderedFrames++;
+}
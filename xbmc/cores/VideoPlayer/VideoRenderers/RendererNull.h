@@ -0,0 +1,67 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "BaseRenderer.h"
+
+#include <atomic>
+
+/*!
+ * \brief Renderer that accepts every picture and draws nothing
+ *
+ * Used to run the player pipeline without a GPU, e.g. to measure decoder
+ * throughput. The window systems register it when KODI_RENDERER=null is set,
+ * it is then preferred over the default renderer.
+ */
+class CRendererNull : public CBaseRenderer
+{
+public:
+  CRendererNull() = default;
+  ~CRendererNull() override;
+
+  static CBaseRenderer* Create(CVideoBuffer* buffer);
+  static void Register();
+
+  /*!
+   * \brief Whether the null renderer was selected with KODI_RENDERER=null
+   */
+  static bool IsSelected();
+
+  // Player functions
+  bool Configure(const VideoPicture& picture, float fps, unsigned int orientation) override;
+  bool IsConfigured() override { return m_bConfigured; }
+  void AddVideoPicture(const VideoPicture& picture, int index) override;
+  void UnInit() override;
+  bool Flush(bool saveBuffers) override;
+  void ReleaseBuffer(int idx) override;
+  bool IsGuiLayer() override { return false; }
+  CRenderInfo GetRenderInfo() override;
+  void Update() override {}
+  void RenderUpdate(int index, int index2, bool clear, unsigned int flags, unsigned int alpha) override;
+  bool RenderCapture(CRenderCapture* capture) override { return false; }
+  bool ConfigChanged(const VideoPicture& picture) override { return false; }
+
+  // Feature support
+  bool SupportsMultiPassRendering() override { return false; }
+  bool Supports(ERENDERFEATURE feature) override { return false; }
+  bool Supports(ESCALINGMETHOD method) override { return method == VS_SCALINGMETHOD_AUTO; }
+
+  /*!
+   * \brief Number of pictures passed to RenderUpdate of any null renderer
+   *
+   * The renderer is owned by the render manager of the player, so the count
+   * is kept for all of them.
+   */
+  static unsigned int GetRenderedFrames() { return m_renderedFrames; }
+
+private:
+  CVideoBuffer* m_buffers[NUM_BUFFERS] = {};
+  bool m_bConfigured = false;
+  static std::atomic<unsigned int> m_renderedFrames;
+};
@@ -0,0 +1,298 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "cores/DataCacheCore.h"
+#include "cores/IPlayerCallback.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "cores/VideoPlayer/VideoPlayer.h"
+#include "cores/VideoPlayer/VideoPlayerVideo.h"
+#include "cores/VideoPlayer/VideoRenderers/RenderFactory.h"
+#include "cores/VideoPlayer/VideoRenderers/RendererNull.h"
+#include "threads/SystemClock.h"
+#include "utils/XTimeUtils.h"
+#include "windowing/WinSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+/*!
+ * \brief Window system without a window, just enough for the player and the
+ *        render manager
+ *
+ * Registers the null renderer like the window systems do when it is selected.
+ */
+class CWinSystemBenchmark : public CWinSystemBase
+{
+public:
+  bool InitWindowSystem() override
+  {
+    VIDEOPLAYER::CRendererFactory::ClearRenderer();
+    CRendererNull::Register();
+    return true;
+  }
+  bool DestroyWindowSystem() override
+  {
+    VIDEOPLAYER::CRendererFactory::ClearRenderer();
+    return true;
+  }
+  bool CreateNewWindow(const std::string& name, bool fullScreen, RESOLUTION_INFO& res) override
+  {
+    return true;
+  }
+  bool ResizeWindow(int newWidth, int newHeight, int newLeft, int newTop) override { return true; }
+  bool SetFullScreen(bool fullScreen, RESOLUTION_INFO& res, bool blankOtherDisplays) override
+  {
+    return true;
+  }
+  void Register(IDispResource* resource) override {}
+  void Unregister(IDispResource* resource) override {}
+};
+
+class CBenchmarkCallback : public IPlayerCallback
+{
+public:
+  void OnPlayBackEnded() override { m_ended = true; }
+  void OnPlayBackStarted(const CFileItem& file) override {}
+  void OnPlayBackStopped() override { m_ended = true; }
+  void OnPlayBackError() override
+  {
+    m_error = true;
+    m_ended = true;
+  }
+  void OnQueueNextItem() override {}
+
+  std::atomic<bool> m_ended{false};
+  std::atomic<bool> m_error{false};
+};
+
+/*!
+ * \brief Player that lets the benchmark step the clock and look at its queues
+ */
+class CBenchmarkPlayer : public CVideoPlayer
+{
+public:
+  explicit CBenchmarkPlayer(IPlayerCallback& callback) : CVideoPlayer(callback) {}
+
+  /*!
+   * \brief Stop the clock, from now on it only moves with StepClock
+   */
+  void StopClock() { m_clock.Pause(true); }
+  void StepClock(double time) { m_clock.Advance(time); }
+
+  float GetFps() { return m_processInfo->GetVideoFps(); }
+  int GetVideoLevel() { return m_processInfo->GetLevelVQ(); }
+  int GetAudioLevel() { return m_CurrentAudio.id >= 0 ? m_VideoPlayerAudio->GetLevel() : -1; }
+  int GetRenderQueued()
+  {
+    int queued, discard, free;
+    m_processInfo->GetRenderBuffers(queued, discard, free);
+    return queued;
+  }
+
+  int GetDroppedFrames()
+  {
+    CVideoPlayerVideo* video = dynamic_cast<CVideoPlayerVideo*>(m_VideoPlayerVideo);
+    return video ? video->GetDroppedFrames() : 0;
+  }
+  int GetSkippedFrames() { return m_renderManager.GetSkippedFrames(); }
+};
+
+struct QueueStats
+{
+  void Add(int level)
+  {
+    if (level < 0)
+      return;
+    min = std::min(min, level);
+    max = std::max(max, level);
+    sum += level;
+    samples++;
+  }
+  double Avg() const { return samples ? static_cast<double>(sum) / samples : 0.0; }
+
+  int min = INT_MAX;
+  int max = 0;
+  long long sum = 0;
+  unsigned int samples = 0;
+};
+
+struct BenchmarkResult
+{
+  std::string decoder;
+  float fps = 0.0f;
+  unsigned int renderedFrames = 0;
+  int droppedFrames = 0;
+  int skippedFrames = 0;
+  double playedSeconds = 0.0;
+  double wallSeconds = 0.0;
+  double cpuSeconds = 0.0;
+
+  QueueStats demux;
+  QueueStats video;
+  QueueStats audio;
+  QueueStats render;
+};
+
+/*!
+ * \brief Plays a file with CVideoPlayer on the null renderer and the null
+ *        audio sink
+ *
+ * The test thread takes the part of the GUI thread and drives the render loop.
+ * Without audio the clock of the player is stopped and stepped by a frame
+ * whenever the renderer has a picture queued, so the file plays as fast as it
+ * can be decoded. Audio is played by the sink in realtime, with it the file
+ * plays at normal speed.
+ */
+class CPlayerBenchmark
+{
+public:
+  bool Run(const std::string& path, unsigned int maxMs, bool audio, BenchmarkResult& result)
+  {
+    CAESinkNULL::Register();
+    ActiveAE::CActiveAE audioEngine;
+    audioEngine.Start();
+    CServiceBroker::RegisterAE(&audioEngine);
+
+    CWinSystemBenchmark winSystem;
+    winSystem.InitWindowSystem();
+    CServiceBroker::RegisterWinSystem(&winSystem);
+
+    bool success = Play(path, maxMs, audio, winSystem, result);
+
+    CServiceBroker::UnregisterWinSystem();
+    winSystem.DestroyWindowSystem();
+
+    CServiceBroker::UnregisterAE();
+    audioEngine.Shutdown();
+    AE::CAESinkFactory::ClearSinks();
+
+    return success;
+  }
+
+private:
+  bool Play(const std::string& path,
+            unsigned int maxMs,
+            bool audio,
+            CWinSystemBenchmark& winSystem,
+            BenchmarkResult& result)
+  {
+    CBenchmarkCallback callback;
+    CBenchmarkPlayer player(callback);
+
+    CFileItem item(path, false);
+    CPlayerOptions options;
+    options.fullscreen = false;
+    options.videoOnly = !audio;
+
+    const unsigned int renderedStart = CRendererNull::GetRenderedFrames();
+    const unsigned int start = XbmcThreads::SystemClockMillis();
+    const std::clock_t cpuStart = std::clock();
+
+    if (!player.OpenFile(item, options))
+      return false;
+
+    if (!audio)
+      player.StopClock();
+
+    XbmcThreads::EndTime timeout(maxMs);
+    while (!callback.m_ended && !timeout.IsTimePast())
+    {
+      const int queued = player.GetRenderQueued();
+      result.demux.Add(player.GetCacheLevel());
+      result.video.Add(player.GetVideoLevel());
+      result.audio.Add(player.GetAudioLevel());
+      result.render.Add(queued);
+
+      const float fps = player.GetFps();
+      if (!audio && queued > 0 && fps > 0)
+        player.StepClock(DVD_TIME_BASE / fps);
+
+      winSystem.DriveRenderLoop();
+      player.Render(true, 255, false);
+      result.playedSeconds = CServiceBroker::GetDataCacheCore().GetPlayTime() / 1000.0;
+
+      // only wait when there is nothing to show yet, the loop doesn't pace playback
+      if (audio || queued == 0)
+        KODI::TIME::Sleep(1);
+    }
+
+    result.decoder = CServiceBroker::GetDataCacheCore().GetVideoDecoderName();
+    result.fps = player.GetFps();
+    result.droppedFrames = player.GetDroppedFrames();
+    result.skippedFrames = player.GetSkippedFrames();
+
+    player.CloseFile();
+
+    result.wallSeconds = (XbmcThreads::SystemClockMillis() - start) / 1000.0;
+    result.cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    result.renderedFrames = CRendererNull::GetRenderedFrames() - renderedStart;
+
+    return !callback.m_error;
+  }
+};
+
+void PrintQueue(const char* name, const QueueStats& stats)
+{
+  if (stats.samples)
+    printf("  %-6s min %3d, avg %5.1f, max %3d\n", name, stats.min, stats.Avg(), stats.max);
+  else
+    printf("  %-6s -\n", name);
+}
+} // namespace
+
+// Set KODI_BENCHMARK_FILE to the file to play and run with
+// --gtest_also_run_disabled_tests --gtest_filter=TestDecodeBenchmark.*
+// Playback stops after KODI_BENCHMARK_SECONDS (default 30) if the file is longer.
+// The video plays as fast as it decodes, with KODI_BENCHMARK_AUDIO=1 the audio
+// is played too and playback runs in realtime.
+TEST(TestDecodeBenchmark, DISABLED_Playback)
+{
+  const char* path = getenv("KODI_BENCHMARK_FILE");
+  if (!path)
+    GTEST_SKIP() << "KODI_BENCHMARK_FILE is not set";
+
+  const char* seconds = getenv("KODI_BENCHMARK_SECONDS");
+  const unsigned int maxMs = (seconds ? std::max(1, atoi(seconds)) : 30) * 1000;
+  const char* audio = getenv("KODI_BENCHMARK_AUDIO");
+
+  CPlayerBenchmark benchmark;
+  BenchmarkResult result;
+  ASSERT_TRUE(benchmark.Run(path, maxMs, audio && atoi(audio) != 0, result));
+
+  printf("decoder %s, %.1f s played in %.2f s wall time, %.2f s cpu time (%.0f%% of realtime)\n",
+         result.decoder.c_str(), result.playedSeconds, result.wallSeconds, result.cpuSeconds,
+         result.playedSeconds > 0 ? result.cpuSeconds * 100.0 / result.playedSeconds : 0.0);
+  // skipped frames were decoded but never shown, dropped ones weren't decoded or output
+  const unsigned int decodedFrames = result.renderedFrames + result.skippedFrames;
+  printf("%u frames decoded at %.1f fps (stream %.3f fps), %u rendered, %d skipped by the "
+         "renderer, %d dropped by the decoder\n",
+         decodedFrames, result.wallSeconds > 0 ? decodedFrames / result.wallSeconds : 0.0,
+         result.fps, result.renderedFrames, result.skippedFrames, result.droppedFrames);
+  printf("queue levels (demux, video and audio in %%, render in pictures):\n");
+  PrintQueue("demux", result.demux);
+  PrintQueue("video", result.video);
+  PrintQueue("audio", result.audio);
+  PrintQueue("render", result.render);
+
+  EXPECT_GT(result.renderedFrames, 0U);
+  EXPECT_GT(result.playedSeconds, 0.0);
+}
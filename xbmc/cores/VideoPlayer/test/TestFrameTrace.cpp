@@ -0,0 +1,130 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/FrameTrace.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/Variant.h"
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(TestFrameTrace, Disabled)
+{
+  CFrameTrace::GetInstance().Start();
+  CFrameTrace::GetInstance().Stop();
+
+  CFrameTrace::Trace(FrameTraceStage::DEMUX, DVD_MSEC_TO_TIME(40));
+  EXPECT_TRUE(CFrameTrace::GetInstance().GetEvents().empty());
+}
+
+TEST(TestFrameTrace, Record)
+{
+  CFrameTrace& trace = CFrameTrace::GetInstance();
+  trace.Start();
+
+  for (int i = 0; i < static_cast<int>(FrameTraceStage::MAX); i++)
+    CFrameTrace::Trace(static_cast<FrameTraceStage>(i), DVD_MSEC_TO_TIME(40));
+  CFrameTrace::Trace(FrameTraceStage::DEMUX, DVD_NOPTS_VALUE);
+
+  trace.Stop();
+
+  const std::vector<FrameTraceEvent> events = trace.GetEvents();
+  ASSERT_EQ(static_cast<size_t>(FrameTraceStage::MAX), events.size());
+  for (size_t i = 0; i < events.size(); i++)
+  {
+    EXPECT_EQ(static_cast<FrameTraceStage>(i), events[i].stage);
+    EXPECT_EQ(DVD_MSEC_TO_TIME(40), events[i].id);
+    if (i > 0)
+      EXPECT_LE(events[i - 1].time, events[i].time);
+  }
+}
+
+TEST(TestFrameTrace, Overwrite)
+{
+  CFrameTrace& trace = CFrameTrace::GetInstance();
+  trace.Start();
+
+  const unsigned int count = CFrameTrace::RING_SIZE + 100;
+  for (unsigned int i = 0; i < count; i++)
+    CFrameTrace::Trace(FrameTraceStage::DEMUX, i);
+
+  trace.Stop();
+
+  const std::vector<FrameTraceEvent> events = trace.GetEvents();
+  ASSERT_EQ(CFrameTrace::RING_SIZE, events.size());
+  EXPECT_EQ(100, events.front().id);
+  EXPECT_EQ(static_cast<int64_t>(count - 1), events.back().id);
+}
+
+TEST(TestFrameTrace, Concurrent)
+{
+  CFrameTrace& trace = CFrameTrace::GetInstance();
+  trace.Start();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+  {
+    threads.emplace_back([t]() {
+      for (int i = 0; i < 1000; i++)
+        CFrameTrace::Trace(static_cast<FrameTraceStage>(t), i);
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  trace.Stop();
+
+  EXPECT_EQ(4000u, trace.GetEvents().size());
+}
+
+TEST(TestFrameTrace, Export)
+{
+  CFrameTrace& trace = CFrameTrace::GetInstance();
+  trace.Start();
+
+  for (int frame = 0; frame < 3; frame++)
+  {
+    for (int i = 0; i < static_cast<int>(FrameTraceStage::MAX); i++)
+      CFrameTrace::Trace(static_cast<FrameTraceStage>(i), DVD_MSEC_TO_TIME(40 * frame));
+  }
+  // the same pts again, e.g. after a seek back
+  CFrameTrace::Trace(FrameTraceStage::DEMUX, 0);
+
+  trace.Stop();
+
+  std::string json;
+  ASSERT_TRUE(trace.Export(json, true));
+
+  CVariant value;
+  ASSERT_TRUE(CJSONVariantParser::Parse(json, value));
+  ASSERT_TRUE(value["traceEvents"].isArray());
+
+  unsigned int begins = 0;
+  unsigned int ends = 0;
+  unsigned int instants = 0;
+  for (auto it = value["traceEvents"].begin_array(); it != value["traceEvents"].end_array(); ++it)
+  {
+    const std::string phase = (*it)["ph"].asString();
+    if (phase == "b")
+      begins++;
+    else if (phase == "e")
+    {
+      ends++;
+      EXPECT_GE((*it)["args"]["latency_ms"].asDouble(), 0.0);
+    }
+    else if (phase == "i")
+      instants++;
+  }
+
+  EXPECT_EQ(4u, begins);
+  EXPECT_EQ(4u, ends);
+  EXPECT_EQ(3u * static_cast<unsigned int>(FrameTraceStage::MAX) + 1, instants);
+}
@@ -0,0 +1,129 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/RenderBufferQueue.h"
+#include "utils/TimeUtils.h"
+
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+TEST(TestRenderBufferQueue, Reset)
+{
+  CRenderBufferQueue queue;
+  EXPECT_EQ(-1, queue.GetFree());
+
+  queue.Reset(4, 0);
+  EXPECT_EQ(3, queue.Count(RenderBufferState::FREE));
+  EXPECT_EQ(1, queue.Count(RenderBufferState::RENDERING));
+  EXPECT_EQ(CRenderBufferQueue::CAPACITY - 4, queue.Count(RenderBufferState::UNUSED));
+  EXPECT_EQ(1, queue.GetFree());
+}
+
+TEST(TestRenderBufferQueue, Order)
+{
+  CRenderBufferQueue queue;
+  queue.Reset(4, 0);
+
+  EXPECT_TRUE(queue.Queue(1));
+  EXPECT_TRUE(queue.Queue(3));
+  EXPECT_TRUE(queue.Queue(2));
+  EXPECT_FALSE(queue.Queue(2));
+  EXPECT_EQ(-1, queue.GetFree());
+
+  int indices[CRenderBufferQueue::CAPACITY];
+  ASSERT_EQ(3, queue.Get(RenderBufferState::QUEUED, indices));
+  EXPECT_EQ(1, indices[0]);
+  EXPECT_EQ(3, indices[1]);
+  EXPECT_EQ(2, indices[2]);
+
+  // released buffers become free in the order they were released
+  EXPECT_TRUE(queue.Render(1));
+  EXPECT_TRUE(queue.Discard(0));
+  EXPECT_FALSE(queue.Release(1));
+  EXPECT_TRUE(queue.Discard(1));
+  EXPECT_TRUE(queue.Release(1));
+  EXPECT_TRUE(queue.Release(0));
+  EXPECT_EQ(1, queue.GetFree());
+}
+
+TEST(TestRenderBufferQueue, DiscardRace)
+{
+  CRenderBufferQueue queue;
+  queue.Reset(4, 0);
+  queue.Queue(1);
+  queue.Queue(2);
+
+  EXPECT_EQ(2, queue.DiscardQueued());
+  EXPECT_FALSE(queue.Render(1));
+  EXPECT_EQ(2, queue.Count(RenderBufferState::DISCARDED));
+
+  // a flush takes back buffers the decoder is still filling
+  queue.Reset(4, 0);
+  EXPECT_EQ(0, queue.Count(RenderBufferState::DISCARDED));
+  EXPECT_EQ(3, queue.Count(RenderBufferState::FREE));
+}
+
+TEST(TestRenderBufferQueue, Threads)
+{
+  const int frames = 10000;
+  CRenderBufferQueue queue;
+  queue.Reset(4, 0);
+
+  std::atomic_int rendered(0);
+  std::thread decoder([&queue]() {
+    for (int i = 0; i < frames; i++)
+    {
+      int index;
+      while ((index = queue.GetFree()) < 0)
+        std::this_thread::yield();
+      EXPECT_TRUE(queue.Queue(index));
+    }
+  });
+
+  int current = 0;
+  while (rendered < frames)
+  {
+    int indices[CRenderBufferQueue::CAPACITY];
+    if (queue.Get(RenderBufferState::QUEUED, indices) == 0)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_TRUE(queue.Render(indices[0]));
+    ASSERT_TRUE(queue.Discard(current));
+    ASSERT_TRUE(queue.Release(current));
+    current = indices[0];
+    rendered++;
+  }
+  decoder.join();
+
+  EXPECT_EQ(1, queue.Count(RenderBufferState::RENDERING));
+  EXPECT_EQ(3, queue.Count(RenderBufferState::FREE));
+}
+
+TEST(TestRenderBufferQueue, Wait)
+{
+  CRenderQueueWait wait;
+  const int64_t ms = CurrentHostFrequency() / 1000;
+  wait.Add(2 * ms);
+  wait.Add(4 * ms);
+
+  unsigned int count;
+  double average, max;
+  wait.Get(count, average, max);
+  EXPECT_EQ(2u, count);
+  EXPECT_NEAR(3.0, average, 0.01);
+  EXPECT_NEAR(4.0, max, 0.01);
+
+  wait.Reset();
+  wait.Get(count, average, max);
+  EXPECT_EQ(0u, count);
+  EXPECT_EQ(0.0, max);
+}
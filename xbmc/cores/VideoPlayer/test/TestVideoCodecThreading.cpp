@@ -0,0 +1,105 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDCodecs/Video/VideoCodecThreading.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+bool RunWindow(CVideoCodecThreading& threading, int late, int renderQueued)
+{
+  bool changed = false;
+  for (int i = 0; i < CVideoCodecThreading::WINDOW_FRAMES; i++)
+    changed = threading.Process(i < late, false, renderQueued) || changed;
+  return changed;
+}
+} // namespace
+
+TEST(TestVideoCodecThreading, Resolution)
+{
+  CVideoCodecThreading threading;
+
+  threading.Init(true, true, 720, 576, false, 16);
+  EXPECT_EQ(VideoCodecThreadingType::FRAME, threading.GetType());
+  EXPECT_EQ(4, threading.GetCount());
+
+  threading.Init(true, true, 1920, 1080, false, 16);
+  EXPECT_EQ(8, threading.GetCount());
+
+  threading.Init(true, true, 3840, 2160, false, 16);
+  EXPECT_EQ(CVideoCodecThreading::MAX_THREADS, threading.GetCount());
+
+  // UHD oversubscribes the CPUs
+  threading.Init(true, true, 3840, 2160, false, 2);
+  EXPECT_EQ(3, threading.GetCount());
+  EXPECT_EQ("frame x3", threading.GetDescription());
+}
+
+TEST(TestVideoCodecThreading, Realtime)
+{
+  CVideoCodecThreading threading;
+
+  threading.Init(true, true, 1920, 1080, true, 8);
+  EXPECT_EQ(VideoCodecThreadingType::SLICE, threading.GetType());
+
+  threading.Init(true, false, 1920, 1080, true, 8);
+  EXPECT_EQ(VideoCodecThreadingType::FRAME, threading.GetType());
+  EXPECT_EQ(4, threading.GetCount());
+}
+
+TEST(TestVideoCodecThreading, SingleCore)
+{
+  CVideoCodecThreading threading;
+
+  threading.Init(true, true, 1920, 1080, false, 1);
+  EXPECT_EQ(VideoCodecThreadingType::NONE, threading.GetType());
+  EXPECT_EQ(1, threading.GetCount());
+  EXPECT_EQ("none", threading.GetDescription());
+  EXPECT_FALSE(RunWindow(threading, CVideoCodecThreading::WINDOW_FRAMES, 0));
+}
+
+TEST(TestVideoCodecThreading, GrowAndShrink)
+{
+  CVideoCodecThreading threading;
+  threading.Init(true, true, 1920, 1080, false, 8);
+  ASSERT_EQ(8, threading.GetCount());
+
+  // a window with late frames and an empty render queue asks for more threads
+  EXPECT_TRUE(RunWindow(threading, 25, 0));
+  EXPECT_EQ(12, threading.GetCount());
+  EXPECT_FALSE(threading.GetReason().empty());
+
+  // the next windows are skipped while the change settles
+  EXPECT_FALSE(RunWindow(threading, 25, 0));
+  EXPECT_FALSE(RunWindow(threading, 25, 0));
+
+  // never more than the maximum
+  EXPECT_FALSE(RunWindow(threading, 25, 0));
+  EXPECT_EQ(12, threading.GetCount());
+
+  // the threads are given back once the decoder stays ahead
+  for (int i = 0; i < 2; i++)
+    EXPECT_FALSE(RunWindow(threading, 0, 3));
+  bool changed = false;
+  for (int i = 0; i < 6; i++)
+    changed = RunWindow(threading, 0, 3) || changed;
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(8, threading.GetCount());
+}
+
+TEST(TestVideoCodecThreading, SliceToFrame)
+{
+  CVideoCodecThreading threading;
+  threading.Init(true, true, 1920, 1080, true, 8);
+  ASSERT_EQ(VideoCodecThreadingType::SLICE, threading.GetType());
+
+  EXPECT_TRUE(RunWindow(threading, 25, 0));
+  EXPECT_EQ(VideoCodecThreadingType::FRAME, threading.GetType());
+  EXPECT_LE(threading.GetCount(), 4);
+}
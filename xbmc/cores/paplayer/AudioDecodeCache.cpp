@@ -0,0 +1,220 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AudioDecodeCache.h"
+
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+#include <string.h>
+
+CAudioDecodeCache::CAudioDecodeCache(unsigned int blockFrames)
+  : m_blockFrames(std::max(1u, blockFrames))
+{
+}
+
+void CAudioDecodeCache::SetMaxSize(size_t maxSize)
+{
+  CSingleLock lock(m_critSection);
+  if (maxSize == m_maxSize)
+    return;
+
+  m_maxSize = maxSize;
+  Trim();
+}
+
+size_t CAudioDecodeCache::GetMaxSize() const
+{
+  CSingleLock lock(m_critSection);
+  return m_maxSize;
+}
+
+size_t CAudioDecodeCache::GetSize() const
+{
+  CSingleLock lock(m_critSection);
+  return m_size;
+}
+
+void CAudioDecodeCache::Add(const std::string& file, unsigned int frameSize, uint64_t position,
+                            const uint8_t* data, size_t size, bool eof)
+{
+  CSingleLock lock(m_critSection);
+  if (m_maxSize == 0 || frameSize == 0)
+    return;
+
+  auto it = m_files.find(file);
+  if (it != m_files.end() && it->second.frameSize != frameSize)
+  {
+    DropFile(it);
+    it = m_files.end();
+  }
+
+  if (it == m_files.end())
+  {
+    if (size == 0)
+      return;
+
+    it = m_files.insert(std::make_pair(file, File())).first;
+    it->second.frameSize = frameSize;
+    it->second.blockSize = static_cast<size_t>(frameSize) * m_blockFrames;
+  }
+
+  File& entry = it->second;
+  // the end of the file without data is only known if it follows cached audio
+  if (eof && (size > 0 || position == 0 || FindBlock(entry, position - 1)))
+    entry.eofPosition = position + size;
+
+  while (size > 0)
+  {
+    const uint64_t index = position / entry.blockSize;
+    const size_t offset = static_cast<size_t>(position % entry.blockSize);
+    const size_t count = std::min(size, entry.blockSize - offset);
+
+    auto blockIt = entry.blocks.find(index);
+    if (blockIt == entry.blocks.end())
+    {
+      blockIt = entry.blocks.insert(std::make_pair(index, Block())).first;
+      blockIt->second.data.resize(entry.blockSize);
+      blockIt->second.begin = blockIt->second.end = offset;
+      blockIt->second.lru = m_lru.insert(m_lru.end(), BlockRef(file, index));
+      m_size += entry.blockSize;
+    }
+
+    // a block holds a single run, audio apart from it replaces it
+    Block& block = blockIt->second;
+    if (offset > block.end || offset + count < block.begin)
+      block.begin = block.end = offset;
+
+    memcpy(block.data.data() + offset, data, count);
+    block.begin = std::min(block.begin, offset);
+    block.end = std::max(block.end, offset + count);
+    Touch(block);
+
+    position += count;
+    data += count;
+    size -= count;
+  }
+
+  Trim();
+}
+
+bool CAudioDecodeCache::GetRange(const std::string& file, unsigned int frameSize, uint64_t position,
+                                 uint64_t& end, bool& eof)
+{
+  CSingleLock lock(m_critSection);
+  auto it = Find(file, frameSize);
+  if (it == m_files.end())
+    return false;
+
+  File& entry = it->second;
+  Block* block = FindBlock(entry, position);
+  if (!block)
+    return false;
+
+  Touch(*block);
+
+  // the range goes on in the next blocks as long as they continue it
+  uint64_t index = position / entry.blockSize;
+  end = index * entry.blockSize + block->end;
+  while (block->end == entry.blockSize)
+  {
+    auto next = entry.blocks.find(++index);
+    if (next == entry.blocks.end() || next->second.begin != 0)
+      break;
+    block = &next->second;
+    end = index * entry.blockSize + block->end;
+  }
+
+  eof = end >= entry.eofPosition;
+  return true;
+}
+
+size_t CAudioDecodeCache::Read(const std::string& file, unsigned int frameSize, uint64_t position,
+                               uint8_t* buffer, size_t size)
+{
+  CSingleLock lock(m_critSection);
+  auto it = Find(file, frameSize);
+  if (it == m_files.end())
+    return 0;
+
+  File& entry = it->second;
+  size_t copied = 0;
+  while (copied < size)
+  {
+    Block* block = FindBlock(entry, position);
+    if (!block)
+      break;
+
+    const size_t offset = static_cast<size_t>(position % entry.blockSize);
+    const size_t count = std::min(size - copied, block->end - offset);
+    memcpy(buffer + copied, block->data.data() + offset, count);
+    Touch(*block);
+
+    position += count;
+    copied += count;
+  }
+  return copied;
+}
+
+void CAudioDecodeCache::Clear()
+{
+  CSingleLock lock(m_critSection);
+  m_files.clear();
+  m_lru.clear();
+  m_size = 0;
+}
+
+CAudioDecodeCache::Files::iterator CAudioDecodeCache::Find(const std::string& file, unsigned int frameSize)
+{
+  auto it = m_files.find(file);
+  if (it == m_files.end() || it->second.frameSize != frameSize)
+    return m_files.end();
+  return it;
+}
+
+CAudioDecodeCache::Block* CAudioDecodeCache::FindBlock(File& file, uint64_t position)
+{
+  auto it = file.blocks.find(position / file.blockSize);
+  if (it == file.blocks.end())
+    return nullptr;
+
+  const size_t offset = static_cast<size_t>(position % file.blockSize);
+  if (offset < it->second.begin || offset >= it->second.end)
+    return nullptr;
+  return &it->second;
+}
+
+void CAudioDecodeCache::Touch(Block& block)
+{
+  m_lru.splice(m_lru.end(), m_lru, block.lru);
+}
+
+void CAudioDecodeCache::DropFile(Files::iterator it)
+{
+  for (const auto& block : it->second.blocks)
+  {
+    m_lru.erase(block.second.lru);
+    m_size -= it->second.blockSize;
+  }
+  m_files.erase(it);
+}
+
+void CAudioDecodeCache::Trim()
+{
+  // drop the least recently used blocks first
+  while (m_size > m_maxSize && !m_lru.empty())
+  {
+    auto it = m_files.find(m_lru.front().first);
+    File& file = it->second;
+    file.blocks.erase(m_lru.front().second);
+    m_lru.pop_front();
+    m_size -= file.blockSize;
+    if (file.blocks.empty())
+      m_files.erase(it);
+  }
+}
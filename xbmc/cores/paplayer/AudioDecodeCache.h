@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <list>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Decoded audio of the files played last, shared by the decoders of PAPlayer
+
+ The audio is kept as the codec decoded it. Positions are byte offsets in the
+ decoded audio of the whole file. Every file is split into blocks of a fixed
+ number of frames, so the ranges a decoder went through before and after a seek
+ are all kept. A decoder seeking back into one of them, or playing a file again,
+ reads from the cache instead of the codec for as long as the range lasts.
+
+ The least recently used blocks are dropped when the cache grows beyond its
+ size, whichever file they belong to.
+ */
+class CAudioDecodeCache
+{
+public:
+  /*!
+   \param blockFrames number of audio frames in a block
+   */
+  explicit CAudioDecodeCache(unsigned int blockFrames = DEFAULT_BLOCK_FRAMES);
+
+  /*!
+   \brief Set the size of the cache in bytes, 0 disables it
+   */
+  void SetMaxSize(size_t maxSize);
+  size_t GetMaxSize() const;
+  size_t GetSize() const;
+
+  /*!
+   \brief Add decoded audio of a file
+   \param frameSize size of an audio frame in bytes, positions are multiples of it
+   \param position position of the data
+   \param eof if the data ends at the end of the file
+   */
+  void Add(const std::string& file, unsigned int frameSize, uint64_t position, const uint8_t* data,
+           size_t size, bool eof);
+
+  /*!
+   \brief Get the end of the cached range of a file that holds a position
+   \param end end of the range, the audio from position up to there is cached
+   \param eof true if the range ends at the end of the file
+   \return false if the position isn't cached
+   */
+  bool GetRange(const std::string& file, unsigned int frameSize, uint64_t position, uint64_t& end,
+                bool& eof);
+
+  /*!
+   \brief Copy cached audio of a file
+   \return the number of bytes copied, 0 if the position isn't cached (anymore)
+   */
+  size_t Read(const std::string& file, unsigned int frameSize, uint64_t position, uint8_t* buffer, size_t size);
+
+  void Clear();
+
+  static const unsigned int DEFAULT_BLOCK_FRAMES = 16384;
+
+private:
+  CAudioDecodeCache(const CAudioDecodeCache&) = delete;
+  CAudioDecodeCache& operator=(const CAudioDecodeCache&) = delete;
+
+  //! file and index of a block
+  typedef std::pair<std::string, uint64_t> BlockRef;
+  typedef std::list<BlockRef> Lru;
+
+  //! a block holds one run of audio between begin and end, offsets in the block
+  struct Block
+  {
+    std::vector<uint8_t> data;
+    size_t begin = 0;
+    size_t end = 0;
+    Lru::iterator lru;
+  };
+
+  struct File
+  {
+    unsigned int frameSize = 0;
+    size_t blockSize = 0;
+    uint64_t eofPosition = UINT64_MAX;
+    std::map<uint64_t, Block> blocks;
+  };
+  typedef std::map<std::string, File> Files;
+
+  Files::iterator Find(const std::string& file, unsigned int frameSize);
+  Block* FindBlock(File& file, uint64_t position);
+  void Touch(Block& block);
+  void DropFile(Files::iterator it);
+  void Trim();
+
+  mutable CCriticalSection m_critSection;
+  const unsigned int m_blockFrames;
+  Files m_files;
+  Lru m_lru; ///< least recently used block first
+  size_t m_size = 0;
+  size_t m_maxSize = 0;
+};
@@ -9,15 +9,18 @@
 #include "AudioDecoder.h"
 
 #include "Application.h"
+#include "AudioDecodeCache.h"
 #include "CodecFactory.h"
 #include "FileItem.h"
 #include "ServiceBroker.h"
 #include "music/tags/MusicInfoTag.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 
+#include <cinttypes>
 #include <math.h>
 
 CAudioDecoder::CAudioDecoder()
@@ -55,6 +58,10 @@ void CAudioDecoder::Destroy()
   m_codec = NULL;
 
   m_canPlay = false;
+
+  m_cache = nullptr;
+  m_cachePos = m_cacheEnd = 0;
+  m_skipBytes = 0;
 }
 
 bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
@@ -122,8 +129,20 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
       m_codec->m_tag.SetReplayGain(rgInfo);
   }
 
-  if (seekOffset)
-    m_codec->Seek(seekOffset);
+  const int cacheSize = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioDecodeCacheSize;
+  if (cacheSize > 0 && m_codec->m_format.m_dataFormat != AE_FMT_RAW)
+  {
+    m_cache = &CServiceBroker::GetAudioDecodeCache();
+    m_cache->SetMaxSize(static_cast<size_t>(cacheSize) * 1024 * 1024);
+    m_cachePath = file.GetDynPath();
+  }
+  m_frameSize = blockSize;
+  m_decodedBytes = 0;
+  m_decodedKnown = true;
+
+  // a file decoded before is played from the cache
+  if (!SeekCache(seekOffset) && seekOffset)
+    SeekCodec(seekOffset);
 
   m_status = STATUS_QUEUING;
 
@@ -148,7 +167,82 @@ int64_t CAudioDecoder::Seek(int64_t time)
     return 0;
   if (time < 0) time = 0;
   if (time > m_codec->m_TotalTime) time = m_codec->m_TotalTime;
-  return m_codec->Seek(time);
+  if (SeekCache(time))
+    return time;
+  return SeekCodec(time);
+}
+
+int64_t CAudioDecoder::SeekCodec(int64_t time)
+{
+  m_skipBytes = 0;
+
+  // codecs can end up before or after the requested time, positions continue from where it is
+  const int64_t reached = m_codec->Seek(time);
+  m_decodedKnown = reached >= 0;
+  if (m_decodedKnown)
+    m_decodedBytes = TimeToBytes(reached);
+  return reached;
+}
+
+bool CAudioDecoder::SeekCache(int64_t time)
+{
+  m_cachePos = m_cacheEnd = 0;
+  m_skipBytes = 0;
+  if (!m_cache)
+    return false;
+
+  uint64_t end;
+  bool eof;
+  const uint64_t position = TimeToBytes(time);
+  if (!m_cache->GetRange(m_cachePath, m_frameSize, position, end, eof))
+    return false;
+
+  m_cachePos = position;
+  m_cacheEnd = end;
+  m_cacheEndsAtEof = eof;
+  return true;
+}
+
+void CAudioDecoder::ContinueWithCodec(uint64_t position)
+{
+  m_cachePos = m_cacheEnd = 0;
+  if (m_decodedKnown && m_decodedBytes == position)
+    return;
+
+  // the codec seeks to the millisecond, the audio decoded before the position is dropped
+  const int64_t time = static_cast<int64_t>(position / m_frameSize * 1000 / m_codec->m_format.m_sampleRate);
+  CLog::Log(LOGDEBUG, "CAudioDecoder: Seeking the codec to %" PRId64 " ms after the cached audio", time);
+  if (SeekCodec(time) >= 0 && m_decodedBytes < position)
+    m_skipBytes = position - m_decodedBytes;
+}
+
+int CAudioDecoder::ReadCache(uint8_t* buffer, int size, int* actualsize)
+{
+  const size_t available = static_cast<size_t>(std::min<uint64_t>(size, m_cacheEnd - m_cachePos));
+  *actualsize = static_cast<int>(m_cache->Read(m_cachePath, m_frameSize, m_cachePos, buffer, available));
+  if (*actualsize == 0)
+  {
+    // other files took the place in the cache
+    CLog::Log(LOGDEBUG, "CAudioDecoder: Decoded audio dropped from the cache");
+    ContinueWithCodec(m_cachePos);
+    return READ_SUCCESS;
+  }
+
+  m_cachePos += *actualsize;
+  if (m_cachePos >= m_cacheEnd)
+  {
+    if (m_cacheEndsAtEof)
+      return READ_EOF;
+    ContinueWithCodec(m_cacheEnd);
+  }
+  return READ_SUCCESS;
+}
+
+uint64_t CAudioDecoder::TimeToBytes(int64_t time) const
+{
+  if (time <= 0)
+    return 0;
+  return static_cast<uint64_t>(time) * m_codec->m_format.m_sampleRate / 1000 * m_frameSize;
 }
 
 void CAudioDecoder::SetTotalTime(int64_t time)
@@ -251,7 +345,30 @@ int CAudioDecoder::ReadSamples(int numsamples)
     if (numsamples)
     {
       int readSize = 0;
-      int result = m_codec->ReadPCM(m_pcmInputBuffer, numsamples * (m_codec->m_bitsPerSample >> 3), &readSize);
+      int result;
+      if (m_cachePos < m_cacheEnd)
+        result = ReadCache(m_pcmInputBuffer, numsamples * (m_codec->m_bitsPerSample >> 3), &readSize);
+      else
+      {
+        result = m_codec->ReadPCM(m_pcmInputBuffer, numsamples * (m_codec->m_bitsPerSample >> 3), &readSize);
+        if (result != READ_ERROR && m_decodedKnown)
+        {
+          if (m_cache)
+            m_cache->Add(m_cachePath, m_frameSize, m_decodedBytes, m_pcmInputBuffer, readSize, result == READ_EOF);
+          m_decodedBytes += readSize;
+        }
+
+        // audio before the end of the cached audio that was played already
+        if (result != READ_ERROR && m_skipBytes > 0 && readSize > 0)
+        {
+          const int skip = static_cast<int>(std::min<uint64_t>(m_skipBytes, readSize));
+          memmove(m_pcmInputBuffer, m_pcmInputBuffer + skip, readSize - skip);
+          readSize -= skip;
+          m_skipBytes -= skip;
+          if (readSize == 0 && result == READ_SUCCESS)
+            return RET_SUCCESS;
+        }
+      }
 
       if (result != READ_ERROR && readSize)
       {
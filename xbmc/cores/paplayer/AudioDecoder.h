@@ -13,6 +13,9 @@
 #include "threads/CriticalSection.h"
 #include "utils/RingBuffer.h"
 
+#include <string>
+
+class CAudioDecodeCache;
 class CFileItem;
 
 #define PACKET_SIZE 3840    // audio packet size - we keep 1 in reserve for gapless playback
@@ -66,6 +69,12 @@ public:
   float GetReplayGain(float &peakVal);
 
 private:
+  int64_t SeekCodec(int64_t time);
+  bool SeekCache(int64_t time);
+  void ContinueWithCodec(uint64_t position);
+  int ReadCache(uint8_t* buffer, int size, int* actualsize);
+  uint64_t TimeToBytes(int64_t time) const;
+
   // pcm buffer
   CRingBuffer m_pcmBuffer;
 
@@ -87,5 +96,16 @@ private:
   // the codec we're using
   ICodec* m_codec;
 
+  // decoded audio shared with other decoders, positions are bytes in the audio of the file
+  CAudioDecodeCache* m_cache = nullptr;
+  std::string m_cachePath;
+  unsigned int m_frameSize = 0;
+  uint64_t m_decodedBytes = 0;     // position of the codec
+  bool m_decodedKnown = false;     // false if the codec failed to seek
+  uint64_t m_cachePos = 0;         // position read from the cache while before m_cacheEnd
+  uint64_t m_cacheEnd = 0;
+  bool m_cacheEndsAtEof = false;
+  uint64_t m_skipBytes = 0;        // decoded audio to drop, the codec landed before m_cacheEnd
+
   CCriticalSection m_critSection;
 };
@@ -47,9 +47,10 @@ public:
 
   // Seek()
   // Should seek to the appropriate time (in ms) in the file, and return the
-  // time to which we managed to seek (in the case where seeking is problematic)
+  // time to which we managed to seek (in the case where seeking is problematic),
+  // that is the time of the first audio ReadPCM() returns next, or -1 on failure.
   // This is used in FFwd/Rewd so can be called very often.
-  virtual bool Seek(int64_t iSeekTime)=0;
+  virtual int64_t Seek(int64_t iSeekTime)=0;
 
   // ReadPCM()
   // Decodes audio into pBuffer up to size bytes.  The actual amount of returned data
@@ -9,7 +9,9 @@
 #include "PAPlayer.h"
 
 #include "CodecFactory.h"
+#include "PlayListPlayer.h"
 #include "ServiceBroker.h"
+#include "URL.h"
 #include "Util.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Interfaces/AEStream.h"
@@ -19,13 +21,18 @@
 #include "cores/VideoPlayer/Process/ProcessInfo.h"
 #include "messaging/ApplicationMessenger.h"
 #include "music/tags/MusicInfoTag.h"
+#include "playlists/PlayList.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/JobManager.h"
+#include "utils/Stopwatch.h"
+#include "utils/URIUtils.h"
 #include "utils/log.h"
 #include "video/Bookmark.h"
 
+#include <algorithm>
+
 using namespace KODI::MESSAGING;
 
 #define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
@@ -239,6 +246,7 @@ bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
     this,
     CJob::PRIORITY_NORMAL
   );
+  UpdateLookAhead(file);
 
   CSingleLock lock(m_streamsLock);
   if (m_streams.size() == 2)
@@ -301,6 +309,7 @@ bool PAPlayer::QueueNextFile(const CFileItem &file)
   CJobManager::GetInstance().Submit([this, file]() {
     QueueNextFileEx(file, true);
   }, this, CJob::PRIORITY_NORMAL);
+  UpdateLookAhead(file);
 
   return true;
 }
@@ -325,18 +334,30 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
     m_currentStream->m_nextFileItem.reset();
   }
 
-  StreamInfo *si = new StreamInfo();
-  si->m_fileItem = file;
-  if (!si->m_decoder.Create(file, si->m_fileItem.m_lStartOffset))
+  CStopWatch readyTimer;
+  readyTimer.StartZero();
+
+  StreamInfo *si = TakeLookAhead(file);
+  const bool lookedAhead = si != nullptr;
+  if (lookedAhead)
+  {
+    si->m_fileItem = file;
+  }
+  else
   {
-    CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
+    si = new StreamInfo();
+    si->m_fileItem = file;
+    if (!si->m_decoder.Create(file, si->m_fileItem.m_lStartOffset))
+    {
+      CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
 
-    // advance playlist
-    AdvancePlaylistOnError(si->m_fileItem);
-    m_callback.OnQueueNextItem();
+      // advance playlist
+      AdvancePlaylistOnError(si->m_fileItem);
+      m_callback.OnQueueNextItem();
 
-    delete si;
-    return false;
+      delete si;
+      return false;
+    }
   }
 
   /* decode until there is data-available */
@@ -427,12 +448,248 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   /* add the stream to the list */
   CSingleLock lock(m_streamsLock);
   m_streams.push_back(si);
+
+  const unsigned int readyMs = static_cast<unsigned int>(readyTimer.GetElapsedMilliseconds());
+  m_transitionStats.m_streams++;
+  if (lookedAhead)
+    m_transitionStats.m_lookAheads++;
+  m_transitionStats.m_lastReadyMs = readyMs;
+  m_transitionStats.m_maxReadyMs = std::max(m_transitionStats.m_maxReadyMs, readyMs);
+  m_transitionStats.m_totalReadyMs += readyMs;
+  CLog::Log(LOGDEBUG, "PAPlayer::QueueNextFileEx - %s ready in %u ms%s", CURL::GetRedacted(file.GetPath()).c_str(),
+            readyMs, lookedAhead ? " (opened in advance)" : "");
   //update the current stream to start playing the next track at the correct frame.
   UpdateStreamInfoPlayNextAtFrame(m_currentStream, m_upcomingCrossfadeMS);
 
   return true;
 }
 
+namespace
+{
+bool IsSameFile(const CFileItem& left, const CFileItem& right)
+{
+  return left.GetDynPath() == right.GetDynPath() && left.m_lStartOffset == right.m_lStartOffset;
+}
+
+bool CanLookAhead(const CFileItem& item, const CFileItem& playing)
+{
+  // items that are resolved when queued, streams without an end and cd drives
+  // are opened when they are queued only
+  if (item.IsPlugin() || URIUtils::IsUPnP(item.GetDynPath()) || item.IsInternetStream() ||
+      item.IsCDDA() || !item.IsAudio() || item.IsVideo())
+    return false;
+
+  // tracks of the same file, e.g. of a CUE sheet, continue in the stream of the file
+  return item.GetDynURL().GetFileName() != playing.GetDynURL().GetFileName();
+}
+} // namespace
+
+void PAPlayer::UpdateLookAhead(const CFileItem& file)
+{
+  // the playlist player may only be used on the application thread, the
+  // upcoming entries are therefore taken when a file is opened or queued
+  std::vector<CFileItem> upcoming;
+  const int count = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioLookAhead;
+  PLAYLIST::CPlayListPlayer& playlistPlayer = CServiceBroker::GetPlaylistPlayer();
+  if (count > 0 && playlistPlayer.GetCurrentPlaylist() == PLAYLIST_MUSIC)
+  {
+    const PLAYLIST::CPlayList& playlist = playlistPlayer.GetPlaylist(PLAYLIST_MUSIC);
+
+    // the file is either the current entry of the playlist or the next one
+    int offset = -1;
+    for (int i = 0; i <= 1 && offset < 0; i++)
+    {
+      const int index = playlistPlayer.GetNextSong(i);
+      if (index >= 0 && index < playlist.size() && playlist[index]->GetPath() == file.GetPath())
+        offset = i;
+    }
+
+    for (int i = offset + 1; offset >= 0 && i <= offset + count; i++)
+    {
+      const int index = playlistPlayer.GetNextSong(i);
+      if (index < 0 || index >= playlist.size())
+        break;
+
+      const CFileItem& item = *playlist[index];
+      if (CanLookAhead(item, file) &&
+          std::none_of(upcoming.begin(), upcoming.end(),
+                       [&item](const CFileItem& entry) { return IsSameFile(entry, item); }))
+        upcoming.push_back(item);
+    }
+  }
+
+  std::vector<StreamInfo*> dropped;
+  bool start = false;
+  {
+    CSingleLock lock(m_lookAheadLock);
+    for (auto it = m_lookAhead.begin(); it != m_lookAhead.end();)
+    {
+      // keep the entry of the file as it is taken when it's queued
+      if (IsSameFile(it->m_fileItem, file) ||
+          std::any_of(upcoming.begin(), upcoming.end(),
+                      [&it](const CFileItem& item) { return IsSameFile(item, it->m_fileItem); }))
+      {
+        ++it;
+        continue;
+      }
+      if (it->m_stream)
+        dropped.push_back(it->m_stream);
+      it = m_lookAhead.erase(it);
+    }
+
+    for (const auto& item : upcoming)
+    {
+      if (std::none_of(m_lookAhead.begin(), m_lookAhead.end(),
+                       [&item](const LookAheadEntry& entry) { return IsSameFile(entry.m_fileItem, item); }))
+      {
+        LookAheadEntry entry;
+        entry.m_fileItem = item;
+        m_lookAhead.push_back(entry);
+      }
+    }
+
+    if (!m_lookAheadRunning && !m_lookAheadStop && !upcoming.empty())
+    {
+      m_lookAheadRunning = true;
+      start = true;
+    }
+  }
+
+  // closing the decoders of the dropped entries may have to wait for the network,
+  // so it is done on a job that CloseFile waits for like the look-ahead itself
+  if (!dropped.empty())
+  {
+    {
+      CSingleLock lock(m_streamsLock);
+      m_jobCounter++;
+    }
+    CJobManager::GetInstance().Submit([dropped]() {
+      for (auto si : dropped)
+      {
+        si->m_decoder.Destroy();
+        delete si;
+      }
+    }, this, CJob::PRIORITY_LOW);
+  }
+
+  if (start)
+  {
+    {
+      CSingleLock lock(m_streamsLock);
+      m_jobCounter++;
+    }
+    CJobManager::GetInstance().Submit([this]() { LookAhead(); }, this, CJob::PRIORITY_LOW);
+  }
+}
+
+void PAPlayer::LookAhead()
+{
+  CSingleLock lock(m_lookAheadLock);
+  while (!m_lookAheadStop)
+  {
+    auto it = std::find_if(m_lookAhead.begin(), m_lookAhead.end(),
+                           [](const LookAheadEntry& entry) { return !entry.m_tried; });
+    if (it == m_lookAhead.end())
+      break;
+
+    it->m_tried = true;
+    it->m_opening = true;
+    const CFileItem item = it->m_fileItem;
+    lock.Leave();
+
+    CStopWatch timer;
+    timer.StartZero();
+    StreamInfo* si = new StreamInfo();
+    si->m_fileItem = item;
+    bool ready = si->m_decoder.Create(item, item.m_lStartOffset) && PrimeDecoder(si->m_decoder);
+    CLog::Log(LOGDEBUG, "PAPlayer::LookAhead - %s %s in %u ms", CURL::GetRedacted(item.GetPath()).c_str(),
+              ready ? "opened" : "failed to open", static_cast<unsigned int>(timer.GetElapsedMilliseconds()));
+
+    lock.Enter();
+    // the entry is gone if the playlist changed meanwhile
+    it = std::find_if(m_lookAhead.begin(), m_lookAhead.end(),
+                      [&item](const LookAheadEntry& entry) { return IsSameFile(entry.m_fileItem, item); });
+    if (it != m_lookAhead.end())
+    {
+      it->m_opening = false;
+      if (ready)
+      {
+        it->m_stream = si;
+        si = nullptr;
+      }
+    }
+    m_lookAheadCondition.notifyAll();
+
+    if (si)
+    {
+      CSingleExit exit(m_lookAheadLock);
+      si->m_decoder.Destroy();
+      delete si;
+    }
+  }
+  m_lookAheadRunning = false;
+  m_lookAheadCondition.notifyAll();
+}
+
+bool PAPlayer::PrimeDecoder(CAudioDecoder& decoder)
+{
+  // decode until the pcm buffer of the decoder is full, it's only read once
+  // the stream is queued
+  while (decoder.GetStatus() == STATUS_QUEUING)
+  {
+    if (m_lookAheadStop)
+      return false;
+
+    const int result = decoder.ReadSamples(PACKET_SIZE);
+    if (result == RET_ERROR)
+      return false;
+    if (result == RET_SLEEP)
+      CThread::Sleep(1);
+  }
+  return decoder.GetStatus() != STATUS_NO_FILE;
+}
+
+PAPlayer::StreamInfo* PAPlayer::TakeLookAhead(const CFileItem& file)
+{
+  CSingleLock lock(m_lookAheadLock);
+  while (true)
+  {
+    auto it = std::find_if(m_lookAhead.begin(), m_lookAhead.end(),
+                           [&file](const LookAheadEntry& entry) { return IsSameFile(entry.m_fileItem, file); });
+    if (it == m_lookAhead.end())
+      return nullptr;
+
+    // waiting for the decoder being opened is faster than opening it again
+    if (it->m_opening)
+    {
+      m_lookAheadCondition.wait(lock);
+      continue;
+    }
+
+    StreamInfo* si = it->m_stream;
+    m_lookAhead.erase(it);
+    return si;
+  }
+}
+
+void PAPlayer::ClearLookAhead()
+{
+  std::list<LookAheadEntry> entries;
+  {
+    CSingleLock lock(m_lookAheadLock);
+    m_lookAhead.swap(entries);
+  }
+
+  for (auto& entry : entries)
+  {
+    if (entry.m_stream)
+    {
+      entry.m_stream->m_decoder.Destroy();
+      delete entry.m_stream;
+    }
+  }
+}
+
 void PAPlayer::UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime)
 {
   // if no crossfading or cue sheet, wait for eof
@@ -524,7 +781,9 @@ bool PAPlayer::CloseFile(bool reopen)
   /* wait for the thread to terminate */
   StopThread(true);//true - wait for end of thread
 
-  // wait for any pending jobs to complete
+  // wait for any pending jobs to complete, the look-ahead stops after the
+  // decoder it is opening
+  m_lookAheadStop = true;
   {
     CSingleLock lock(m_streamsLock);
     while (m_jobCounter > 0)
@@ -534,6 +793,18 @@ bool PAPlayer::CloseFile(bool reopen)
       lock.Enter();
     }
   }
+  ClearLookAhead();
+  m_lookAheadStop = false;
+
+  TransitionStats stats;
+  {
+    CSingleLock lock(m_streamsLock);
+    std::swap(stats, m_transitionStats);
+  }
+  if (stats.m_streams > 0)
+    CLog::Log(LOGINFO, "PAPlayer::CloseFile - %u streams, %u opened in advance, %u gaps, ready in %u ms on average, %u ms max",
+              stats.m_streams, stats.m_lookAheads, stats.m_gaps,
+              static_cast<unsigned int>(stats.m_totalReadyMs / stats.m_streams), stats.m_maxReadyMs);
 
   return true;
 }
@@ -626,6 +897,7 @@ inline void PAPlayer::ProcessStreams(double &freeBufferTime)
     /* if the stream is finishing */
     if ((si->m_playNextTriggered && si->m_stream && !si->m_stream->IsFading()) || !ProcessStream(si, freeBufferTime))
     {
+      const bool nextRequested = si->m_prepareTriggered;
       if (!si->m_prepareTriggered)
       {
         if (si->m_waitOnDrain)
@@ -645,6 +917,13 @@ inline void PAPlayer::ProcessStreams(double &freeBufferTime)
         /* if it was the last stream */
         if (itt == m_streams.end())
         {
+          /* the next stream was requested in time but isn't ready yet */
+          if (nextRequested && !m_isFinished)
+          {
+            m_transitionStats.m_gaps++;
+            CLog::Log(LOGDEBUG, "PAPlayer::ProcessStreams - Next stream not ready at the end of the stream");
+          }
+
           /* if it didnt trigger the next queue item */
           if (!si->m_prepareTriggered)
           {
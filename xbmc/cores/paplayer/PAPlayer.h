@@ -12,6 +12,7 @@
 #include "FileItem.h"
 #include "cores/AudioEngine/Interfaces/IAudioCallback.h"
 #include "cores/IPlayer.h"
+#include "threads/Condition.h"
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 #include "utils/Job.h"
@@ -113,6 +114,25 @@ private:
 
   typedef std::list<StreamInfo*> StreamList;
 
+  /* transition timings of a playlist run, logged and reset by CloseFile */
+  struct TransitionStats
+  {
+    unsigned int m_streams = 0;          /* number of streams that have been made ready to play */
+    unsigned int m_lookAheads = 0;       /* of those, the ones opened in advance by the look-ahead */
+    unsigned int m_gaps = 0;             /* number of streams that ended before the next one was ready */
+    unsigned int m_lastReadyMs = 0;      /* time the last stream took from being queued until ready */
+    unsigned int m_maxReadyMs = 0;
+    uint64_t m_totalReadyMs = 0;
+  };
+
+  struct LookAheadEntry
+  {
+    CFileItem m_fileItem;
+    StreamInfo* m_stream = nullptr;      /* the stream with its decoder opened and primed */
+    bool m_opening = false;              /* if the decoder is being opened */
+    bool m_tried = false;                /* if opening the decoder has been tried */
+  };
+
   bool                m_signalSpeedChange;   /* true if OnPlaybackSpeedChange needs to be called */
   bool m_signalStarted = true;
   std::atomic_int m_playbackSpeed;           /* the playback speed (1 = normal) */
@@ -134,8 +154,20 @@ private:
   int64_t             m_newForcedPlayerTime;
   int64_t             m_newForcedTotalTime;
   std::unique_ptr<CProcessInfo> m_processInfo;
+  TransitionStats     m_transitionStats;     /* guarded by m_streamsLock */
+
+  CCriticalSection    m_lookAheadLock;       /* lock for the look-ahead entries */
+  XbmcThreads::ConditionVariable m_lookAheadCondition;
+  std::list<LookAheadEntry> m_lookAhead;     /* upcoming playlist entries, in playing order */
+  bool                m_lookAheadRunning = false; /* if the look-ahead job is running */
+  std::atomic_bool    m_lookAheadStop{false};
 
   bool QueueNextFileEx(const CFileItem &file, bool fadeIn);
+  void UpdateLookAhead(const CFileItem& file);
+  void ClearLookAhead();
+  void LookAhead();
+  StreamInfo* TakeLookAhead(const CFileItem& file);
+  bool PrimeDecoder(CAudioDecoder& decoder);
   void SoftStart(bool wait = false);
   void SoftStop(bool wait = false, bool close = true);
   void CloseAllStreams(bool fade = true);
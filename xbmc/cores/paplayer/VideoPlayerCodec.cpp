@@ -22,12 +22,15 @@
 #include "utils/StringUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 VideoPlayerCodec::VideoPlayerCodec()
 {
   m_CodecName = "VideoPlayer";
   m_pDemuxer = NULL;
   m_pInputStream = NULL;
   m_pAudioCodec = NULL;
+  m_pPacket = nullptr;
   m_nAudioStream = -1;
   m_nDecodedLen = 0;
   m_bInited = false;
@@ -214,7 +217,7 @@ bool VideoPlayerCodec::Init(const CFileItem &file, unsigned int filecache)
   m_bCanSeek = false;
   if (m_pInputStream->Seek(0, SEEK_POSSIBLE))
   {
-    if (Seek(1))
+    if (Seek(1) >= 0)
     {
       // rewind stream to beginning
       Seek(0);
@@ -288,6 +291,12 @@ bool VideoPlayerCodec::Init(const CFileItem &file, unsigned int filecache)
 
 void VideoPlayerCodec::DeInit()
 {
+  if (m_pPacket)
+  {
+    CDVDDemuxUtils::FreeDemuxPacket(m_pPacket);
+    m_pPacket = nullptr;
+  }
+
   if (m_pDemuxer != NULL)
   {
     delete m_pDemuxer;
@@ -320,18 +329,49 @@ void VideoPlayerCodec::DeInit()
   m_bInited = false;
 }
 
-bool VideoPlayerCodec::Seek(int64_t iSeekTime)
+int64_t VideoPlayerCodec::Seek(int64_t iSeekTime)
 {
   // default to announce backwards seek if !m_pPacket to not make FFmpeg
   // skip mpeg audio frames at playback start
   bool seekback = true;
 
+  if (m_pPacket)
+    CDVDDemuxUtils::FreeDemuxPacket(m_pPacket);
+  m_pPacket = nullptr;
+
   bool ret = m_pDemuxer->SeekTime((int)iSeekTime, seekback);
   m_pAudioCodec->Reset();
 
   m_nDecodedLen = 0;
 
-  return ret;
+  if (!ret)
+    return -1;
+
+  // the demuxer ends up on a packet before the requested time, decoding starts there
+  m_pPacket = ReadPacket();
+  if (m_pPacket && m_pPacket->pts != DVD_NOPTS_VALUE)
+    return std::max(0, DVD_TIME_TO_MSEC(m_pPacket->pts));
+
+  return iSeekTime;
+}
+
+DemuxPacket* VideoPlayerCodec::ReadPacket()
+{
+  DemuxPacket* pPacket = m_pPacket;
+  m_pPacket = nullptr;
+
+  while (!pPacket)
+  {
+    pPacket = m_pDemuxer->Read();
+    if (!pPacket)
+      break;
+    if (pPacket->iStreamId != m_nAudioStream)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+      pPacket = nullptr;
+    }
+  }
+  return pPacket;
 }
 
 int VideoPlayerCodec::ReadPCM(unsigned char *pBuffer, int size, int *actualsize)
@@ -365,12 +405,7 @@ int VideoPlayerCodec::ReadPCM(unsigned char *pBuffer, int size, int *actualsize)
 
   if (!bytes)
   {
-    DemuxPacket* pPacket;
-    do
-    {
-      pPacket = m_pDemuxer->Read();
-    } while (pPacket && pPacket->iStreamId != m_nAudioStream);
-
+    DemuxPacket* pPacket = ReadPacket();
     if (!pPacket)
     {
       return READ_EOF;
@@ -421,8 +456,6 @@ int VideoPlayerCodec::ReadPCM(unsigned char *pBuffer, int size, int *actualsize)
 
 int VideoPlayerCodec::ReadRaw(uint8_t **pBuffer, int *bufferSize)
 {
-  DemuxPacket* pPacket;
-
   m_nDecodedLen = 0;
   DVDAudioFrame audioframe;
 
@@ -432,11 +465,7 @@ int VideoPlayerCodec::ReadRaw(uint8_t **pBuffer, int *bufferSize)
     return READ_SUCCESS;
   }
 
-  do
-  {
-    pPacket = m_pDemuxer->Read();
-  } while (pPacket && pPacket->iStreamId != m_nAudioStream);
-
+  DemuxPacket* pPacket = ReadPacket();
   if (!pPacket)
   {
     return READ_EOF;
@@ -25,7 +25,7 @@ public:
   ~VideoPlayerCodec() override;
 
   bool Init(const CFileItem &file, unsigned int filecache) override;
-  bool Seek(int64_t iSeekTime) override;
+  int64_t Seek(int64_t iSeekTime) override;
   int ReadPCM(unsigned char *pBuffer, int size, int *actualsize) override;
   int ReadRaw(uint8_t **pBuffer, int *bufferSize) override;
   bool CanInit() override;
@@ -40,10 +40,12 @@ public:
 
 private:
   CAEStreamInfo::DataType GetPassthroughStreamType(AVCodecID codecId, int samplerate, int profile);
+  DemuxPacket* ReadPacket();
 
   CDVDDemux* m_pDemuxer;
   std::shared_ptr<CDVDInputStream> m_pInputStream;
   CDVDAudioCodec* m_pAudioCodec;
+  DemuxPacket* m_pPacket; ///< audio packet read by Seek(), decoded next
 
   std::string m_strContentType;
   std::string m_strFileName;
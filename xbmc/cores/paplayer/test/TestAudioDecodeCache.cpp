@@ -0,0 +1,152 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/paplayer/AudioDecodeCache.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const unsigned int FRAME_SIZE = 4;
+// blocks of 64 bytes
+const unsigned int BLOCK_FRAMES = 16;
+
+std::vector<uint8_t> MakeData(size_t size, uint8_t value)
+{
+  return std::vector<uint8_t>(size, value);
+}
+} // namespace
+
+TEST(TestAudioDecodeCache, AddAndRead)
+{
+  CAudioDecodeCache cache(BLOCK_FRAMES);
+  cache.SetMaxSize(1024);
+
+  std::vector<uint8_t> data = MakeData(64, 1);
+  cache.Add("a.flac", FRAME_SIZE, 128, data.data(), data.size(), false);
+  data = MakeData(64, 2);
+  cache.Add("a.flac", FRAME_SIZE, 192, data.data(), data.size(), true);
+
+  uint64_t end;
+  bool eof;
+  ASSERT_TRUE(cache.GetRange("a.flac", FRAME_SIZE, 160, end, eof));
+  EXPECT_EQ(256u, end);
+  EXPECT_TRUE(eof);
+  EXPECT_FALSE(cache.GetRange("a.flac", FRAME_SIZE, 64, end, eof));
+  EXPECT_FALSE(cache.GetRange("a.flac", FRAME_SIZE, 256, end, eof));
+
+  uint8_t buffer[64];
+  EXPECT_EQ(64u, cache.Read("a.flac", FRAME_SIZE, 160, buffer, sizeof(buffer)));
+  EXPECT_EQ(1, buffer[0]);
+  EXPECT_EQ(2, buffer[63]);
+  EXPECT_EQ(32u, cache.Read("a.flac", FRAME_SIZE, 224, buffer, sizeof(buffer)));
+  EXPECT_EQ(0u, cache.Read("a.flac", FRAME_SIZE, 64, buffer, sizeof(buffer)));
+  EXPECT_EQ(0u, cache.Read("a.flac", 2, 160, buffer, sizeof(buffer)));
+}
+
+TEST(TestAudioDecodeCache, RangesKeptOverSeeks)
+{
+  CAudioDecodeCache cache(BLOCK_FRAMES);
+  cache.SetMaxSize(1024);
+
+  std::vector<uint8_t> data = MakeData(100, 1);
+  cache.Add("a.flac", FRAME_SIZE, 0, data.data(), data.size(), false);
+  // a decoder that seeked forward adds a second range
+  cache.Add("a.flac", FRAME_SIZE, 512, data.data(), data.size(), false);
+
+  uint64_t end;
+  bool eof;
+  ASSERT_TRUE(cache.GetRange("a.flac", FRAME_SIZE, 0, end, eof));
+  EXPECT_EQ(100u, end);
+  ASSERT_TRUE(cache.GetRange("a.flac", FRAME_SIZE, 540, end, eof));
+  EXPECT_EQ(612u, end);
+  EXPECT_FALSE(eof);
+  EXPECT_FALSE(cache.GetRange("a.flac", FRAME_SIZE, 300, end, eof));
+  EXPECT_EQ(4u * 64u, cache.GetSize());
+
+  // audio decoded again after seeking back into a range joins it
+  cache.Add("a.flac", FRAME_SIZE, 40, data.data(), data.size(), false);
+  ASSERT_TRUE(cache.GetRange("a.flac", FRAME_SIZE, 0, end, eof));
+  EXPECT_EQ(140u, end);
+
+  // a block holds one run, audio apart from it within the block replaces it
+  cache.Add("a.flac", FRAME_SIZE, 640, data.data(), 16, false);
+  cache.Add("a.flac", FRAME_SIZE, 680, data.data(), 16, false);
+  EXPECT_FALSE(cache.GetRange("a.flac", FRAME_SIZE, 640, end, eof));
+  ASSERT_TRUE(cache.GetRange("a.flac", FRAME_SIZE, 680, end, eof));
+  EXPECT_EQ(696u, end);
+}
+
+TEST(TestAudioDecodeCache, EndOfFile)
+{
+  CAudioDecodeCache cache(BLOCK_FRAMES);
+  cache.SetMaxSize(1024);
+
+  // codecs report the end of the file without data
+  std::vector<uint8_t> data = MakeData(100, 1);
+  cache.Add("a.flac", FRAME_SIZE, 0, data.data(), data.size(), false);
+  cache.Add("a.flac", FRAME_SIZE, 300, nullptr, 0, true);
+
+  uint64_t end;
+  bool eof;
+  ASSERT_TRUE(cache.GetRange("a.flac", FRAME_SIZE, 0, end, eof));
+  EXPECT_FALSE(eof);
+
+  cache.Add("a.flac", FRAME_SIZE, 100, nullptr, 0, true);
+  ASSERT_TRUE(cache.GetRange("a.flac", FRAME_SIZE, 0, end, eof));
+  EXPECT_EQ(100u, end);
+  EXPECT_TRUE(eof);
+}
+
+TEST(TestAudioDecodeCache, LeastRecentlyUsed)
+{
+  CAudioDecodeCache cache(BLOCK_FRAMES);
+  cache.SetMaxSize(256);
+
+  std::vector<uint8_t> data = MakeData(128, 1);
+  cache.Add("a.flac", FRAME_SIZE, 0, data.data(), data.size(), true);
+  cache.Add("b.flac", FRAME_SIZE, 0, data.data(), data.size(), true);
+
+  // the first block of a is used, its second block is dropped for c
+  uint64_t end;
+  bool eof;
+  ASSERT_TRUE(cache.GetRange("a.flac", FRAME_SIZE, 0, end, eof));
+  cache.Add("c.flac", FRAME_SIZE, 0, data.data(), 64, false);
+
+  ASSERT_TRUE(cache.GetRange("a.flac", FRAME_SIZE, 0, end, eof));
+  EXPECT_EQ(64u, end);
+  EXPECT_FALSE(eof);
+  ASSERT_TRUE(cache.GetRange("b.flac", FRAME_SIZE, 0, end, eof));
+  EXPECT_EQ(128u, end);
+  EXPECT_TRUE(eof);
+  EXPECT_TRUE(cache.GetRange("c.flac", FRAME_SIZE, 0, end, eof));
+  EXPECT_EQ(256u, cache.GetSize());
+
+  cache.SetMaxSize(0);
+  EXPECT_EQ(0u, cache.GetSize());
+  EXPECT_FALSE(cache.GetRange("a.flac", FRAME_SIZE, 0, end, eof));
+}
+
+TEST(TestAudioDecodeCache, LatestPartOfLargeFile)
+{
+  CAudioDecodeCache cache(BLOCK_FRAMES);
+  cache.SetMaxSize(256);
+
+  std::vector<uint8_t> data = MakeData(200, 1);
+  cache.Add("a.flac", FRAME_SIZE, 0, data.data(), data.size(), false);
+  cache.Add("a.flac", FRAME_SIZE, 200, data.data(), data.size(), false);
+
+  uint64_t end;
+  bool eof;
+  EXPECT_FALSE(cache.GetRange("a.flac", FRAME_SIZE, 188, end, eof));
+  ASSERT_TRUE(cache.GetRange("a.flac", FRAME_SIZE, 192, end, eof));
+  EXPECT_EQ(400u, end);
+  EXPECT_EQ(256u, cache.GetSize());
+}
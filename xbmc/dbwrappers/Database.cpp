@@ -14,8 +14,11 @@
 #include "utils/log.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "sqlitedataset.h"
+#include "DatabaseConnectionPool.h"
 #include "DatabaseManager.h"
+#include "FullTextQuery.h"
 #include "DbUrl.h"
 #include "ServiceBroker.h"
 
@@ -27,10 +30,28 @@
 #include "platform/posix/ConvUtils.h"
 #endif
 
+#include <algorithm>
+
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
 
+const size_t CDatabase::DELETE_BATCH_SIZE;
+
+namespace
+{
+// everything that makes a connection, only connections with equal keys are reused
+std::string GetPoolKey(const std::string &dbName, const DatabaseSettings &settings)
+{
+  return StringUtils::Join(std::vector<std::string>{settings.type, settings.host, settings.port,
+                                                    settings.user, settings.pass, dbName,
+                                                    settings.key, settings.cert, settings.ca,
+                                                    settings.capath, settings.ciphers,
+                                                    settings.compression ? "1" : "0"},
+                           "\n");
+}
+}
+
 void CDatabase::Filter::AppendField(const std::string &strField)
 {
   if (strField.empty())
@@ -300,6 +321,14 @@ std::string CDatabase::GetSingleValue(const std::string &query)
   return GetSingleValue(query, m_pDS);
 }
 
+int64_t CDatabase::GetChangeCount()
+{
+  const std::string changes = GetSingleValue("SELECT iChanges FROM changecount");
+  if (changes.empty())
+    return -1;
+  return strtoll(changes.c_str(), nullptr, 10);
+}
+
 bool CDatabase::DeleteValues(const std::string &strTable, const Filter &filter /* = Filter() */)
 {
   std::string strQuery;
@@ -449,7 +478,30 @@ bool CDatabase::Open(const DatabaseSettings &settings)
 
   std::string dbName = dbSettings.name;
   dbName += StringUtils::Format("%d", GetSchemaVersion());
-  return Connect(dbName, dbSettings, false);
+
+  // take a warm connection this thread used before
+  CDatabaseConnectionPool &pool = CServiceBroker::GetDatabaseManager().GetConnectionPool();
+  const std::string poolKey = GetPoolKey(dbName, dbSettings);
+  std::unique_ptr<dbiplus::Database> pooled = pool.Acquire(poolKey, dbName);
+  if (pooled)
+  {
+    m_pDB = std::move(pooled);
+    m_pDS.reset(m_pDB->CreateDataset());
+    m_pDS2.reset(m_pDB->CreateDataset());
+    m_openCount = 1;
+  }
+  else
+  {
+    const int64_t start = CurrentHostCounter();
+    if (!Connect(dbName, dbSettings, false))
+      return false;
+    pool.AddConnect(dbName, CurrentHostCounter() - start);
+  }
+
+  // Close() returns the connection to the pool
+  m_poolKey = poolKey;
+  m_poolName = dbName;
+  return true;
 }
 
 void CDatabase::InitSettings(DatabaseSettings &dbSettings)
@@ -494,6 +546,8 @@ void CDatabase::DropAnalytics()
 
 bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSettings, bool create)
 {
+  m_fullTextIndexes.clear();
+
   // create the appropriate database structure
   if (dbSettings.type == "sqlite3")
   {
@@ -608,14 +662,21 @@ void CDatabase::Close()
   m_openCount = 0;
   m_multipleExecute = false;
 
+  const std::string poolKey = std::move(m_poolKey);
+  m_poolKey.clear();
+
   if (nullptr == m_pDB)
     return;
   if (nullptr != m_pDS)
     m_pDS->close();
-  m_pDB->disconnect();
-  m_pDB.reset();
+  // the datasets refer to the connection
   m_pDS.reset();
   m_pDS2.reset();
+  if (!poolKey.empty())
+    CServiceBroker::GetDatabaseManager().GetConnectionPool().Release(poolKey, m_poolName, std::move(m_pDB));
+  else
+    m_pDB->disconnect();
+  m_pDB.reset();
 }
 
 bool CDatabase::Compress(bool bForce /* =true */)
@@ -764,3 +825,163 @@ bool CDatabase::BuildSQL(const std::string &strBaseDir, const std::string &strQu
 
   return BuildSQL(strQuery, filter, strSQL);
 }
+
+void CDatabase::CreateFullTextIndex(const FullTextIndex& index)
+{
+  m_fullTextIndexes.erase(index.name);
+
+  const std::string strColumns = StringUtils::Join(index.columns, ", ");
+  try
+  {
+    if (!m_sqlite)
+    {
+      m_pDS->exec("CREATE FULLTEXT INDEX " + index.name + " ON " + index.table + " (" + strColumns + ")");
+      return;
+    }
+
+    // External content table, only the index is stored and the triggers keep it in sync
+    std::string strNew = "NEW." + StringUtils::Join(index.columns, ", NEW.");
+    std::string strOld = "OLD." + StringUtils::Join(index.columns, ", OLD.");
+    m_pDS->exec("DROP TABLE IF EXISTS " + index.name);
+    m_pDS->exec("CREATE VIRTUAL TABLE " + index.name + " USING fts5(" + strColumns +
+                ", content='" + index.table + "', content_rowid='" + index.idField + "')");
+    m_pDS->exec("CREATE TRIGGER tgrInsert_" + index.name + " AFTER INSERT ON " + index.table +
+                " FOR EACH ROW BEGIN"
+                " INSERT INTO " + index.name + " (rowid, " + strColumns + ")"
+                " VALUES (NEW." + index.idField + ", " + strNew + ");"
+                " END");
+    m_pDS->exec("CREATE TRIGGER tgrDelete_" + index.name + " AFTER DELETE ON " + index.table +
+                " FOR EACH ROW BEGIN"
+                " INSERT INTO " + index.name + " (" + index.name + ", rowid, " + strColumns + ")"
+                " VALUES ('delete', OLD." + index.idField + ", " + strOld + ");"
+                " END");
+    m_pDS->exec("CREATE TRIGGER tgrUpdate_" + index.name + " AFTER UPDATE OF " + strColumns +
+                " ON " + index.table + " FOR EACH ROW BEGIN"
+                " INSERT INTO " + index.name + " (" + index.name + ", rowid, " + strColumns + ")"
+                " VALUES ('delete', OLD." + index.idField + ", " + strOld + ");"
+                " INSERT INTO " + index.name + " (rowid, " + strColumns + ")"
+                " VALUES (NEW." + index.idField + ", " + strNew + ");"
+                " END");
+    // The triggers were missing during the update of the tables
+    m_pDS->exec("INSERT INTO " + index.name + " (" + index.name + ") VALUES ('rebuild')");
+  }
+  catch (...)
+  {
+    // e.g. SQLite built without FTS5, searching falls back to LIKE
+    CLog::Log(LOGWARNING, "%s - unable to create full text index %s", __FUNCTION__,
+              index.name.c_str());
+  }
+}
+
+bool CDatabase::GetFullTextFilter(const FullTextIndex& index,
+                                  const std::string& search,
+                                  Filter& filter,
+                                  std::string* score /* = nullptr */)
+{
+  CFullTextQuery query(search);
+  if (query.IsEmpty())
+    return false;
+
+  auto it = m_fullTextIndexes.find(index.name);
+  if (it == m_fullTextIndexes.end())
+  {
+    std::string strSQL;
+    if (m_sqlite)
+      strSQL = PrepareSQL("SELECT name FROM sqlite_master WHERE type = 'table' AND name = '%s'",
+                          index.name.c_str());
+    else
+      strSQL = PrepareSQL("SELECT index_name FROM information_schema.statistics "
+                          "WHERE table_schema = DATABASE() AND table_name = '%s' "
+                          "AND index_name = '%s'",
+                          index.table.c_str(), index.name.c_str());
+    it = m_fullTextIndexes.insert(std::make_pair(index.name, !GetSingleValue(strSQL).empty())).first;
+  }
+  if (!it->second)
+    return false;
+
+  std::string strScore;
+  if (m_sqlite)
+  {
+    // FTS5 ranks with bm25, lower is better
+    filter.AppendJoin(PrepareSQL("JOIN %s ON %s.rowid = %s.%s", index.name.c_str(),
+                                 index.name.c_str(), index.table.c_str(), index.idField.c_str()));
+    filter.AppendWhere(PrepareSQL("%s MATCH '%s'", index.name.c_str(),
+                                  query.GetSQLiteMatch().c_str()));
+    strScore = index.name + ".rank";
+  }
+  else
+  {
+    strScore = PrepareSQL("MATCH(%s.%s) AGAINST('%s' IN BOOLEAN MODE)", index.table.c_str(),
+                          StringUtils::Join(index.columns, ", " + index.table + ".").c_str(),
+                          query.GetMySQLMatch().c_str());
+    filter.AppendWhere(strScore);
+  }
+
+  // words too short for the index have to be found anywhere in the columns
+  for (const auto& word : query.GetShortWords())
+  {
+    std::vector<std::string> likes;
+    for (const auto& column : index.columns)
+      likes.push_back(PrepareSQL("%s.%s LIKE '%%%s%%'", index.table.c_str(), column.c_str(),
+                                 word.c_str()));
+    filter.AppendWhere("(" + StringUtils::Join(likes, " OR ") + ")");
+  }
+
+  if (score)
+  {
+    *score = strScore + " AS ftsScore";
+    strScore = "ftsScore";
+  }
+  filter.AppendOrder(m_sqlite ? strScore : strScore + " DESC");
+  return true;
+}
+
+void CDatabase::CreateChangeCountTable()
+{
+  CLog::Log(LOGINFO, "create changecount table");
+  m_pDS->exec("CREATE TABLE changecount (iChanges BIGINT)");
+  m_pDS->exec("INSERT INTO changecount (iChanges) VALUES (0)");
+}
+
+void CDatabase::CreateChangeCountTriggers(const std::string& table,
+                                          const std::vector<std::string>& events /* = {"INSERT", "UPDATE", "DELETE"} */)
+{
+  for (const auto& event : events)
+  {
+    std::string name = StringUtils::Format("changecount_%s_%s", event.c_str(), table.c_str());
+    StringUtils::ToLower(name);
+    m_pDS->exec(StringUtils::Format("CREATE TRIGGER %s AFTER %s ON %s FOR EACH ROW BEGIN "
+                                    "UPDATE changecount SET iChanges = iChanges + 1; END",
+                                    name.c_str(), event.c_str(), table.c_str()));
+  }
+}
+
+void CDatabase::DeleteByIds(const std::string& table,
+                            const std::string& idField,
+                            const std::vector<int>& ids)
+{
+  // a transaction of the caller isn't split up
+  const bool ownTransactions = !m_pDB->in_transaction();
+  for (size_t i = 0; i < ids.size(); i += DELETE_BATCH_SIZE)
+  {
+    std::string strIds;
+    for (size_t j = i; j < std::min(ids.size(), i + DELETE_BATCH_SIZE); j++)
+      strIds += StringUtils::Format("%i,", ids[j]);
+    strIds.pop_back();
+
+    if (ownTransactions)
+      BeginTransaction();
+    try
+    {
+      m_pDS->exec("DELETE FROM " + table + " WHERE " + idField + " IN (" + strIds + ")");
+    }
+    catch (...)
+    {
+      if (ownTransactions)
+        RollbackTransaction();
+      throw;
+    }
+    if (ownTransactions)
+      CommitTransaction();
+  }
+}
@@ -13,7 +13,9 @@ namespace dbiplus {
   class Dataset;
 }
 
+#include <map>
 #include <memory>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -93,6 +95,17 @@ public:
   };
 
 
+  /*! \brief Full text index over columns of a table
+   A FTS5 table kept up to date by triggers on SQLite, a FULLTEXT index on MySQL.
+   */
+  struct FullTextIndex
+  {
+    std::string name; ///< name of the FTS5 table or the FULLTEXT index
+    std::string table;
+    std::string idField; ///< integer primary key of the table
+    std::vector<std::string> columns;
+  };
+
   CDatabase();
   virtual ~CDatabase(void);
   bool IsOpen();
@@ -137,6 +150,13 @@ public:
    */
   bool DeleteValues(const std::string &strTable, const Filter &filter = Filter());
 
+  /*! \brief Get the number of changes made to the tables counted in the changecount table
+   The count is kept by triggers in the database, so it includes changes made by other
+   clients of a shared database.
+   \return the number of changes, -1 if the database has no change count
+   */
+  int64_t GetChangeCount();
+
   /*!
    * @brief Execute a query that does not return any result.
    *        Note that if BeginMultipleExecute() has been called, the
@@ -235,6 +255,54 @@ protected:
 
   bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
 
+  /*! \brief Create a full text index, called from CreateAnalytics()
+   Failing to create the index, e.g. with SQLite built without FTS5, is not an error,
+   GetFullTextFilter() then reports the index as missing.
+   */
+  void CreateFullTextIndex(const FullTextIndex& index);
+
+  /*! \brief Filter for the rows matching a search on a full text index, best matches first
+   Every word of the search has to match the start of a word in one of the columns, words
+   too short for the index anywhere in one of the columns.
+   \param index the index to search, its table has to be part of the query
+   \param search the search string entered by the user
+   \param filter the join, where and order are appended to
+   \param score if not null, set to the score as a field to select, e.g. "actor_fts.rank AS ftsScore",
+   and the rows are ordered by the selected field. SELECT DISTINCT can only be ordered by selected fields.
+   \return false if the index is missing or the search has no words long enough to use it
+   */
+  bool GetFullTextFilter(const FullTextIndex& index,
+                         const std::string& search,
+                         Filter& filter,
+                         std::string* score = nullptr);
+
+  /*! \brief Delete rows by their ids, DELETE_BATCH_SIZE rows per statement
+   Outside of a transaction every statement is committed on its own, so that the
+   database isn't locked for the whole of a large delete.
+   \param table the table to delete from
+   \param idField the id column of the table
+   \param ids the ids of the rows to delete
+   */
+  void DeleteByIds(const std::string& table, const std::string& idField, const std::vector<int>& ids);
+
+  /*! \brief Create the changecount table, called from CreateTables() and UpdateTables()
+   */
+  void CreateChangeCountTable();
+
+  /*! \brief Count the inserts, updates and deletes of a table in the changecount table,
+   called from CreateAnalytics()
+   MySQL before 5.7.2 and MariaDB before 10.2.3 allow one trigger per table, timing and event.
+   Where an AFTER trigger already exists, it has to count the change itself with
+   "UPDATE changecount SET iChanges = iChanges + 1" and its event is left out here.
+   \param table the table whose changes are counted
+   \param events the events to create triggers for, e.g. {"INSERT", "UPDATE"}
+   */
+  void CreateChangeCountTriggers(const std::string& table,
+                                 const std::vector<std::string>& events = {"INSERT", "UPDATE",
+                                                                           "DELETE"});
+
+  static const size_t DELETE_BATCH_SIZE = 500;
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::unique_ptr<dbiplus::Database> m_pDB;
@@ -252,6 +320,11 @@ private:
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
 
+  std::string m_poolKey; /*!< Connection pool key if Close() keeps the connection warm */
+  std::string m_poolName;
+
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  std::map<std::string, bool> m_fullTextIndexes; /*!< Full text indexes found in the database */
 };
@@ -0,0 +1,300 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DatabaseConnectionPool.h"
+
+#include "dataset.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+const unsigned int CDatabaseConnectionPool::IDLE_TIMEOUT_MS;
+const unsigned int CDatabaseConnectionPool::PING_AFTER_IDLE_MS;
+const unsigned int CDatabaseConnectionPool::MAX_IDLE_PER_THREAD;
+const unsigned int CDatabaseConnectionPool::STATS_INTERVAL_MS;
+
+namespace
+{
+double TicksToMs(int64_t ticks)
+{
+  return ticks * 1000.0 / CurrentHostFrequency();
+}
+} // namespace
+
+struct CDatabaseConnectionPool::PoolRef
+{
+  CCriticalSection section;
+  CDatabaseConnectionPool* pool;
+};
+
+/*!
+ * \brief The pools a thread released connections to, told when the thread ends
+ */
+class CDatabaseConnectionPool::CThreadConnections
+{
+public:
+  ~CThreadConnections()
+  {
+    for (const auto& weakRef : m_pools)
+    {
+      std::shared_ptr<PoolRef> ref = weakRef.lock();
+      if (!ref)
+        continue;
+
+      // the pool isn't destroyed while its connections of this thread are disconnected
+      CSingleLock lock(ref->section);
+      if (ref->pool)
+        ref->pool->OnThreadEnded(std::this_thread::get_id());
+    }
+  }
+
+  void Add(const std::shared_ptr<PoolRef>& ref)
+  {
+    m_pools.erase(std::remove_if(m_pools.begin(), m_pools.end(),
+                                 [](const std::weak_ptr<PoolRef>& pool) { return pool.expired(); }),
+                  m_pools.end());
+    for (const auto& pool : m_pools)
+    {
+      if (pool.lock() == ref)
+        return;
+    }
+    m_pools.push_back(ref);
+  }
+
+private:
+  std::vector<std::weak_ptr<PoolRef>> m_pools;
+};
+
+CDatabaseConnectionPool::CDatabaseConnectionPool(unsigned int idleTimeoutMs /* = IDLE_TIMEOUT_MS */,
+                                                 unsigned int pingAfterIdleMs /* = PING_AFTER_IDLE_MS */)
+  : m_idleTimeoutMs(idleTimeoutMs),
+    m_pingAfterIdleMs(pingAfterIdleMs),
+    m_ref(new PoolRef),
+    m_statsTimer(STATS_INTERVAL_MS)
+{
+  m_ref->pool = this;
+}
+
+CDatabaseConnectionPool::~CDatabaseConnectionPool()
+{
+  {
+    CSingleLock lock(m_ref->section);
+    m_ref->pool = nullptr;
+  }
+  Clear();
+}
+
+std::unique_ptr<dbiplus::Database> CDatabaseConnectionPool::Acquire(const std::string& key,
+                                                                    const std::string& name)
+{
+  const int64_t start = CurrentHostCounter();
+  const std::thread::id thread = std::this_thread::get_id();
+
+  while (true)
+  {
+    std::vector<std::unique_ptr<dbiplus::Database>> expired;
+    std::unique_ptr<dbiplus::Database> db;
+    unsigned int released = 0;
+    {
+      CSingleLock lock(m_section);
+      Expire(expired);
+
+      // the most recently released connection is the most likely to be alive
+      auto it = std::find_if(m_idle.rbegin(), m_idle.rend(), [&](const Connection& connection) {
+        return connection.thread == thread && connection.key == key;
+      });
+      if (it != m_idle.rend())
+      {
+        db = std::move(it->db);
+        released = it->released;
+        m_idle.erase(std::next(it).base());
+      }
+    }
+    Disconnect(expired);
+
+    if (!db)
+      return nullptr;
+
+    // only the server may have dropped a connection since it was released, and
+    // only after it was idle for a while. The ping is a round trip to the
+    // server, don't hold the lock.
+    const bool ping = XbmcThreads::SystemClockMillis() - released >= m_pingAfterIdleMs;
+    if (!ping || db->ping())
+    {
+      CSingleLock lock(m_section);
+      Stats& stats = m_stats[name];
+      if (ping)
+        stats.pings++;
+      stats.reuses++;
+      stats.reuseMs += TicksToMs(CurrentHostCounter() - start);
+      return db;
+    }
+
+    CLog::Log(LOGDEBUG, "%s - idle connection to %s failed the health check", __FUNCTION__,
+              name.c_str());
+    db->disconnect();
+    CSingleLock lock(m_section);
+    Stats& stats = m_stats[name];
+    stats.pings++;
+    stats.discarded++;
+  }
+}
+
+void CDatabaseConnectionPool::Release(const std::string& key,
+                                      const std::string& name,
+                                      std::unique_ptr<dbiplus::Database> db)
+{
+  if (!db)
+    return;
+
+  std::vector<std::unique_ptr<dbiplus::Database>> expired;
+  if (!db->is_reusable())
+  {
+    expired.push_back(std::move(db));
+    CSingleLock lock(m_section);
+    m_stats[name].discarded++;
+  }
+  else
+  {
+    const std::thread::id thread = std::this_thread::get_id();
+
+    CSingleLock lock(m_section);
+    Expire(expired);
+
+    // drop the oldest connection of the thread beyond the limit
+    unsigned int count = 0;
+    for (auto it = m_idle.rbegin(); it != m_idle.rend(); ++it)
+    {
+      if (it->thread == thread && it->key == key && ++count >= MAX_IDLE_PER_THREAD)
+      {
+        expired.push_back(std::move(it->db));
+        m_idle.erase(std::next(it).base());
+        break;
+      }
+    }
+
+    Connection connection;
+    connection.thread = thread;
+    connection.key = key;
+    connection.name = name;
+    connection.db = std::move(db);
+    connection.released = XbmcThreads::SystemClockMillis();
+    m_idle.push_back(std::move(connection));
+
+    if (m_statsTimer.IsTimePast())
+    {
+      LogStats();
+      m_statsTimer.Set(STATS_INTERVAL_MS);
+    }
+  }
+  Disconnect(expired);
+
+  // the thread disconnects its connections when it ends
+  static thread_local CThreadConnections threadConnections;
+  threadConnections.Add(m_ref);
+}
+
+void CDatabaseConnectionPool::AddConnect(const std::string& name, int64_t ticks)
+{
+  const double ms = TicksToMs(ticks);
+
+  CSingleLock lock(m_section);
+  Stats& stats = m_stats[name];
+  stats.connects++;
+  stats.connectMs += ms;
+  stats.maxConnectMs = std::max(stats.maxConnectMs, ms);
+}
+
+void CDatabaseConnectionPool::Clear()
+{
+  std::vector<std::unique_ptr<dbiplus::Database>> connections;
+  {
+    CSingleLock lock(m_section);
+    for (auto& connection : m_idle)
+      connections.push_back(std::move(connection.db));
+    m_idle.clear();
+
+    LogStats();
+  }
+  Disconnect(connections);
+}
+
+std::map<std::string, CDatabaseConnectionPool::Stats> CDatabaseConnectionPool::GetStats() const
+{
+  CSingleLock lock(m_section);
+  return m_stats;
+}
+
+unsigned int CDatabaseConnectionPool::GetIdleCount() const
+{
+  CSingleLock lock(m_section);
+  return static_cast<unsigned int>(m_idle.size());
+}
+
+void CDatabaseConnectionPool::OnThreadEnded(std::thread::id thread)
+{
+  std::vector<std::unique_ptr<dbiplus::Database>> connections;
+  {
+    CSingleLock lock(m_section);
+    for (auto it = m_idle.begin(); it != m_idle.end();)
+    {
+      if (it->thread == thread)
+      {
+        connections.push_back(std::move(it->db));
+        it = m_idle.erase(it);
+      }
+      else
+        ++it;
+    }
+  }
+  Disconnect(connections);
+}
+
+void CDatabaseConnectionPool::Expire(std::vector<std::unique_ptr<dbiplus::Database>>& expired)
+{
+  const unsigned int now = XbmcThreads::SystemClockMillis();
+  for (auto it = m_idle.begin(); it != m_idle.end();)
+  {
+    if (now - it->released >= m_idleTimeoutMs)
+    {
+      m_stats[it->name].expired++;
+      expired.push_back(std::move(it->db));
+      it = m_idle.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+void CDatabaseConnectionPool::LogStats() const
+{
+  for (const auto& it : m_stats)
+  {
+    const Stats& stats = it.second;
+    CLog::Log(LOGDEBUG,
+              "%s - %s: %u connects (avg %.2f ms, max %.2f ms), %u reused (avg %.3f ms), "
+              "%u pinged, %u discarded, %u expired",
+              __FUNCTION__, it.first.c_str(), stats.connects,
+              stats.connects ? stats.connectMs / stats.connects : 0.0, stats.maxConnectMs,
+              stats.reuses, stats.reuses ? stats.reuseMs / stats.reuses : 0.0, stats.pings,
+              stats.discarded, stats.expired);
+  }
+}
+
+void CDatabaseConnectionPool::Disconnect(std::vector<std::unique_ptr<dbiplus::Database>>& connections)
+{
+  for (auto& db : connections)
+  {
+    if (db)
+      db->disconnect();
+  }
+  connections.clear();
+}
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dbiplus
+{
+class Database;
+}
+
+/*!
+ * \brief Warm database connections, kept per thread
+ *
+ * Most users of CDatabase open a database, run a few queries and close it
+ * again. Connecting runs the PRAGMA setup on SQLite and a full TCP and
+ * authentication handshake on MySQL every time. CDatabase::Close() hands its
+ * connection to the pool instead, and the next Open() of the same database on
+ * the same thread takes it back. A connection is only reused by the thread
+ * that released it, so connections never move between threads.
+ *
+ * Connections are only kept if dbiplus::Database::is_reusable() says so, which
+ * needs no round trip to the server. Connections that were idle for longer
+ * than the ping threshold are also checked with dbiplus::Database::ping()
+ * before they are reused, and disconnected once they were idle for longer than
+ * the timeout. The connections of a thread are disconnected when it ends.
+ */
+class CDatabaseConnectionPool
+{
+public:
+  static const unsigned int IDLE_TIMEOUT_MS = 60000;
+  static const unsigned int PING_AFTER_IDLE_MS = 5000;
+  static const unsigned int MAX_IDLE_PER_THREAD = 2;
+  static const unsigned int STATS_INTERVAL_MS = 10 * 60 * 1000;
+
+  /*!
+   * \brief Connection counters of a database
+   */
+  struct Stats
+  {
+    unsigned int connects = 0; ///< connections established
+    unsigned int reuses = 0; ///< warm connections taken from the pool
+    unsigned int discarded = 0; ///< idle connections that failed the health check
+    unsigned int expired = 0; ///< idle connections closed after the timeout
+    unsigned int pings = 0; ///< health checks of connections idle for longer than the ping threshold
+    double connectMs = 0.0; ///< total time spent connecting
+    double maxConnectMs = 0.0;
+    double reuseMs = 0.0; ///< total time spent taking connections from the pool
+  };
+
+  explicit CDatabaseConnectionPool(unsigned int idleTimeoutMs = IDLE_TIMEOUT_MS,
+                                   unsigned int pingAfterIdleMs = PING_AFTER_IDLE_MS);
+  ~CDatabaseConnectionPool();
+
+  /*!
+   * \brief Take a warm connection released by the calling thread
+   *
+   * Connections idle for longer than the ping threshold are checked with a ping.
+   * \param key identifies the database and the connection settings
+   * \param name database name the counters are kept for
+   * \return the connection, nullptr if there is no healthy one
+   */
+  std::unique_ptr<dbiplus::Database> Acquire(const std::string& key, const std::string& name);
+
+  /*!
+   * \brief Keep a connection for the calling thread
+   *
+   * Connections left in a state they can't be reused in, e.g. in a transaction,
+   * or that exceed the idle limit of the thread are disconnected.
+   */
+  void Release(const std::string& key, const std::string& name, std::unique_ptr<dbiplus::Database> db);
+
+  /*!
+   * \brief Account a new connection
+   * \param ticks time spent connecting, measured with CurrentHostCounter()
+   */
+  void AddConnect(const std::string& name, int64_t ticks);
+
+  /*!
+   * \brief Disconnect all idle connections and log the counters
+   */
+  void Clear();
+
+  std::map<std::string, Stats> GetStats() const;
+  unsigned int GetIdleCount() const;
+
+private:
+  CDatabaseConnectionPool(const CDatabaseConnectionPool&) = delete;
+  CDatabaseConnectionPool& operator=(const CDatabaseConnectionPool&) = delete;
+
+  class CThreadConnections;
+  struct PoolRef;
+
+  struct Connection
+  {
+    std::thread::id thread;
+    std::string key;
+    std::string name;
+    std::unique_ptr<dbiplus::Database> db;
+    unsigned int released;
+  };
+
+  /*!
+   * \brief Disconnect the connections of a thread that ends, called on that thread
+   */
+  void OnThreadEnded(std::thread::id thread);
+
+  /*!
+   * \brief Move connections idle for too long to expired, m_section is held
+   */
+  void Expire(std::vector<std::unique_ptr<dbiplus::Database>>& expired);
+  /*!
+   * \brief Log the counters, m_section is held
+   */
+  void LogStats() const;
+  static void Disconnect(std::vector<std::unique_ptr<dbiplus::Database>>& connections);
+
+  const unsigned int m_idleTimeoutMs;
+  const unsigned int m_pingAfterIdleMs;
+  std::shared_ptr<PoolRef> m_ref; ///< lets ending threads reach the pool while it exists
+  mutable CCriticalSection m_section;
+  std::vector<Connection> m_idle;
+  std::map<std::string, Stats> m_stats;
+  XbmcThreads::EndTime m_statsTimer;
+};
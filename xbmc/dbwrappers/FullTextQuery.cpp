@@ -0,0 +1,63 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FullTextQuery.h"
+
+const size_t CFullTextQuery::MIN_TOKEN_LENGTH;
+
+namespace
+{
+bool IsTokenChar(unsigned char c)
+{
+  // bytes of multibyte UTF-8 sequences are kept, the index tokenizers treat
+  // non ASCII letters as part of words too
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+}
+} // namespace
+
+CFullTextQuery::CFullTextQuery(const std::string& search)
+{
+  std::string token;
+  for (size_t i = 0; i <= search.size(); i++)
+  {
+    if (i < search.size() && IsTokenChar(static_cast<unsigned char>(search[i])))
+    {
+      token += search[i];
+      continue;
+    }
+    if (token.size() >= MIN_TOKEN_LENGTH)
+      m_tokens.push_back(token);
+    else if (!token.empty())
+      m_shortWords.push_back(token);
+    token.clear();
+  }
+}
+
+std::string CFullTextQuery::GetSQLiteMatch() const
+{
+  std::string match;
+  for (const auto& token : m_tokens)
+  {
+    if (!match.empty())
+      match += ' ';
+    match += "\"" + token + "\"*";
+  }
+  return match;
+}
+
+std::string CFullTextQuery::GetMySQLMatch() const
+{
+  std::string match;
+  for (const auto& token : m_tokens)
+  {
+    if (!match.empty())
+      match += ' ';
+    match += "+" + token + "*";
+  }
+  return match;
+}
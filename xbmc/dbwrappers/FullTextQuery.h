@@ -0,0 +1,54 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Search string as a full text match expression
+ *
+ * The search is split into words at anything that is not a letter or digit,
+ * every word has to match as the prefix of a word in the index. Words shorter
+ * than MIN_TOKEN_LENGTH are kept apart, MySQL doesn't index them by default,
+ * they have to be matched without the index.
+ */
+class CFullTextQuery
+{
+public:
+  static const size_t MIN_TOKEN_LENGTH = 3;
+
+  explicit CFullTextQuery(const std::string& search);
+
+  /*!
+   * \brief Whether no word is left to match, the search can't use the index
+   */
+  bool IsEmpty() const { return m_tokens.empty(); }
+
+  const std::vector<std::string>& GetTokens() const { return m_tokens; }
+
+  /*!
+   * \brief Words shorter than MIN_TOKEN_LENGTH, not part of the match expressions
+   */
+  const std::vector<std::string>& GetShortWords() const { return m_shortWords; }
+
+  /*!
+   * \brief Expression for MATCH on a SQLite FTS5 table, e.g. "dark"* "knig"*
+   */
+  std::string GetSQLiteMatch() const;
+
+  /*!
+   * \brief Expression for MATCH ... AGAINST in boolean mode, e.g. +dark* +knig*
+   */
+  std::string GetMySQLMatch() const;
+
+private:
+  std::vector<std::string> m_tokens;
+  std::vector<std::string> m_shortWords;
+};
@@ -79,6 +79,7 @@ Dataset::Dataset():
   frecno = 0;
   fbof = feof = true;
   autocommit = true;
+  query_mode = res_mode = rmRows;
   fieldIndexMapID = ~0;
 
   fields_object = new Fields();
@@ -97,6 +98,7 @@ Dataset::Dataset(Database *newDb):
   frecno = 0;
   fbof = feof = true;
   autocommit = true;
+  query_mode = res_mode = rmRows;
   fieldIndexMapID = ~0;
 
   fields_object = new Fields();
@@ -193,6 +195,7 @@ void Dataset::close(void) {
   frecno = 0;
   fbof = feof = true;
   active = false;
+  res_mode = rmRows;
 
   fieldIndexMap_Entries.clear();
   fieldIndexMap_Sorter.clear();
@@ -201,6 +204,8 @@ void Dataset::close(void) {
 
 
 bool Dataset::seek(int pos) {
+  if (res_mode == rmStream)
+    throw DbErrors("Streaming result is forward only");
   frecno = (pos<num_rows()-1)? pos: num_rows()-1;
   frecno = (frecno<0)? 0: frecno;
   fbof = feof = (num_rows()==0)? true: false;
@@ -221,6 +226,12 @@ void Dataset::refresh() {
 
 void Dataset::first() {
   if (ds_state == dsSelect) {
+    if (res_mode == rmStream) {
+      if (frecno != 0)
+        throw DbErrors("Streaming result is forward only");
+      feof = fbof = (num_rows()>0)? false : true;
+      return;
+    }
     frecno = 0;
     feof = fbof = (num_rows()>0)? false : true;
   }
@@ -228,6 +239,14 @@ void Dataset::first() {
 
 void Dataset::next() {
   if (ds_state == dsSelect) {
+    if (res_mode == rmStream) {
+      fbof = false;
+      if (!feof && fetch_row())
+        frecno++;
+      else
+        feof = true;
+      return;
+    }
     fbof = false;
     if (frecno<num_rows()-1) {
       frecno++;
@@ -239,6 +258,8 @@ void Dataset::next() {
 
 void Dataset::prev() {
   if (ds_state == dsSelect) {
+    if (res_mode == rmStream)
+      throw DbErrors("Streaming result is forward only");
     feof = false;
     if (frecno) {
       frecno--;
@@ -250,6 +271,8 @@ void Dataset::prev() {
 
 void Dataset::last() {
   if (ds_state == dsSelect) {
+    if (res_mode == rmStream)
+      throw DbErrors("Streaming result is forward only");
     frecno = (num_rows()>0)? num_rows()-1: 0;
     feof = fbof = (num_rows()>0)? false : true;
   }
@@ -280,6 +303,8 @@ void Dataset::edit() {
   }
   edit_object->resize(field_count());
   for (unsigned int i=0; i<fields_object->size(); i++) {
+       if (res_mode != rmRows)
+         result.columns.get_value(column_row(), i, (*fields_object)[i].val);
        (*edit_object)[i].props = (*fields_object)[i].props;
        (*edit_object)[i].val = (*fields_object)[i].val;
   }
@@ -366,7 +391,7 @@ const field_value Dataset::get_field_value(const char *f_name) {
       for (unsigned int i=0; i < fields_object->size(); i++)
         if (str_compare((*fields_object)[i].props.name.c_str(), f_name) == 0 || (name && str_compare((*fields_object)[i].props.name.c_str(), name) == 0)) {
           fieldIndexMap_Entries[fieldIndexMapID].fieldIndex = i;
-          return (*fields_object)[i].val;
+          return get_field_value(static_cast<int>(i));
         }
     }
     throw DbErrors("Field not found: %s",f_name);
@@ -389,6 +414,12 @@ const field_value Dataset::get_field_value(int index) {
       if (index < 0 || index >= field_count())
         throw DbErrors("Field index not found: %d",index);
 
+      if (res_mode != rmRows)
+      {
+        if (column_row() >= result.columns.num_rows())
+          return field_value("");
+        return result.columns.get_value(column_row(), index);
+      }
       return (*fields_object)[index].val;
     }
   }
@@ -397,6 +428,18 @@ const field_value Dataset::get_field_value(int index) {
 
 const sql_record* Dataset::get_sql_record()
 {
+  if (res_mode != rmRows)
+  {
+    if (column_row() >= result.columns.num_rows())
+      return NULL;
+
+    // one buffer for all rows, the strings keep their capacity
+    row_buffer.resize(result.columns.num_columns());
+    for (unsigned int i = 0; i < row_buffer.size(); i++)
+      result.columns.get_value(column_row(), i, row_buffer[i]);
+    return &row_buffer;
+  }
+
   if (result.records.empty() || frecno >= (int)result.records.size())
     return NULL;
 
@@ -113,6 +113,10 @@ public:
                       const char *newKey=NULL, const char *newCert=NULL, const char *newCA=NULL,
                       const char *newCApath=NULL, const char *newCiphers=NULL, bool newCompression = false);
   virtual void disconnect(void) { active = false; }
+/* checks without a round trip that the connection was left in a state it can be reused in */
+  virtual bool is_reusable(void) { return active && !in_transaction(); }
+/* checks that an idle connection can still be used, e.g. before it is reused */
+  virtual bool ping(void) { return is_reusable(); }
   virtual int reset(void) { return DB_COMMAND_OK; }
   virtual int create(void) { return DB_COMMAND_OK; }
   virtual int drop(void) { return DB_COMMAND_OK; }
@@ -196,6 +200,9 @@ protected:
   ParamList plist;              // Paramlist for locate
   bool fbof, feof;
   bool autocommit;		// for transactions
+  resultMode query_mode;	// storage requested for the next query
+  resultMode res_mode;		// storage of the current result
+  sql_record row_buffer;	// current row of a columnar result for get_sql_record()
 
 
 /* Variables to store SQL statements */
@@ -242,6 +249,11 @@ protected:
    Filling the fields information from select statement */
   virtual void fill_fields(void)=0;
 
+/* Fetch the next row of a streaming result into result.columns, returns false at the end */
+  virtual bool fetch_row() { return false; }
+/* Row of result.columns the dataset is positioned on */
+  unsigned int column_row() const { return res_mode == rmStream ? 0 : frecno; }
+
 /* Parse Sql - replacing fields with prefixes :OLD_ and :NEW_ with current values of OLD or NEW field. */
   void parse_sql(std::string &sql);
 
@@ -268,6 +280,14 @@ public:
 /* retrieves a query string */
   const char *getExecSql(void) { return sql.c_str(); }
 
+/* storage of the result of the next query(), applies to that query only.
+   rmColumns and rmStream results are read through fv()/get_field_value() or
+   get_sql_record(), get_result_set().records stays empty. A streaming result
+   can only be read once with next(), num_rows() is 1 while positioned on a
+   row and 0 once the end is reached. */
+  void set_result_mode(resultMode mode) { query_mode = mode; }
+  resultMode get_result_mode() { return res_mode; }
+
 /* status active is OK query */
   virtual bool isActive(void) { return active; }
 
@@ -267,6 +267,15 @@ void MysqlDatabase::disconnect(void) {
   active = false;
 }
 
+bool MysqlDatabase::is_reusable(void) {
+  return active && conn != NULL && !_in_transaction;
+}
+
+bool MysqlDatabase::ping(void) {
+  // the server drops connections that were idle for longer than wait_timeout
+  return is_reusable() && mysql_ping(conn) == 0;
+}
+
 int MysqlDatabase::create() {
   return connect(true);
 }
@@ -1405,6 +1414,7 @@ MysqlDataset::MysqlDataset():Dataset() {
   db = NULL;
   errmsg = NULL;
   autorefresh = false;
+  stream_res = NULL;
 }
 
 MysqlDataset::MysqlDataset(MysqlDatabase *newDb):Dataset(newDb) {
@@ -1412,9 +1422,11 @@ MysqlDataset::MysqlDataset(MysqlDatabase *newDb):Dataset(newDb) {
   db = newDb;
   errmsg = NULL;
   autorefresh = false;
+  stream_res = NULL;
 }
 
 MysqlDataset::~MysqlDataset() {
+   close_stream();
    if (errmsg) free(errmsg);
  }
 
@@ -1489,6 +1501,10 @@ void MysqlDataset::fill_fields() {
       (*fields_object)[i].props = result.record_header[i];
   }
 
+  // columnar results are read directly by get_field_value()
+  if (res_mode != rmRows)
+    return;
+
   //Filling result
   if (result.records.size() != 0)
   {
@@ -1532,6 +1548,47 @@ bool MysqlDataset::dropIndex(const char *table, const char *index)
   return true;
 }
 
+/* append a row to a columnar result, with the same conversions as query() */
+static void add_column_row(result_columns &columns, MYSQL_ROW row, MYSQL_FIELD *fields,
+                           unsigned long *lengths, unsigned int numColumns)
+{
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    switch (fields[i].type)
+    {
+      case MYSQL_TYPE_LONGLONG:
+      case MYSQL_TYPE_DECIMAL:
+      case MYSQL_TYPE_NEWDECIMAL:
+      case MYSQL_TYPE_TINY:
+      case MYSQL_TYPE_SHORT:
+      case MYSQL_TYPE_INT24:
+      case MYSQL_TYPE_LONG:
+        columns.add_int64(i, row[i] != NULL ? strtoll(row[i], NULL, 10) : 0);
+        break;
+      case MYSQL_TYPE_FLOAT:
+      case MYSQL_TYPE_DOUBLE:
+        columns.add_double(i, row[i] != NULL ? atof(row[i]) : 0);
+        break;
+      case MYSQL_TYPE_STRING:
+      case MYSQL_TYPE_VAR_STRING:
+      case MYSQL_TYPE_VARCHAR:
+      case MYSQL_TYPE_TINY_BLOB:
+      case MYSQL_TYPE_MEDIUM_BLOB:
+      case MYSQL_TYPE_LONG_BLOB:
+      case MYSQL_TYPE_BLOB:
+        if (row[i] != NULL)
+          columns.add_string(i, row[i], lengths[i]);
+        else
+          columns.add_string(i, "", 0);
+        break;
+      case MYSQL_TYPE_NULL:
+      default:
+        columns.add_null(i);
+        break;
+    }
+  }
+}
+
 static bool ci_test(char l, char r)
 {
   return tolower(l) == tolower(r);
@@ -1605,6 +1662,8 @@ bool MysqlDataset::query(const std::string &query) {
     throw DbErrors("MUST be select SQL!");
 
   close();
+  res_mode = query_mode;
+  query_mode = rmRows;
 
   size_t loc;
 
@@ -1630,8 +1689,28 @@ bool MysqlDataset::query(const std::string &query) {
   for (unsigned int i = 0; i < numColumns; i++)
     result.record_header[i].name = fields[i].name;
 
+  if (res_mode == rmStream)
+  {
+    // mysql_store_result() already read the rows from the connection, so other
+    // queries can run while next() walks the client side result
+    result.columns.set_num_columns(numColumns);
+    stream_res = stmt;
+    fetch_row();
+    active = true;
+    ds_state = dsSelect;
+    this->first();
+    return true;
+  }
+
+  if (res_mode == rmColumns)
+  {
+    result.columns.set_num_columns(numColumns);
+    while ((row = mysql_fetch_row(stmt)))
+      add_column_row(result.columns, row, fields, mysql_fetch_lengths(stmt), numColumns);
+  }
+
   // returned rows
-  while ((row = mysql_fetch_row(stmt)))
+  while (res_mode == rmRows && (row = mysql_fetch_row(stmt)))
   { // have a row of data
     sql_record *res = new sql_record;
     res->resize(numColumns);
@@ -1712,6 +1791,7 @@ void MysqlDataset::open() {
 }
 
 void MysqlDataset::close() {
+  close_stream();
   Dataset::close();
   result.clear();
   edit_object->clear();
@@ -1731,6 +1811,8 @@ void MysqlDataset::cancel() {
 }
 
 int MysqlDataset::num_rows() {
+  if (res_mode != rmRows)
+    return result.columns.num_rows();
   return result.records.size();
 }
 
@@ -1776,6 +1858,33 @@ void MysqlDataset::free_row(void)
   }
 }
 
+bool MysqlDataset::fetch_row()
+{
+  if (!stream_res)
+    return false;
+
+  result.columns.clear_rows();
+  MYSQL_ROW row = mysql_fetch_row(stream_res);
+  if (row)
+  {
+    add_column_row(result.columns, row, mysql_fetch_fields(stream_res),
+                   mysql_fetch_lengths(stream_res), result.columns.num_columns());
+    return true;
+  }
+
+  close_stream();
+  return false;
+}
+
+void MysqlDataset::close_stream()
+{
+  if (stream_res)
+  {
+    mysql_free_result(stream_res);
+    stream_res = NULL;
+  }
+}
+
 bool MysqlDataset::seek(int pos) {
   if (ds_state == dsSelect)
   {
@@ -50,6 +50,8 @@ public:
   int connect(bool create) override;
 /* func. disconnects from database-server */
   void disconnect() override;
+  bool is_reusable() override;
+  bool ping() override;
 /* func. creates new database */
   int create() override;
 /* func. deletes database */
@@ -119,6 +121,12 @@ protected:
   void fill_fields() override;
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
+/* Walk the stored result of a streaming query */
+  bool fetch_row() override;
+  void close_stream();
+
+/* stored result of a streaming query */
+  MYSQL_RES *stream_res;
 
 public:
 /* constructor */
@@ -20,6 +20,7 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifndef __GNUC__
 #pragma warning (disable:4800)
@@ -725,4 +726,88 @@ std::string field_value::gft() {
   return tmp;
   }
 
+//************* result_columns implementation ***************
+
+void result_columns::clear() {
+  columns.clear();
+  strings.clear();
+}
+
+void result_columns::clear_rows() {
+  for (auto &column : columns)
+    column.clear();
+  strings.clear();
+}
+
+void result_columns::set_num_columns(unsigned int count) {
+  clear();
+  columns.resize(count);
+}
+
+void result_columns::add_null(unsigned int col) {
+  cell c;
+  c.type = ft_String;
+  c.is_null = true;
+  c.str.offset = 0;
+  c.str.length = 0;
+  columns[col].push_back(c);
+}
+
+void result_columns::add_int64(unsigned int col, int64_t value) {
+  cell c;
+  c.type = ft_Int64;
+  c.is_null = false;
+  c.int64_value = value;
+  columns[col].push_back(c);
+}
+
+void result_columns::add_double(unsigned int col, double value) {
+  cell c;
+  c.type = ft_Double;
+  c.is_null = false;
+  c.double_value = value;
+  columns[col].push_back(c);
+}
+
+void result_columns::add_string(unsigned int col, const char *value, size_t length) {
+  cell c;
+  c.type = ft_String;
+  c.is_null = false;
+  c.str.offset = strings.size();
+  c.str.length = length;
+  // keep the terminator, values are handed out as C strings
+  strings.insert(strings.end(), value, value + length);
+  strings.push_back('\0');
+  columns[col].push_back(c);
+}
+
+void result_columns::add_string(unsigned int col, const char *value) {
+  add_string(col, value, strlen(value));
+}
+
+void result_columns::get_value(unsigned int row, unsigned int col, field_value &value) const {
+  const cell &c = columns[col][row];
+  switch (c.type) {
+    case ft_Int64:
+      value.set_asInt64(c.int64_value);
+      break;
+    case ft_Double:
+      value.set_asDouble(c.double_value);
+      break;
+    default:
+      value.set_asString(c.is_null ? "" : &strings[c.str.offset]);
+      break;
+  }
+  if (c.is_null)
+    value.set_isNull();
+  else
+    value.set_notNull();
+}
+
+field_value result_columns::get_value(unsigned int row, unsigned int col) const {
+  field_value value;
+  get_value(row, col, value);
+  return value;
+}
+
 } //namespace
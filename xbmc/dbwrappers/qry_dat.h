@@ -163,6 +163,7 @@ public:
   }
 
   void set_isNull(){is_null=true;}
+  void set_notNull(){is_null=false;}
   void set_asString(const char *s);
   void set_asString(const std::string & s);
   void set_asBool(const bool b);
@@ -206,6 +207,60 @@ typedef sql_record::iterator rec_itor;
 typedef record_prop::iterator recprop_itor;
 typedef query_data::iterator qry_itor;
 
+/* Columnar storage of a query result: one array of typed cells per column
+   and a single arena holding the text of all string cells. Filling a result
+   costs a few vector reallocations instead of one sql_record and one
+   std::string per row and field; field_values are only built when read. */
+class result_columns
+{
+public:
+  void clear();
+/* drop the rows but keep the columns and the allocated memory */
+  void clear_rows();
+  void set_num_columns(unsigned int count);
+
+  unsigned int num_columns() const { return columns.size(); }
+  unsigned int num_rows() const { return columns.empty() ? 0 : columns[0].size(); }
+
+/* every row has to add a cell to each column, in any order */
+  void add_null(unsigned int col);
+  void add_int64(unsigned int col, int64_t value);
+  void add_double(unsigned int col, double value);
+  void add_string(unsigned int col, const char *value, size_t length);
+  void add_string(unsigned int col, const char *value);
+
+/* fill an existing field_value, reusing its string buffer */
+  void get_value(unsigned int row, unsigned int col, field_value &value) const;
+  field_value get_value(unsigned int row, unsigned int col) const;
+
+private:
+  struct cell
+  {
+    fType type;
+    bool is_null;
+    union
+    {
+      int64_t int64_value;
+      double double_value;
+      struct
+      {
+        size_t offset;
+        size_t length;
+      } str;
+    };
+  };
+
+  std::vector<std::vector<cell>> columns;
+  std::vector<char> strings;
+};
+
+/* How a query stores its rows:
+   rmRows - a sql_record per row in result_set::records (default)
+   rmColumns - all rows in result_set::columns
+   rmStream - forward-only, only the current row is held in
+              result_set::columns and next() fetches the following one */
+enum resultMode { rmRows, rmColumns, rmStream };
+
 class result_set
 {
 public:
@@ -221,10 +276,12 @@ public:
         delete records[i];
     records.clear();
     record_header.clear();
+    columns.clear();
   };
 
   record_prop record_header;
   query_data records;
+  result_columns columns;
 };
 
 #ifdef TARGET_WINDOWS_STORE
@@ -195,6 +195,34 @@ int callback(void* res_ptr,int ncol, char** result,char** cols)
   return 0;
 }
 
+/* append the current row of a statement to a columnar result */
+static void add_column_row(result_columns &columns, sqlite3_stmt *stmt, unsigned int numColumns)
+{
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    switch (sqlite3_column_type(stmt, i))
+    {
+    case SQLITE_INTEGER:
+      columns.add_int64(i, sqlite3_column_int64(stmt, i));
+      break;
+    case SQLITE_FLOAT:
+      columns.add_double(i, sqlite3_column_double(stmt, i));
+      break;
+    case SQLITE_TEXT:
+    case SQLITE_BLOB:
+    {
+      const char *text = (const char *)sqlite3_column_text(stmt, i);
+      columns.add_string(i, text, sqlite3_column_bytes(stmt, i));
+      break;
+    }
+    case SQLITE_NULL:
+    default:
+      columns.add_null(i);
+      break;
+    }
+  }
+}
+
 static int busy_callback(void*, int busyCount)
 {
   KODI::TIME::Sleep(100);
@@ -366,6 +394,11 @@ void SqliteDatabase::disconnect(void) {
   active = false;
 }
 
+bool SqliteDatabase::is_reusable(void) {
+  // a connection left inside a transaction is not reusable
+  return active && conn != NULL && sqlite3_get_autocommit(conn) != 0;
+}
+
 int SqliteDatabase::create() {
   return connect(true);
 }
@@ -604,6 +637,7 @@ SqliteDataset::SqliteDataset():Dataset() {
   db = NULL;
   errmsg = NULL;
   autorefresh = false;
+  stream_stmt = NULL;
 }
 
 
@@ -612,9 +646,11 @@ SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
   db = newDb;
   errmsg = NULL;
   autorefresh = false;
+  stream_stmt = NULL;
 }
 
  SqliteDataset::~SqliteDataset(){
+   close_stream();
    if (errmsg) sqlite3_free(errmsg);
  }
 
@@ -708,6 +744,10 @@ void SqliteDataset::fill_fields() {
       (*fields_object)[i].props = result.record_header[i];
   }
 
+  // columnar results are read directly by get_field_value()
+  if (res_mode != rmRows)
+    return;
+
   //Filling result
   if (result.records.size() != 0)
   {
@@ -812,6 +852,8 @@ bool SqliteDataset::query(const std::string &query) {
          throw DbErrors("MUST be select SQL!");
 
   close();
+  res_mode = query_mode;
+  query_mode = rmRows;
 
   sqlite3_stmt *stmt = NULL;
   if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
@@ -823,8 +865,27 @@ bool SqliteDataset::query(const std::string &query) {
   for (unsigned int i = 0; i < numColumns; i++)
     result.record_header[i].name = sqlite3_column_name(stmt, i);
 
+  if (res_mode == rmStream)
+  {
+    // the statement stays open, next() steps it
+    result.columns.set_num_columns(numColumns);
+    stream_stmt = stmt;
+    fetch_row();
+    active = true;
+    ds_state = dsSelect;
+    this->first();
+    return true;
+  }
+
+  if (res_mode == rmColumns)
+  {
+    result.columns.set_num_columns(numColumns);
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+      add_column_row(result.columns, stmt, numColumns);
+  }
+
   // returned rows
-  while (sqlite3_step(stmt) == SQLITE_ROW)
+  while (res_mode == rmRows && sqlite3_step(stmt) == SQLITE_ROW)
   { // have a row of data
     sql_record *res = new sql_record;
     res->resize(numColumns);
@@ -883,6 +944,7 @@ void SqliteDataset::open() {
 
 
 void SqliteDataset::close() {
+  close_stream();
   Dataset::close();
   result.clear();
   edit_object->clear();
@@ -903,6 +965,8 @@ void SqliteDataset::cancel() {
 
 
 int SqliteDataset::num_rows() {
+  if (res_mode != rmRows)
+    return result.columns.num_rows();
   return result.records.size();
 }
 
@@ -951,6 +1015,36 @@ void SqliteDataset::free_row(void)
   }
 }
 
+bool SqliteDataset::fetch_row()
+{
+  if (!stream_stmt)
+    return false;
+
+  result.columns.clear_rows();
+  if (sqlite3_step(stream_stmt) == SQLITE_ROW)
+  {
+    add_column_row(result.columns, stream_stmt, result.columns.num_columns());
+    return true;
+  }
+
+  // end of the result or an error, finalize reports which one
+  const std::string query = sqlite3_sql(stream_stmt);
+  const int err = sqlite3_finalize(stream_stmt);
+  stream_stmt = NULL;
+  if (db->setErr(err, query.c_str()) != SQLITE_OK)
+    throw DbErrors("%s", db->getErrorMsg());
+  return false;
+}
+
+void SqliteDataset::close_stream()
+{
+  if (stream_stmt)
+  {
+    sqlite3_finalize(stream_stmt);
+    stream_stmt = NULL;
+  }
+}
+
 bool SqliteDataset::seek(int pos) {
   if (ds_state == dsSelect) {
     Dataset::seek(pos);
@@ -56,6 +56,7 @@ public:
   int connect(bool create) override;
 /* func. disconnects from database-server */
   void disconnect() override;
+  bool is_reusable() override;
 /* func. creates new database */
   int create() override;
 /* func. deletes database */
@@ -112,6 +113,12 @@ protected:
   void fill_fields() override;
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
+/* Step the statement of a streaming result */
+  bool fetch_row() override;
+  void close_stream();
+
+/* open statement of a streaming result */
+  sqlite3_stmt *stream_stmt;
 
 public:
 /* constructor */
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/DatabaseConnectionPool.h"
+#include "dbwrappers/dataset.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+class CFakeDatabase : public dbiplus::Database
+{
+public:
+  explicit CFakeDatabase(int& disconnects) : m_disconnects(disconnects) { active = true; }
+
+  dbiplus::Dataset* CreateDataset() const override { return nullptr; }
+  int setErr(int err_code, const char* qry) override { return err_code; }
+  long nextid(const char* seq_name) override { return 0; }
+  std::string vprepare(const char* format, va_list args) override { return format; }
+
+  void disconnect() override
+  {
+    if (active)
+      m_disconnects++;
+    active = false;
+  }
+  bool is_reusable() override { return active && !transaction; }
+  bool ping() override
+  {
+    pings++;
+    return healthy && is_reusable();
+  }
+
+  bool healthy = true;
+  bool transaction = false;
+  int pings = 0;
+
+private:
+  int& m_disconnects;
+};
+
+std::unique_ptr<dbiplus::Database> Fake(int& disconnects)
+{
+  return std::unique_ptr<dbiplus::Database>(new CFakeDatabase(disconnects));
+}
+} // namespace
+
+TEST(TestDatabaseConnectionPool, Reuse)
+{
+  int disconnects = 0;
+  CDatabaseConnectionPool pool;
+  EXPECT_EQ(nullptr, pool.Acquire("video", "MyVideos"));
+
+  std::unique_ptr<dbiplus::Database> db = Fake(disconnects);
+  dbiplus::Database* connection = db.get();
+  pool.AddConnect("MyVideos", 0);
+  pool.Release("video", "MyVideos", std::move(db));
+  EXPECT_EQ(1u, pool.GetIdleCount());
+
+  // only the same database is reused
+  EXPECT_EQ(nullptr, pool.Acquire("music", "MyMusic"));
+  db = pool.Acquire("video", "MyVideos");
+  EXPECT_EQ(connection, db.get());
+  EXPECT_EQ(0u, pool.GetIdleCount());
+
+  const CDatabaseConnectionPool::Stats stats = pool.GetStats()["MyVideos"];
+  EXPECT_EQ(1u, stats.connects);
+  EXPECT_EQ(1u, stats.reuses);
+  EXPECT_EQ(0, disconnects);
+}
+
+TEST(TestDatabaseConnectionPool, PerThread)
+{
+  int disconnects = 0;
+  CDatabaseConnectionPool pool;
+  pool.Release("video", "MyVideos", Fake(disconnects));
+
+  bool acquired = true;
+  std::thread other([&]() {
+    acquired = pool.Acquire("video", "MyVideos") != nullptr;
+    pool.Release("video", "MyVideos", Fake(disconnects));
+  });
+  other.join();
+  EXPECT_FALSE(acquired);
+
+  // the connection of the thread was disconnected when it ended
+  EXPECT_EQ(1u, pool.GetIdleCount());
+  EXPECT_EQ(1, disconnects);
+
+  pool.Clear();
+  EXPECT_EQ(0u, pool.GetIdleCount());
+  EXPECT_EQ(2, disconnects);
+}
+
+TEST(TestDatabaseConnectionPool, HealthCheck)
+{
+  int disconnects = 0;
+  // every idle connection is pinged
+  CDatabaseConnectionPool pool(CDatabaseConnectionPool::IDLE_TIMEOUT_MS, 0);
+
+  std::unique_ptr<dbiplus::Database> db = Fake(disconnects);
+  CFakeDatabase* fake = static_cast<CFakeDatabase*>(db.get());
+  pool.Release("video", "MyVideos", std::move(db));
+  EXPECT_EQ(0, fake->pings);
+
+  // e.g. the server closed the idle connection
+  fake->healthy = false;
+  EXPECT_EQ(nullptr, pool.Acquire("video", "MyVideos"));
+  EXPECT_EQ(1, disconnects);
+  EXPECT_EQ(1u, pool.GetStats()["MyVideos"].discarded);
+  EXPECT_EQ(1u, pool.GetStats()["MyVideos"].pings);
+
+  // a connection left in a transaction is not kept
+  db = Fake(disconnects);
+  static_cast<CFakeDatabase*>(db.get())->transaction = true;
+  pool.Release("video", "MyVideos", std::move(db));
+  EXPECT_EQ(0u, pool.GetIdleCount());
+  EXPECT_EQ(2, disconnects);
+}
+
+TEST(TestDatabaseConnectionPool, NoPingWhenRecentlyUsed)
+{
+  int disconnects = 0;
+  CDatabaseConnectionPool pool;
+
+  std::unique_ptr<dbiplus::Database> db = Fake(disconnects);
+  CFakeDatabase* fake = static_cast<CFakeDatabase*>(db.get());
+  pool.Release("video", "MyVideos", std::move(db));
+  db = pool.Acquire("video", "MyVideos");
+  EXPECT_EQ(fake, db.get());
+  EXPECT_EQ(0, fake->pings);
+  EXPECT_EQ(0u, pool.GetStats()["MyVideos"].pings);
+}
+
+TEST(TestDatabaseConnectionPool, Limits)
+{
+  int disconnects = 0;
+  CDatabaseConnectionPool pool;
+  for (unsigned int i = 0; i < CDatabaseConnectionPool::MAX_IDLE_PER_THREAD + 2; i++)
+    pool.Release("video", "MyVideos", Fake(disconnects));
+  EXPECT_EQ(CDatabaseConnectionPool::MAX_IDLE_PER_THREAD, pool.GetIdleCount());
+  EXPECT_EQ(2, disconnects);
+
+  CDatabaseConnectionPool expiring(0);
+  expiring.Release("video", "MyVideos", Fake(disconnects));
+  EXPECT_EQ(nullptr, expiring.Acquire("video", "MyVideos"));
+  EXPECT_EQ(3, disconnects);
+  EXPECT_EQ(1u, expiring.GetStats()["MyVideos"].expired);
+}
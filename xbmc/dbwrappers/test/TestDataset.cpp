@@ -0,0 +1,176 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+namespace
+{
+const char* dbName = "TestDataset.db";
+}
+
+class TestDataset : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_host = CSpecialProtocol::TranslatePath("special://temp/");
+    std::remove((m_host + dbName).c_str());
+
+    m_db.setHostName(m_host.c_str());
+    m_db.setDatabase(dbName);
+    ASSERT_EQ(DB_CONNECTION_OK, m_db.connect(true));
+
+    m_ds.reset(m_db.CreateDataset());
+    m_ds->exec("CREATE TABLE song (idSong INTEGER PRIMARY KEY, strTitle TEXT, fRating REAL, strComment TEXT)");
+    m_ds->exec("INSERT INTO song VALUES (1, 'One', 7.5, NULL)");
+    m_ds->exec("INSERT INTO song VALUES (2, 'Two', 3.0, 'live')");
+    m_ds->exec("INSERT INTO song VALUES (3, '', 0.5, 'demo')");
+  }
+
+  void TearDown() override
+  {
+    m_ds.reset();
+    m_db.disconnect();
+    std::remove((m_host + dbName).c_str());
+  }
+
+  void CheckRows(resultMode mode)
+  {
+    m_ds->set_result_mode(mode);
+    ASSERT_TRUE(m_ds->query("SELECT idSong, strTitle, fRating, strComment FROM song ORDER BY idSong"));
+    EXPECT_EQ(mode, m_ds->get_result_mode());
+    EXPECT_NE(0, m_ds->num_rows());
+
+    ASSERT_FALSE(m_ds->eof());
+    EXPECT_EQ(1, m_ds->fv("idSong").get_asInt());
+    EXPECT_EQ("One", m_ds->fv("strTitle").get_asString());
+    EXPECT_DOUBLE_EQ(7.5, m_ds->fv(2).get_asDouble());
+    EXPECT_TRUE(m_ds->fv("strComment").get_isNull());
+    EXPECT_EQ("", m_ds->fv("strComment").get_asString());
+
+    m_ds->next();
+    ASSERT_FALSE(m_ds->eof());
+    const sql_record* record = m_ds->get_sql_record();
+    ASSERT_NE(nullptr, record);
+    ASSERT_EQ(4u, record->size());
+    EXPECT_EQ(2, record->at(0).get_asInt());
+    EXPECT_EQ("Two", record->at(1).get_asString());
+    EXPECT_FALSE(record->at(3).get_isNull());
+    EXPECT_EQ("live", record->at(3).get_asString());
+
+    m_ds->next();
+    ASSERT_FALSE(m_ds->eof());
+    EXPECT_EQ(3, m_ds->fv("song.idSong").get_asInt());
+    EXPECT_EQ("", m_ds->fv("strTitle").get_asString());
+    EXPECT_FALSE(m_ds->fv("strTitle").get_isNull());
+    EXPECT_EQ("demo", m_ds->fv("strComment").get_asString());
+
+    m_ds->next();
+    EXPECT_TRUE(m_ds->eof());
+    m_ds->close();
+  }
+
+  std::string m_host;
+  SqliteDatabase m_db;
+  std::unique_ptr<Dataset> m_ds;
+};
+
+TEST_F(TestDataset, Rows)
+{
+  CheckRows(rmRows);
+  EXPECT_EQ(rmRows, m_ds->get_result_mode());
+}
+
+TEST_F(TestDataset, Columns)
+{
+  CheckRows(rmColumns);
+
+  // the mode applies to a single query
+  ASSERT_TRUE(m_ds->query("SELECT idSong FROM song"));
+  EXPECT_EQ(rmRows, m_ds->get_result_mode());
+  EXPECT_EQ(3u, m_ds->get_result_set().records.size());
+  m_ds->close();
+
+  m_ds->set_result_mode(rmColumns);
+  ASSERT_TRUE(m_ds->query("SELECT idSong FROM song ORDER BY idSong"));
+  EXPECT_EQ(3, m_ds->num_rows());
+  EXPECT_TRUE(m_ds->get_result_set().records.empty());
+  m_ds->last();
+  EXPECT_EQ(3, m_ds->fv(0).get_asInt());
+  m_ds->seek(1);
+  EXPECT_EQ(2, m_ds->fv(0).get_asInt());
+  m_ds->close();
+}
+
+TEST_F(TestDataset, Stream)
+{
+  CheckRows(rmStream);
+
+  m_ds->set_result_mode(rmStream);
+  ASSERT_TRUE(m_ds->query("SELECT idSong FROM song ORDER BY idSong"));
+  m_ds->next();
+  EXPECT_THROW(m_ds->first(), DbErrors);
+  EXPECT_THROW(m_ds->prev(), DbErrors);
+
+  // other statements run on the connection while the stream is open
+  std::unique_ptr<Dataset> other(m_db.CreateDataset());
+  ASSERT_TRUE(other->query("SELECT COUNT(*) FROM song"));
+  EXPECT_EQ(3, other->fv(0).get_asInt());
+  other->close();
+
+  m_ds->next();
+  EXPECT_EQ(3, m_ds->fv(0).get_asInt());
+  m_ds->close();
+
+  m_ds->set_result_mode(rmStream);
+  ASSERT_TRUE(m_ds->query("SELECT idSong FROM song WHERE idSong > 10"));
+  EXPECT_EQ(0, m_ds->num_rows());
+  EXPECT_TRUE(m_ds->eof());
+  m_ds->close();
+}
+
+TEST_F(TestDataset, DISABLED_Benchmark)
+{
+  const int rows = 50000;
+  m_ds->exec("BEGIN TRANSACTION");
+  for (int i = 0; i < rows; i++)
+    m_ds->exec(m_db.prepare("INSERT INTO song (strTitle, fRating, strComment) VALUES ('Song title %i', %i.5, 'comment on the song %i')", i, i % 10, i));
+  m_ds->exec("COMMIT");
+
+  const resultMode modes[] = {rmRows, rmColumns, rmStream};
+  const char* names[] = {"rows", "columns", "stream"};
+  for (int mode = 0; mode < 3; mode++)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < 5; round++)
+    {
+      m_ds->set_result_mode(modes[mode]);
+      ASSERT_TRUE(m_ds->query("SELECT idSong, strTitle, fRating, strComment FROM song"));
+      int64_t sum = 0;
+      while (!m_ds->eof())
+      {
+        sum += m_ds->fv("idSong").get_asInt() + m_ds->fv("strTitle").get_asString().size();
+        m_ds->next();
+      }
+      EXPECT_LT(0, sum);
+      m_ds->close();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%s: %.0f rows/s\n", names[mode], rows * 5 / seconds);
+  }
+}
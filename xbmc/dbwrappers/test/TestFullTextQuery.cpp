@@ -0,0 +1,56 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/FullTextQuery.h"
+
+#include <gtest/gtest.h>
+
+TEST(TestFullTextQuery, Tokens)
+{
+  CFullTextQuery query("The Dark-Knight's return");
+  ASSERT_EQ(4u, query.GetTokens().size());
+  EXPECT_EQ("The", query.GetTokens()[0]);
+  EXPECT_EQ("Dark", query.GetTokens()[1]);
+  EXPECT_EQ("Knight", query.GetTokens()[2]);
+  EXPECT_EQ("return", query.GetTokens()[3]);
+
+  EXPECT_EQ("\"The\"* \"Dark\"* \"Knight\"* \"return\"*", query.GetSQLiteMatch());
+  EXPECT_EQ("+The* +Dark* +Knight* +return*", query.GetMySQLMatch());
+}
+
+TEST(TestFullTextQuery, Operators)
+{
+  // quotes and operators of either syntax never reach the match expression
+  CFullTextQuery query("\"abc\" -def +ghi* (jkl) OR 'mno'");
+  EXPECT_EQ("\"abc\"* \"def\"* \"ghi\"* \"jkl\"* \"mno\"*", query.GetSQLiteMatch());
+  EXPECT_EQ("+abc* +def* +ghi* +jkl* +mno*", query.GetMySQLMatch());
+}
+
+TEST(TestFullTextQuery, Short)
+{
+  CFullTextQuery u2("U2");
+  EXPECT_TRUE(u2.IsEmpty());
+  ASSERT_EQ(1u, u2.GetShortWords().size());
+  EXPECT_EQ("U2", u2.GetShortWords()[0]);
+  EXPECT_TRUE(CFullTextQuery("").IsEmpty());
+  EXPECT_TRUE(CFullTextQuery("").GetShortWords().empty());
+
+  // short words are kept apart to be matched without the index
+  CFullTextQuery query("AC/DC Back in Black");
+  EXPECT_EQ("+Back* +Black*", query.GetMySQLMatch());
+  ASSERT_EQ(3u, query.GetShortWords().size());
+  EXPECT_EQ("AC", query.GetShortWords()[0]);
+  EXPECT_EQ("DC", query.GetShortWords()[1]);
+  EXPECT_EQ("in", query.GetShortWords()[2]);
+
+  // UTF-8 letters are part of the words
+  CFullTextQuery utf8("Sigur Rós Ágætis byrjun");
+  ASSERT_EQ(4u, utf8.GetTokens().size());
+  EXPECT_EQ("Rós", utf8.GetTokens()[1]);
+  EXPECT_EQ("Ágætis", utf8.GetTokens()[2]);
+}
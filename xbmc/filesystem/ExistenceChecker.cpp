@@ -0,0 +1,219 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ExistenceChecker.h"
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/Stopwatch.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+using namespace XFILE;
+
+const unsigned int CExistenceChecker::DEFAULT_JOBS_PER_HOST;
+const unsigned int CExistenceChecker::MAX_JOBS;
+
+class CExistenceChecker::CWorker : public CThread
+{
+public:
+  explicit CWorker(CExistenceChecker& owner) : CThread("ExistenceChecker"), m_owner(owner) {}
+
+protected:
+  void Process() override { m_owner.Work(); }
+
+private:
+  CExistenceChecker& m_owner;
+};
+
+CExistenceChecker::CExistenceChecker(unsigned int jobsPerHost /* = DEFAULT_JOBS_PER_HOST */)
+  : m_jobsPerHost(std::max(1u, jobsPerHost))
+{
+}
+
+CExistenceChecker::~CExistenceChecker() = default;
+
+void CExistenceChecker::Add(const std::string& path)
+{
+  const std::string folder = URIUtils::HasSlashAtEnd(path) ? URIUtils::GetParentPath(path)
+                                                           : URIUtils::GetDirectory(path);
+  Folder& entry = m_folders[folder];
+  entry.path = folder;
+  entry.entries.push_back(path);
+  m_stats.paths++;
+}
+
+bool CExistenceChecker::Check(const ProgressCallback& progress /* = nullptr */)
+{
+  CStopWatch timer;
+  timer.StartZero();
+
+  {
+    CSingleLock lock(m_section);
+    for (auto& it : m_folders)
+    {
+      const CURL url(it.first);
+      m_pending[url.GetProtocol() + "://" + url.GetHostName()].push_back(&it.second);
+    }
+    m_done = 0;
+    m_stop = false;
+  }
+
+  const unsigned int total = static_cast<unsigned int>(m_folders.size());
+  std::vector<std::unique_ptr<CWorker>> workers;
+  for (unsigned int i = 0; i < std::min(total, MAX_JOBS); i++)
+  {
+    workers.emplace_back(new CWorker(*this));
+    workers.back()->Create();
+  }
+
+  bool cancelled = false;
+  {
+    CSingleLock lock(m_section);
+    while (m_done < total)
+    {
+      m_condition.wait(lock, 100);
+      if (progress)
+      {
+        const unsigned int done = m_done;
+        CSingleExit exit(m_section);
+        cancelled = !progress(done, total);
+      }
+      if (cancelled)
+      {
+        m_stop = true;
+        m_condition.notifyAll();
+        break;
+      }
+    }
+  }
+  // a listing that is running when cancelled is waited for
+  for (auto& worker : workers)
+    worker->StopThread();
+  if (progress && !cancelled)
+    progress(total, total);
+
+  m_pending.clear();
+  m_running.clear();
+  m_stats.missing = static_cast<unsigned int>(m_missing.size());
+  m_stats.elapsedMs = static_cast<unsigned int>(timer.GetElapsedMilliseconds());
+  return !cancelled;
+}
+
+bool CExistenceChecker::Exists(const std::string& path) const
+{
+  if (m_missing.find(path) != m_missing.end())
+    return false;
+
+  const std::string folder = URIUtils::HasSlashAtEnd(path) ? URIUtils::GetParentPath(path)
+                                                           : URIUtils::GetDirectory(path);
+  const auto it = m_folders.find(folder);
+  if (it != m_folders.end() &&
+      std::find(it->second.entries.begin(), it->second.entries.end(), path) != it->second.entries.end())
+    return true;
+
+  return ExistsOnItsOwn(path);
+}
+
+void CExistenceChecker::Work()
+{
+  Folder* folder;
+  std::string host;
+  while (Next(folder, host))
+  {
+    const Result result = List(*folder);
+
+    CSingleLock lock(m_section);
+    m_missing.insert(result.missing.begin(), result.missing.end());
+    m_stats.listings++;
+    m_stats.fallbacks += result.fallbacks;
+    m_running[host]--;
+    m_done++;
+    m_condition.notifyAll();
+  }
+}
+
+bool CExistenceChecker::Next(Folder*& folder, std::string& host)
+{
+  CSingleLock lock(m_section);
+  while (!m_stop && !m_pending.empty())
+  {
+    for (auto it = m_pending.begin(); it != m_pending.end(); ++it)
+    {
+      unsigned int& running = m_running[it->first];
+      if (running >= m_jobsPerHost)
+        continue;
+
+      running++;
+      host = it->first;
+      folder = it->second.front();
+      it->second.pop_front();
+      if (it->second.empty())
+        m_pending.erase(it);
+      return true;
+    }
+    // every host with folders left is busy
+    m_condition.wait(lock);
+  }
+  return false;
+}
+
+CExistenceChecker::Result CExistenceChecker::List(const Folder& folder)
+{
+  Result result;
+
+  CFileItemList items;
+  if (CDirectory::GetDirectory(folder.path, items, "",
+                               DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO | DIR_FLAG_BYPASS_CACHE))
+  {
+    std::unordered_set<std::string> listed;
+    for (const auto& item : items)
+      listed.insert(item->GetPath());
+
+    for (const auto& path : folder.entries)
+    {
+      if (listed.find(path) != listed.end())
+        continue;
+      result.fallbacks++;
+      if (!ExistsOnItsOwn(path))
+        result.missing.push_back(path);
+    }
+  }
+  else
+  {
+    // files can't exist without their folder, but the parent of a folder may be
+    // virtual, e.g. the server of a share, so folders are always checked
+    const bool folderExists = CDirectory::Exists(folder.path, false);
+    for (const auto& path : folder.entries)
+    {
+      if (!folderExists && !URIUtils::HasSlashAtEnd(path))
+      {
+        result.missing.push_back(path);
+        continue;
+      }
+      result.fallbacks++;
+      if (!ExistsOnItsOwn(path))
+        result.missing.push_back(path);
+    }
+  }
+
+  return result;
+}
+
+bool CExistenceChecker::ExistsOnItsOwn(const std::string& path)
+{
+  if (URIUtils::HasSlashAtEnd(path))
+    return CDirectory::Exists(path, false);
+  return CFile::Exists(path, false);
+}
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace XFILE
+{
+  /*!
+   \brief Checks whether a large number of files and folders still exist
+
+   Checking every path with CFile::Exists() costs a round trip per path on
+   network shares. Paths are grouped by their parent folder instead and each
+   folder is listed once, on a few threads at a time. Only the paths missing
+   from the listing are checked on their own, so e.g. a different encoding of
+   the name in the listing doesn't make a path missing.
+
+   Folders of different hosts are listed in parallel, at most jobsPerHost
+   listings run against a single host at once.
+   */
+  class CExistenceChecker
+  {
+  public:
+    static const unsigned int DEFAULT_JOBS_PER_HOST = 4;
+    static const unsigned int MAX_JOBS = 8;
+
+    struct Stats
+    {
+      unsigned int paths = 0;       ///< paths checked
+      unsigned int listings = 0;    ///< folders listed
+      unsigned int fallbacks = 0;   ///< paths checked on their own
+      unsigned int missing = 0;     ///< paths that don't exist
+      unsigned int elapsedMs = 0;
+    };
+
+    /*!
+     \brief Called while checking
+     \param done number of folders listed so far
+     \param total number of folders to list
+     \return false to cancel the check
+     */
+    using ProgressCallback = std::function<bool(unsigned int done, unsigned int total)>;
+
+    explicit CExistenceChecker(unsigned int jobsPerHost = DEFAULT_JOBS_PER_HOST);
+    ~CExistenceChecker();
+
+    /*!
+     \brief Add a path to check, folders end with a slash
+     */
+    void Add(const std::string& path);
+
+    /*!
+     \brief Check all added paths
+     \param progress called about every 100ms, after each folder and once done (optional)
+     \return false if the check was cancelled
+     */
+    bool Check(const ProgressCallback& progress = nullptr);
+
+    /*!
+     \brief Whether a path exists, paths that weren't added are checked on their own
+     */
+    bool Exists(const std::string& path) const;
+
+    const Stats& GetStats() const { return m_stats; }
+
+  private:
+    CExistenceChecker(const CExistenceChecker&) = delete;
+    CExistenceChecker& operator=(const CExistenceChecker&) = delete;
+
+    class CWorker;
+
+    struct Folder
+    {
+      std::string path;
+      std::vector<std::string> entries; ///< paths to check in the folder
+    };
+
+    struct Result
+    {
+      std::vector<std::string> missing;
+      unsigned int fallbacks = 0;
+    };
+
+    void Work();
+    bool Next(Folder*& folder, std::string& host);
+    static Result List(const Folder& folder);
+    static bool ExistsOnItsOwn(const std::string& path);
+
+    const unsigned int m_jobsPerHost;
+    std::map<std::string, Folder> m_folders;
+    std::set<std::string> m_missing;
+    Stats m_stats;
+
+    CCriticalSection m_section;
+    XbmcThreads::ConditionVariable m_condition;
+    std::map<std::string, std::deque<Folder*>> m_pending; ///< folders to list by host
+    std::map<std::string, unsigned int> m_running;        ///< listings running by host
+    unsigned int m_done = 0;
+    bool m_stop = false;
+  };
+}
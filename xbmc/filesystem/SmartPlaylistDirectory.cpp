@@ -9,12 +9,15 @@
 #include "SmartPlaylistDirectory.h"
 
 #include "FileItem.h"
+#include "GUIPassword.h"
 #include "ServiceBroker.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "filesystem/FileDirectoryFactory.h"
 #include "music/MusicDatabase.h"
 #include "playlists/SmartPlayList.h"
+#include "playlists/SmartPlaylistCache.h"
+#include "profiles/ProfileManager.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/SortUtils.h"
@@ -50,6 +53,47 @@ namespace XFILE
   }
 
   bool CSmartPlaylistDirectory::GetDirectory(const CSmartPlaylist &playlist, CFileItemList& items, const std::string &strBaseDir /* = "" */, bool filter /* = false */)
+  {
+    // filters change with every key press and a random order without seed
+    // is a new one every time, only the items of other playlists are cached
+    if (filter || (playlist.GetOrder() == SortByRandom && playlist.GetOrderSeed() == 0))
+      return GetItems(playlist, items, strBaseDir, filter);
+
+    const std::string key = GetCacheKey(playlist, items, strBaseDir);
+    if (key.empty())
+      return GetItems(playlist, items, strBaseDir, filter);
+
+    CSmartPlaylistCache& cache = CServiceBroker::GetSmartPlaylistCache();
+    if (cache.Get(key, playlist.GetType(), items))
+      return true;
+
+    // without a change count of the library the items can't be cached
+    const int64_t changeCount = cache.GetChangeCount(playlist.GetType());
+    if (!GetItems(playlist, items, strBaseDir, filter))
+      return false;
+
+    if (changeCount >= 0)
+      cache.Put(key, playlist.GetType(), changeCount, items);
+    return true;
+  }
+
+  std::string CSmartPlaylistDirectory::GetCacheKey(const CSmartPlaylist &playlist, const CFileItemList& items, const std::string &strBaseDir)
+  {
+    std::string xsp;
+    if (!playlist.SaveAsJson(xsp))
+      return "";
+
+    // the items also depend on the profile, locks and sort settings
+    const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+    return StringUtils::Format("%s|%s|%s|%s|%u|%d|%d|%d", xsp.c_str(), playlist.GetName().c_str(),
+                               items.GetPath().c_str(), strBaseDir.c_str(),
+                               CServiceBroker::GetSettingsComponent()->GetProfileManager()->GetCurrentProfileIndex(),
+                               g_passwordManager.bMasterUser,
+                               settings->GetBool(CSettings::SETTING_FILELISTS_IGNORETHEWHENSORTING),
+                               settings->GetBool(CSettings::SETTING_MUSICLIBRARY_USEARTISTSORTNAME));
+  }
+
+  bool CSmartPlaylistDirectory::GetItems(const CSmartPlaylist &playlist, CFileItemList& items, const std::string &strBaseDir, bool filter)
   {
     bool success = false, success2 = false;
     std::vector<std::string> virtualFolders;
@@ -59,6 +103,7 @@ namespace XFILE
     sorting.sortBy = playlist.GetOrder();
     sorting.sortOrder = playlist.GetOrderAscending() ? SortOrderAscending : SortOrderDescending;
     sorting.sortAttributes = playlist.GetOrderAttributes();
+    sorting.randomSeed = playlist.GetOrderSeed();
     if (CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_FILELISTS_IGNORETHEWHENSORTING))
       sorting.sortAttributes = (SortAttribute)(sorting.sortAttributes | SortAttributeIgnoreArticle);
     if (playlist.IsMusicType() && CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(
@@ -29,5 +29,9 @@ namespace XFILE
     static bool GetDirectory(const CSmartPlaylist &playlist, CFileItemList& items, const std::string &strBaseDir = "", bool filter = false);
 
     static std::string GetPlaylistByName(const std::string& name, const std::string& playlistType);
+
+  private:
+    static bool GetItems(const CSmartPlaylist &playlist, CFileItemList& items, const std::string &strBaseDir, bool filter);
+    static std::string GetCacheKey(const CSmartPlaylist &playlist, const CFileItemList& items, const std::string &strBaseDir);
   };
 }
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/ExistenceChecker.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+
+#include <gtest/gtest.h>
+
+class TestExistenceChecker : public testing::Test
+{
+protected:
+  TestExistenceChecker()
+  {
+    m_root = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"),
+                                       "TestExistenceChecker/");
+    m_folder = URIUtils::AddFileToFolder(m_root, "folder/");
+    XFILE::CDirectory::Create(m_folder);
+
+    m_file = URIUtils::AddFileToFolder(m_root, "file.mkv");
+    XFILE::CFile file;
+    file.OpenForWrite(m_file, true);
+    file.Close();
+  }
+
+  ~TestExistenceChecker() override { XFILE::CDirectory::RemoveRecursive(m_root); }
+
+  std::string m_root;
+  std::string m_folder;
+  std::string m_file;
+};
+
+TEST_F(TestExistenceChecker, Exists)
+{
+  const std::string missingFile = URIUtils::AddFileToFolder(m_root, "missing.mkv");
+  const std::string missingFolder = URIUtils::AddFileToFolder(m_root, "missing/");
+  const std::string missingParent = URIUtils::AddFileToFolder(m_root, "missing/file.mkv");
+
+  XFILE::CExistenceChecker checker;
+  checker.Add(m_file);
+  checker.Add(m_folder);
+  checker.Add(missingFile);
+  checker.Add(missingFolder);
+  checker.Add(missingParent);
+
+  unsigned int calls = 0;
+  EXPECT_TRUE(checker.Check([&calls](unsigned int done, unsigned int total) {
+    EXPECT_LE(done, total);
+    calls++;
+    return true;
+  }));
+
+  EXPECT_TRUE(checker.Exists(m_file));
+  EXPECT_TRUE(checker.Exists(m_folder));
+  EXPECT_FALSE(checker.Exists(missingFile));
+  EXPECT_FALSE(checker.Exists(missingFolder));
+  EXPECT_FALSE(checker.Exists(missingParent));
+
+  // the root folder is listed once for all of its entries
+  const XFILE::CExistenceChecker::Stats& stats = checker.GetStats();
+  EXPECT_EQ(5u, stats.paths);
+  EXPECT_EQ(2u, stats.listings);
+  EXPECT_EQ(3u, stats.missing);
+  EXPECT_LT(0u, calls);
+}
+
+TEST_F(TestExistenceChecker, Cancel)
+{
+  XFILE::CExistenceChecker checker(1);
+  checker.Add(m_file);
+  checker.Add(URIUtils::AddFileToFolder(m_folder, "file.mkv"));
+
+  EXPECT_FALSE(checker.Check([](unsigned int, unsigned int) { return false; }));
+
+  // nothing is reported missing for folders that weren't listed
+  EXPECT_TRUE(checker.Exists(m_file));
+}
@@ -64,6 +64,55 @@ struct ThumbDataManagement
   }
 };
 
+namespace
+{
+// swscale context reused across decodes on the same thread, sws_getCachedContext
+// only reallocates when the geometry or pixel formats change
+struct CachedSwsContext
+{
+  SwsContext* context = nullptr;
+  ~CachedSwsContext() { sws_freeContext(context); }
+};
+
+thread_local CachedSwsContext cachedDecodeContext;
+
+// read the frame dimensions from the first SOFn marker of a jpeg stream
+bool GetJpegDimensions(const uint8_t* buffer, size_t size, unsigned int& width, unsigned int& height)
+{
+  size_t pos = 2; // skip SOI
+  while (pos + 4 <= size)
+  {
+    if (buffer[pos] != 0xFF)
+      return false;
+    const uint8_t marker = buffer[pos + 1];
+    if (marker == 0xFF)
+    { // fill byte
+      pos++;
+      continue;
+    }
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7))
+    { // standalone markers without a length field
+      pos += 2;
+      continue;
+    }
+    if (marker == 0xDA || marker == 0xD9)
+      return false; // start of scan or end of image before any SOF
+
+    const size_t length = (buffer[pos + 2] << 8) | buffer[pos + 3];
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+    {
+      if (pos + 9 > size)
+        return false;
+      height = (buffer[pos + 5] << 8) | buffer[pos + 6];
+      width = (buffer[pos + 7] << 8) | buffer[pos + 8];
+      return width > 0 && height > 0;
+    }
+    pos += 2 + length;
+  }
+  return false;
+}
+}
+
 // valid positions are including 0 (start of buffer)
 // and bufferSize -1 last data point
 static inline size_t Clamp(int64_t newPosition, size_t bufferSize)
@@ -139,7 +188,7 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
                                       unsigned int width, unsigned int height)
 {
 
-  if (!Initialize(buffer, bufSize))
+  if (!Initialize(buffer, bufSize, width, height))
   {
     //log
     return false;
@@ -151,7 +200,8 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
   return !(m_pFrame == nullptr);
 }
 
-bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize)
+bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize,
+                              unsigned int maxWidth /* = 0 */, unsigned int maxHeight /* = 0 */)
 {
   int bufferSize = 4096;
   uint8_t* fbuffer = (uint8_t*)av_malloc(bufferSize + AV_INPUT_BUFFER_PADDING_SIZE);
@@ -249,6 +299,29 @@ bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize)
     return false;
   }
 
+  // let the jpeg decoder scale down by 1/2, 1/4 or 1/8 in the DCT domain if the
+  // result is still at least as large as what the caller asked for
+  unsigned int jpegWidth = 0, jpegHeight = 0;
+  if (codec->id == AV_CODEC_ID_MJPEG && maxWidth > 0 && maxHeight > 0 &&
+      GetJpegDimensions(buffer, bufSize, jpegWidth, jpegHeight))
+  {
+    const float scale = std::min(std::min(static_cast<float>(maxWidth) / jpegWidth,
+                                          static_cast<float>(maxHeight) / jpegHeight), 1.0f);
+    const unsigned int fitWidth = static_cast<unsigned int>(jpegWidth * scale + 0.5f);
+    const unsigned int fitHeight = static_cast<unsigned int>(jpegHeight * scale + 0.5f);
+    int lowres = 0;
+    while (lowres < codec->max_lowres &&
+           (jpegWidth >> (lowres + 1)) >= fitWidth && (jpegHeight >> (lowres + 1)) >= fitHeight)
+      lowres++;
+
+    if (lowres > 0)
+    {
+      m_codec_ctx->lowres = lowres;
+      m_originalWidth = jpegWidth;
+      m_originalHeight = jpegHeight;
+    }
+  }
+
   if (avcodec_open2(m_codec_ctx, codec, NULL) < 0)
   {
     avformat_close_input(&m_fctx);
@@ -293,8 +366,12 @@ AVFrame* CFFmpegImage::ExtractFrame()
   frame->pkt_duration = av_rescale_q(frame->pkt_duration, m_fctx->streams[0]->time_base, AVRational{ 1, 1000 });
   m_height = frame->height;
   m_width = frame->width;
-  m_originalWidth = m_width;
-  m_originalHeight = m_height;
+  // when decoding at reduced scale the original dimensions come from the bitstream
+  if (m_codec_ctx->lowres == 0)
+  {
+    m_originalWidth = m_width;
+    m_originalHeight = m_height;
+  }
 
   const AVPixFmtDescriptor* pixDescriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
   if (pixDescriptor && ((pixDescriptor->flags & (AV_PIX_FMT_FLAG_ALPHA | AV_PIX_FMT_FLAG_PAL)) != 0))
@@ -468,8 +545,8 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
 
   // assumption quadratic maximums e.g. 2048x2048
   float ratio = m_width / (float)m_height;
-  unsigned int nHeight = m_originalHeight;
-  unsigned int nWidth = m_originalWidth;
+  unsigned int nHeight = frame->height;
+  unsigned int nWidth = frame->width;
   if (nHeight > height)
   {
     nHeight = height;
@@ -481,22 +558,29 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     nHeight = (unsigned int)(nWidth / ratio + 0.5f);
   }
 
-  struct SwsContext* context = sws_getContext(m_originalWidth, m_originalHeight, pixFormat,
+  cachedDecodeContext.context = sws_getCachedContext(cachedDecodeContext.context,
+    frame->width, frame->height, pixFormat,
     nWidth, nHeight, AV_PIX_FMT_RGB32, SWS_BICUBIC, NULL, NULL, NULL);
+  struct SwsContext* context = cachedDecodeContext.context;
+  if (!context)
+  {
+    CLog::LogF(LOGERROR, "Could not allocate scaling context");
+    av_frame_free(&pictureRGB);
+    return false;
+  }
 
-  if (range == AVCOL_RANGE_JPEG)
+  // the context is reused, so the source range has to be set every time
+  int* inv_table = nullptr;
+  int* table = nullptr;
+  int srcRange, dstRange, brightness, contrast, saturation;
+  if (sws_getColorspaceDetails(context, &inv_table, &srcRange, &table, &dstRange, &brightness, &contrast, &saturation) >= 0)
   {
-    int* inv_table = nullptr;
-    int* table = nullptr;
-    int srcRange, dstRange, brightness, contrast, saturation;
-    sws_getColorspaceDetails(context, &inv_table, &srcRange, &table, &dstRange, &brightness, &contrast, &saturation);
-    srcRange = 1;
+    srcRange = (range == AVCOL_RANGE_JPEG) ? 1 : 0;
     sws_setColorspaceDetails(context, inv_table, srcRange, table, dstRange, brightness, contrast, saturation);
   }
 
-  sws_scale(context, frame->data, frame->linesize, 0, m_originalHeight,
+  sws_scale(context, frame->data, frame->linesize, 0, frame->height,
     pictureRGB->data, pictureRGB->linesize);
-  sws_freeContext(context);
 
   if (needsCopy)
   {
@@ -69,7 +69,13 @@ public:
                                   unsigned int &bufferoutSize) override;
   void ReleaseThumbnailBuffer() override;
 
-  bool Initialize(unsigned char* buffer, size_t bufSize);
+  /*!
+   \brief Open the image stream
+   \param maxWidth,maxHeight if set, decoders which can scale while decoding
+   (jpeg) produce frames no smaller than needed to fit into these bounds
+   */
+  bool Initialize(unsigned char* buffer, size_t bufSize,
+                  unsigned int maxWidth = 0, unsigned int maxHeight = 0);
 
   std::shared_ptr<Frame> ReadFrame();
 
@@ -308,6 +308,9 @@ bool CPlayerGUIInfo::GetLabel(std::string& value, const CFileItem *item, int con
     case PLAYER_PROCESS_VIDEODECODER:
       value = CServiceBroker::GetDataCacheCore().GetVideoDecoderName();
       return true;
+    case PLAYER_PROCESS_VIDEOTHREADING:
+      value = CServiceBroker::GetDataCacheCore().GetVideoDecoderThreading();
+      return true;
     case PLAYER_PROCESS_DEINTMETHOD:
       value = CServiceBroker::GetDataCacheCore().GetVideoDeintMethod();
       return true;
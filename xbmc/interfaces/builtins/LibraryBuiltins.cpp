@@ -12,6 +12,7 @@
 #include "GUIUserMessages.h"
 #include "MediaSource.h"
 #include "ServiceBroker.h"
+#include "TextureCache.h"
 #include "dialogs/GUIDialogFileBrowser.h"
 #include "dialogs/GUIDialogYesNo.h"
 #include "guilib/GUIComponent.h"
@@ -19,6 +20,7 @@
 #include "guilib/LocalizeStrings.h"
 #include "messaging/helpers/DialogHelper.h"
 #include "music/MusicLibraryQueue.h"
+#include "music/MusicLoudnessJob.h"
 #include "settings/LibExportSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
@@ -26,18 +28,22 @@
 #include "utils/StringUtils.h"
 #include "utils/log.h"
 #include "video/VideoDatabase.h"
+#include "video/VideoThumbBatchJob.h"
 
 using namespace KODI::MESSAGING;
 
 /*! \brief Clean a library.
  *  \param params The parameters.
  *  \details params[0] = "video" or "music".
+ *           params[1] = "true" if user initiated (optional).
+ *           params[2] = "dryrun" to only log what would be removed (optional).
  */
 static int CleanLibrary(const std::vector<std::string>& params)
 {
   bool userInitiated = true;
   if (params.size() > 1)
     userInitiated = StringUtils::EqualsNoCase(params[1], "true");
+  const bool dryRun = params.size() > 2 && StringUtils::EqualsNoCase(params[2], "dryrun");
   if (!params.size() || StringUtils::EqualsNoCase(params[0], "video")
                      || StringUtils::EqualsNoCase(params[0], "movies")
                      || StringUtils::EqualsNoCase(params[0], "tvshows")
@@ -46,7 +52,7 @@ static int CleanLibrary(const std::vector<std::string>& params)
     if (!g_application.IsVideoScanning())
     {
       const std::string content = (params.empty() || params[0] == "video") ? "" : params[0];
-      g_application.StartVideoCleanup(userInitiated, content);
+      g_application.StartVideoCleanup(userInitiated, content, dryRun);
     }
     else
       CLog::Log(LOGERROR, "CleanLibrary is not possible while scanning or cleaning");
@@ -54,7 +60,7 @@ static int CleanLibrary(const std::vector<std::string>& params)
   else if (StringUtils::EqualsNoCase(params[0], "music"))
   {
     if (!g_application.IsMusicScanning())
-      g_application.StartMusicCleanup(userInitiated);
+      g_application.StartMusicCleanup(userInitiated, dryRun);
     else
       CLog::Log(LOGERROR, "CleanLibrary is not possible while scanning for media info");
   }
@@ -258,6 +264,80 @@ static int ExportLibrary2(const std::vector<std::string>& params)
 }
 
 
+/*! \brief Extract thumbs for the videos in the library that have no art.
+ *  \param params The parameters.
+ *  \details params[0] = "chapters" to extract chapter thumbs too, or "stop" (optional).
+ *           params[1] = number of videos to process at once (optional).
+ */
+static int ExtractVideoThumbs(const std::vector<std::string>& params)
+{
+  if (!params.empty() && StringUtils::EqualsNoCase(params[0], "stop"))
+  {
+    CVideoThumbBatchJob::CancelActive();
+    return 0;
+  }
+
+  const bool chapters = !params.empty() && StringUtils::EqualsNoCase(params[0], "chapters");
+  unsigned int parallelism = 0;
+  if (params.size() > 1)
+    parallelism = static_cast<unsigned int>(std::max(0, atoi(params[1].c_str())));
+
+  if (!CVideoThumbBatchJob::ExtractLibraryThumbs(chapters, parallelism, true))
+    CLog::Log(LOGWARNING, "%s - thumbs are already being extracted", __FUNCTION__);
+
+  return 0;
+}
+
+/*! \brief Measure the loudness of the songs in the music library that weren't analysed yet.
+ *  \param params The parameters.
+ *  \details params[0] = number of albums to analyse at once, or "stop" (optional).
+ *           params[1] = maximum decoding speed of an album as a multiple of realtime (optional).
+ */
+static int AnalyzeLoudness(const std::vector<std::string>& params)
+{
+  if (!params.empty() && StringUtils::EqualsNoCase(params[0], "stop"))
+  {
+    CMusicLoudnessJob::CancelActive();
+    return 0;
+  }
+
+  unsigned int parallelism = 0;
+  unsigned int maxSpeed = 0;
+  if (!params.empty())
+    parallelism = static_cast<unsigned int>(std::max(0, atoi(params[0].c_str())));
+  if (params.size() > 1)
+    maxSpeed = static_cast<unsigned int>(std::max(0, atoi(params[1].c_str())));
+
+  if (!CMusicLoudnessJob::AnalyzeLibrary(parallelism, maxSpeed, true))
+    CLog::Log(LOGWARNING, "%s - loudness is already being analysed", __FUNCTION__);
+
+  return 0;
+}
+
+/*! \brief Cache the artwork of a library.
+ *  \param params The parameters.
+ *  \details params[0] = "video", "music" or "all" (optional).
+ *           params[1] = number of images to cache at once (optional).
+ *           params[2] = maximum number of images to start per second (optional).
+ */
+static int PrecacheArtwork(const std::vector<std::string>& params)
+{
+  const bool video = params.empty() || !StringUtils::EqualsNoCase(params[0], "music");
+  const bool music = params.empty() || !StringUtils::EqualsNoCase(params[0], "video");
+  unsigned int parallelism = 0;
+  unsigned int maxRate = 0;
+  if (params.size() > 1)
+    parallelism = static_cast<unsigned int>(std::max(0, atoi(params[1].c_str())));
+  if (params.size() > 2)
+    maxRate = static_cast<unsigned int>(std::max(0, atoi(params[2].c_str())));
+
+  std::vector<std::string> images = CTexturePrecacheJob::GetLibraryImages(video, music);
+  if (!CTextureCache::GetInstance().PrecacheImages(std::move(images), parallelism, maxRate, true))
+    CLog::Log(LOGWARNING, "%s - artwork is already being cached", __FUNCTION__);
+
+  return 0;
+}
+
 /*! \brief Update a library.
  *  \param params The parameters.
  *  \details params[0] = "video" or "music".
@@ -309,10 +389,19 @@ static int SearchVideoLibrary(const std::vector<std::string>& params)
 ///     Function,
 ///     Description }
 ///   \table_row2_l{
-///     <b>`cleanlibrary(type)`</b>
+///     <b>`analyzeloudness([parallelism\, maxspeed])`</b>
+///     ,
+///     Measure the loudness of the music library songs not analysed yet in the background and set their ReplayGain
+///     @param[in] parallelism           Number of albums to analyse at once\, "stop" to cancel (optional).
+///     @param[in] maxspeed              Maximum decoding speed of an album as a multiple of realtime (optional).
+///   }
+///   \table_row2_l{
+///     <b>`cleanlibrary(type [\, userInitiated\, dryrun])`</b>
 ///     ,
 ///      Clean the video/music library
 ///     @param[in] type                  "video"\, "movies"\, "tvshows"\, "musicvideos" or "music".
+///     @param[in] userInitiated         "true" to show dialogs (optional).
+///     @param[in] dryrun                Add "dryrun" to only log what would be removed (optional).
 ///   }
 ///   \table_row2_l{
 ///     <b>`exportlibrary(type [\, exportSingeFile\, exportThumbs\, overwrite\, exportActorThumbs])`</b>
@@ -343,6 +432,21 @@ static int SearchVideoLibrary(const std::vector<std::string>& params)
 ///     @param[in] actorthumbs           Add "actorthumbs" to include other actor thumbs.
 ///   }
 ///   \table_row2_l{
+///     <b>`extractvideothumbs([mode\, parallelism])`</b>
+///     ,
+///     Extract thumbs for all videos in the library without artwork in the background
+///     @param[in] mode                  "chapters" to extract chapter thumbs too\, "stop" to cancel (optional).
+///     @param[in] parallelism           Number of videos to process at once (optional).
+///   }
+///   \table_row2_l{
+///     <b>`precacheartwork([type\, parallelism\, maxrate])`</b>
+///     ,
+///     Cache the artwork of the video/music library in the background
+///     @param[in] type                  "video"\, "music" or "all" (optional).
+///     @param[in] parallelism           Number of images to cache at once (optional).
+///     @param[in] maxrate               Maximum number of images to start per second (optional).
+///   }
+///   \table_row2_l{
 ///     <b>`updatelibrary([type\, suppressDialogs])`</b>
 ///     ,
 ///     Update the selected library (music or video)
@@ -360,9 +464,12 @@ static int SearchVideoLibrary(const std::vector<std::string>& params)
 CBuiltins::CommandMap CLibraryBuiltins::GetOperations() const
 {
   return {
+          {"analyzeloudness",     {"Measure the loudness of the music library songs", 0, AnalyzeLoudness}},
           {"cleanlibrary",        {"Clean the video/music library", 1, CleanLibrary}},
           {"exportlibrary",       {"Export the video/music library", 1, ExportLibrary}},
           {"exportlibrary2",      {"Export the video/music library", 1, ExportLibrary2}},
+          {"extractvideothumbs",  {"Extract thumbs for library videos without artwork", 0, ExtractVideoThumbs}},
+          {"precacheartwork",     {"Cache the artwork of the video/music library", 0, PrecacheArtwork}},
           {"updatelibrary",       {"Update the selected library (music or video)", 1, UpdateLibrary}},
           {"videolibrary.search", {"Brings up a search dialog which will search the library", 0, SearchVideoLibrary}}
          };
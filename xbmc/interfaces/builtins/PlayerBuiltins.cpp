@@ -18,6 +18,7 @@
 #include "PartyModeManager.h"
 #include "PlayListPlayer.h"
 #include "SeekHandler.h"
+#include "cores/VideoPlayer/FrameTrace.h"
 #include "settings/MediaSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
@@ -505,6 +506,28 @@ static int Seek(const std::vector<std::string>& params)
   return 0;
 }
 
+/*! \brief Control the tracing of video frames through the player.
+ *  \param params The parameters.
+ *  \details params[0] = "start", "stop" or "export".
+ *           params[1] = Path of the exported trace (optional).
+ */
+static int FrameTrace(const std::vector<std::string>& params)
+{
+  if (StringUtils::EqualsNoCase(params[0], "start"))
+    CFrameTrace::GetInstance().Start();
+  else if (StringUtils::EqualsNoCase(params[0], "stop"))
+    CFrameTrace::GetInstance().Stop();
+  else if (StringUtils::EqualsNoCase(params[0], "export"))
+  {
+    const std::string path = params.size() > 1 ? params[1] : "special://temp/frametrace.json";
+    CFrameTrace::GetInstance().Export(path);
+  }
+  else
+    CLog::Log(LOGERROR, "FrameTrace called with invalid argument: \"%s\"", params[0].c_str());
+
+  return 0;
+}
+
 // Note: For new Texts with comma add a "\" before!!! Is used for table text.
 //
 /// \page page_List_of_built_in_functions
@@ -517,6 +540,16 @@ static int Seek(const std::vector<std::string>& params)
 ///     Function,
 ///     Description }
 ///   \table_row2_l{
+///     <b>`FrameTrace(command[\,path])`</b>
+///     ,
+///     Records when each video frame is demuxed\, decoded\, queued and presented.
+///     "start" clears the trace and starts recording\, "stop" stops it and
+///     "export" writes the recorded frames as Chrome trace event JSON\, by
+///     default to special://temp/frametrace.json.
+///     @param[in] command               "start"\, "stop" or "export".
+///     @param[in] path                  Path of the exported trace (optional).
+///   }
+///   \table_row2_l{
 ///     <b>`PlaysDisc(parm)`</b>\n
 ///     <b>`PlayDVD(param)`</b>(deprecated)
 ///     ,
@@ -615,6 +648,7 @@ static int Seek(const std::vector<std::string>& params)
 CBuiltins::CommandMap CPlayerBuiltins::GetOperations() const
 {
   return {
+           {"frametrace",          {"Control the tracing of video frames through the player", 1, FrameTrace}},
            {"playdisc",            {"Plays the inserted disc, like CD, DVD or Blu-ray, in the disc drive.", 0, PlayDVD}},
            {"playdvd",             {"Plays the inserted disc, like CD, DVD or Blu-ray, in the disc drive.", 0, PlayDVD}},
            {"playlist.clear",      {"Clear the current playlist", 0, ClearPlaylist}},
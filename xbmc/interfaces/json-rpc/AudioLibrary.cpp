@@ -9,6 +9,7 @@
 #include "AudioLibrary.h"
 
 #include "FileItem.h"
+#include "JSONResultStream.h"
 #include "ServiceBroker.h"
 #include "TextureDatabase.h"
 #include "Util.h"
@@ -33,6 +34,73 @@ using namespace JSONRPC;
 using namespace XFILE;
 using namespace KODI::MESSAGING;
 
+namespace
+{
+void FillArt(const CFileItem& item, bool bFetchArt, CVariant& object)
+{
+  if (bFetchArt)
+  {
+    CGUIListItem::ArtMap artMap = item.GetArt();
+    CVariant artObj(CVariant::VariantTypeObject);
+    for (const auto& artIt : artMap)
+    {
+      if (!artIt.second.empty())
+        artObj[artIt.first] = CTextureUtils::GetWrappedImageURL(artIt.second);
+    }
+    object["art"] = artObj;
+  }
+}
+
+void FillAlbumArt(CThumbLoader& thumbLoader, bool bFetchArt, bool bFetchFanart, CVariant& album)
+{
+  CFileItem item;
+  item.GetMusicInfoTag()->SetDatabaseId(album["albumid"].asInteger(), MediaTypeAlbum);
+
+  // Could use FillDetails, but it does unnecessary serialization of empty MusiInfoTag
+  thumbLoader.FillLibraryArt(item);
+
+  if (bFetchFanart)
+  {
+    if (item.HasArt("fanart"))
+      album["fanart"] = CTextureUtils::GetWrappedImageURL(item.GetArt("fanart"));
+    else
+      album["fanart"] = "";
+  }
+  FillArt(item, bFetchArt, album);
+}
+
+void FillSongArt(CThumbLoader& thumbLoader, bool bFetchArt, bool bFetchFanart, bool bFetchThumb, CVariant& song)
+{
+  CFileItem item;
+  // Only needs song and album id (if we have it) set to get art
+  // Getting art is quicker if "albumid" has been fetched
+  item.GetMusicInfoTag()->SetDatabaseId(song["songid"].asInteger(), MediaTypeSong);
+  if (song.isMember("albumid"))
+    item.GetMusicInfoTag()->SetAlbumId(song["albumid"].asInteger());
+  else
+    item.GetMusicInfoTag()->SetAlbumId(-1);
+
+  // Could use FillDetails, but it does unnecessary serialization of empty MusiInfoTag
+  thumbLoader.FillLibraryArt(item);
+
+  if (bFetchThumb)
+  {
+    if (item.HasArt("thumb"))
+      song["thumbnail"] = CTextureUtils::GetWrappedImageURL(item.GetArt("thumb"));
+    else
+      song["thumbnail"] = "";
+  }
+  if (bFetchFanart)
+  {
+    if (item.HasArt("fanart"))
+      song["fanart"] = CTextureUtils::GetWrappedImageURL(item.GetArt("fanart"));
+    else
+      song["fanart"] = "";
+  }
+  FillArt(item, bFetchArt, song);
+}
+} // namespace
+
 JSONRPC_STATUS CAudioLibrary::GetProperties(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CVariant properties = CVariant(CVariant::VariantTypeObject);
@@ -155,6 +223,18 @@ JSONRPC_STATUS CAudioLibrary::GetArtists(const std::string &method, ITransportLa
       fields.insert(field->asString());
   }
 
+  if ((transport->GetCapabilities() & ResponseStreaming) == ResponseStreaming)
+  {
+    const std::string url = musicUrl.ToString();
+    StreamList(transport, "artists", parameterObject,
+               [fields, url, sorting](CMusicDatabase& db, int& total,
+                                      const CMusicDatabase::JSONItemCallback& callback) {
+                 db.SetTranslateBlankArtist(false);
+                 return db.GetArtistsByWhereJSON(fields, url, callback, total, sorting);
+               });
+    return OK;
+  }
+
   musicdatabase.SetTranslateBlankArtist(false);
   if (!musicdatabase.GetArtistsByWhereJSON(fields, musicUrl.ToString(), result, total, sorting))
     return InternalError;
@@ -256,6 +336,27 @@ JSONRPC_STATUS CAudioLibrary::GetAlbums(const std::string &method, ITransportLay
       fields.insert(field->asString());
   }
 
+  if ((transport->GetCapabilities() & ResponseStreaming) == ResponseStreaming)
+  {
+    const std::string url = musicUrl.ToString();
+    StreamList(transport, "albums", parameterObject,
+               [fields, url, sorting](CMusicDatabase& db, int& total,
+                                      const CMusicDatabase::JSONItemCallback& callback) {
+                 const bool bFetchArt = fields.find("art") != fields.end();
+                 const bool bFetchFanart = fields.find("fanart") != fields.end();
+                 if (!bFetchArt && !bFetchFanart)
+                   return db.GetAlbumsByWhereJSON(fields, url, callback, total, sorting);
+
+                 CMusicThumbLoader thumbLoader;
+                 thumbLoader.OnLoaderStart();
+                 return db.GetAlbumsByWhereJSON(fields, url, [&](CVariant& album) {
+                   FillAlbumArt(thumbLoader, bFetchArt, bFetchFanart, album);
+                   return callback(album);
+                 }, total, sorting);
+               });
+    return OK;
+  }
+
   if (!musicdatabase.GetAlbumsByWhereJSON(fields, musicUrl.ToString(), result, total, sorting))
     return InternalError;
 
@@ -275,35 +376,7 @@ JSONRPC_STATUS CAudioLibrary::GetAlbums(const std::string &method, ITransportLay
         artfields.insert("fanart");
 
       for (unsigned int index = 0; index < result["albums"].size(); index++)
-      {
-        CFileItem item;
-        item.GetMusicInfoTag()->SetDatabaseId(result["albums"][index]["albumid"].asInteger(), MediaTypeAlbum);
-
-        // Could use FillDetails, but it does unnecessary serialization of empty MusiInfoTag
-        // CFileItemPtr itemptr(new CFileItem(item));
-        // FillDetails(item.GetMusicInfoTag(), itemptr, artfields, result["albums"][index], thumbLoader);
-
-        thumbLoader->FillLibraryArt(item);
-
-        if (bFetchFanart)
-        {
-          if (item.HasArt("fanart"))
-            result["albums"][index]["fanart"] = CTextureUtils::GetWrappedImageURL(item.GetArt("fanart"));
-          else
-            result["albums"][index]["fanart"] = "";
-        }
-        if (bFetchArt)
-        {
-          CGUIListItem::ArtMap artMap = item.GetArt();
-          CVariant artObj(CVariant::VariantTypeObject);
-          for (const auto& artIt : artMap)
-          {
-            if (!artIt.second.empty())
-              artObj[artIt.first] = CTextureUtils::GetWrappedImageURL(artIt.second);
-          }
-          result["albums"][index]["art"] = artObj;
-        }
-      }
+        FillAlbumArt(*thumbLoader, bFetchArt, bFetchFanart, result["albums"][index]);
 
       delete thumbLoader;
     }
@@ -408,6 +481,28 @@ JSONRPC_STATUS CAudioLibrary::GetSongs(const std::string &method, ITransportLaye
       fields.insert(field->asString());
   }
 
+  if ((transport->GetCapabilities() & ResponseStreaming) == ResponseStreaming)
+  {
+    const std::string url = musicUrl.ToString();
+    StreamList(transport, "songs", parameterObject,
+               [fields, url, sorting](CMusicDatabase& db, int& total,
+                                      const CMusicDatabase::JSONItemCallback& callback) {
+                 const bool bFetchArt = fields.find("art") != fields.end();
+                 const bool bFetchFanart = fields.find("fanart") != fields.end();
+                 const bool bFetchThumb = fields.find("thumbnail") != fields.end();
+                 if (!bFetchArt && !bFetchFanart && !bFetchThumb)
+                   return db.GetSongsByWhereJSON(fields, url, callback, total, sorting);
+
+                 CMusicThumbLoader thumbLoader;
+                 thumbLoader.OnLoaderStart();
+                 return db.GetSongsByWhereJSON(fields, url, [&](CVariant& song) {
+                   FillSongArt(thumbLoader, bFetchArt, bFetchFanart, bFetchThumb, song);
+                   return callback(song);
+                 }, total, sorting);
+               });
+    return OK;
+  }
+
   if (!musicdatabase.GetSongsByWhereJSON(fields, musicUrl.ToString(), result, total, sorting))
     return InternalError;
 
@@ -430,48 +525,7 @@ JSONRPC_STATUS CAudioLibrary::GetSongs(const std::string &method, ITransportLaye
         artfields.insert("thumbnail");
 
       for (unsigned int index = 0; index < result["songs"].size(); index++)
-      {
-        CFileItem item;
-        // Only needs song and album id (if we have it) set to get art
-        // Getting art is quicker if "albumid" has been fetched
-        item.GetMusicInfoTag()->SetDatabaseId(result["songs"][index]["songid"].asInteger(), MediaTypeSong);
-        if (result["songs"][index].isMember("albumid"))
-          item.GetMusicInfoTag()->SetAlbumId(result["songs"][index]["albumid"].asInteger());
-        else
-          item.GetMusicInfoTag()->SetAlbumId(-1);
-
-        // Could use FillDetails, but it does unnecessary serialization of empty MusiInfoTag
-        // CFileItemPtr itemptr(new CFileItem(item));
-        // FillDetails(item.GetMusicInfoTag(), itemptr, artfields, result["songs"][index], thumbLoader);
-
-        thumbLoader->FillLibraryArt(item);
-
-        if (bFetchThumb)
-        {
-          if (item.HasArt("thumb"))
-            result["songs"][index]["thumbnail"] = CTextureUtils::GetWrappedImageURL(item.GetArt("thumb"));
-          else
-            result["songs"][index]["thumbnail"] = "";
-        }
-        if (bFetchFanart)
-        {
-          if (item.HasArt("fanart"))
-            result["songs"][index]["fanart"] = CTextureUtils::GetWrappedImageURL(item.GetArt("fanart"));
-          else
-            result["songs"][index]["fanart"] = "";
-        }
-        if (bFetchArt)
-        {
-          CGUIListItem::ArtMap artMap = item.GetArt();
-          CVariant artObj(CVariant::VariantTypeObject);
-          for (const auto& artIt : artMap)
-          {
-            if (!artIt.second.empty())
-              artObj[artIt.first] = CTextureUtils::GetWrappedImageURL(artIt.second);
-          }
-          result["songs"][index]["art"] = artObj;
-        }
-      }
+        FillSongArt(*thumbLoader, bFetchArt, bFetchFanart, bFetchThumb, result["songs"][index]);
 
       delete thumbLoader;
     }
@@ -1100,6 +1154,40 @@ void CAudioLibrary::FillItemArtistIDs(const std::vector<int> artistids, CFileIte
   item->SetProperty("artistid", artistidObj);
 }
 
+void CAudioLibrary::StreamList(ITransportLayer *transport, const std::string &name, const CVariant &parameterObject,
+                               const StreamQuery &query)
+{
+  // the query runs on the thread of the stream with a database connection of its own
+  transport->SetResultStream(std::unique_ptr<IResultStream>(new CJSONResultStream(name,
+    [parameterObject, query](CJSONResultStream& stream) {
+      CMusicDatabase musicdatabase;
+      if (!musicdatabase.Open())
+        return false;
+
+      int total = -1;
+      bool begun = false;
+      auto begin = [&]() {
+        // the total is known before the first item
+        CVariant head;
+        int start, end;
+        HandleLimits(parameterObject, head, total, start, end);
+        stream.Begin(head);
+        begun = true;
+      };
+
+      if (!query(musicdatabase, total, [&](CVariant& item) {
+            if (!begun)
+              begin();
+            return stream.Append(item);
+          }))
+        return false;
+
+      if (!begun)
+        begin();
+      return true;
+    })));
+}
+
 void CAudioLibrary::FillAlbumItem(const CAlbum &album, const std::string &path, CFileItemPtr &item)
 {
   item = CFileItemPtr(new CFileItem(path, album));
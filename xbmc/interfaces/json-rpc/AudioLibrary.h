@@ -11,6 +11,7 @@
 #include "FileItemHandler.h"
 #include "JSONRPC.h"
 
+#include <functional>
 #include <set>
 #include <string>
 #include <vector>
@@ -56,6 +57,16 @@ namespace JSONRPC
     static JSONRPC_STATUS GetAdditionalSongDetails(const CVariant &parameterObject, CFileItemList &items, CMusicDatabase &musicdatabase);
 
   private:
+    // the same as CMusicDatabase::JSONItemCallback
+    using StreamQuery = std::function<bool(CMusicDatabase& musicdatabase, int& total,
+                                           const std::function<bool(CVariant& item)>& callback)>;
+
+    /*!
+     \brief Sends the result of a list query as a stream with the limits ahead of the items
+     */
+    static void StreamList(ITransportLayer *transport, const std::string &name, const CVariant &parameterObject,
+                           const StreamQuery &query);
+
     static void FillAlbumItem(const CAlbum &album, const std::string &path, CFileItemPtr &item);
     static void FillItemArtistIDs(const std::vector<int> artistids, CFileItemPtr &item);
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 class CVariant;
@@ -19,11 +20,31 @@ namespace JSONRPC
     Response = 0x1,
     Announcing = 0x2,
     FileDownloadRedirect = 0x4,
-    FileDownloadDirect = 0x8
+    FileDownloadDirect = 0x8,
+    ResponseStreaming = 0x10
   };
 
   #define TRANSPORT_LAYER_CAPABILITY_ALL (Response | Announcing | FileDownloadRedirect | FileDownloadDirect)
 
+  /*!
+   \brief Result of a method that is serialized while it is sent
+
+   Methods returning very long lists can hand one of these to a transport
+   with the ResponseStreaming capability instead of filling the result
+   variant, so the list never has to be held in memory as a whole.
+   */
+  class IResultStream
+  {
+  public:
+    virtual ~IResultStream() = default;
+
+    /*!
+     \brief Appends the next part of the serialized result to output
+     \return false once the result is complete, output may have received the last part
+     */
+    virtual bool Read(std::string& output) = 0;
+  };
+
   class ITransportLayer
   {
   public:
@@ -31,5 +52,12 @@ namespace JSONRPC
     virtual bool PrepareDownload(const char *path, CVariant &details, std::string &protocol) = 0;
     virtual bool Download(const char *path, CVariant &result) = 0;
     virtual int GetCapabilities() = 0;
+
+    /*!
+     \brief Hands the result of the current method over as a stream
+     \details Only used on transports with the ResponseStreaming capability.
+     */
+    virtual void SetResultStream(std::unique_ptr<IResultStream> stream) { }
+    virtual std::unique_ptr<IResultStream> TakeResultStream() { return nullptr; }
   };
 }
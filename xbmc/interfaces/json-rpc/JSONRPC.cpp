@@ -28,6 +28,62 @@
 
 using namespace JSONRPC;
 
+namespace
+{
+/*!
+ \brief Wraps a streamed method result into the JSON-RPC response object
+ */
+class CResponseStream : public IResultStream
+{
+public:
+  CResponseStream(const CVariant& id, std::string errorResponse, std::unique_ptr<IResultStream> result)
+    : m_errorResponse(std::move(errorResponse)),
+      m_result(std::move(result))
+  {
+    // same member order as a response written from a CVariant
+    std::string idString;
+    CJSONVariantWriter::Write(id, idString, true);
+    m_prefix = "{\"id\":" + idString + ",\"jsonrpc\":\"2.0\",\"result\":";
+  }
+
+  bool Read(std::string& output) override
+  {
+    if (m_done)
+      return false;
+
+    std::string data;
+    const bool more = m_result->Read(data);
+    if (!m_started)
+    {
+      // as long as nothing has been sent a failure is still a proper error response
+      if (!more && data.empty())
+      {
+        output.append(m_errorResponse);
+        m_done = true;
+        return false;
+      }
+      output.append(m_prefix);
+      m_started = true;
+    }
+
+    output.append(data);
+    if (!more)
+    {
+      output.append("}");
+      m_done = true;
+    }
+    return more;
+  }
+
+private:
+  std::string m_prefix;
+  std::string m_errorResponse;
+  std::unique_ptr<IResultStream> m_result;
+  bool m_started = false;
+  bool m_done = false;
+};
+} // namespace
+
 bool CJSONRPC::m_initialized = false;
 
 void CJSONRPC::Initialize()
@@ -257,7 +313,22 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
       }
     }
     else
-      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
+    {
+      std::unique_ptr<IResultStream> stream;
+      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client, &stream);
+      if (stream)
+      {
+        // the response is sent by the transport while the result is serialized
+        CVariant errorResponse;
+        std::string errorString;
+        BuildResponse(inputroot, InternalError, CVariant(), errorResponse);
+        CJSONVariantWriter::Write(errorResponse, errorString, true);
+
+        transport->SetResultStream(std::unique_ptr<IResultStream>(
+            new CResponseStream(inputroot["id"], errorString, std::move(stream))));
+        return "";
+      }
+    }
   }
   else
   {
@@ -273,7 +344,8 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
   return str;
 }
 
-bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
+bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client,
+                                std::unique_ptr<IResultStream>* stream /* = nullptr */)
 {
   JSONRPC_STATUS errorCode = OK;
   CVariant result;
@@ -290,7 +362,29 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     CVariant params;
 
     if ((errorCode = CJSONServiceDescription::CheckCall(methodName.c_str(), request["params"], transport, client, isNotification, method, params)) == OK)
+    {
       errorCode = method(methodName, transport, client, params, result);
+
+      std::unique_ptr<IResultStream> resultStream;
+      if (transport != nullptr && (resultStream = transport->TakeResultStream()))
+      {
+        if (errorCode == OK && !isNotification && stream != nullptr)
+        {
+          *stream = std::move(resultStream);
+          return true;
+        }
+
+        // e.g. within a batch call, the result has to be part of the response
+        std::string data;
+        if (errorCode == OK && !isNotification)
+        {
+          while (resultStream->Read(data))
+            ;
+          if (!CJSONVariantParser::Parse(data, result))
+            errorCode = InternalError;
+        }
+      }
+    }
     else
       result = params;
   }
@@ -13,6 +13,7 @@
 
 #include <iostream>
 #include <map>
+#include <memory>
 #include <stdio.h>
 #include <string>
 
@@ -62,7 +63,13 @@ namespace JSONRPC
     static JSONRPC_STATUS NotifyAll(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
 
   private:
-    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    /*
+     \brief Calls a single method
+     \param stream receives the result instead of response if the method streamed it,
+            without it a streamed result is read into response
+     */
+    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client,
+                                 std::unique_ptr<IResultStream>* stream = nullptr);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
     inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
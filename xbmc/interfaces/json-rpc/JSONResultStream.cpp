@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "JSONResultStream.h"
+
+#include "threads/SingleLock.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+using namespace JSONRPC;
+
+const size_t CJSONResultStream::MAX_BUFFER_SIZE;
+
+CJSONResultStream::CJSONResultStream(const std::string& name, Producer producer)
+  : CThread("JSONRPCResultStream"),
+    m_name(name),
+    m_producer(std::move(producer))
+{
+}
+
+CJSONResultStream::~CJSONResultStream()
+{
+  {
+    // wake up a producer waiting for the transport that is gone
+    CSingleLock lock(m_critSection);
+    m_bStop = true;
+    m_condition.notifyAll();
+  }
+  StopThread();
+}
+
+void CJSONResultStream::Begin(const CVariant& head)
+{
+  std::string data = "{";
+  for (CVariant::const_iterator_map it = head.begin_map(); it != head.end_map(); ++it)
+  {
+    std::string key, value;
+    CJSONVariantWriter::Write(CVariant(it->first), key, true);
+    CJSONVariantWriter::Write(it->second, value, true);
+    if (data.size() > 1)
+      data += ",";
+    data += key + ":" + value;
+  }
+
+  m_begun = true;
+  m_headEmpty = head.empty();
+  Write(data);
+}
+
+bool CJSONResultStream::Append(const CVariant& item)
+{
+  std::string data;
+  if (!CJSONVariantWriter::Write(item, data, true))
+    return false;
+
+  CSingleLock lock(m_critSection);
+  while (m_buffer.size() >= MAX_BUFFER_SIZE && !m_bStop)
+    m_condition.wait(lock);
+  if (m_bStop)
+    return false;
+
+  // like a list in a CVariant the member is only written if it has items
+  if (m_empty)
+    m_buffer += (m_headEmpty ? "\"" : ",\"") + m_name + "\":[";
+  else
+    m_buffer += ',';
+  m_buffer += data;
+  m_empty = false;
+  m_condition.notifyAll();
+
+  return true;
+}
+
+bool CJSONResultStream::Read(std::string& output)
+{
+  CSingleLock lock(m_critSection);
+  if (!m_started)
+  {
+    // the producer only runs once the result is actually wanted
+    m_started = true;
+    Create();
+  }
+
+  while (m_buffer.empty() && !m_done)
+    m_condition.wait(lock);
+
+  output.append(m_buffer);
+  m_buffer.clear();
+  m_condition.notifyAll();
+
+  return !m_done;
+}
+
+void CJSONResultStream::Process()
+{
+  const bool success = m_producer(*this);
+  if (success)
+  {
+    if (!m_begun)
+      Begin(CVariant(CVariant::VariantTypeObject));
+    Write(m_empty ? "}" : "]}");
+  }
+  else if (m_begun && !m_bStop)
+    CLog::Log(LOGERROR, "JSONRPC: Streamed result \"%s\" is incomplete", m_name.c_str());
+
+  CSingleLock lock(m_critSection);
+  m_done = true;
+  m_condition.notifyAll();
+}
+
+void CJSONResultStream::Write(const std::string& data)
+{
+  CSingleLock lock(m_critSection);
+  m_buffer += data;
+  m_condition.notifyAll();
+}
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "ITransportLayer.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <functional>
+#include <string>
+
+class CVariant;
+
+namespace JSONRPC
+{
+  /*!
+   \ingroup jsonrpc
+   \brief List result that is serialized while the transport sends it
+
+   The producer runs on a thread of its own and hands the items over one at
+   a time, e.g. straight from the rows of a database query. Serialized items
+   are buffered up to MAX_BUFFER_SIZE bytes, beyond that the producer waits
+   for the transport, so memory use doesn't grow with the number of items.
+
+   The result is written as {<members of head>,"<name>":[<items>]}, without
+   the list if there are no items.
+   */
+  class CJSONResultStream : public IResultStream, private CThread
+  {
+  public:
+    static const size_t MAX_BUFFER_SIZE = 256 * 1024;
+
+    /*!
+     \brief Produces the result, called on the thread of the stream
+     \return false if the result couldn't be produced
+     */
+    using Producer = std::function<bool(CJSONResultStream& stream)>;
+
+    CJSONResultStream(const std::string& name, Producer producer);
+    ~CJSONResultStream() override;
+
+    /*!
+     \brief Starts the result, must be called before the first item
+     \param head object whose members are written ahead of the list, e.g. "limits"
+     */
+    void Begin(const CVariant& head);
+
+    /*!
+     \brief Appends an item to the list, waits while the buffer is full
+     \return false if the result isn't wanted any more and the producer should stop
+     */
+    bool Append(const CVariant& item);
+
+    // implementation of IResultStream
+    bool Read(std::string& output) override;
+
+  protected:
+    // implementation of CThread
+    void Process() override;
+
+  private:
+    void Write(const std::string& data);
+
+    const std::string m_name;
+    Producer m_producer;
+
+    CCriticalSection m_critSection;
+    XbmcThreads::ConditionVariable m_condition;
+    std::string m_buffer;
+    bool m_started = false;
+    bool m_begun = false;
+    bool m_headEmpty = true;
+    bool m_empty = true;
+    bool m_done = false;
+  };
+}
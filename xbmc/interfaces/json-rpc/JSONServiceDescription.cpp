@@ -225,6 +225,9 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
 // Textures operations
   { "Textures.GetTextures",                         CTextureOperations::GetTextures },
   { "Textures.RemoveTexture",                       CTextureOperations::RemoveTexture },
+  { "Textures.Precache",                            CTextureOperations::Precache },
+  { "Textures.GetPrecacheStatus",                   CTextureOperations::GetPrecacheStatus },
+  { "Textures.CancelPrecache",                      CTextureOperations::CancelPrecache },
 
 // Settings operations
   { "Settings.GetSections",                         CSettingsOperations::GetSections },
@@ -91,3 +91,43 @@ JSONRPC_STATUS CTextureOperations::RemoveTexture(const std::string &method, ITra
 
   return ACK;
 }
+
+JSONRPC_STATUS CTextureOperations::Precache(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  std::vector<std::string> images;
+  for (CVariant::const_iterator_array it = parameterObject["images"].begin_array(); it != parameterObject["images"].end_array(); ++it)
+    images.push_back(it->asString());
+
+  if (images.empty())
+  {
+    const std::string library = parameterObject["library"].asString();
+    images = CTexturePrecacheJob::GetLibraryImages(library != "music", library != "video");
+  }
+
+  if (!CTextureCache::GetInstance().PrecacheImages(std::move(images),
+                                                   static_cast<unsigned int>(parameterObject["parallelism"].asUnsignedInteger()),
+                                                   static_cast<unsigned int>(parameterObject["maxrate"].asUnsignedInteger()),
+                                                   parameterObject["showdialogs"].asBoolean()))
+    return FailedToExecute;
+
+  return ACK;
+}
+
+JSONRPC_STATUS CTextureOperations::GetPrecacheStatus(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  const TexturePrecacheStatus status = CTextureCache::GetInstance().GetPrecacheStatus();
+  result["active"] = status.active;
+  result["total"] = status.total;
+  result["processed"] = status.processed;
+  result["cached"] = status.cached;
+  result["failed"] = status.failed;
+  result["elapsed"] = status.elapsedMs;
+  result["imagespersecond"] = status.imagesPerSecond;
+  return OK;
+}
+
+JSONRPC_STATUS CTextureOperations::CancelPrecache(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CTextureCache::GetInstance().CancelPrecache();
+  return ACK;
+}
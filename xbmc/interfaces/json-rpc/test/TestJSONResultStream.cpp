@@ -0,0 +1,105 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "interfaces/json-rpc/JSONResultStream.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/Variant.h"
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace JSONRPC;
+
+namespace
+{
+std::string ReadAll(IResultStream& stream)
+{
+  std::string output;
+  while (stream.Read(output))
+    ;
+  return output;
+}
+
+CVariant Limits(int total)
+{
+  CVariant head;
+  head["limits"]["start"] = 0;
+  head["limits"]["end"] = total;
+  head["limits"]["total"] = total;
+  return head;
+}
+} // namespace
+
+TEST(TestJSONResultStream, Items)
+{
+  const int count = 5000;
+  CJSONResultStream stream("songs", [](CJSONResultStream& stream) {
+    stream.Begin(Limits(count));
+    for (int i = 0; i < count; i++)
+    {
+      CVariant song;
+      song["songid"] = i;
+      song["label"] = "Song \"" + std::to_string(i) + "\"";
+      if (!stream.Append(song))
+        return false;
+    }
+    return true;
+  });
+
+  // the result is the same as a list collected in a CVariant
+  CVariant result;
+  ASSERT_TRUE(CJSONVariantParser::Parse(ReadAll(stream), result));
+  EXPECT_EQ(count, result["limits"]["total"].asInteger());
+  ASSERT_EQ(static_cast<unsigned int>(count), result["songs"].size());
+  EXPECT_EQ(4999, result["songs"][4999]["songid"].asInteger());
+  EXPECT_EQ("Song \"7\"", result["songs"][7]["label"].asString());
+}
+
+TEST(TestJSONResultStream, Empty)
+{
+  CJSONResultStream stream("albums", [](CJSONResultStream& stream) {
+    stream.Begin(Limits(0));
+    return true;
+  });
+  EXPECT_EQ("{\"limits\":{\"end\":0,\"start\":0,\"total\":0}}", ReadAll(stream));
+
+  CJSONResultStream noHead("albums", [](CJSONResultStream& stream) { return true; });
+  EXPECT_EQ("{}", ReadAll(noHead));
+}
+
+TEST(TestJSONResultStream, Failed)
+{
+  CJSONResultStream stream("artists", [](CJSONResultStream& stream) { return false; });
+  std::string output;
+  EXPECT_FALSE(stream.Read(output));
+  EXPECT_TRUE(output.empty());
+}
+
+TEST(TestJSONResultStream, Abandoned)
+{
+  bool stopped = false;
+  {
+    // the producer is blocked on the full buffer when the transport goes away
+    CJSONResultStream stream("songs", [&stopped](CJSONResultStream& stream) {
+      stream.Begin(Limits(1000000));
+      CVariant song;
+      song["title"] = std::string(1024, 'x');
+      while (stream.Append(song))
+        ;
+      stopped = true;
+      return false;
+    });
+
+    std::string output;
+    EXPECT_TRUE(stream.Read(output));
+    EXPECT_FALSE(output.empty());
+  }
+  EXPECT_TRUE(stopped);
+}
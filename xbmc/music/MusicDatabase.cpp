@@ -31,6 +31,7 @@
 #include "events/NotificationEvent.h"
 #include "filesystem/Directory.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/ExistenceChecker.h"
 #include "filesystem/File.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
 #include "guilib/GUIComponent.h"
@@ -73,6 +74,14 @@ using KODI::MESSAGING::HELPERS::DialogResponse;
 #define RECENTLY_PLAYED_LIMIT 25
 #define MIN_FULL_SEARCH_LENGTH 3
 
+// Full text indexes used by search, titles are matched together with the artists
+static const CDatabase::FullTextIndex ArtistSearchIndex{"artist_fts", "artist", "idArtist",
+                                                        {"strArtist"}};
+static const CDatabase::FullTextIndex AlbumSearchIndex{"album_fts", "album", "idAlbum",
+                                                       {"strAlbum", "strArtistDisp"}};
+static const CDatabase::FullTextIndex SongSearchIndex{"song_fts", "song", "idSong",
+                                                      {"strTitle", "strArtistDisp"}};
+
 #ifdef HAS_DVD_DRIVE
 using namespace CDDB;
 using namespace MEDIA_DETECT;
@@ -230,6 +239,35 @@ void CMusicDatabase::CreateTables()
   CLog::Log(LOGINFO, "create removed_link table");
   m_pDS->exec("CREATE TABLE removed_link (idArtist INTEGER, idMedia INTEGER, idRole INTEGER)");
 
+  CreateNavSummaryTables();
+  CreateLoudnessTable();
+  CreateChangeCountTable();
+}
+
+void CMusicDatabase::CreateNavSummaryTables()
+{
+  /* Summary tables that the navigation nodes are read from instead of joining song_artist,
+     album_artist and song_genre every time. They are kept up to date per album, see
+     RefreshNavSummary(). nav_relation holds the distinct (artist, album, role, genre) links
+     where role 0 is an album artist and genre 0 is any genre, including none.
+  */
+  CLog::Log(LOGINFO, "create navigation summary tables");
+  m_pDS->exec("CREATE TABLE nav_relation (idArtist INTEGER, idAlbum INTEGER, "
+              "idRole INTEGER, idGenre INTEGER)");
+  m_pDS->exec("CREATE TABLE nav_genre (idGenre INTEGER PRIMARY KEY, iSongs INTEGER, "
+              "iAlbums INTEGER, iArtists INTEGER)");
+  m_pDS->exec("CREATE TABLE nav_year (iYear INTEGER, bOriginal INTEGER, iAlbums INTEGER)");
+  m_pDS->exec("CREATE TABLE nav_changed (idChanged INTEGER PRIMARY KEY, idAlbum INTEGER)");
+}
+
+void CMusicDatabase::CreateLoudnessTable()
+{
+  /* Results of the loudness analysis, one row per analysed song. Songs without a row are
+     analysed by the next run, see CMusicLoudnessJob. Loudness is in LUFS, the peak is linear.
+  */
+  CLog::Log(LOGINFO, "create songloudness table");
+  m_pDS->exec("CREATE TABLE songloudness (idSong INTEGER PRIMARY KEY, iStatus INTEGER, "
+              "fTrackLoudness REAL, fAlbumLoudness REAL, fPeak REAL, dateAnalysed TEXT)");
 }
 
 void CMusicDatabase::CreateAnalytics()
@@ -281,23 +319,38 @@ void CMusicDatabase::CreateAnalytics()
 
   m_pDS->exec("CREATE INDEX ix_art ON art(media_id, media_type(20), type(20))");
 
+  m_pDS->exec("CREATE UNIQUE INDEX idxNavRelation_1 ON nav_relation ( idAlbum, idArtist, idRole, idGenre )");
+  m_pDS->exec("CREATE INDEX idxNavRelation_2 ON nav_relation ( idArtist, idGenre, idRole )");
+  m_pDS->exec("CREATE INDEX idxNavRelation_3 ON nav_relation ( idGenre, idRole )");
+
+  CLog::Log(LOGINFO, "create full text indexes");
+  CreateFullTextIndex(ArtistSearchIndex);
+  CreateFullTextIndex(AlbumSearchIndex);
+  CreateFullTextIndex(SongSearchIndex);
+
   CLog::Log(LOGINFO, "create triggers");
   m_pDS->exec("CREATE TRIGGER tgrDeleteAlbum AFTER delete ON album FOR EACH ROW BEGIN"
               "  DELETE FROM song WHERE song.idAlbum = old.idAlbum;"
               "  DELETE FROM album_artist WHERE album_artist.idAlbum = old.idAlbum;"
               "  DELETE FROM album_source WHERE album_source.idAlbum = old.idAlbum;"
               "  DELETE FROM art WHERE media_id=old.idAlbum AND media_type='album';"
+              "  INSERT INTO nav_changed (idAlbum) VALUES(old.idAlbum);"
+              "  UPDATE changecount SET iChanges = iChanges + 1;"
               " END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteArtist AFTER delete ON artist FOR EACH ROW BEGIN"
               "  DELETE FROM album_artist WHERE album_artist.idArtist = old.idArtist;"
               "  DELETE FROM song_artist WHERE song_artist.idArtist = old.idArtist;"
               "  DELETE FROM discography WHERE discography.idArtist = old.idArtist;"
               "  DELETE FROM art WHERE media_id=old.idArtist AND media_type='artist';"
+              "  UPDATE changecount SET iChanges = iChanges + 1;"
               " END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteSong AFTER delete ON song FOR EACH ROW BEGIN"
               "  DELETE FROM song_artist WHERE song_artist.idSong = old.idSong;"
               "  DELETE FROM song_genre WHERE song_genre.idSong = old.idSong;"
               "  DELETE FROM art WHERE media_id=old.idSong AND media_type='song';"
+              "  DELETE FROM songloudness WHERE songloudness.idSong = old.idSong;"
+              "  INSERT INTO nav_changed (idAlbum) VALUES(old.idAlbum);"
+              "  UPDATE changecount SET iChanges = iChanges + 1;"
               " END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteSource AFTER delete ON source FOR EACH ROW BEGIN"
               "  DELETE FROM source_path WHERE source_path.idSource = old.idSource;"
@@ -320,6 +373,7 @@ void CMusicDatabase::CreateAnalytics()
                 " UPDATE song SET dateNew = DATETIME('now') WHERE idSong = NEW.idSong"
                 " AND NEW.dateNew IS NULL;"
                 " UPDATE song SET dateModified = DATETIME('now') WHERE idSong = NEW.idSong;"
+                " UPDATE changecount SET iChanges = iChanges + 1;"
                 " END");
     m_pDS->exec("CREATE TRIGGER tgrUpdateSong AFTER UPDATE ON song FOR EACH ROW"
                 " WHEN NEW.dateModified <= OLD.dateModified BEGIN"
@@ -329,6 +383,7 @@ void CMusicDatabase::CreateAnalytics()
                 " UPDATE album SET dateNew = DATETIME('now') WHERE idAlbum = NEW.idAlbum"
                 " AND NEW.dateNew IS NULL;"
                 " UPDATE album SET dateModified = DATETIME('now') WHERE idAlbum = NEW.idAlbum;"
+                " UPDATE changecount SET iChanges = iChanges + 1;"
                 " END");
     m_pDS->exec("CREATE TRIGGER tgrUpdateAlbum AFTER UPDATE ON album FOR EACH ROW"
                 " WHEN NEW.dateModified <= OLD.dateModified BEGIN"
@@ -338,6 +393,7 @@ void CMusicDatabase::CreateAnalytics()
                 " UPDATE artist SET dateNew = DATETIME('now') WHERE idArtist = NEW.idArtist"
                 " AND NEW.dateNew IS NULL;"
                 " UPDATE artist SET dateModified = DATETIME('now') WHERE idArtist = NEW.idArtist;"
+                " UPDATE changecount SET iChanges = iChanges + 1;"
                 " END");
     m_pDS->exec("CREATE TRIGGER tgrUpdateArtist AFTER UPDATE ON artist FOR EACH ROW"
                 " WHEN NEW.dateModified <= OLD.dateModified BEGIN"
@@ -347,6 +403,18 @@ void CMusicDatabase::CreateAnalytics()
     m_pDS->exec("CREATE TRIGGER tgrInsertGenre AFTER INSERT ON genre"
                 " BEGIN UPDATE versiontagscan SET genresupdated = DATETIME('now');"
                 " END");
+
+    // Album links and dates that the navigation summary is built from
+    m_pDS->exec("CREATE TRIGGER tgrNavUpdateSong AFTER UPDATE ON song FOR EACH ROW"
+                " WHEN NEW.idAlbum <> OLD.idAlbum BEGIN"
+                " INSERT INTO nav_changed (idAlbum) VALUES(OLD.idAlbum);"
+                " INSERT INTO nav_changed (idAlbum) VALUES(NEW.idAlbum);"
+                " END");
+    m_pDS->exec("CREATE TRIGGER tgrNavUpdateAlbum AFTER UPDATE ON album FOR EACH ROW"
+                " WHEN NEW.strReleaseDate IS NOT OLD.strReleaseDate"
+                " OR NEW.strOrigReleaseDate IS NOT OLD.strOrigReleaseDate BEGIN"
+                " INSERT INTO nav_changed (idAlbum) VALUES(NEW.idAlbum);"
+                " END");
   }
   else
   { // MySQL trigger syntax - BEFORE INSERT/UPDATE
@@ -373,19 +441,66 @@ void CMusicDatabase::CreateAnalytics()
 
     m_pDS->exec("CREATE TRIGGER tgrInsertGenre AFTER INSERT ON genre FOR EACH ROW"
                 " UPDATE versiontagscan SET genresupdated = now()");
+
+    // Album links and dates that the navigation summary is built from
+    m_pDS->exec("CREATE TRIGGER tgrNavUpdateSong AFTER UPDATE ON song FOR EACH ROW BEGIN"
+                "  IF NEW.idAlbum <> OLD.idAlbum THEN"
+                "   INSERT INTO nav_changed (idAlbum) VALUES(OLD.idAlbum), (NEW.idAlbum);"
+                "  END IF;"
+                "  UPDATE changecount SET iChanges = iChanges + 1;"
+                " END");
+    m_pDS->exec("CREATE TRIGGER tgrNavUpdateAlbum AFTER UPDATE ON album FOR EACH ROW BEGIN"
+                "  IF NOT (NEW.strReleaseDate <=> OLD.strReleaseDate"
+                "   AND NEW.strOrigReleaseDate <=> OLD.strOrigReleaseDate) THEN"
+                "   INSERT INTO nav_changed (idAlbum) VALUES(NEW.idAlbum);"
+                "  END IF;"
+                "  UPDATE changecount SET iChanges = iChanges + 1;"
+                " END");
   }
 
     // Triggers to maintain recent changes to album and song artist links in removed_link table
   m_pDS->exec("CREATE TRIGGER tgrInsertSongArtist AFTER INSERT ON song_artist FOR EACH ROW BEGIN "
               "DELETE FROM removed_link "
               "WHERE idArtist = NEW.idArtist AND idMedia = NEW.idSong AND idRole = NEW.idRole; "
+              "INSERT INTO nav_changed (idAlbum) SELECT idAlbum FROM song WHERE idSong = NEW.idSong; "
+              "UPDATE changecount SET iChanges = iChanges + 1; "
               "END");
   m_pDS->exec("CREATE TRIGGER tgrInsertAlbumArtist AFTER INSERT ON album_artist FOR EACH ROW BEGIN "
               "DELETE FROM removed_link "
               "WHERE idArtist = NEW.idArtist AND idMedia = NEW.idAlbum AND idRole = -1; "
+              "INSERT INTO nav_changed (idAlbum) VALUES(NEW.idAlbum); "
+              "UPDATE changecount SET iChanges = iChanges + 1; "
+              "END");
+  m_pDS->exec("CREATE TRIGGER tgrInsertSongGenre AFTER INSERT ON song_genre FOR EACH ROW BEGIN "
+              "INSERT INTO nav_changed (idAlbum) SELECT idAlbum FROM song WHERE idSong = NEW.idSong; "
+              "UPDATE changecount SET iChanges = iChanges + 1; "
+              "END");
+  m_pDS->exec("CREATE TRIGGER tgrDeleteSongGenre AFTER DELETE ON song_genre FOR EACH ROW BEGIN "
+              "INSERT INTO nav_changed (idAlbum) SELECT idAlbum FROM song WHERE idSong = OLD.idSong; "
+              "UPDATE changecount SET iChanges = iChanges + 1; "
               "END");
   CreateRemovedLinkTriggers(); // DELETE ON song_artist and album_artist tables
 
+  // The cached items of smart playlists are outdated by changes of these. MySQL before 5.7.2
+  // allows one trigger per table, timing and event, the AFTER triggers above count the changes
+  // of their events themselves.
+  if (!bisMySQL)
+  {
+    CreateChangeCountTriggers("song", {"UPDATE"});
+    CreateChangeCountTriggers("album", {"UPDATE"});
+    CreateChangeCountTriggers("artist", {"UPDATE"});
+  }
+  else
+  {
+    CreateChangeCountTriggers("song", {"INSERT"});
+    CreateChangeCountTriggers("album", {"INSERT"});
+    CreateChangeCountTriggers("artist", {"INSERT", "UPDATE"});
+  }
+  CreateChangeCountTriggers("song_artist", {"UPDATE"});
+  CreateChangeCountTriggers("album_artist", {"UPDATE"});
+  CreateChangeCountTriggers("song_genre", {"UPDATE"});
+  CreateChangeCountTriggers("album_source");
+
   // Create native functions stored in DB (MySQL/MariaDB only)
   CreateNativeDBFunctions();
 
@@ -399,10 +514,14 @@ void CMusicDatabase::CreateRemovedLinkTriggers()
   m_pDS->exec("CREATE TRIGGER tgrDeleteSongArtist AFTER DELETE ON song_artist FOR EACH ROW BEGIN"
               " INSERT INTO removed_link (idArtist, idMedia, idRole)"
               " VALUES(OLD.idArtist, OLD.idSong, OLD.idRole);"
+              " INSERT INTO nav_changed (idAlbum) SELECT idAlbum FROM song WHERE idSong = OLD.idSong;"
+              " UPDATE changecount SET iChanges = iChanges + 1;"
               " END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteAlbumArtist AFTER DELETE ON album_artist FOR EACH ROW BEGIN"
               " INSERT INTO removed_link (idArtist, idMedia, idRole)"
               " VALUES(OLD.idArtist, OLD.idAlbum, -1);"
+              " INSERT INTO nav_changed (idAlbum) VALUES(OLD.idAlbum);"
+              " UPDATE changecount SET iChanges = iChanges + 1;"
               " END");
 }
 
@@ -1235,6 +1354,10 @@ int CMusicDatabase::UpdateSong(int idSong,
 
   bool status = ExecuteQuery(strSQL);
 
+  // Gain from the tags replaced the measured one, have the song analysed again
+  if (status && !replayGain.Get(ReplayGain::TRACK).Valid())
+    ExecuteQuery(PrepareSQL("DELETE FROM songloudness WHERE idSong = %i", idSong));
+
   if (status)
     AnnounceUpdate(MediaTypeSong, idSong);
   return idSong;
@@ -3082,7 +3205,13 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList &art
 
     std::string strVariousArtists = g_localizeStrings.Get(340).c_str();
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    Filter filter;
+    if (GetFullTextFilter(ArtistSearchIndex, search, filter))
+    {
+      filter.AppendWhere(PrepareSQL("artist.strArtist <> '%s'", strVariousArtists.c_str()));
+      BuildSQL("SELECT artist.* FROM artist ", filter, strSQL);
+    }
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL=PrepareSQL("select * from artist "
                                 "where (strArtist like '%s%%' or strArtist like '%% %s%%') and strArtist <> '%s' "
                                 , search.c_str(), search.c_str(), strVariousArtists.c_str() );
@@ -3659,7 +3788,14 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items
       return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    Filter filter;
+    if (GetFullTextFilter(SongSearchIndex, search, filter))
+    {
+      filter.limit = "1000";
+      BuildSQL("SELECT songview.* FROM songview JOIN song ON song.idSong = songview.idSong ",
+               filter, strSQL);
+    }
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' or strTitle like '%% %s%%' limit 1000", search.c_str(), search.c_str());
     else
       strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' limit 1000", search.c_str());
@@ -3697,7 +3833,11 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albu
       return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    Filter filter;
+    if (GetFullTextFilter(AlbumSearchIndex, search, filter))
+      BuildSQL("SELECT albumview.* FROM albumview JOIN album ON album.idAlbum = albumview.idAlbum ",
+               filter, strSQL);
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%' or strAlbum like '%% %s%%'", search.c_str(), search.c_str());
     else
       strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%'", search.c_str());
@@ -3727,64 +3867,7 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albu
   return false;
 }
 
-bool CMusicDatabase::CleanupSongsByIds(const std::string &strSongIds)
-{
-  try
-  {
-    if (nullptr == m_pDB)
-      return false;
-    if (nullptr == m_pDS)
-      return false;
-    // ok, now find all idSong's
-    std::string strSQL=PrepareSQL("select * from song join path on song.idPath = path.idPath where song.idSong in %s", strSongIds.c_str());
-    if (!m_pDS->query(strSQL)) return false;
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound == 0)
-    {
-      m_pDS->close();
-      return true;
-    }
-    std::vector<std::string> songsToDelete;
-    while (!m_pDS->eof())
-    { // get the full song path
-      std::string strFileName = URIUtils::AddFileToFolder(m_pDS->fv("path.strPath").get_asString(), m_pDS->fv("song.strFileName").get_asString());
-
-      //  Special case for streams inside an ogg file. (oggstream)
-      //  The last dir in the path is the ogg file that
-      //  contains the stream, so test if its there
-      if (URIUtils::HasExtension(strFileName, ".oggstream|.nsfstream"))
-      {
-        strFileName = URIUtils::GetDirectory(strFileName);
-        // we are dropping back to a file, so remove the slash at end
-        URIUtils::RemoveSlashAtEnd(strFileName);
-      }
-
-      if (!CFile::Exists(strFileName, false))
-      { // file no longer exists, so add to deletion list
-        songsToDelete.push_back(m_pDS->fv("song.idSong").get_asString());
-      }
-      m_pDS->next();
-    }
-    m_pDS->close();
-
-    if (!songsToDelete.empty())
-    {
-      std::string strSongsToDelete = "(" + StringUtils::Join(songsToDelete, ",") + ")";
-      // ok, now delete these songs + all references to them from the linked tables
-      strSQL = "delete from song where idSong in " + strSongsToDelete;
-      m_pDS->exec(strSQL);
-      m_pDS->close();
-    }
-    return true;
-  }
-  catch (...)
-  {
-    CLog::Log(LOGERROR, "Exception in CMusicDatabase::CleanupSongsFromPaths()");
-  }
-  return false;
-}
-
-bool CMusicDatabase::CleanupSongs(CGUIDialogProgress* progressDialog /*= nullptr*/)
+bool CMusicDatabase::CleanupSongs(CGUIDialogProgress* progressDialog /*= nullptr*/, bool dryRun /* = false */)
 {
   try
   {
@@ -3795,45 +3878,85 @@ bool CMusicDatabase::CleanupSongs(CGUIDialogProgress* progressDialog /*= nullptr
     if (total == 0)
       return true;
 
-    // run through all songs and get all unique path ids
-    int iLIMIT = 1000;
-    for (int i=0;;i+=iLIMIT)
-    {
-      std::string strSQL=PrepareSQL("select song.idSong from song order by song.idSong limit %i offset %i",iLIMIT,i);
-      if (!m_pDS->query(strSQL)) return false;
-      int iRowsFound = m_pDS->num_rows();
-      // keep going until no rows are left!
-      if (iRowsFound == 0)
-      {
-        m_pDS->close();
-        return true;
-      }
+    // run through the songs a page at a time, ordered by path so that each folder
+    // is listed only once to check that its songs still exist
+    std::vector<std::pair<int, std::string>> songsToDelete;
+    CExistenceChecker::Stats stats;
+    int iLIMIT = 5000;
+    for (int i = 0; i < total; i += iLIMIT)
+    {
+      std::string strSQL = PrepareSQL("SELECT song.idSong, song.strFileName, path.strPath FROM song "
+                                      "JOIN path ON song.idPath = path.idPath "
+                                      "ORDER BY song.idPath, song.idSong LIMIT %i OFFSET %i",
+                                      iLIMIT, i);
+      if (!m_pDS->query(strSQL))
+        return false;
 
-      std::vector<std::string> songIds;
+      CExistenceChecker checker;
+      std::vector<std::pair<int, std::string>> songs;
       while (!m_pDS->eof())
-      {
-        songIds.push_back(m_pDS->fv("song.idSong").get_asString());
+      { // get the full song path
+        std::string strFileName = URIUtils::AddFileToFolder(m_pDS->fv("path.strPath").get_asString(), m_pDS->fv("song.strFileName").get_asString());
+
+        //  Special case for streams inside an ogg file. (oggstream)
+        //  The last dir in the path is the ogg file that
+        //  contains the stream, so test if its there
+        if (URIUtils::HasExtension(strFileName, ".oggstream|.nsfstream"))
+        {
+          strFileName = URIUtils::GetDirectory(strFileName);
+          // we are dropping back to a file, so remove the slash at end
+          URIUtils::RemoveSlashAtEnd(strFileName);
+        }
+
+        checker.Add(strFileName);
+        songs.emplace_back(m_pDS->fv("song.idSong").get_asInt(), strFileName);
         m_pDS->next();
       }
       m_pDS->close();
-      std::string strSongIds = "(" + StringUtils::Join(songIds, ",") + ")";
-      CLog::Log(LOGDEBUG,"Checking songs from song ID list: %s",strSongIds.c_str());
-      if (progressDialog)
-      {
-        int percentage = i * 100 / total;
+
+      const bool completed = checker.Check([&](unsigned int done, unsigned int folders) {
+        if (!progressDialog)
+          return true;
+        int percentage = static_cast<int>((i + static_cast<int64_t>(songs.size()) * done / std::max(1u, folders)) * 100 / total);
         if (percentage > progressDialog->GetPercentage())
         {
           progressDialog->SetPercentage(percentage);
           progressDialog->Progress();
         }
-        if (progressDialog->IsCanceled())
-        {
-          m_pDS->close();
-          return false;
-        }
+        return !progressDialog->IsCanceled();
+      });
+
+      const CExistenceChecker::Stats& pageStats = checker.GetStats();
+      stats.paths += pageStats.paths;
+      stats.listings += pageStats.listings;
+      stats.fallbacks += pageStats.fallbacks;
+      stats.elapsedMs += pageStats.elapsedMs;
+      if (!completed)
+        return false;
+
+      for (const auto& song : songs)
+      {
+        if (!checker.Exists(song.second))
+          songsToDelete.push_back(song);
       }
-      if (!CleanupSongsByIds(strSongIds)) return false;
     }
+    CLog::Log(LOGINFO, "%s: checked %u songs in %u folders (%u checked on their own) in %u ms, %u songs missing",
+              __FUNCTION__, stats.paths, stats.listings, stats.fallbacks, stats.elapsedMs,
+              static_cast<unsigned int>(songsToDelete.size()));
+
+    if (dryRun)
+    {
+      for (const auto& song : songsToDelete)
+        CLog::Log(LOGINFO, "%s: would remove song %i: %s", __FUNCTION__, song.first,
+                  CURL::GetRedacted(song.second).c_str());
+      return true;
+    }
+
+    // delete these songs + all references to them from the linked tables
+    std::vector<int> songIds;
+    for (const auto& song : songsToDelete)
+      songIds.push_back(song.first);
+    DeleteByIds("song", "idSong", songIds);
     return true;
   }
   catch(...)
@@ -3887,40 +4010,35 @@ bool CMusicDatabase::CleanupPaths()
     // we can happily delete any path that has no reference to a song
     // but we must keep all paths that have been scanned that may contain songs in subpaths
 
-    // first create a temporary table of song paths
-    m_pDS->exec("CREATE TEMPORARY TABLE songpaths (idPath integer, strPath varchar(512))\n");
-    m_pDS->exec("INSERT INTO songpaths select idPath,strPath from path where idPath in (select idPath from song)\n");
+    // first get the song paths, sorted so that the paths below a path follow it
+    std::vector<std::string> songPaths;
+    if (!m_pDS->query("SELECT strPath FROM path WHERE idPath IN (SELECT idPath FROM song)"))
+      return false;
+    while (!m_pDS->eof())
+    {
+      songPaths.push_back(m_pDS->fv("strPath").get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    std::sort(songPaths.begin(), songPaths.end());
 
     // grab all paths that aren't immediately connected with a song
-    std::string sql = "select * from path where idPath not in (select idPath from song)";
+    std::string sql = "SELECT idPath, strPath FROM path WHERE idPath NOT IN (SELECT idPath FROM song)";
     if (!m_pDS->query(sql)) return false;
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound == 0)
-    {
-      m_pDS->close();
-      return true;
-    }
     // and construct a list to delete
-    std::vector<std::string> pathIds;
+    std::vector<int> pathIds;
     while (!m_pDS->eof())
     {
       // anything that isn't a parent path of a song path is to be deleted
       std::string path = m_pDS->fv("strPath").get_asString();
-      std::string sql = PrepareSQL("select count(idPath) from songpaths where SUBSTR(strPath,1,%i)='%s'", StringUtils::utf8_strlen(path.c_str()), path.c_str());
-      if (m_pDS2->query(sql) && m_pDS2->num_rows() == 1 && m_pDS2->fv(0).get_asInt() == 0)
-        pathIds.push_back(m_pDS->fv("idPath").get_asString()); // nothing found, so delete
-      m_pDS2->close();
+      auto songPath = std::lower_bound(songPaths.begin(), songPaths.end(), path);
+      if (songPath == songPaths.end() || !StringUtils::StartsWith(*songPath, path))
+        pathIds.push_back(m_pDS->fv("idPath").get_asInt()); // nothing found, so delete
       m_pDS->next();
     }
     m_pDS->close();
 
-    if (!pathIds.empty())
-    {
-      // do the deletion, and drop our temp table
-      std::string deleteSQL = "DELETE FROM path WHERE idPath IN (" + StringUtils::Join(pathIds, ",") + ")";
-      m_pDS->exec(deleteSQL);
-    }
-    m_pDS->exec("drop table songpaths");
+    DeleteByIds("path", "idPath", pathIds);
     return true;
   }
   catch (...)
@@ -4053,7 +4171,274 @@ bool CMusicDatabase::CleanupOrphanedItems()
   return true;
 }
 
-int CMusicDatabase::Cleanup(CGUIDialogProgress* progressDialog /*= nullptr*/)
+bool CMusicDatabase::RefreshNavSummary()
+{
+  if (nullptr == m_pDB)
+    return false;
+  if (nullptr == m_pDS)
+    return false;
+
+  try
+  {
+    unsigned int time = XbmcThreads::SystemClockMillis();
+
+    // Only the changes recorded so far, other clients may be adding more meanwhile
+    if (!m_pDS->query("SELECT MAX(idChanged) FROM nav_changed"))
+      return false;
+    int idLastChange = m_pDS->eof() ? 0 : m_pDS->fv(0).get_asInt();
+    m_pDS->close();
+    if (idLastChange <= 0)
+      return true;
+
+    const std::string strChanged =
+        PrepareSQL("SELECT idAlbum FROM nav_changed WHERE idChanged <= %i", idLastChange);
+
+    BeginTransaction();
+
+    // Genre counts need updating for those genres the changed albums had before and have after
+    std::set<int> genres;
+    const std::string strGenres =
+        "SELECT DISTINCT idGenre FROM nav_relation WHERE idGenre > 0 AND idAlbum IN (" +
+        strChanged + ")";
+    if (!m_pDS->query(strGenres))
+    {
+      RollbackTransaction();
+      return false;
+    }
+    for (; !m_pDS->eof(); m_pDS->next())
+      genres.insert(m_pDS->fv(0).get_asInt());
+    m_pDS->close();
+
+    m_pDS->exec("DELETE FROM nav_relation WHERE idAlbum IN (" + strChanged + ")");
+    // Album artists, role 0
+    m_pDS->exec("INSERT INTO nav_relation (idArtist, idAlbum, idRole, idGenre) "
+                "SELECT DISTINCT album_artist.idArtist, album_artist.idAlbum, 0, 0 "
+                "FROM album_artist WHERE album_artist.idAlbum IN (" + strChanged + ")");
+    m_pDS->exec("INSERT INTO nav_relation (idArtist, idAlbum, idRole, idGenre) "
+                "SELECT DISTINCT album_artist.idArtist, album_artist.idAlbum, 0, song_genre.idGenre "
+                "FROM album_artist "
+                "JOIN song ON song.idAlbum = album_artist.idAlbum "
+                "JOIN song_genre ON song_genre.idSong = song.idSong "
+                "WHERE album_artist.idAlbum IN (" + strChanged + ")");
+    // Song artists by role
+    m_pDS->exec("INSERT INTO nav_relation (idArtist, idAlbum, idRole, idGenre) "
+                "SELECT DISTINCT song_artist.idArtist, song.idAlbum, song_artist.idRole, 0 "
+                "FROM song_artist "
+                "JOIN song ON song.idSong = song_artist.idSong "
+                "WHERE song.idAlbum IN (" + strChanged + ")");
+    m_pDS->exec("INSERT INTO nav_relation (idArtist, idAlbum, idRole, idGenre) "
+                "SELECT DISTINCT song_artist.idArtist, song.idAlbum, song_artist.idRole, song_genre.idGenre "
+                "FROM song_artist "
+                "JOIN song ON song.idSong = song_artist.idSong "
+                "JOIN song_genre ON song_genre.idSong = song.idSong "
+                "WHERE song.idAlbum IN (" + strChanged + ")");
+
+    if (!m_pDS->query(strGenres))
+    {
+      RollbackTransaction();
+      return false;
+    }
+    for (; !m_pDS->eof(); m_pDS->next())
+      genres.insert(m_pDS->fv(0).get_asInt());
+    m_pDS->close();
+
+    if (!genres.empty())
+    {
+      std::string strGenreIds;
+      for (const auto& idGenre : genres)
+        strGenreIds += StringUtils::Format("%i,", idGenre);
+      strGenreIds.pop_back();
+
+      m_pDS->exec("DELETE FROM nav_genre WHERE idGenre IN (" + strGenreIds + ")");
+      m_pDS->exec("INSERT INTO nav_genre (idGenre, iSongs, iAlbums, iArtists) "
+                  "SELECT song_genre.idGenre, COUNT(DISTINCT song.idSong), "
+                  "COUNT(DISTINCT song.idAlbum), 0 "
+                  "FROM song_genre JOIN song ON song.idSong = song_genre.idSong "
+                  "WHERE song_genre.idGenre IN (" + strGenreIds + ") "
+                  "GROUP BY song_genre.idGenre");
+      // Artists as listed by the artists node, album artists and song artists
+      m_pDS->exec("UPDATE nav_genre SET iArtists = "
+                  "(SELECT COUNT(DISTINCT nav_relation.idArtist) FROM nav_relation "
+                  "WHERE nav_relation.idGenre = nav_genre.idGenre AND nav_relation.idRole <= 1) "
+                  "WHERE idGenre IN (" + strGenreIds + ")");
+    }
+
+    // Year buckets, there is one album row per album so count them all again rather than
+    // track which years the changed albums had
+    m_pDS->exec("DELETE FROM nav_year");
+    m_pDS->exec("INSERT INTO nav_year (iYear, bOriginal, iAlbums) "
+                "SELECT CAST(strReleaseDate AS INTEGER), 0, COUNT(1) FROM album "
+                "WHERE TRIM(strReleaseDate) <> '' AND strReleaseDate IS NOT NULL "
+                "GROUP BY CAST(strReleaseDate AS INTEGER)");
+    m_pDS->exec("INSERT INTO nav_year (iYear, bOriginal, iAlbums) "
+                "SELECT CAST(strOrigReleaseDate AS INTEGER), 1, COUNT(1) FROM album "
+                "WHERE TRIM(strOrigReleaseDate) <> '' AND strOrigReleaseDate IS NOT NULL "
+                "GROUP BY CAST(strOrigReleaseDate AS INTEGER)");
+
+    m_pDS->exec(PrepareSQL("DELETE FROM nav_changed WHERE idChanged <= %i", idLastChange));
+
+    if (!CommitTransaction())
+      return false;
+
+    CLog::Log(LOGDEBUG, "%s - navigation summary refreshed for %u genres in %u ms", __FUNCTION__,
+              static_cast<unsigned int>(genres.size()), XbmcThreads::SystemClockMillis() - time);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+    RollbackTransaction();
+  }
+  return false;
+}
+
+bool CMusicDatabase::IsNavSummaryValid()
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    // Any change not yet in the summary, e.g. while a scan is running, means the
+    // navigation falls back to the song and album link tables
+    if (!m_pDS->query("SELECT idChanged FROM nav_changed LIMIT 1"))
+      return false;
+    bool valid = m_pDS->eof();
+    m_pDS->close();
+    return valid;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CMusicDatabase::GetAlbumsWithoutLoudness(std::vector<int>& albums)
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    if (!m_pDS->query("SELECT DISTINCT song.idAlbum FROM song "
+                      "LEFT JOIN songloudness ON songloudness.idSong = song.idSong "
+                      "WHERE songloudness.idSong IS NULL ORDER BY song.idAlbum"))
+      return false;
+    for (; !m_pDS->eof(); m_pDS->next())
+      albums.push_back(m_pDS->fv(0).get_asInt());
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CMusicDatabase::GetSongsForLoudness(int idAlbum, std::vector<CSong>& songs)
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    std::string strSQL = PrepareSQL("SELECT song.idSong, path.strPath, song.strFileName, "
+                                    "song.iStartOffset, song.iEndOffset, song.iDuration, "
+                                    "song.strReplayGain FROM song "
+                                    "JOIN path ON path.idPath = song.idPath "
+                                    "WHERE song.idAlbum = %i ORDER BY song.iTrack", idAlbum);
+    if (!m_pDS->query(strSQL))
+      return false;
+    for (; !m_pDS->eof(); m_pDS->next())
+    {
+      CSong song;
+      song.idSong = m_pDS->fv(0).get_asInt();
+      song.idAlbum = idAlbum;
+      song.strFileName = URIUtils::AddFileToFolder(m_pDS->fv(1).get_asString(),
+                                                   m_pDS->fv(2).get_asString());
+      song.iStartOffset = m_pDS->fv(3).get_asInt();
+      song.iEndOffset = m_pDS->fv(4).get_asInt();
+      song.iDuration = m_pDS->fv(5).get_asInt();
+      song.replayGain.Set(m_pDS->fv(6).get_asString());
+      songs.push_back(std::move(song));
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%i) failed", __FUNCTION__, idAlbum);
+  }
+  return false;
+}
+
+bool CMusicDatabase::SetLoudness(const std::vector<SongLoudness>& songs)
+{
+  if (nullptr == m_pDB)
+    return false;
+  if (nullptr == m_pDS)
+    return false;
+
+  try
+  {
+    const std::string strNow = CDateTime::GetUTCDateTime().GetAsDBDateTime();
+
+    BeginTransaction();
+    for (const auto& song : songs)
+    {
+      m_pDS->exec(PrepareSQL("REPLACE INTO songloudness (idSong, iStatus, fTrackLoudness, "
+                             "fAlbumLoudness, fPeak, dateAnalysed) VALUES (%i, %i, %f, %f, %f, '%s')",
+                             song.idSong, static_cast<int>(song.status), song.trackLoudness,
+                             song.albumLoudness, song.peak, strNow.c_str()));
+      if (song.status == LOUDNESS_MEASURED)
+        m_pDS->exec(PrepareSQL("UPDATE song SET strReplayGain = '%s' WHERE idSong = %i",
+                               song.replayGain.Get().c_str(), song.idSong));
+    }
+    if (!CommitTransaction())
+      return false;
+
+    for (const auto& song : songs)
+    {
+      if (song.status == LOUDNESS_MEASURED)
+        AnnounceUpdate(MediaTypeSong, song.idSong);
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+    RollbackTransaction();
+  }
+  return false;
+}
+
+std::string CMusicDatabase::GetNavRelationSQL(const std::string& param,
+                                              int idRole,
+                                              int idGenre,
+                                              bool albumArtistsOnly)
+{
+  // Matches the same artists and albums as the album_artist and song_artist subqueries of
+  // GetFilter, except for album artists only with a role other than artist
+  std::string strSQL = "EXISTS(SELECT 1 FROM nav_relation WHERE " + param;
+  if (idRole == 0 || (idRole == 1 && albumArtistsOnly))
+    strSQL += " AND nav_relation.idRole = 0";
+  else if (idRole == 1)
+    strSQL += " AND nav_relation.idRole <= 1";
+  else if (idRole > 1)
+    strSQL += PrepareSQL(" AND nav_relation.idRole = %i", idRole);
+  strSQL += PrepareSQL(" AND nav_relation.idGenre = %i)", idGenre > 0 ? idGenre : 0);
+  return strSQL;
+}
+
+int CMusicDatabase::Cleanup(CGUIDialogProgress* progressDialog /*= nullptr*/, bool dryRun /* = false */)
 {
   if (nullptr == m_pDB)
     return ERROR_DATABASE;
@@ -4062,6 +4447,27 @@ int CMusicDatabase::Cleanup(CGUIDialogProgress* progressDialog /*= nullptr*/)
 
   int ret = ERROR_OK;
   unsigned int time = XbmcThreads::SystemClockMillis();
+  if (dryRun)
+  {
+    // only report the songs that no longer exist, everything else follows from removing them
+    CLog::Log(LOGINFO, "%s: Starting musicdatabase cleanup dry run ..", __FUNCTION__);
+    if (progressDialog)
+    {
+      progressDialog->SetLine(1, CVariant{318});
+      progressDialog->SetLine(2, CVariant{330});
+      progressDialog->SetPercentage(0);
+      progressDialog->Progress();
+    }
+    if (!CleanupSongs(progressDialog, true))
+      ret = progressDialog && progressDialog->IsCanceled() ? ERROR_CANCEL : ERROR_REORG_SONGS;
+    if (progressDialog)
+      progressDialog->Close();
+    time = XbmcThreads::SystemClockMillis() - time;
+    CLog::Log(LOGINFO, "%s: Cleanup dry run of musicdatabase done. Operation took %s", __FUNCTION__,
+              StringUtils::SecondsToTimeString(time / 1000).c_str());
+    return ret;
+  }
+
   CLog::Log(LOGINFO, "%s: Starting musicdatabase cleanup ..", __FUNCTION__);
   CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::AudioLibrary, "xbmc", "OnCleanStarted");
 
@@ -4189,6 +4595,9 @@ int CMusicDatabase::Cleanup(CGUIDialogProgress* progressDialog /*= nullptr*/)
   // Recreate DELETE triggers on song_artist and album_artist
   CreateRemovedLinkTriggers();
 
+  // Bring the navigation summary up to date for the removed songs and albums
+  RefreshNavSummary();
+
   // and compress the database
   if (progressDialog)
   {
@@ -4465,6 +4874,14 @@ bool CMusicDatabase::GetGenresNav(const std::string& strBaseDir, CFileItemList&
       }
       extFilter.AppendGroup("genre.idGenre");
     }
+    // otherwise the genres that have songs, and their counts, are in the navigation summary
+    bool navSummary = extFilter.where.empty() && extFilter.join.empty() &&
+                      (extFilter.fields.empty() || extFilter.fields == "*") && IsNavSummaryValid();
+    if (navSummary)
+    {
+      extFilter.AppendJoin("JOIN nav_genre ON nav_genre.idGenre = genre.idGenre");
+      extFilter.fields = "genre.*, nav_genre.iSongs, nav_genre.iAlbums, nav_genre.iArtists";
+    }
     extFilter.AppendWhere("genre.strGenre != ''");
 
     if (countOnly)
@@ -4508,6 +4925,12 @@ bool CMusicDatabase::GetGenresNav(const std::string& strBaseDir, CFileItemList&
       CFileItemPtr pItem(new CFileItem(m_pDS->fv("genre.strGenre").get_asString()));
       pItem->GetMusicInfoTag()->SetGenre(m_pDS->fv("genre.strGenre").get_asString());
       pItem->GetMusicInfoTag()->SetDatabaseId(m_pDS->fv("genre.idGenre").get_asInt(), "genre");
+      if (navSummary)
+      {
+        pItem->SetProperty("totalsongs", m_pDS->fv("nav_genre.iSongs").get_asInt());
+        pItem->SetProperty("totalalbums", m_pDS->fv("nav_genre.iAlbums").get_asInt());
+        pItem->SetProperty("totalartists", m_pDS->fv("nav_genre.iArtists").get_asInt());
+      }
 
       CMusicDbUrl itemUrl = musicUrl;
       std::string strDir = StringUtils::Format("%i/", m_pDS->fv("genre.idGenre").get_asInt());
@@ -4666,7 +5089,12 @@ bool CMusicDatabase::GetYearsNav(const std::string& strBaseDir, CFileItemList& i
     useOriginalYears =
         useOriginalYears || StringUtils::StartsWith(strBaseDir, "musicdb://originalyears/");
 
-    if (!useOriginalYears)
+    if (extFilter.where.empty() && extFilter.join.empty() && IsNavSummaryValid())
+    { // Get years from the year buckets of the navigation summary
+      strSQL = PrepareSQL("SELECT iYear AS year FROM nav_year WHERE bOriginal = %i ",
+                          useOriginalYears ? 1 : 0);
+    }
+    else if (!useOriginalYears)
     { // Get years from year part of release date
       strSQL = "SELECT DISTINCT CAST(strReleaseDate AS INTEGER) AS year FROM albumview ";
       extFilter.AppendWhere("(TRIM(strReleaseDate) <> '' AND strReleaseDate IS NOT NULL)");
@@ -5972,6 +6400,15 @@ static const size_t NUM_ARTIST_FIELDS = sizeof(JSONtoDBArtist) / sizeof(translat
 
 bool CMusicDatabase::GetArtistsByWhereJSON(const std::set<std::string>& fields, const std::string &baseDir,
   CVariant& result, int& total, const SortDescription &sortDescription /* = SortDescription() */)
+{
+  return GetArtistsByWhereJSON(fields, baseDir, [&result](CVariant& item) {
+    result["artists"].append(item);
+    return true;
+  }, total, sortDescription);
+}
+
+bool CMusicDatabase::GetArtistsByWhereJSON(const std::set<std::string>& fields, const std::string &baseDir,
+  const JSONItemCallback& callback, int& total, const SortDescription &sortDescription /* = SortDescription() */)
 {
   if (nullptr == m_pDB)
     return false;
@@ -6314,6 +6751,7 @@ bool CMusicDatabase::GetArtistsByWhereJSON(const std::set<std::string>& fields,
     CLog::Log(LOGDEBUG, "%s query: %s", __FUNCTION__, strSQL.c_str());
     // run query
     unsigned int time = XbmcThreads::SystemClockMillis();
+    m_pDS->set_result_mode(dbiplus::rmStream);
     if (!m_pDS->query(strSQL))
       return false;
     CLog::Log(LOGDEBUG, "%s - query took %i ms",
@@ -6340,7 +6778,11 @@ bool CMusicDatabase::GetArtistsByWhereJSON(const std::set<std::string>& fields,
     bool bIsAlbumArtist(true);
     bool bGenreFoundViaAlbum(false);
     CVariant artistObj;
-    result["artists"].reserve(resultcount);
+    // Items are only collected when their order has to be randomised after the multi-value joins
+    const bool bShuffle = sortDescription.sortBy == SortByRandom && joinLayout.HasFilterFields();
+    std::vector<CVariant> shuffled;
+    if (bShuffle)
+      shuffled.reserve(resultcount);
     while (!m_pDS->eof() || bHaveArtist)
     {
       const dbiplus::sql_record* const record = m_pDS->get_sql_record();
@@ -6355,7 +6797,13 @@ bool CMusicDatabase::GetArtistsByWhereJSON(const std::set<std::string>& fields,
           if (artistObj.isMember("musicbrainzartistid") && artistObj["musicbrainzartistid"].empty())
             artistObj["musicbrainzartistid"].append("");
 
-          result["artists"].append(artistObj);
+          if (bShuffle)
+            shuffled.push_back(artistObj);
+          else if (!callback(artistObj))
+          {
+            m_pDS->close();
+            return false;
+          }
           bHaveArtist = false;
           artistObj.clear();
         }
@@ -6580,8 +7028,15 @@ bool CMusicDatabase::GetArtistsByWhereJSON(const std::set<std::string>& fields,
     m_pDS->close(); // cleanup recordset data
 
     // Ensure random order of output when results set is sorted to process multi-value joins
-    if (sortDescription.sortBy == SortByRandom && joinLayout.HasFilterFields())
-      KODI::UTILS::RandomShuffle(result["artists"].begin_array(), result["artists"].end_array());
+    if (bShuffle)
+    {
+      KODI::UTILS::RandomShuffle(shuffled.begin(), shuffled.end());
+      for (auto& item : shuffled)
+      {
+        if (!callback(item))
+          return false;
+      }
+    }
 
     return true;
   }
@@ -6654,6 +7109,15 @@ static const size_t NUM_ALBUM_FIELDS = sizeof(JSONtoDBAlbum) / sizeof(translateJ
 bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, const std::string &baseDir,  
   CVariant& result, int& total, const SortDescription &sortDescription /* = SortDescription() */)
 {
+  return GetAlbumsByWhereJSON(fields, baseDir, [&result](CVariant& item) {
+    result["albums"].append(item);
+    return true;
+  }, total, sortDescription);
+}
+
+bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, const std::string &baseDir,
+  const JSONItemCallback& callback, int& total, const SortDescription &sortDescription /* = SortDescription() */)
+{
 
   if (nullptr == m_pDB)
     return false;
@@ -6843,6 +7307,7 @@ bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, c
     CLog::Log(LOGDEBUG, "%s query: %s", __FUNCTION__, strSQL.c_str());
     // run query
     unsigned int time = XbmcThreads::SystemClockMillis();
+    m_pDS->set_result_mode(dbiplus::rmStream);
     if (!m_pDS->query(strSQL))
       return false;
     CLog::Log(LOGDEBUG, "%s - query took %i ms",
@@ -6859,7 +7324,11 @@ bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, c
     int albumId = -1;
     int artistId = -1;
     CVariant albumObj;
-    result["albums"].reserve(resultcount);
+    // Items are only collected when their order has to be randomised after the multi-value joins
+    const bool bShuffle = sortDescription.sortBy == SortByRandom && joinLayout.HasFilterFields();
+    std::vector<CVariant> shuffled;
+    if (bShuffle)
+      shuffled.reserve(resultcount);
     while (!m_pDS->eof() || !albumObj.empty())
     {
       const dbiplus::sql_record* const record = m_pDS->get_sql_record();
@@ -6877,7 +7346,13 @@ bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, c
             for (size_t i = 0; i < sources.size(); i++)
               albumObj["sourceid"].append(atoi(sources[i].c_str()));
           }
-          result["albums"].append(albumObj);
+          if (bShuffle)
+            shuffled.push_back(albumObj);
+          else if (!callback(albumObj))
+          {
+            m_pDS->close();
+            return false;
+          }
           albumObj.clear();          
           artistId = -1;
         }
@@ -6964,8 +7439,15 @@ bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, c
     m_pDS->close(); // cleanup recordset data
 
     // Ensure random order of output when results set is sorted to process multi-value joins
-    if (sortDescription.sortBy == SortByRandom && joinLayout.HasFilterFields())
-      KODI::UTILS::RandomShuffle(result["albums"].begin_array(), result["albums"].end_array());
+    if (bShuffle)
+    {
+      KODI::UTILS::RandomShuffle(shuffled.begin(), shuffled.end());
+      for (auto& item : shuffled)
+      {
+        if (!callback(item))
+          return false;
+      }
+    }
 
     return true;
   }
@@ -7063,6 +7545,15 @@ static const size_t NUM_SONG_FIELDS = sizeof(JSONtoDBSong) / sizeof(translateJSO
 bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, const std::string &baseDir,
   CVariant& result, int& total, const SortDescription &sortDescription /* = SortDescription() */)
 {
+  return GetSongsByWhereJSON(fields, baseDir, [&result](CVariant& item) {
+    result["songs"].append(item);
+    return true;
+  }, total, sortDescription);
+}
+
+bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, const std::string &baseDir,
+  const JSONItemCallback& callback, int& total, const SortDescription &sortDescription /* = SortDescription() */)
+{
 
   if (nullptr == m_pDB)
     return false;
@@ -7408,6 +7899,7 @@ bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, co
 
     // Run query
     unsigned int time = XbmcThreads::SystemClockMillis();
+    m_pDS->set_result_mode(dbiplus::rmStream);
     if (!m_pDS->query(strSQL))
       return false;
     CLog::Log(LOGDEBUG, "%s - query took %i ms",
@@ -7429,7 +7921,11 @@ bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, co
     bool bSongArtistDone(false);
     bool bHaveSong(false);
     CVariant songObj;
-    result["songs"].reserve(resultcount);
+    // Items are only collected when their order has to be randomised after the multi-value joins
+    const bool bShuffle = sortDescription.sortBy == SortByRandom && joinLayout.HasFilterFields();
+    std::vector<CVariant> shuffled;
+    if (bShuffle)
+      shuffled.reserve(resultcount);
     while (!m_pDS->eof() || bHaveSong)
     {
       const dbiplus::sql_record* const record = m_pDS->get_sql_record();
@@ -7468,7 +7964,13 @@ bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, co
                 songObj[displayXXX] = "";
             }
           }
-          result["songs"].append(songObj);
+          if (bShuffle)
+            shuffled.push_back(songObj);
+          else if (!callback(songObj))
+          {
+            m_pDS->close();
+            return false;
+          }
           bHaveSong = false;
           songObj.clear();
         }
@@ -7612,8 +8114,15 @@ bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, co
     m_pDS->close(); // cleanup recordset data
 
     // Ensure random order of output when results set is sorted to process multi-value joins
-    if (sortDescription.sortBy == SortByRandom && joinLayout.HasFilterFields())
-      KODI::UTILS::RandomShuffle(result["songs"].begin_array(), result["songs"].end_array());
+    if (bShuffle)
+    {
+      KODI::UTILS::RandomShuffle(shuffled.begin(), shuffled.end());
+      for (auto& item : shuffled)
+      {
+        if (!callback(item))
+          return false;
+      }
+    }
 
     return true;
   }
@@ -8554,6 +9063,20 @@ void CMusicDatabase::UpdateTables(int version)
   {
     m_pDS->exec("ALTER TABLE discography ADD strReleaseGroupMBID TEXT");
   }
+  if (version < 80)
+  {
+    // Add navigation summary tables, built for all albums on the next scan or clean
+    CreateNavSummaryTables();
+    m_pDS->exec("INSERT INTO nav_changed (idAlbum) SELECT idAlbum FROM album");
+  }
+  if (version < 82)
+  {
+    // Songs are analysed by the next run of the loudness analysis
+    CreateLoudnessTable();
+  }
+
+  if (version < 83)
+    CreateChangeCountTable();
 
   // Set the verion of tag scanning required.
   // Not every schema change requires the tags to be rescanned, set to the highest schema version
@@ -8575,7 +9098,7 @@ void CMusicDatabase::UpdateTables(int version)
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 79;
+  return 83;
 }
 
 int CMusicDatabase::GetMusicNeedsTagScan()
@@ -11969,6 +12492,34 @@ bool CMusicDatabase::GetArtTypes(const MediaType &mediaType, std::vector<std::st
   return false;
 }
 
+bool CMusicDatabase::GetArtURLs(std::vector<std::string> &urls)
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    if (!m_pDS->query("SELECT DISTINCT url FROM art"))
+      return false;
+
+    urls.reserve(urls.size() + m_pDS->num_rows());
+    while (!m_pDS->eof())
+    {
+      urls.emplace_back(m_pDS->fv(0).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
 std::vector<std::string> CMusicDatabase::GetAvailableArtTypesForItem(int mediaId,
   const MediaType& mediaType)
 {
@@ -12024,7 +12575,10 @@ int CMusicDatabase::GetOrderFilter(const std::string& type,
   if (sorting.sortOrder == SortOrderDescending)
     DESC = " DESC";
 
-  if (sorting.sortBy == SortByRandom)
+  if (sorting.sortBy == SortByRandom && sorting.randomSeed > 0)
+    orderfields.emplace_back(DatabaseUtils::BuildRandomOrderClause(
+        DatabaseUtils::GetField(FieldId, type, DatabaseQueryPartSelect), sorting.randomSeed));
+  else if (sorting.sortBy == SortByRandom)
     orderfields.emplace_back(PrepareSQL("RANDOM()")); //Adjusts styntax for MySQL
   else
   {
@@ -12117,6 +12671,8 @@ bool CMusicDatabase::GetFilter(CDbUrl &musicUrl, Filter &filter, SortDescription
         sorting.limitEnd = xsp.GetLimit();
       if (xsp.GetOrder() != SortByNone)
         sorting.sortBy = xsp.GetOrder();
+      if (xsp.GetOrderSeed() > 0)
+        sorting.randomSeed = xsp.GetOrderSeed();
       sorting.sortOrder = xsp.GetOrderAscending() ? SortOrderAscending : SortOrderDescending;
       if (CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_FILELISTS_IGNORETHEWHENSORTING))
         sorting.sortAttributes = SortAttributeIgnoreArticle;
@@ -12237,6 +12793,11 @@ bool CMusicDatabase::GetFilter(CDbUrl &musicUrl, Filter &filter, SortDescription
         filter.AppendWhere(PrepareSQL("artistview.idArtist IN (SELECT song_artist.idArtist FROM song_artist "
           "WHERE song_artist.idSong = %i %s)", idSong, strRoleSQL.c_str()));
       }
+      else if (idSource <= 0 && !(idRole > 1 && albumArtistsOnly) && IsNavSummaryValid())
+      { // Role, genre and album artist links from the navigation summary
+        filter.AppendWhere(GetNavRelationSQL("nav_relation.idArtist = artistview.idArtist",
+                                             idRole, idGenre, albumArtistsOnly));
+      }
       else
       { /*
         Process idRole, idGenre, idSource and albumArtistsOnly options
@@ -12404,7 +12965,14 @@ bool CMusicDatabase::GetFilter(CDbUrl &musicUrl, Filter &filter, SortDescription
       songArtistSub.AppendWhere(PrepareSQL("song_genre.idGenre = %i", idGenre));
     }
 
-    if (idArtist > 0 || !artistname.empty())
+    if (idArtist > 0 && !(idRole > 1 && albumArtistsOnly) && IsNavSummaryValid())
+    { // Artist, role and genre links from the navigation summary
+      filter.AppendWhere(GetNavRelationSQL(
+          PrepareSQL("nav_relation.idAlbum = albumview.idAlbum AND nav_relation.idArtist = %i",
+                     idArtist),
+          idRole, idGenre, albumArtistsOnly));
+    }
+    else if (idArtist > 0 || !artistname.empty())
     {
       if (idRole <= 1 && idGenre > 0)
       { // Check genre of songs of album using nested subquery
@@ -33,6 +33,7 @@ namespace dbiplus
   typedef std::vector<field_value> sql_record;
 }
 
+#include <functional>
 #include <set>
 #include <string>
 
@@ -107,7 +108,12 @@ public:
   bool CommitTransaction() override;
   void EmptyCache();
   void Clean();
-  int  Cleanup(CGUIDialogProgress* progressDialog = nullptr);
+  /*! \brief Remove the songs that no longer exist and everything only used by them
+   \param progressDialog dialog to report progress to (optional)
+   \param dryRun only log the songs that would be removed, the database isn't changed
+   \return ERROR_OK or the step that failed
+   */
+  int  Cleanup(CGUIDialogProgress* progressDialog = nullptr, bool dryRun = false);
   bool LookupCDDBInfo(bool bRequery=false);
   void DeleteCDDBInfo();
 
@@ -471,6 +477,49 @@ public:
   void IncrementPlayCount(const CFileItem &item);
   bool CleanupOrphanedItems();
 
+  /*! \brief Bring the navigation summary up to date with the albums changed since the last refresh
+   The summary holds the artist, role and genre links per album, the genre counts and the year
+   buckets that the navigation nodes are read from. Changes are recorded by triggers, the summary
+   is refreshed after scanning and cleaning.
+   \return true if the summary is up to date
+   */
+  bool RefreshNavSummary();
+
+  /////////////////////////////////////////////////
+  // Loudness analysis
+  /////////////////////////////////////////////////
+  enum LoudnessStatus
+  {
+    LOUDNESS_MEASURED = 0, ///< measured, the gain of the song was set from the measurement
+    LOUDNESS_TAGGED = 1, ///< not measured, the song has a gain from its tags
+    LOUDNESS_FAILED = 2 ///< the song couldn't be decoded
+  };
+
+  struct SongLoudness
+  {
+    int idSong = -1;
+    LoudnessStatus status = LOUDNESS_FAILED;
+    float trackLoudness = 0.0f; ///< integrated loudness of the song in LUFS
+    float albumLoudness = 0.0f; ///< integrated loudness of the album in LUFS
+    float peak = 0.0f; ///< sample peak of the song, 1.0 == full digital scale
+    ReplayGain replayGain; ///< gain stored for the song when measured
+  };
+
+  /*! \brief Get the albums that have songs which weren't analysed yet
+   \param albums [out] ids of the albums, in ascending order
+   */
+  bool GetAlbumsWithoutLoudness(std::vector<int>& albums);
+
+  /*! \brief Get the songs of an album to analyse
+   Sets the id, full path, offsets, duration and gain of the songs
+   */
+  bool GetSongsForLoudness(int idAlbum, std::vector<CSong>& songs);
+
+  /*! \brief Store the analysis of songs, all at once
+   The gain of measured songs is set, which is what playback applies
+   */
+  bool SetLoudness(const std::vector<SongLoudness>& songs);
+
   /////////////////////////////////////////////////
   // VIEWS
   /////////////////////////////////////////////////
@@ -532,6 +581,24 @@ public:
   bool GetSongsByWhereJSON(const std::set<std::string>& fields, const std::string& baseDir,
     CVariant& result, int& total, const SortDescription& sortDescription = SortDescription());
 
+  /*! \brief Receives the items of a JSON-RPC list query one at a time
+   \param item the artist, album or song, may be modified
+   \return false to stop the query
+   */
+  using JSONItemCallback = std::function<bool(CVariant& item)>;
+
+  /*! \brief Get artists, albums or songs for JSON-RPC without collecting the whole list.
+   The query stays open while the items are handed to the callback one by one, in order,
+   and total is set before the first item.
+   \return false if the query failed or the callback stopped it
+   */
+  bool GetArtistsByWhereJSON(const std::set<std::string>& fields, const std::string& baseDir,
+    const JSONItemCallback& callback, int& total, const SortDescription& sortDescription = SortDescription());
+  bool GetAlbumsByWhereJSON(const std::set<std::string>& fields, const std::string& baseDir,
+    const JSONItemCallback& callback, int& total, const SortDescription& sortDescription = SortDescription());
+  bool GetSongsByWhereJSON(const std::set<std::string>& fields, const std::string& baseDir,
+    const JSONItemCallback& callback, int& total, const SortDescription& sortDescription = SortDescription());
+
   /////////////////////////////////////////////////
   // Scraper
   /////////////////////////////////////////////////
@@ -656,6 +723,12 @@ public:
   */
   bool GetArtTypes(const MediaType &mediaType, std::vector<std::string> &artTypes);
 
+  /*! \brief Fetch the urls of all art held in the database.
+  \param urls [out] the distinct art urls.
+  \return true if the query succeeded, false otherwise.
+  */
+  bool GetArtURLs(std::vector<std::string> &urls);
+
   /*! \brief Fetch the distinct types of available-but-unassigned art held in the
   database for a specific media item.
   \param mediaId the id in the media (artist/album) table.
@@ -716,6 +789,21 @@ private:
   virtual void CreateViews();
   void CreateNativeDBFunctions();
   void CreateRemovedLinkTriggers();
+  void CreateNavSummaryTables();
+  void CreateLoudnessTable();
+
+  /*! \brief Check whether the navigation summary has all changes, e.g. not during a scan
+   */
+  bool IsNavSummaryValid();
+
+  /*! \brief Build the EXISTS condition on the navigation summary for artist, role and genre options
+  \param param condition correlating nav_relation with the outer query
+  \param idRole role of the artist, 0 for album artists and < 0 for any role
+  \param idGenre genre of the songs, < 0 for any genre
+  \param albumArtistsOnly only album artists when idRole is 1, album artists with other roles are not held
+  \return SQL string e.g. EXISTS(SELECT 1 FROM nav_relation WHERE ...)
+  */
+  std::string GetNavRelationSQL(const std::string& param, int idRole, int idGenre, bool albumArtistsOnly);
 
   void SplitPath(const std::string& strFileNameAndPath, std::string& strPath, std::string& strFileName);
 
@@ -734,8 +822,7 @@ private:
     
   bool DeleteRemovedLinks();
 
-  bool CleanupSongs(CGUIDialogProgress* progressDialog = nullptr);
-  bool CleanupSongsByIds(const std::string &strSongIds);
+  bool CleanupSongs(CGUIDialogProgress* progressDialog = nullptr, bool dryRun = false);
   bool CleanupPaths();
   bool CleanupAlbums();
   bool CleanupArtists();
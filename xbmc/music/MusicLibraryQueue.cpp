@@ -173,7 +173,7 @@ void CMusicLibraryQueue::StopLibraryScanning()
   Refresh();
 }
 
-void CMusicLibraryQueue::CleanLibrary(bool showDialog /* = false */)
+void CMusicLibraryQueue::CleanLibrary(bool showDialog /* = false */, bool dryRun /* = false */)
 {
   CGUIDialogProgress* progress = NULL;
   if (showDialog)
@@ -188,7 +188,7 @@ void CMusicLibraryQueue::CleanLibrary(bool showDialog /* = false */)
     }
   }
 
-  CMusicLibraryCleaningJob* cleaningJob = new CMusicLibraryCleaningJob(progress);
+  CMusicLibraryCleaningJob* cleaningJob = new CMusicLibraryCleaningJob(progress, dryRun);
   AddJob(cleaningJob);
 
   // Wait for cleaning to complete or be canceled, but render every 20ms so that the
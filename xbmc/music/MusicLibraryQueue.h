@@ -86,8 +86,9 @@ public:
   /*!
    \brief Enqueue an asynchronous library cleaning job.
    \param[in] showDialog Show a model progress dialog while cleaning. Default is false.
+   \param[in] dryRun Only log what would be removed. Default is false.
    */
-  void CleanLibrary(bool showDialog = false);
+  void CleanLibrary(bool showDialog = false, bool dryRun = false);
 
   /*!
    \brief Executes a library cleaning with a modal dialog.
@@ -0,0 +1,405 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "MusicLoudnessJob.h"
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "cores/paplayer/CodecFactory.h"
+#include "cores/paplayer/ICodec.h"
+#include "dialogs/GUIDialogExtendedProgressBar.h"
+#include "guilib/GUIComponent.h"
+#include "guilib/GUIWindowManager.h"
+#include "guilib/LocalizeStrings.h"
+#include "music/MusicDatabase.h"
+#include "music/Song.h"
+#include "music/tags/LoudnessMeter.h"
+#include "threads/SingleLock.h"
+#include "utils/Stopwatch.h"
+#include "utils/StringUtils.h"
+#include "utils/XTimeUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+// frames decoded at once
+const unsigned int kDecodeFrames = 4096;
+
+// gain is set to bring songs to this loudness, as ReplayGain 2.0 does
+const float kReferenceLoudness = -18.0f;
+
+CActiveBatchJob<CMusicLoudnessJob> activeRun;
+
+std::vector<float> GetChannelWeights(const CAEChannelInfo& layout)
+{
+  // a mono song plays on both front speakers
+  if (layout.Count() == 1)
+    return {2.0f};
+
+  std::vector<float> weights;
+  for (unsigned int i = 0; i < layout.Count(); i++)
+  {
+    switch (layout[i])
+    {
+      case AE_CH_LFE:
+        weights.push_back(0.0f);
+        break;
+      case AE_CH_BL:
+      case AE_CH_BR:
+      case AE_CH_BC:
+      case AE_CH_SL:
+      case AE_CH_SR:
+        weights.push_back(1.41f);
+        break;
+      default:
+        weights.push_back(1.0f);
+        break;
+    }
+  }
+  return weights;
+}
+
+/*! \brief Convert decoded samples to float, for the formats the codec can output
+ */
+bool ToFloat(AEDataFormat format, const uint8_t* data, unsigned int samples, float* out)
+{
+  switch (format)
+  {
+    case AE_FMT_FLOAT:
+      std::copy_n(reinterpret_cast<const float*>(data), samples, out);
+      return true;
+    case AE_FMT_DOUBLE:
+    {
+      const double* in = reinterpret_cast<const double*>(data);
+      for (unsigned int i = 0; i < samples; i++)
+        out[i] = static_cast<float>(in[i]);
+      return true;
+    }
+    case AE_FMT_S32NE:
+    {
+      const int32_t* in = reinterpret_cast<const int32_t*>(data);
+      for (unsigned int i = 0; i < samples; i++)
+        out[i] = in[i] * (1.0f / 2147483648.0f);
+      return true;
+    }
+    case AE_FMT_S16NE:
+    {
+      const int16_t* in = reinterpret_cast<const int16_t*>(data);
+      for (unsigned int i = 0; i < samples; i++)
+        out[i] = in[i] * (1.0f / 32768.0f);
+      return true;
+    }
+    case AE_FMT_U8:
+      for (unsigned int i = 0; i < samples; i++)
+        out[i] = (data[i] - 128) * (1.0f / 128.0f);
+      return true;
+    default:
+      return false;
+  }
+}
+} // namespace
+
+CMusicLoudnessJob::CAlbumJob::CAlbumJob(std::shared_ptr<CBatchQueue> queue,
+                                        int idAlbum,
+                                        unsigned int maxSpeed)
+  : m_queue(std::move(queue)),
+    m_idAlbum(idAlbum),
+    m_maxSpeed(maxSpeed)
+{
+}
+
+bool CMusicLoudnessJob::CAlbumJob::DoWork()
+{
+  if (m_queue->IsAborted())
+    return false;
+
+  std::vector<CSong> songs;
+  {
+    CMusicDatabase db;
+    if (!db.Open())
+      return false;
+    db.GetSongsForLoudness(m_idAlbum, songs);
+    db.Close();
+  }
+  if (songs.empty())
+    return false;
+
+  std::vector<CMusicDatabase::SongLoudness> results(songs.size());
+  for (size_t i = 0; i < songs.size(); i++)
+  {
+    results[i].idSong = songs[i].idSong;
+    results[i].status = CMusicDatabase::LOUDNESS_TAGGED;
+  }
+
+  // albums that have all gains from their tags aren't decoded
+  const bool tagged = std::all_of(songs.begin(), songs.end(), [](const CSong& song) {
+    return song.replayGain.Get(ReplayGain::TRACK).Valid() &&
+           song.replayGain.Get(ReplayGain::ALBUM).Valid();
+  });
+
+  if (!tagged)
+  {
+    std::vector<double> albumBlocks;
+    float albumPeak = 0.0f;
+    for (size_t i = 0; i < songs.size(); i++)
+    {
+      std::unique_ptr<CLoudnessMeter> meter;
+      const bool measured = AnalyzeSong(songs[i], meter);
+
+      // nothing is stored, the album is analysed again by the next run
+      if (m_queue->IsAborted())
+        return false;
+
+      if (!measured)
+      {
+        results[i].status = CMusicDatabase::LOUDNESS_FAILED;
+        m_failed++;
+        continue;
+      }
+
+      results[i].status = CMusicDatabase::LOUDNESS_MEASURED;
+      results[i].trackLoudness = meter->GetIntegratedLoudness();
+      results[i].peak = meter->GetPeak();
+      albumBlocks.insert(albumBlocks.end(), meter->GetBlocks().begin(), meter->GetBlocks().end());
+      albumPeak = std::max(albumPeak, meter->GetPeak());
+      m_measured++;
+    }
+
+    // e.g. a share that is offline, the album is tried again by the next run
+    if (m_failed == songs.size())
+      return false;
+
+    const float albumLoudness = CLoudnessMeter::GetIntegratedLoudness(albumBlocks);
+    for (size_t i = 0; i < songs.size(); i++)
+    {
+      CMusicDatabase::SongLoudness& result = results[i];
+      if (result.status != CMusicDatabase::LOUDNESS_MEASURED)
+        continue;
+
+      // gain from the tags is kept, silent songs get none
+      result.albumLoudness = albumLoudness;
+      result.replayGain = songs[i].replayGain;
+      if (!result.replayGain.Get(ReplayGain::TRACK).Valid() && result.trackLoudness != LOUDNESS_NONE)
+      {
+        result.replayGain.SetGain(ReplayGain::TRACK, kReferenceLoudness - result.trackLoudness);
+        result.replayGain.SetPeak(ReplayGain::TRACK, result.peak);
+      }
+      if (!result.replayGain.Get(ReplayGain::ALBUM).Valid() && albumLoudness != LOUDNESS_NONE)
+      {
+        result.replayGain.SetGain(ReplayGain::ALBUM, kReferenceLoudness - albumLoudness);
+        result.replayGain.SetPeak(ReplayGain::ALBUM, albumPeak);
+      }
+    }
+  }
+
+  CMusicDatabase db;
+  if (!db.Open())
+    return false;
+  const bool stored = db.SetLoudness(results);
+  db.Close();
+  return stored;
+}
+
+bool CMusicLoudnessJob::CAlbumJob::AnalyzeSong(const CSong& song,
+                                               std::unique_ptr<CLoudnessMeter>& meter)
+{
+  CFileItem item(song.strFileName, false);
+  item.m_lStartOffset = song.iStartOffset;
+  item.m_lEndOffset = song.iEndOffset;
+
+  std::unique_ptr<ICodec> codec(CodecFactory::CreateCodecDemux(item, 0));
+  if (!codec || !codec->Init(item, 0))
+  {
+    CLog::Log(LOGDEBUG, "%s - unable to open %s", __FUNCTION__,
+              CURL::GetRedacted(song.strFileName).c_str());
+    return false;
+  }
+
+  const AEAudioFormat& format = codec->m_format;
+  const unsigned int channels = format.m_channelLayout.Count();
+  const unsigned int frameSize = channels * (codec->m_bitsPerSample >> 3);
+  if (format.m_dataFormat == AE_FMT_RAW || format.m_sampleRate == 0 || frameSize == 0)
+    return false;
+
+  // songs of a cue sheet are parts of the file
+  if (song.iStartOffset > 0 && codec->Seek(song.iStartOffset) < 0)
+    return false;
+  uint64_t maxFrames = std::numeric_limits<uint64_t>::max();
+  if (song.iEndOffset > song.iStartOffset)
+    maxFrames = static_cast<uint64_t>(song.iEndOffset - song.iStartOffset) * format.m_sampleRate / 1000;
+
+  meter.reset(new CLoudnessMeter(format.m_sampleRate, GetChannelWeights(format.m_channelLayout)));
+
+  std::vector<uint8_t> buffer(kDecodeFrames * frameSize);
+  std::vector<float> samples(kDecodeFrames * channels);
+  uint64_t frames = 0;
+
+  CStopWatch timer;
+  timer.StartZero();
+
+  while (frames < maxFrames && !m_queue->IsAborted())
+  {
+    int size = 0;
+    const int ret = codec->ReadPCM(buffer.data(), static_cast<int>(buffer.size()), &size);
+    if (ret == READ_ERROR)
+    {
+      CLog::Log(LOGDEBUG, "%s - error decoding %s", __FUNCTION__,
+                CURL::GetRedacted(song.strFileName).c_str());
+      return false;
+    }
+
+    const unsigned int count = static_cast<unsigned int>(
+        std::min<uint64_t>(size / frameSize, maxFrames - frames));
+    if (count > 0)
+    {
+      if (!ToFloat(format.m_dataFormat, buffer.data(), count * channels, samples.data()))
+        return false;
+      meter->AddFrames(samples.data(), count);
+      frames += count;
+    }
+    if (ret == READ_EOF)
+      break;
+
+    // no faster than the given multiple of realtime
+    if (m_maxSpeed > 0)
+    {
+      const float due = static_cast<float>(frames) / format.m_sampleRate / m_maxSpeed;
+      float ahead = due - timer.GetElapsedSeconds();
+      while (ahead > 0.0f && !m_queue->IsAborted())
+      {
+        KODI::TIME::Sleep(std::min(100u, static_cast<unsigned int>(ahead * 1000) + 1));
+        ahead = due - timer.GetElapsedSeconds();
+      }
+    }
+  }
+
+  m_decodedMs += frames * 1000 / format.m_sampleRate;
+  return !m_queue->IsAborted();
+}
+
+void CMusicLoudnessJob::CBatchQueue::OnResult(CJob* job, bool success)
+{
+  const CAlbumJob* album = static_cast<const CAlbumJob*>(job);
+  CSingleLock lock(m_resultSection);
+  m_measured += album->m_measured;
+  m_failed += album->m_failed;
+  m_decodedMs += album->m_decodedMs;
+}
+
+CMusicLoudnessJob::CMusicLoudnessJob(std::vector<int> albums,
+                                     unsigned int parallelism,
+                                     unsigned int maxSpeed,
+                                     CGUIDialogProgressBarHandle* progressBar /* = nullptr */)
+  : CProgressJob(progressBar),
+    m_albums(std::move(albums)),
+    m_parallelism(parallelism > 0 ? parallelism : DefaultParallelism),
+    m_maxSpeed(maxSpeed),
+    m_queue(std::make_shared<CBatchQueue>(m_parallelism))
+{
+}
+
+CMusicLoudnessJob::~CMusicLoudnessJob()
+{
+  activeRun.Remove(this);
+}
+
+bool CMusicLoudnessJob::operator==(const CJob* job) const
+{
+  // only a single run at a time
+  return strcmp(job->GetType(), GetType()) == 0;
+}
+
+bool CMusicLoudnessJob::AnalyzeLibrary(unsigned int parallelism, unsigned int maxSpeed, bool showProgress)
+{
+  if (activeRun.IsActive())
+    return false;
+
+  std::vector<int> albums;
+  CMusicDatabase db;
+  if (!db.Open())
+    return false;
+  db.GetAlbumsWithoutLoudness(albums);
+  db.Close();
+
+  CGUIDialogProgressBarHandle* progressBar = nullptr;
+  if (showProgress)
+  {
+    CGUIDialogExtendedProgressBar* dialog = CServiceBroker::GetGUI()->GetWindowManager().GetWindow<CGUIDialogExtendedProgressBar>(WINDOW_DIALOG_EXT_PROGRESS);
+    if (dialog)
+      progressBar = dialog->GetHandle(g_localizeStrings.Get(39124));
+  }
+
+  return activeRun.Start(new CMusicLoudnessJob(std::move(albums), parallelism, maxSpeed, progressBar));
+}
+
+void CMusicLoudnessJob::CancelActive()
+{
+  activeRun.Cancel();
+}
+
+bool CMusicLoudnessJob::IsAborted() const
+{
+  return m_cancelled || IsCancelled();
+}
+
+void CMusicLoudnessJob::UpdateProgress(unsigned int elapsedMs)
+{
+  const unsigned int processed = m_queue->GetProcessed();
+  uint64_t decodedMs;
+  {
+    CSingleLock lock(m_queue->m_resultSection);
+    decodedMs = m_queue->m_decodedMs;
+  }
+  const float speed = elapsedMs > 0 ? static_cast<float>(decodedMs) / elapsedMs : 0.0f;
+  SetProgress(processed, m_albums.size());
+  SetText(StringUtils::Format(g_localizeStrings.Get(39125).c_str(), processed,
+                              static_cast<unsigned int>(m_albums.size()), speed));
+}
+
+bool CMusicLoudnessJob::DoWork()
+{
+  SetTitle(g_localizeStrings.Get(39124));
+
+  CStopWatch timer;
+  timer.StartZero();
+
+  const auto aborted = [this]() { return IsAborted(); };
+  const auto progress = [this, &timer]() {
+    UpdateProgress(static_cast<unsigned int>(timer.GetElapsedMilliseconds()));
+  };
+
+  for (const auto& idAlbum : m_albums)
+  {
+    if (!m_queue->WaitForSlot(aborted, progress))
+      break;
+    m_queue->Add(new CAlbumJob(m_queue, idAlbum, m_maxSpeed));
+    progress();
+  }
+
+  // wait for the remaining albums, running ones stop without storing anything when cancelled
+  m_queue->WaitForAll(aborted, progress);
+  m_queue->Finish(IsAborted());
+
+  const unsigned int elapsedMs = static_cast<unsigned int>(timer.GetElapsedMilliseconds());
+  UpdateProgress(elapsedMs);
+
+  {
+    CSingleLock lock(m_queue->m_resultSection);
+    CLog::Log(LOGINFO, "%s - analysed %u of %u albums, measured %u songs (%u failed) at %.1fx realtime in %.1fs%s",
+              __FUNCTION__, m_queue->GetProcessed(), static_cast<unsigned int>(m_albums.size()), m_queue->m_measured,
+              m_queue->m_failed, elapsedMs > 0 ? static_cast<float>(m_queue->m_decodedMs) / elapsedMs : 0.0f,
+              elapsedMs / 1000.0f, IsAborted() ? " (cancelled)" : "");
+  }
+
+  return !IsAborted();
+}
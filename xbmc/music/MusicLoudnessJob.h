@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "utils/BatchJobQueue.h"
+#include "utils/ProgressJob.h"
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+class CGUIDialogProgressBarHandle;
+class CLoudnessMeter;
+class CSong;
+
+/*!
+ \ingroup music,jobs
+ \brief Job for measuring the loudness of the songs in the music library
+
+ Albums are analysed a given number at a time. Every song of an album is decoded and its EBU R128
+ integrated loudness measured, together with the loudness of the whole album. Songs without a
+ track or album gain in their tags get the gain that brings them to the ReplayGain 2.0 reference
+ of -18 LUFS, which is applied on playback like gain read from tags.
+
+ Results are stored per album, a run that is cancelled continues with the albums not analysed yet
+ on the next run. The albums run as low priority jobs that are paused during video playback, and
+ decoding can be limited to a multiple of realtime so that a run can be left going overnight.
+
+ \sa CLoudnessMeter, CMusicDatabase::SetLoudness
+ */
+class CMusicLoudnessJob : public CProgressJob
+{
+public:
+  /*!
+   \param albums ids of the albums to analyse
+   \param parallelism number of albums analysed at once, 0 for the default
+   \param maxSpeed maximum decoding speed of an album as a multiple of realtime, 0 for no limit
+   \param progressBar progress bar to report progress to (optional)
+   */
+  CMusicLoudnessJob(std::vector<int> albums,
+                    unsigned int parallelism,
+                    unsigned int maxSpeed,
+                    CGUIDialogProgressBarHandle* progressBar = nullptr);
+  ~CMusicLoudnessJob() override;
+
+  const char* GetType() const override { return "analyzeloudness"; }
+  bool operator==(const CJob* job) const override;
+  bool DoWork() override;
+
+  /*! \brief Request the job to stop, the albums currently being analysed are left for the next run
+   */
+  void Cancel() { m_cancelled = true; }
+
+  /*! \brief Analyse all albums of the library with songs that weren't analysed yet
+   Only one run can be active at a time.
+   \return true if the run was started, false if another one is still active
+   */
+  static bool AnalyzeLibrary(unsigned int parallelism, unsigned int maxSpeed, bool showProgress);
+
+  /*! \brief Stop the active run, if any
+   */
+  static void CancelActive();
+
+  static const unsigned int DefaultParallelism = 2;
+
+private:
+  class CBatchQueue;
+
+  class CAlbumJob : public CJob
+  {
+  public:
+    CAlbumJob(std::shared_ptr<CBatchQueue> queue, int idAlbum, unsigned int maxSpeed);
+    const char* GetType() const override { return "analyzealbumloudness"; }
+    bool operator==(const CJob* job) const override { return this == job; }
+    bool DoWork() override;
+
+    unsigned int m_measured = 0; ///< number of songs measured
+    unsigned int m_failed = 0; ///< number of songs that couldn't be decoded
+    uint64_t m_decodedMs = 0; ///< duration of the audio decoded
+
+  private:
+    bool AnalyzeSong(const CSong& song, std::unique_ptr<CLoudnessMeter>& meter);
+
+    std::shared_ptr<CBatchQueue> m_queue;
+    int m_idAlbum;
+    unsigned int m_maxSpeed;
+  };
+
+  /*!
+   \brief Runs the album jobs and collects their results, shared with the album jobs
+   */
+  class CBatchQueue : public CBatchJobQueue
+  {
+  public:
+    explicit CBatchQueue(unsigned int jobsAtOnce) : CBatchJobQueue(jobsAtOnce) {}
+
+    CCriticalSection m_resultSection;
+    unsigned int m_measured = 0;
+    unsigned int m_failed = 0;
+    uint64_t m_decodedMs = 0;
+
+  protected:
+    void OnResult(CJob* job, bool success) override;
+  };
+
+  bool IsAborted() const;
+  void UpdateProgress(unsigned int elapsedMs);
+
+  std::vector<int> m_albums;
+  unsigned int m_parallelism;
+  unsigned int m_maxSpeed;
+  std::atomic<bool> m_cancelled{false};
+  std::shared_ptr<CBatchQueue> m_queue;
+};
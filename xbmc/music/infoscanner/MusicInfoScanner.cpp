@@ -260,6 +260,8 @@ void CMusicInfoScanner::Process()
     //propagate artist sort names to albums and songs
     if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bMusicLibraryArtistSortOnUpdate)
       m_musicDatabase.UpdateArtistSortNames();
+
+    m_musicDatabase.RefreshNavSummary();
   }
   catch (...)
   {
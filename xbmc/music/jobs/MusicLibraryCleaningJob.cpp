@@ -11,8 +11,9 @@
 #include "dialogs/GUIDialogProgress.h"
 #include "music/MusicDatabase.h"
 
-CMusicLibraryCleaningJob::CMusicLibraryCleaningJob(CGUIDialogProgress* progressDialog)
-  : CMusicLibraryProgressJob(nullptr)
+CMusicLibraryCleaningJob::CMusicLibraryCleaningJob(CGUIDialogProgress* progressDialog, bool dryRun /* = false */)
+  : CMusicLibraryProgressJob(nullptr),
+    m_dryRun(dryRun)
 {
   if (progressDialog)
     SetProgressIndicators(nullptr, progressDialog);
@@ -30,11 +31,11 @@ bool CMusicLibraryCleaningJob::operator==(const CJob* job) const
   if (cleaningJob == nullptr)
     return false;
 
-  return true;
+  return m_dryRun == cleaningJob->m_dryRun;
 }
 
 bool CMusicLibraryCleaningJob::Work(CMusicDatabase &db)
 {
-  db.Cleanup(GetProgressDialog());
+  db.Cleanup(GetProgressDialog(), m_dryRun);
   return true;
 }
@@ -21,8 +21,9 @@ public:
   /*!
    \brief Creates a new music library cleaning job.
    \param[in] progressDialog Progress dialog to be used to display the cleaning progress
+   \param[in] dryRun Only log what would be removed
   */
-  CMusicLibraryCleaningJob(CGUIDialogProgress* progressDialog);
+  CMusicLibraryCleaningJob(CGUIDialogProgress* progressDialog, bool dryRun = false);
   ~CMusicLibraryCleaningJob() override;
 
   // specialization of CJob
@@ -34,5 +35,5 @@ protected:
   bool Work(CMusicDatabase &db) override;
 
 private:
-
+  bool m_dryRun;
 };
@@ -0,0 +1,185 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LoudnessMeter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// blocks below -70 LUFS are left out of the integrated loudness
+const double kAbsoluteGate = -70.0;
+// and so are blocks more than 10 LU below the mean of the blocks above the absolute gate
+const double kRelativeGate = -10.0;
+
+// filter state this small is flushed, it would decay into denormals during silence
+const double kDenormal = 1e-20;
+
+double EnergyToLoudness(double energy)
+{
+  return -0.691 + 10.0 * std::log10(energy);
+}
+
+double LoudnessToEnergy(double loudness)
+{
+  return std::pow(10.0, (loudness + 0.691) / 10.0);
+}
+} // namespace
+
+CLoudnessMeter::CLoudnessMeter(unsigned int sampleRate, std::vector<float> channelWeights)
+  : m_weights(std::move(channelWeights)),
+    m_channels(static_cast<unsigned int>(m_weights.size())),
+    m_state(m_weights.size() * 4, 0.0),
+    m_subBlockFrames(std::max(1u, (sampleRate + 5) / 10))
+{
+  // The filters of BS.1770 are specified for 48 kHz, these are their analog prototypes
+  // transformed for the sample rate of the audio
+  const double pi = 3.14159265358979323846;
+  const double rate = static_cast<double>(std::max(1u, sampleRate));
+
+  {
+    const double f0 = 1681.974450955533;
+    const double gain = 3.999843853973347;
+    const double q = 0.7071752369554196;
+    const double k = std::tan(pi * f0 / rate);
+    const double vh = std::pow(10.0, gain / 20.0);
+    const double vb = std::pow(vh, 0.4996667741545416);
+    const double a0 = 1.0 + k / q + k * k;
+    m_shelf.b0 = (vh + vb * k / q + k * k) / a0;
+    m_shelf.b1 = 2.0 * (k * k - vh) / a0;
+    m_shelf.b2 = (vh - vb * k / q + k * k) / a0;
+    m_shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+    m_shelf.a2 = (1.0 - k / q + k * k) / a0;
+  }
+
+  {
+    const double f0 = 38.13547087602444;
+    const double q = 0.5003270373238773;
+    const double k = std::tan(pi * f0 / rate);
+    const double a0 = 1.0 + k / q + k * k;
+    m_highPass.b0 = 1.0;
+    m_highPass.b1 = -2.0;
+    m_highPass.b2 = 1.0;
+    m_highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+    m_highPass.a2 = (1.0 - k / q + k * k) / a0;
+  }
+}
+
+void CLoudnessMeter::AddFrames(const float* data, unsigned int frames)
+{
+  if (m_channels == 0)
+    return;
+
+  // the peak over the interleaved samples, a plain loop the compiler vectorizes
+  const unsigned int samples = frames * m_channels;
+  float peak = m_peak;
+  for (unsigned int i = 0; i < samples; i++)
+    peak = std::max(peak, std::fabs(data[i]));
+  m_peak = peak;
+
+  while (frames > 0)
+  {
+    const unsigned int count = std::min(frames, m_subBlockFrames - m_subBlockPos);
+
+    // The filters are recursive in time, so a channel is run over the whole run of frames at
+    // once with its state kept in registers rather than stepping all channels frame by frame
+    for (unsigned int c = 0; c < m_channels; c++)
+    {
+      if (m_weights[c] == 0.0f)
+        continue;
+
+      double* state = &m_state[c * 4];
+      double s1 = state[0], s2 = state[1], h1 = state[2], h2 = state[3];
+      const Biquad shelf = m_shelf;
+      const Biquad highPass = m_highPass;
+      double energy = 0.0;
+
+      const float* in = data + c;
+      for (unsigned int i = 0; i < count; i++, in += m_channels)
+      {
+        // transposed direct form II, both stages
+        const double x = *in;
+        const double y = shelf.b0 * x + s1;
+        s1 = shelf.b1 * x - shelf.a1 * y + s2;
+        s2 = shelf.b2 * x - shelf.a2 * y;
+
+        const double z = highPass.b0 * y + h1;
+        h1 = highPass.b1 * y - highPass.a1 * z + h2;
+        h2 = highPass.b2 * y - highPass.a2 * z;
+
+        energy += z * z;
+      }
+
+      state[0] = std::fabs(s1) < kDenormal ? 0.0 : s1;
+      state[1] = std::fabs(s2) < kDenormal ? 0.0 : s2;
+      state[2] = std::fabs(h1) < kDenormal ? 0.0 : h1;
+      state[3] = std::fabs(h2) < kDenormal ? 0.0 : h2;
+      m_subBlockEnergy += m_weights[c] * energy;
+    }
+
+    data += count * m_channels;
+    frames -= count;
+    m_subBlockPos += count;
+    if (m_subBlockPos == m_subBlockFrames)
+      EndSubBlock();
+  }
+}
+
+void CLoudnessMeter::EndSubBlock()
+{
+  // blocks are 400 ms long and start every 100 ms, made up of the last 4 sub blocks
+  m_subBlocks[m_subBlockCount % 4] = m_subBlockEnergy;
+  m_subBlockCount++;
+  m_subBlockEnergy = 0.0;
+  m_subBlockPos = 0;
+
+  if (m_subBlockCount >= 4)
+  {
+    const double sum = m_subBlocks[0] + m_subBlocks[1] + m_subBlocks[2] + m_subBlocks[3];
+    m_blocks.push_back(sum / (4.0 * m_subBlockFrames));
+  }
+}
+
+float CLoudnessMeter::GetIntegratedLoudness() const
+{
+  return GetIntegratedLoudness(m_blocks);
+}
+
+float CLoudnessMeter::GetIntegratedLoudness(const std::vector<double>& blocks)
+{
+  const double absoluteGate = LoudnessToEnergy(kAbsoluteGate);
+  double sum = 0.0;
+  size_t count = 0;
+  for (const auto& energy : blocks)
+  {
+    if (energy > absoluteGate)
+    {
+      sum += energy;
+      count++;
+    }
+  }
+  if (count == 0)
+    return LOUDNESS_NONE;
+
+  const double relativeGate = std::max(absoluteGate, sum / count * std::pow(10.0, kRelativeGate / 10.0));
+  sum = 0.0;
+  count = 0;
+  for (const auto& energy : blocks)
+  {
+    if (energy > relativeGate)
+    {
+      sum += energy;
+      count++;
+    }
+  }
+  if (count == 0)
+    return LOUDNESS_NONE;
+
+  return static_cast<float>(EnergyToLoudness(sum / count));
+}
@@ -0,0 +1,85 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <vector>
+
+#define LOUDNESS_NONE -1000.0f
+
+/*!
+ \brief Measures the integrated loudness of audio as specified by ITU-R BS.1770-4 and EBU R128
+
+ Audio is K-weighted per channel, the mean square of every 400 ms block (with 75% overlap) is
+ weighted per channel and summed. The integrated loudness is the mean of the blocks above the
+ absolute gate of -70 LUFS and the relative gate 10 LU below the mean of those blocks. The block
+ energies are kept so that tracks can be combined into the loudness of an album.
+
+ The sample peak is measured too, not the oversampled true peak.
+ */
+class CLoudnessMeter
+{
+public:
+  /*!
+   \param sampleRate sample rate of the audio
+   \param channelWeights weight of every channel, 1.0 for front channels, 1.41 for surround
+   channels and 0 for channels that are left out, e.g. LFE
+   */
+  CLoudnessMeter(unsigned int sampleRate, std::vector<float> channelWeights);
+
+  /*!
+   \brief Add interleaved audio with samples in the range -1.0 to 1.0
+   */
+  void AddFrames(const float* data, unsigned int frames);
+
+  /*!
+   \return the integrated loudness in LUFS, LOUDNESS_NONE if the audio is too short or silent
+   */
+  float GetIntegratedLoudness() const;
+
+  /*!
+   \return the highest absolute sample value
+   */
+  float GetPeak() const { return m_peak; }
+
+  /*!
+   \return the mean square energy of every 400 ms block measured so far
+   */
+  const std::vector<double>& GetBlocks() const { return m_blocks; }
+
+  /*!
+   \brief Integrated loudness of the given blocks, e.g. of all tracks of an album
+   \return the loudness in LUFS, LOUDNESS_NONE if all blocks are gated
+   */
+  static float GetIntegratedLoudness(const std::vector<double>& blocks);
+
+private:
+  struct Biquad
+  {
+    double b0, b1, b2, a1, a2;
+  };
+
+  void EndSubBlock();
+
+  std::vector<float> m_weights;
+  unsigned int m_channels;
+  Biquad m_shelf; ///< stage 1 of the K-weighting, models the acoustic effect of the head
+  Biquad m_highPass; ///< stage 2 of the K-weighting, the RLB weighting curve
+
+  /*! filter state, 4 values per channel: the 2 delays of the shelf and of the high-pass */
+  std::vector<double> m_state;
+
+  unsigned int m_subBlockFrames;
+  unsigned int m_subBlockPos = 0;
+  double m_subBlockEnergy = 0.0;
+  double m_subBlocks[4] = {};
+  unsigned int m_subBlockCount = 0;
+
+  std::vector<double> m_blocks;
+  float m_peak = 0.0f;
+};
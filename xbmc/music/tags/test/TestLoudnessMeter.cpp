@@ -0,0 +1,99 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "music/tags/LoudnessMeter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// stereo sine of the given level in dBFS, the same on both channels
+std::vector<float> MakeSine(unsigned int sampleRate, float frequency, float level, float seconds)
+{
+  const float amplitude = std::pow(10.0f, level / 20.0f);
+  const unsigned int frames = static_cast<unsigned int>(sampleRate * seconds);
+  std::vector<float> data(frames * 2);
+  for (unsigned int i = 0; i < frames; i++)
+  {
+    const float sample =
+        amplitude * static_cast<float>(std::sin(2.0 * 3.14159265358979323846 * frequency * i / sampleRate));
+    data[i * 2] = sample;
+    data[i * 2 + 1] = sample;
+  }
+  return data;
+}
+
+float Measure(unsigned int sampleRate, const std::vector<float>& data)
+{
+  CLoudnessMeter meter(sampleRate, {1.0f, 1.0f});
+  // in uneven pieces, as a decoder returns them
+  const unsigned int frames = static_cast<unsigned int>(data.size() / 2);
+  for (unsigned int pos = 0; pos < frames; pos += 1000)
+    meter.AddFrames(&data[pos * 2], std::min(1000u, frames - pos));
+  return meter.GetIntegratedLoudness();
+}
+} // namespace
+
+TEST(TestLoudnessMeter, Sine)
+{
+  // EBU Tech 3341 test case 1 and 2, a 1 kHz stereo sine of -23 and -33 dBFS
+  for (unsigned int sampleRate : {44100u, 48000u})
+  {
+    EXPECT_NEAR(-23.0f, Measure(sampleRate, MakeSine(sampleRate, 1000.0f, -23.0f, 20.0f)), 0.1f);
+    EXPECT_NEAR(-33.0f, Measure(sampleRate, MakeSine(sampleRate, 1000.0f, -33.0f, 20.0f)), 0.1f);
+  }
+}
+
+TEST(TestLoudnessMeter, Gating)
+{
+  // silence and audio 13 LU below the rest don't count
+  std::vector<float> data = MakeSine(48000, 1000.0f, -36.0f, 10.0f);
+  const std::vector<float> loud = MakeSine(48000, 1000.0f, -23.0f, 20.0f);
+  data.insert(data.end(), loud.begin(), loud.end());
+  data.resize(data.size() + 48000 * 2 * 10, 0.0f);
+  EXPECT_NEAR(-23.0f, Measure(48000, data), 0.1f);
+
+  EXPECT_EQ(LOUDNESS_NONE, Measure(48000, std::vector<float>(48000 * 2 * 5, 0.0f)));
+  // too short for a single block
+  EXPECT_EQ(LOUDNESS_NONE, Measure(48000, MakeSine(48000, 1000.0f, -23.0f, 0.3f)));
+}
+
+TEST(TestLoudnessMeter, Album)
+{
+  std::vector<double> blocks;
+  for (float level : {-20.0f, -26.0f})
+  {
+    const std::vector<float> data = MakeSine(48000, 1000.0f, level, 10.0f);
+    CLoudnessMeter meter(48000, {1.0f, 1.0f});
+    meter.AddFrames(data.data(), static_cast<unsigned int>(data.size() / 2));
+    EXPECT_NEAR(level, meter.GetIntegratedLoudness(), 0.1f);
+    EXPECT_NEAR(std::pow(10.0f, level / 20.0f), meter.GetPeak(), 0.001f);
+    blocks.insert(blocks.end(), meter.GetBlocks().begin(), meter.GetBlocks().end());
+  }
+
+  // the mean energy of both, 6 LU apart
+  const float album = CLoudnessMeter::GetIntegratedLoudness(blocks);
+  EXPECT_NEAR(-20.0f + 10.0f * std::log10((1.0f + std::pow(10.0f, -0.6f)) / 2.0f), album, 0.1f);
+}
+
+TEST(TestLoudnessMeter, ChannelWeights)
+{
+  // a channel with weight 0 is left out, a weight of 1.41 adds 1.5 dB
+  const std::vector<float> data = MakeSine(48000, 1000.0f, -23.0f, 10.0f);
+  CLoudnessMeter lfe(48000, {1.0f, 0.0f});
+  lfe.AddFrames(data.data(), static_cast<unsigned int>(data.size() / 2));
+  EXPECT_NEAR(-26.0f, lfe.GetIntegratedLoudness(), 0.1f);
+
+  CLoudnessMeter surround(48000, {1.41f, 1.41f});
+  surround.AddFrames(data.data(), static_cast<unsigned int>(data.size() / 2));
+  EXPECT_NEAR(-23.0f + 10.0f * std::log10(1.41f), surround.GetIntegratedLoudness(), 0.1f);
+}
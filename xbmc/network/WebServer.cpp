@@ -332,6 +332,10 @@ int CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>& handle
       ret = CreateFileDownloadResponse(handler, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(handler, response);
+      break;
+
     case HTTPMemoryDownloadNoFreeNoCopy:
     case HTTPMemoryDownloadNoFreeCopy:
     case HTTPMemoryDownloadFreeNoCopy:
@@ -868,6 +872,32 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
   return MHD_YES;
 }
 
+int CWebServer::CreateStreamDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const
+{
+  if (handler == nullptr)
+    return MHD_NO;
+
+  const HTTPRequest &request = handler->GetRequest();
+
+  // the handler has to stay alive until the last part has been sent
+  std::unique_ptr<std::shared_ptr<IHTTPRequestHandler>> context(new std::shared_ptr<IHTTPRequestHandler>(handler));
+
+  // without a length MHD sends the response chunked or closes the connection at its end
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, 32 * 1024,
+                                               &CWebServer::StreamReaderCallback,
+                                               context.get(),
+                                               &CWebServer::StreamReaderFreeCallback);
+  if (response == nullptr)
+  {
+    m_logger->error("failed to create a streamed HTTP response for {}", request.pathUrl);
+    return MHD_NO;
+  }
+
+  context.release(); // ownership was passed to mhd
+
+  return MHD_YES;
+}
+
 int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response) const
 {
   size_t payloadSize = 0;
@@ -1056,6 +1086,33 @@ void CWebServer::ContentReaderFreeCallback(void *cls)
     s_logger->debug("[OUT] done");
 }
 
+ssize_t CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, size_t max)
+{
+  std::shared_ptr<IHTTPRequestHandler> *handler = static_cast<std::shared_ptr<IHTTPRequestHandler>*>(cls);
+  if (handler == nullptr || *handler == nullptr)
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+
+  ssize_t written = (*handler)->ReadResponseStream(buf, max);
+  if (written < 0)
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+  if (written == 0)
+    return MHD_CONTENT_READER_END_OF_STREAM;
+
+  if (CServiceBroker::GetLogging().CanLogComponent(LOGWEBSERVER))
+    s_logger->debug("[OUT] streamed {} bytes from {}", written, pos);
+
+  return written;
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  std::shared_ptr<IHTTPRequestHandler> *handler = static_cast<std::shared_ptr<IHTTPRequestHandler>*>(cls);
+  delete handler;
+
+  if (CServiceBroker::GetLogging().CanLogComponent(LOGWEBSERVER))
+    s_logger->debug("[OUT] done");
+}
+
 // static logger for libmicrohttpd
 static Logger GetMhdLogger()
 {
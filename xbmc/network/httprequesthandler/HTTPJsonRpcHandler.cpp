@@ -20,6 +20,9 @@
 #include "utils/Variant.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <cstring>
+
 #define MAX_HTTP_POST_SIZE 65536
 
 bool CHTTPJsonRpcHandler::CanHandleRequest(const HTTPRequest &request) const
@@ -76,6 +79,26 @@ int CHTTPJsonRpcHandler::HandleRequest()
   {
     m_responseData = JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client);
 
+    m_responseStream = m_transportLayer.TakeResultStream();
+    if (m_responseStream)
+    {
+      // the response is serialized while it is sent
+      m_requestData.clear();
+      m_responseData.clear();
+      if (!jsonpCallback.empty())
+      {
+        m_responseData = jsonpCallback + "(";
+        m_responseSuffix = ");";
+      }
+
+      m_response.type = HTTPStreamDownload;
+      m_response.status = MHD_HTTP_OK;
+      m_response.contentType = "application/json";
+      m_response.totalLength = 0;
+
+      return MHD_YES;
+    }
+
     if (!jsonpCallback.empty())
       m_responseData = jsonpCallback + "(" + m_responseData + ");";
   }
@@ -120,6 +143,29 @@ HttpResponseRanges CHTTPJsonRpcHandler::GetResponseData() const
   return ranges;
 }
 
+ssize_t CHTTPJsonRpcHandler::ReadResponseStream(char *buffer, size_t size)
+{
+  while (m_responsePosition >= m_responseData.size())
+  {
+    if (!m_responseStream)
+      return 0;
+
+    m_responseData.clear();
+    m_responsePosition = 0;
+    if (!m_responseStream->Read(m_responseData))
+    {
+      m_responseStream.reset();
+      m_responseData += m_responseSuffix;
+    }
+  }
+
+  size = std::min(size, m_responseData.size() - m_responsePosition);
+  memcpy(buffer, m_responseData.c_str() + m_responsePosition, size);
+  m_responsePosition += size;
+
+  return static_cast<ssize_t>(size);
+}
+
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 {
   if (m_requestData.size() + size > MAX_HTTP_POST_SIZE)
@@ -162,7 +208,17 @@ bool CHTTPJsonRpcHandler::CHTTPTransportLayer::Download(const char *path, CVaria
 
 int CHTTPJsonRpcHandler::CHTTPTransportLayer::GetCapabilities()
 {
-  return JSONRPC::Response | JSONRPC::FileDownloadRedirect;
+  return JSONRPC::Response | JSONRPC::FileDownloadRedirect | JSONRPC::ResponseStreaming;
+}
+
+void CHTTPJsonRpcHandler::CHTTPTransportLayer::SetResultStream(std::unique_ptr<JSONRPC::IResultStream> stream)
+{
+  m_resultStream = std::move(stream);
+}
+
+std::unique_ptr<JSONRPC::IResultStream> CHTTPJsonRpcHandler::CHTTPTransportLayer::TakeResultStream()
+{
+  return std::move(m_resultStream);
 }
 
 CHTTPJsonRpcHandler::CHTTPClient::CHTTPClient(HTTPMethod method)
@@ -12,6 +12,7 @@
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 
+#include <memory>
 #include <string>
 
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
@@ -27,6 +28,7 @@ public:
   int HandleRequest() override;
 
   HttpResponseRanges GetResponseData() const override;
+  ssize_t ReadResponseStream(char *buffer, size_t size) override;
 
   int GetPriority() const override { return 5; }
 
@@ -42,6 +44,11 @@ private:
   std::string m_responseData;
   CHttpResponseRange m_responseRange;
 
+  // streamed responses, m_responseData holds the part being sent
+  std::unique_ptr<JSONRPC::IResultStream> m_responseStream;
+  size_t m_responsePosition = 0;
+  std::string m_responseSuffix;
+
   class CHTTPTransportLayer : public JSONRPC::ITransportLayer
   {
   public:
@@ -52,6 +59,11 @@ private:
     bool PrepareDownload(const char *path, CVariant &details, std::string &protocol) override;
     bool Download(const char *path, CVariant &result) override;
     int GetCapabilities() override;
+    void SetResultStream(std::unique_ptr<JSONRPC::IResultStream> stream) override;
+    std::unique_ptr<JSONRPC::IResultStream> TakeResultStream() override;
+
+  private:
+    std::unique_ptr<JSONRPC::IResultStream> m_resultStream;
   };
   CHTTPTransportLayer m_transportLayer;
 
@@ -54,7 +54,10 @@ typedef enum HTTPResponseType
   HTTPMemoryDownloadFreeNoCopy,
   // creates a HTTP response from a buffer by copying followed by freeing the buffer
   // the buffer must have been malloc'ed and not new'ed
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  // creates a HTTP response of unknown length (chunked with HTTP/1.1) filled
+  // while it is sent
+  HTTPStreamDownload
 } HTTPResponseType;
 
 typedef struct HTTPRequest
@@ -161,6 +164,16 @@ public:
   */
   virtual std::string GetResponseFile() const { return ""; }
 
+  /*!
+  * \brief Fills the buffer with the next part of the response.
+  *
+  * \details This is only used if the response type is HTTPStreamDownload. It is
+  * called from the thread of the connection and may block until data is ready.
+  *
+  * \return Number of bytes written, 0 at the end of the response or -1 on errors
+  */
+  virtual ssize_t ReadResponseStream(char *buffer, size_t size) { return -1; }
+
   /*!
   * \brief Returns the HTTP request handled by the HTTP request handler.
   */
@@ -30,6 +30,19 @@ extern "C" {
 
 using namespace XFILE;
 
+namespace
+{
+// swscale context reused across scales on the same thread, sws_getCachedContext
+// only reallocates when the geometry or algorithm changes
+struct CachedSwsContext
+{
+  SwsContext* context = nullptr;
+  ~CachedSwsContext() { sws_freeContext(context); }
+};
+
+thread_local CachedSwsContext cachedScaleContext;
+}
+
 bool CPicture::GetThumbnailFromSurface(const unsigned char* buffer, int width, int height, int stride, const std::string &thumbFile, uint8_t* &result, size_t& result_size)
 {
   unsigned char *thumb = NULL;
@@ -190,6 +203,19 @@ bool CPicture::ResizeTexture(const std::string &image, uint8_t *pixels, uint32_t
   return success;
 }
 
+void CPicture::GetMaxCacheSize(uint32_t &width, uint32_t &height)
+{
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+
+  // CacheTexture() picks the fanart resolution for 16x9 images only, but the
+  // aspect ratio isn't known before decoding so allow for the larger of both
+  const uint32_t max_height = std::max(advancedSettings->m_imageRes, advancedSettings->m_fanartRes);
+  const uint32_t max_width = max_height * 16/9;
+
+  width = width ? std::min(width, max_width) : max_width;
+  height = height ? std::min(height, max_height) : max_height;
+}
+
 bool CPicture::CacheTexture(CBaseTexture *texture, uint32_t &dest_width, uint32_t &dest_height, const std::string &dest,
   CPictureScalingAlgorithm::Algorithm scalingAlgorithm /* = CPictureScalingAlgorithm::NoAlgorithm */)
 {
@@ -336,9 +362,11 @@ bool CPicture::ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned in
                           uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch,
                           CPictureScalingAlgorithm::Algorithm scalingAlgorithm /* = CPictureScalingAlgorithm::NoAlgorithm */)
 {
-  struct SwsContext *context = sws_getContext(in_width, in_height, AV_PIX_FMT_BGRA,
-                                                         out_width, out_height, AV_PIX_FMT_BGRA,
-                                                         CPictureScalingAlgorithm::ToSwscale(scalingAlgorithm), NULL, NULL, NULL);
+  cachedScaleContext.context = sws_getCachedContext(cachedScaleContext.context,
+                                                    in_width, in_height, AV_PIX_FMT_BGRA,
+                                                    out_width, out_height, AV_PIX_FMT_BGRA,
+                                                    CPictureScalingAlgorithm::ToSwscale(scalingAlgorithm), NULL, NULL, NULL);
+  struct SwsContext *context = cachedScaleContext.context;
 
   uint8_t *src[] = { in_pixels, 0, 0, 0 };
   int     srcStride[] = { (int)in_pitch, 0, 0, 0 };
@@ -348,7 +376,6 @@ bool CPicture::ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned in
   if (context)
   {
     sws_scale(context, src, srcStride, 0, in_height, dst, dstStride);
-    sws_freeContext(context);
     return true;
   }
   return false;
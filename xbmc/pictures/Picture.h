@@ -35,6 +35,12 @@ public:
     uint32_t &dest_width, uint32_t &dest_height, uint8_t* &result, size_t& result_size,
     CPictureScalingAlgorithm::Algorithm scalingAlgorithm = CPictureScalingAlgorithm::NoAlgorithm);
 
+  /*! \brief Limit the given dimensions to the largest size CacheTexture() will store
+   \param width [in/out] requested maximum width in pixels, 0 for no limit
+   \param height [in/out] requested maximum height in pixels, 0 for no limit
+   */
+  static void GetMaxCacheSize(uint32_t &width, uint32_t &height);
+
   /*! \brief Cache a texture, resizing, rotating and flipping as needed, and saving as a JPG or PNG
    \param texture a pointer to a CBaseTexture
    \param dest_width [in/out] maximum width in pixels of cached version - replaced with actual cached width
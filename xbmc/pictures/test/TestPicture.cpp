@@ -0,0 +1,167 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "guilib/FFmpegImage.h"
+#include "guilib/TextureFormats.h"
+#include "pictures/Picture.h"
+#include "utils/Stopwatch.h"
+#include "utils/StringUtils.h"
+
+#if defined(TARGET_POSIX)
+#include <sys/resource.h>
+#endif
+
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// a gradient with some noise so the encoders can't collapse it to nothing
+std::vector<uint8_t> CreateSurface(unsigned int width, unsigned int height)
+{
+  std::vector<uint8_t> pixels(width * height * 4);
+  uint32_t seed = 12345;
+  for (unsigned int y = 0; y < height; y++)
+  {
+    uint8_t* row = pixels.data() + y * width * 4;
+    for (unsigned int x = 0; x < width; x++)
+    {
+      seed = seed * 1103515245 + 12345;
+      row[x * 4 + 0] = static_cast<uint8_t>(x * 255 / width);
+      row[x * 4 + 1] = static_cast<uint8_t>(y * 255 / height);
+      row[x * 4 + 2] = static_cast<uint8_t>((seed >> 16) & 0x3F);
+      row[x * 4 + 3] = 0xFF;
+    }
+  }
+  return pixels;
+}
+
+std::vector<uint8_t> Encode(const std::vector<uint8_t>& pixels, unsigned int width,
+                            unsigned int height, const std::string& mimeType)
+{
+  CFFmpegImage encoder(mimeType);
+  unsigned char* out = nullptr;
+  unsigned int outSize = 0;
+  std::vector<uint8_t> result;
+  if (encoder.CreateThumbnailFromSurface(const_cast<uint8_t*>(pixels.data()), width, height,
+                                         XB_FMT_A8R8G8B8, width * 4, "", out, outSize))
+    result.assign(out, out + outSize);
+  encoder.ReleaseThumbnailBuffer();
+  return result;
+}
+
+long GetPeakRSSKiB()
+{
+#if defined(TARGET_POSIX)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    return usage.ru_maxrss;
+#endif
+  return -1;
+}
+}
+
+TEST(TestPicture, JpegDecodeAtScale)
+{
+  std::vector<uint8_t> pixels = CreateSurface(4000, 2000);
+  std::vector<uint8_t> jpeg = Encode(pixels, 4000, 2000, "image/jpeg");
+  ASSERT_FALSE(jpeg.empty());
+
+  CFFmpegImage image("image/jpeg");
+  ASSERT_TRUE(image.LoadImageFromMemory(jpeg.data(), jpeg.size(), 500, 500));
+  EXPECT_EQ(500U, image.Width());
+  EXPECT_EQ(250U, image.Height());
+  EXPECT_EQ(4000U, image.originalWidth());
+  EXPECT_EQ(2000U, image.originalHeight());
+
+  // a bound larger than half the image must not reduce the decode size
+  CFFmpegImage full("image/jpeg");
+  ASSERT_TRUE(full.LoadImageFromMemory(jpeg.data(), jpeg.size(), 2500, 2500));
+  EXPECT_EQ(4000U, full.Width());
+  EXPECT_EQ(2000U, full.Height());
+}
+
+TEST(TestPicture, CacheTextureScales)
+{
+  std::vector<uint8_t> pixels = CreateSurface(1920, 1080);
+  uint32_t width = 480, height = 480;
+  const std::string dest = "special://temp/testpicture_cache.jpg";
+  EXPECT_TRUE(CPicture::CacheTexture(pixels.data(), 1920, 1080, 1920 * 4, 0, width, height, dest));
+  EXPECT_EQ(480U, width);
+  EXPECT_EQ(270U, height);
+  EXPECT_TRUE(XFILE::CFile::Exists(dest));
+  XFILE::CFile::Delete(dest);
+}
+
+// Benchmark caching a directory of large synthetic posters/fanart the way
+// CTextureCacheJob does. Run with --gtest_also_run_disabled_tests.
+TEST(TestPicture, DISABLED_CacheLargeImagesBenchmark)
+{
+  const std::string dir = "special://temp/picturebenchmark/";
+  const unsigned int count = 16;
+  ASSERT_TRUE(XFILE::CDirectory::Create(dir));
+
+  std::vector<std::string> files;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    const bool png = (i % 4) == 3;
+    const unsigned int width = (i % 2) ? 4000 : 3840;
+    const unsigned int height = (i % 2) ? 6000 : 2160;
+    std::vector<uint8_t> pixels = CreateSurface(width, height);
+    std::vector<uint8_t> encoded = Encode(pixels, width, height, png ? "image/png" : "image/jpeg");
+    ASSERT_FALSE(encoded.empty());
+
+    const std::string file = StringUtils::Format("%simage%02u.%s", dir.c_str(), i, png ? "png" : "jpg");
+    XFILE::CFile out;
+    ASSERT_TRUE(out.OpenForWrite(file, true));
+    ASSERT_EQ(static_cast<ssize_t>(encoded.size()), out.Write(encoded.data(), encoded.size()));
+    out.Close();
+    files.push_back(file);
+  }
+
+  const long rssBefore = GetPeakRSSKiB();
+  CStopWatch timer;
+  timer.StartZero();
+
+  unsigned int cached = 0;
+  for (const auto& file : files)
+  {
+    XFILE::auto_buffer buffer;
+    if (XFILE::CFile().LoadFile(file, buffer) <= 0)
+      continue;
+
+    CFFmpegImage image(StringUtils::EndsWith(file, ".png") ? "image/png" : "image/jpeg");
+    uint32_t maxWidth = 0, maxHeight = 0;
+    CPicture::GetMaxCacheSize(maxWidth, maxHeight);
+    if (!image.LoadImageFromMemory(reinterpret_cast<unsigned char*>(buffer.get()), buffer.size(),
+                                   maxWidth, maxHeight))
+      continue;
+
+    const unsigned int pitch = image.Width() * 4;
+    std::vector<uint8_t> pixels(pitch * image.Height());
+    if (!image.Decode(pixels.data(), image.Width(), image.Height(), pitch, XB_FMT_A8R8G8B8))
+      continue;
+
+    uint32_t width = 0, height = 0;
+    if (CPicture::CacheTexture(pixels.data(), image.Width(), image.Height(), pitch, 0, width,
+                               height, file + ".cached.jpg"))
+      cached++;
+  }
+  timer.Stop();
+
+  EXPECT_EQ(count, cached);
+  const float seconds = timer.GetElapsedSeconds();
+  printf("cached %u images in %.3f s (%.2f images/sec), peak RSS %ld KiB (%ld KiB before)\n",
+         cached, seconds, seconds > 0 ? cached / seconds : 0.0f, GetPeakRSSKiB(), rssBefore);
+
+  XFILE::CDirectory::RemoveRecursive(dir);
+}
@@ -14,6 +14,7 @@
 #include "filesystem/File.h"
 #include "filesystem/SmartPlaylistDirectory.h"
 #include "guilib/LocalizeStrings.h"
+#include "playlists/SmartPlaylistCache.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/DatabaseUtils.h"
@@ -1064,6 +1065,40 @@ std::string CSmartPlaylistRule::GetField(int field, const std::string &type) con
   return "";
 }
 
+// The limit of a playlist inside a playlist only applies to its own items, so they are
+// selected in a subquery in the order of the playlist. Without a limit or with an order
+// that needs the items in memory (e.g. by title) all matching items are included.
+static std::string GetLimitedWhereClause(const CDatabase &db, const CSmartPlaylist &playlist, const std::string &where)
+{
+  if (playlist.GetLimit() == 0)
+    return where;
+
+  // artists are only matched together with the joins to their roles
+  const MediaType mediaType = CMediaTypes::FromString(playlist.GetType());
+  const std::string idField = DatabaseUtils::GetField(FieldId, mediaType, DatabaseQueryPartSelect);
+  const size_t dot = idField.find('.');
+  if (mediaType == MediaTypeArtist || dot == std::string::npos)
+    return where;
+
+  SortDescription sorting;
+  sorting.sortBy = playlist.GetOrder();
+  sorting.sortOrder = playlist.GetOrderAscending() ? SortOrderAscending : SortOrderDescending;
+  sorting.randomSeed = playlist.GetOrderSeed();
+  std::string order;
+  if (sorting.sortBy == SortByRandom && sorting.randomSeed == 0)
+    order = db.PrepareSQL("RANDOM()");
+  else if (!DatabaseUtils::BuildOrderClause(mediaType, sorting, order))
+    return where;
+
+  std::string query = "SELECT " + idField + " FROM " + idField.substr(0, dot);
+  if (!where.empty())
+    query += " WHERE " + where;
+  query += " ORDER BY " + order + DatabaseUtils::BuildLimitClause(playlist.GetLimit());
+
+  // MySQL doesn't support LIMIT in an IN subquery, but in a derived table
+  return idField + " IN (SELECT " + idField.substr(dot + 1) + " FROM (" + query + ") AS nested)";
+}
+
 std::string CSmartPlaylistRuleCombination::GetWhereClause(const CDatabase &db, const std::string& strType, std::set<std::string> &referencedPlaylists) const
 {
   std::string rule;
@@ -1104,7 +1139,7 @@ std::string CSmartPlaylistRuleCombination::GetWhereClause(const CDatabase &db, c
           if (playlist.GetType() == strType || (playlist.GetType() == "mixed" && (strType == "songs" || strType == "musicvideos")) || playlist.GetType().empty())
           {
             playlist.SetType(strType);
-            playlistQuery = playlist.GetWhereClause(db, referencedPlaylists);
+            playlistQuery = GetLimitedWhereClause(db, playlist, playlist.GetWhereClause(db, referencedPlaylists));
           }
           if (playlist.GetType() == strType)
           {
@@ -1316,6 +1351,9 @@ bool CSmartPlaylist::Load(const CVariant &obj)
     if (order.isMember("ignorefolders") && obj["ignorefolders"].isBoolean())
       m_orderAttributes = obj["ignorefolders"].asBoolean() ? SortAttributeIgnoreFolders : SortAttributeNone;
 
+    if (order.isMember("seed") && (order["seed"].isInteger() || order["seed"].isUnsignedInteger()))
+      m_orderSeed = static_cast<unsigned int>(order["seed"].asUnsignedInteger());
+
     m_orderField = CSmartPlaylistRule::TranslateOrder(obj["order"]["method"].asString().c_str());
   }
 
@@ -1360,7 +1398,7 @@ bool CSmartPlaylist::LoadFromXML(const TiXmlNode *root, const std::string &encod
   XMLUtils::GetUInt(root, "limit", m_limit);
 
   // and order
-  // format is <order direction="ascending">field</order>
+  // format is <order direction="ascending" seed="0">field</order>
   const TiXmlElement *order = root->FirstChildElement("order");
   if (order && order->FirstChild())
   {
@@ -1372,6 +1410,10 @@ bool CSmartPlaylist::LoadFromXML(const TiXmlNode *root, const std::string &encod
     if (ignorefolders != NULL)
       m_orderAttributes = StringUtils::EqualsNoCase(ignorefolders, "true") ? SortAttributeIgnoreFolders : SortAttributeNone;
 
+    int seed;
+    if (order->QueryIntAttribute("seed", &seed) == TIXML_SUCCESS && seed > 0)
+      m_orderSeed = static_cast<unsigned int>(seed);
+
     m_orderField = CSmartPlaylistRule::TranslateOrder(order->FirstChild()->Value());
   }
   return true;
@@ -1433,10 +1475,17 @@ bool CSmartPlaylist::Save(const std::string &path) const
     nodeOrder.SetAttribute("direction", m_orderDirection == SortOrderDescending ? "descending" : "ascending");
     if (m_orderAttributes & SortAttributeIgnoreFolders)
       nodeOrder.SetAttribute("ignorefolders", "true");
+    if (m_orderField == SortByRandom && m_orderSeed > 0)
+      nodeOrder.SetAttribute("seed", static_cast<int>(m_orderSeed));
     nodeOrder.InsertEndChild(order);
     pRoot->InsertEndChild(nodeOrder);
   }
-  return doc.SaveFile(path);
+  if (!doc.SaveFile(path))
+    return false;
+
+  // playlists that include this one by name may have changed as well
+  CServiceBroker::GetSmartPlaylistCache().Clear();
+  return true;
 }
 
 bool CSmartPlaylist::Save(CVariant &obj, bool full /* = true */) const
@@ -1471,6 +1520,8 @@ bool CSmartPlaylist::Save(CVariant &obj, bool full /* = true */) const
     obj["order"]["method"] = CSmartPlaylistRule::TranslateOrder(m_orderField);
     obj["order"]["direction"] = m_orderDirection == SortOrderDescending ? "descending" : "ascending";
     obj["order"]["ignorefolders"] = (m_orderAttributes & SortAttributeIgnoreFolders);
+    if (m_orderField == SortByRandom && m_orderSeed > 0)
+      obj["order"]["seed"] = m_orderSeed;
   }
 
   return true;
@@ -1492,6 +1543,7 @@ void CSmartPlaylist::Reset()
   m_orderField = SortByNone;
   m_orderDirection = SortOrderNone;
   m_orderAttributes = SortAttributeNone;
+  m_orderSeed = 0;
   m_playlistType = "songs"; // sane default
   m_group.clear();
   m_groupMixed = false;
@@ -127,6 +127,9 @@ public:
   SortOrder GetOrderDirection() const { return m_orderDirection; }
   void SetOrderAttributes(SortAttribute attributes) { m_orderAttributes = attributes; }
   SortAttribute GetOrderAttributes() const { return m_orderAttributes; }
+  /*! \brief seed of a random order, the same seed always gives the same order, 0 a new one every time */
+  void SetOrderSeed(unsigned int seed) { m_orderSeed = seed; }
+  unsigned int GetOrderSeed() const { return m_orderSeed; }
 
   void SetGroup(const std::string &group) { m_group = group; }
   const std::string& GetGroup() const { return m_group; }
@@ -175,6 +178,7 @@ private:
   SortBy m_orderField;
   SortOrder m_orderDirection;
   SortAttribute m_orderAttributes;
+  unsigned int m_orderSeed;
   std::string m_group;
   bool m_groupMixed;
 
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SmartPlaylistCache.h"
+
+#include "FileItem.h"
+#include "music/MusicDatabase.h"
+#include "playlists/SmartPlayList.h"
+#include "threads/SingleLock.h"
+#include "video/VideoDatabase.h"
+
+#include <algorithm>
+#include <utility>
+
+const size_t CSmartPlaylistCache::MAX_ENTRIES;
+const unsigned int CSmartPlaylistCache::MAX_AGE_MS;
+
+namespace
+{
+int64_t GetMusicChangeCount()
+{
+  CMusicDatabase database;
+  if (!database.Open())
+    return -1;
+  return database.GetChangeCount();
+}
+
+int64_t GetVideoChangeCount()
+{
+  CVideoDatabase database;
+  if (!database.Open())
+    return -1;
+  return database.GetChangeCount();
+}
+
+int64_t GetLibraryChangeCount(const std::string& playlistType)
+{
+  // mixed playlists contain songs and music videos
+  if (playlistType == "mixed")
+  {
+    const int64_t musicChanges = GetMusicChangeCount();
+    const int64_t videoChanges = GetVideoChangeCount();
+    if (musicChanges < 0 || videoChanges < 0)
+      return -1;
+    return musicChanges + videoChanges;
+  }
+  if (CSmartPlaylist::IsMusicType(playlistType) || playlistType.empty())
+    return GetMusicChangeCount();
+  return GetVideoChangeCount();
+}
+} // namespace
+
+CSmartPlaylistCache::CSmartPlaylistCache()
+  : m_changeCount(GetLibraryChangeCount)
+{
+}
+
+CSmartPlaylistCache::CSmartPlaylistCache(ChangeCountFunc changeCount)
+  : m_changeCount(std::move(changeCount))
+{
+}
+
+int64_t CSmartPlaylistCache::GetChangeCount(const std::string& playlistType) const
+{
+  return m_changeCount(playlistType);
+}
+
+bool CSmartPlaylistCache::Get(const std::string& key, const std::string& playlistType, CFileItemList& items)
+{
+  const int64_t changeCount = GetChangeCount(playlistType);
+  if (changeCount < 0)
+    return false;
+
+  std::shared_ptr<CFileItemList> cached;
+  {
+    CSingleLock lock(m_critSection);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+      return false;
+
+    if (it->second.changeCount != changeCount || it->second.expiry.IsTimePast())
+    {
+      m_entries.erase(it);
+      return false;
+    }
+
+    it->second.lastUsed = ++m_uses;
+    cached = it->second.items;
+  }
+
+  // the cached items are never changed, they can be copied without the lock
+  items.Copy(*cached);
+  return true;
+}
+
+void CSmartPlaylistCache::Put(const std::string& key, const std::string& playlistType, int64_t changeCount,
+                              const CFileItemList& items)
+{
+  if (changeCount < 0 || changeCount != GetChangeCount(playlistType))
+    return;
+
+  std::shared_ptr<CFileItemList> cached(new CFileItemList);
+  cached->Copy(items);
+
+  CSingleLock lock(m_critSection);
+  if (m_entries.find(key) == m_entries.end() && m_entries.size() >= MAX_ENTRIES)
+  {
+    auto oldest = std::min_element(m_entries.begin(), m_entries.end(),
+      [](const std::pair<const std::string, Entry>& left, const std::pair<const std::string, Entry>& right)
+      {
+        return left.second.lastUsed < right.second.lastUsed;
+      });
+    m_entries.erase(oldest);
+  }
+
+  Entry& entry = m_entries[key];
+  entry.items = cached;
+  entry.changeCount = changeCount;
+  entry.lastUsed = ++m_uses;
+  entry.expiry.Set(MAX_AGE_MS);
+}
+
+void CSmartPlaylistCache::Clear()
+{
+  CSingleLock lock(m_critSection);
+  m_entries.clear();
+}
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+class CFileItemList;
+
+/*!
+ \brief Items of the smart playlists retrieved last, e.g. for the widgets of the home screen
+
+ Triggers of the video and music databases count every change of the tables
+ playlists are built from, including changes made by other clients of a shared
+ database. Cached items are only used while the change count of the library of
+ the playlist is the same as when they were retrieved. Items are also dropped
+ after MAX_AGE_MS as rules like "in the last 2 weeks" depend on the time, and
+ the least recently used playlists are dropped beyond MAX_ENTRIES.
+ */
+class CSmartPlaylistCache
+{
+public:
+  static const size_t MAX_ENTRIES = 32;
+  static const unsigned int MAX_AGE_MS = 10 * 60 * 1000;
+
+  //! returns the change count of the library of a playlist type, -1 if unknown
+  typedef std::function<int64_t(const std::string& playlistType)> ChangeCountFunc;
+
+  CSmartPlaylistCache();
+  explicit CSmartPlaylistCache(ChangeCountFunc changeCount);
+
+  /*!
+   \brief Get the change count of the library of a playlist type
+   Must be taken before retrieving the items that are put into the cache.
+   \return the change count, -1 if it can't be read and the items mustn't be cached
+   */
+  int64_t GetChangeCount(const std::string& playlistType) const;
+
+  /*!
+   \brief Get a copy of the cached items
+   \param key the playlist with everything else the items depend on, e.g. the sort
+   \return false if the items aren't cached or are outdated
+   */
+  bool Get(const std::string& key, const std::string& playlistType, CFileItemList& items);
+
+  /*!
+   \brief Cache a copy of the items
+   \param changeCount the change count taken before retrieving the items, they
+   aren't cached if the library changed since
+   */
+  void Put(const std::string& key, const std::string& playlistType, int64_t changeCount,
+           const CFileItemList& items);
+
+  void Clear();
+
+private:
+  CSmartPlaylistCache(const CSmartPlaylistCache&) = delete;
+  CSmartPlaylistCache& operator=(const CSmartPlaylistCache&) = delete;
+
+  struct Entry
+  {
+    std::shared_ptr<CFileItemList> items;
+    int64_t changeCount;
+    unsigned int lastUsed;
+    XbmcThreads::EndTime expiry;
+  };
+
+  mutable CCriticalSection m_critSection;
+  ChangeCountFunc m_changeCount;
+  std::map<std::string, Entry> m_entries;
+  unsigned int m_uses = 0;
+};
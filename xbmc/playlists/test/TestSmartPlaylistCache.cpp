@@ -0,0 +1,120 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "playlists/SmartPlaylistCache.h"
+#include "utils/Variant.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+//! change counts of a fake video and music library
+class CLibraryChanges
+{
+public:
+  CSmartPlaylistCache::ChangeCountFunc Func()
+  {
+    return [this](const std::string& playlistType) -> int64_t {
+      if (playlistType == "mixed")
+        return m_video < 0 || m_music < 0 ? -1 : m_video + m_music;
+      if (playlistType == "songs" || playlistType == "albums" || playlistType == "artists")
+        return m_music;
+      return m_video;
+    };
+  }
+
+  int64_t m_video = 0;
+  int64_t m_music = 0;
+};
+
+const CFileItemList& MakeItems(CFileItemList& items, unsigned int count)
+{
+  items.Clear();
+  for (unsigned int i = 0; i < count; i++)
+    items.Add(CFileItemPtr(new CFileItem(std::to_string(i), false)));
+  items.SetProperty("total", count);
+  return items;
+}
+} // namespace
+
+TEST(TestSmartPlaylistCache, Get)
+{
+  CLibraryChanges changes;
+  CSmartPlaylistCache cache(changes.Func());
+  CFileItemList list;
+  CFileItemList items;
+  EXPECT_FALSE(cache.Get("movies", "movies", items));
+
+  cache.Put("movies", "movies", cache.GetChangeCount("movies"), MakeItems(list, 3));
+  ASSERT_TRUE(cache.Get("movies", "movies", items));
+  EXPECT_EQ(3, items.Size());
+  EXPECT_EQ(3, items.GetProperty("total").asInteger());
+
+  // the cached items are copies
+  items.Clear();
+  CFileItemList again;
+  ASSERT_TRUE(cache.Get("movies", "movies", again));
+  EXPECT_EQ(3, again.Size());
+}
+
+TEST(TestSmartPlaylistCache, LibraryChanges)
+{
+  CLibraryChanges changes;
+  CSmartPlaylistCache cache(changes.Func());
+  CFileItemList list;
+  cache.Put("movies", "movies", cache.GetChangeCount("movies"), MakeItems(list, 1));
+  cache.Put("songs", "songs", cache.GetChangeCount("songs"), MakeItems(list, 1));
+
+  // only the playlists of the changed library are outdated
+  changes.m_music++;
+  CFileItemList items;
+  EXPECT_TRUE(cache.Get("movies", "movies", items));
+  EXPECT_FALSE(cache.Get("songs", "songs", items));
+
+  // items retrieved while the library changed aren't cached
+  const int64_t changeCount = cache.GetChangeCount("mixed");
+  changes.m_video++;
+  cache.Put("mixed", "mixed", changeCount, MakeItems(list, 1));
+  EXPECT_FALSE(cache.Get("mixed", "mixed", items));
+  EXPECT_FALSE(cache.Get("movies", "movies", items));
+}
+
+TEST(TestSmartPlaylistCache, UnknownChangeCount)
+{
+  // nothing is cached while the change count of the library can't be read
+  CLibraryChanges changes;
+  changes.m_video = -1;
+  CSmartPlaylistCache cache(changes.Func());
+  CFileItemList list;
+  cache.Put("movies", "movies", cache.GetChangeCount("movies"), MakeItems(list, 1));
+  CFileItemList items;
+  EXPECT_FALSE(cache.Get("movies", "movies", items));
+
+  cache.Put("songs", "songs", cache.GetChangeCount("songs"), MakeItems(list, 1));
+  EXPECT_TRUE(cache.Get("songs", "songs", items));
+  changes.m_music = -1;
+  EXPECT_FALSE(cache.Get("songs", "songs", items));
+}
+
+TEST(TestSmartPlaylistCache, LeastRecentlyUsed)
+{
+  CLibraryChanges changes;
+  CSmartPlaylistCache cache(changes.Func());
+  CFileItemList list;
+  for (size_t i = 0; i < CSmartPlaylistCache::MAX_ENTRIES; i++)
+    cache.Put(std::to_string(i), "movies", cache.GetChangeCount("movies"), MakeItems(list, 1));
+
+  CFileItemList items;
+  ASSERT_TRUE(cache.Get("0", "movies", items));
+  cache.Put("new", "movies", cache.GetChangeCount("movies"), MakeItems(list, 1));
+
+  EXPECT_TRUE(cache.Get("0", "movies", items));
+  EXPECT_FALSE(cache.Get("1", "movies", items));
+  EXPECT_TRUE(cache.Get("new", "movies", items));
+}
@@ -119,6 +119,8 @@ void CAdvancedSettings::Initialize()
   //default hold time of 25 ms, this allows a 20 hertz sine to pass undistorted
   m_limiterHold = 0.025f;
   m_limiterRelease = 0.1f;
+  m_audioLookAhead = 1;
+  m_audioDecodeCacheSize = 32;
 
   m_seekSteps = { 10, 30, 60, 180, 300, 600, 1800 };
 
@@ -154,6 +156,7 @@ void CAdvancedSettings::Initialize()
   m_videoFpsDetect = 1;
   m_maxTempo = 1.55f;
   m_videoPreferStereoStream = false;
+  m_videoKeyframeIndexScan = false;
 
   m_videoDefaultLatency = 0.0;
 
@@ -552,6 +555,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
     XMLUtils::GetFloat(pElement, "limiterhold", m_limiterHold, 0.0f, 100.0f);
     XMLUtils::GetFloat(pElement, "limiterrelease", m_limiterRelease, 0.001f, 100.0f);
+    XMLUtils::GetInt(pElement, "lookahead", m_audioLookAhead, 0, 3);
+    XMLUtils::GetInt(pElement, "decodecachesize", m_audioDecodeCacheSize, 0, 1024);
   }
 
   pElement = pRootElement->FirstChildElement("x11");
@@ -703,6 +708,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "fpsdetect", m_videoFpsDetect, 0, 2);
     XMLUtils::GetFloat(pElement, "maxtempo", m_maxTempo, 1.5, 2.1);
     XMLUtils::GetBoolean(pElement, "preferstereostream", m_videoPreferStereoStream);
+    XMLUtils::GetBoolean(pElement, "keyframeindexscan", m_videoKeyframeIndexScan);
 
     // Store global display latency settings
     TiXmlElement* pVideoLatency = pElement->FirstChildElement("latency");
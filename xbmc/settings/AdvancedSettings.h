@@ -128,6 +128,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_VideoPlayerIgnoreDTSinWAV;
     float m_limiterHold;
     float m_limiterRelease;
+    int m_audioLookAhead; ///< number of upcoming playlist entries PAPlayer opens in advance
+    int m_audioDecodeCacheSize; ///< MB of decoded audio PAPlayer keeps for seeking back and playing again, 0 for none
 
     bool  m_omlSync = false;
 
@@ -172,6 +174,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int  m_videoFpsDetect;
     float m_maxTempo;
     bool m_videoPreferStereoStream = false;
+    bool m_videoKeyframeIndexScan = false;
 
     std::string m_videoDefaultPlayer;
     float m_videoPlayCountMinimumPercent;
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "BatchJobQueue.h"
+
+namespace
+{
+// how often a wait checks whether the run was aborted
+const unsigned int kWaitIntervalMs = 100;
+}
+
+CBatchJobQueue::CBatchJobQueue(unsigned int jobsAtOnce, unsigned int queuedPerJob /* = 2 */)
+  : CJobQueue(false, jobsAtOnce, CJob::PRIORITY_LOW_PAUSABLE),
+    m_maxQueued(jobsAtOnce * queuedPerJob)
+{
+}
+
+bool CBatchJobQueue::WaitForSlot(const std::function<bool()>& aborted,
+                                 const std::function<void()>& idle /* = nullptr */)
+{
+  while (!aborted())
+  {
+    {
+      CSingleLock lock(m_section);
+      if (m_outstanding < m_maxQueued)
+        return true;
+    }
+    m_completeEvent.WaitMSec(kWaitIntervalMs);
+    if (idle)
+      idle();
+  }
+  return false;
+}
+
+bool CBatchJobQueue::Add(CJob* job)
+{
+  {
+    CSingleLock lock(m_section);
+    m_outstanding++;
+  }
+  if (AddJob(job))
+    return true;
+
+  CSingleLock lock(m_section);
+  m_outstanding--;
+  m_processed++;
+  return false;
+}
+
+bool CBatchJobQueue::WaitForAll(const std::function<bool()>& aborted,
+                                const std::function<void()>& idle /* = nullptr */)
+{
+  while (!aborted())
+  {
+    {
+      CSingleLock lock(m_section);
+      if (m_outstanding == 0)
+        return true;
+    }
+    m_completeEvent.WaitMSec(kWaitIntervalMs);
+    if (idle)
+      idle();
+  }
+  return false;
+}
+
+void CBatchJobQueue::Finish(bool aborted)
+{
+  m_aborted = aborted;
+  CancelJobs();
+}
+
+unsigned int CBatchJobQueue::GetProcessed() const
+{
+  CSingleLock lock(m_section);
+  return m_processed;
+}
+
+void CBatchJobQueue::OnJobComplete(unsigned int jobID, bool success, CJob* job)
+{
+  // let the next job start first, the job may hold the last reference to the queue
+  CJobQueue::OnJobComplete(jobID, success, job);
+
+  OnResult(job, success);
+
+  // last, the run may be over as soon as nothing is outstanding
+  {
+    CSingleLock lock(m_section);
+    m_processed++;
+    m_outstanding--;
+  }
+  m_completeEvent.Set();
+}
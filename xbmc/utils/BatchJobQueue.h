@@ -0,0 +1,161 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+
+#include <atomic>
+#include <functional>
+
+/*!
+ \ingroup jobs
+ \brief Queue for the jobs of a batch run, e.g. one job per file of a library scan
+
+ The job driving the run adds the jobs one by one with WaitForSlot and Add, so that only a few
+ more jobs are queued than run at once instead of allocating a job for every item up front, and
+ then waits for the rest with WaitForAll.
+
+ The queue is held in a shared_ptr that the jobs of the run hold on to as well. The job manager
+ deletes a job after the queue was told it completed, so the queue stays alive while running jobs
+ finish after the run was cancelled. Jobs check IsAborted to stop early in that case.
+
+ Like for any CJobQueue, the jobs have to implement operator== so that the queue finds them once
+ they completed.
+
+ \sa CJobQueue
+ */
+class CBatchJobQueue : public CJobQueue
+{
+public:
+  /*!
+   \param jobsAtOnce number of jobs run at once
+   \param queuedPerJob number of jobs queued per job run at once, keeps the workers busy
+   */
+  explicit CBatchJobQueue(unsigned int jobsAtOnce, unsigned int queuedPerJob = 2);
+
+  /*!
+   \brief Wait until fewer jobs are outstanding than are queued at most
+   \param aborted checked while waiting, stops the wait when it returns true
+   \param idle called whenever the wait wakes up, e.g. to update the progress (optional)
+   \return true if a job can be added, false if the run was aborted
+   */
+  bool WaitForSlot(const std::function<bool()>& aborted, const std::function<void()>& idle = nullptr);
+
+  /*!
+   \brief Add a job of the run, it is counted as processed right away if it couldn't be added
+   \param job the job, deleted by the queue
+   \return true if the job was added
+   */
+  bool Add(CJob* job);
+
+  /*!
+   \brief Wait until all jobs of the run completed
+   \param aborted checked while waiting, stops the wait when it returns true
+   \param idle called whenever the wait wakes up, e.g. to update the progress (optional)
+   \return true if all jobs completed, false if the run was aborted
+   */
+  bool WaitForAll(const std::function<bool()>& aborted, const std::function<void()>& idle = nullptr);
+
+  /*!
+   \brief Wait until a job completes or the timeout passes
+   */
+  void WaitForCompletion(unsigned int timeoutMs) { m_completeEvent.WaitMSec(timeoutMs); }
+
+  /*!
+   \brief End the run, queued jobs are cancelled and running ones see IsAborted if aborted is set
+   */
+  void Finish(bool aborted);
+
+  bool IsAborted() const { return m_aborted; }
+
+  /*!
+   \brief Number of jobs completed so far, including the ones that couldn't be added
+   */
+  unsigned int GetProcessed() const;
+
+  void OnJobComplete(unsigned int jobID, bool success, CJob* job) override;
+
+protected:
+  /*!
+   \brief Collect the result of a completed job
+   Called before the job is counted as processed, so the run sees the result once it sees the job
+   complete.
+   */
+  virtual void OnResult(CJob* job, bool success) {}
+
+private:
+  const unsigned int m_maxQueued;
+  std::atomic<bool> m_aborted{false};
+
+  mutable CCriticalSection m_section;
+  CEvent m_completeEvent;
+  unsigned int m_outstanding = 0;
+  unsigned int m_processed = 0;
+};
+
+/*!
+ \ingroup jobs
+ \brief The single active run of a batch job, e.g. for starting and stopping it from the settings
+
+ Holds no ownership, the job manager owns the job, which has to call Remove from its destructor.
+ */
+template<class TJob>
+class CActiveBatchJob
+{
+public:
+  bool IsActive() const
+  {
+    CSingleLock lock(m_section);
+    return m_job != nullptr;
+  }
+
+  /*!
+   \brief Start the job unless another run is active
+   \param job the job, deleted if it isn't started
+   \return true if the job was started
+   */
+  bool Start(TJob* job)
+  {
+    CSingleLock lock(m_section);
+    if (m_job || CJobManager::GetInstance().AddJob(job, nullptr, CJob::PRIORITY_LOW) == 0)
+    {
+      delete job;
+      return false;
+    }
+    m_job = job;
+    return true;
+  }
+
+  /*!
+   \brief Ask the active run to stop, if any
+   */
+  void Cancel()
+  {
+    CSingleLock lock(m_section);
+    if (m_job)
+      m_job->Cancel();
+  }
+
+  /*!
+   \brief Forget the job, called from its destructor, also when it was cancelled before it ran
+   */
+  void Remove(const TJob* job)
+  {
+    CSingleLock lock(m_section);
+    if (m_job == job)
+      m_job = nullptr;
+  }
+
+private:
+  mutable CCriticalSection m_section;
+  TJob* m_job = nullptr;
+};
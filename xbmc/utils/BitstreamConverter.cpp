@@ -314,6 +314,8 @@ CBitstreamConverter::CBitstreamConverter()
   m_convert_bitstream = false;
   m_convertBuffer     = NULL;
   m_convertSize       = 0;
+  m_outputBuffer      = NULL;
+  m_outputBufferSize  = 0;
   m_inputBuffer       = NULL;
   m_inputSize         = 0;
   m_to_annexb         = false;
@@ -494,9 +496,12 @@ void CBitstreamConverter::Close(void)
   if (m_sps_pps_context.sps_pps_data)
     av_free(m_sps_pps_context.sps_pps_data), m_sps_pps_context.sps_pps_data = NULL;
 
-  if (m_convertBuffer)
-    av_free(m_convertBuffer), m_convertBuffer = NULL;
+  if (m_outputBuffer)
+    av_free(m_outputBuffer), m_outputBuffer = NULL;
+  m_outputBufferSize = 0;
+  m_convertBuffer = NULL;
   m_convertSize = 0;
+  m_segments.clear();
 
   if (m_extradata)
     av_free(m_extradata), m_extradata = NULL;
@@ -512,11 +517,8 @@ void CBitstreamConverter::Close(void)
 
 bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
 {
-  if (m_convertBuffer)
-  {
-    av_free(m_convertBuffer);
-    m_convertBuffer = NULL;
-  }
+  m_convertBuffer = NULL;
+  m_segments.clear();
   m_inputSize = 0;
   m_convertSize = 0;
   m_inputBuffer = NULL;
@@ -533,21 +535,14 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
 
         if (m_convert_bitstream)
         {
-          // convert demuxer packet from bitstream to bytestream (AnnexB)
-          int bytestream_size = 0;
-          uint8_t *bytestream_buff = NULL;
-
-          BitstreamConvert(demuxer_content, demuxer_bytes, &bytestream_buff, &bytestream_size);
-          if (bytestream_buff && (bytestream_size > 0))
-          {
-            m_convertSize   = bytestream_size;
-            m_convertBuffer = bytestream_buff;
+          // convert demuxer packet from bitstream to bytestream (AnnexB),
+          // the NAL units are only gathered when the packet is read
+          if (BitstreamConvert(demuxer_content, demuxer_bytes) && m_convertSize > 0)
             return true;
-          }
           else
           {
             m_convertSize = 0;
-            m_convertBuffer = NULL;
+            m_segments.clear();
             CLog::Log(LOGERROR, "CBitstreamConverter::Convert: error converting.");
             return false;
           }
@@ -566,50 +561,45 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
 
         if (m_convert_bytestream)
         {
-          if(m_convertBuffer)
-          {
-            av_free(m_convertBuffer);
-            m_convertBuffer = NULL;
-          }
-          m_convertSize = 0;
-
-          // convert demuxer packet from bytestream (AnnexB) to bitstream
-          AVIOContext *pb;
-
-          if(avio_open_dyn_buf(&pb) < 0)
-          {
+          // convert demuxer packet from bytestream (AnnexB) to bitstream,
+          // size the output first so it is written in one go
+          m_convertSize = avc_write_nal_units(NULL, pData, iSize);
+          m_convertBuffer = GetOutputBuffer(m_convertSize);
+          if (!m_convertBuffer)
             return false;
-          }
-          m_convertSize = avc_parse_nal_units(pb, pData, iSize);
-          m_convertSize = avio_close_dyn_buf(pb, &m_convertBuffer);
+          avc_write_nal_units(m_convertBuffer, pData, iSize);
         }
         else if (m_convert_3byteTo4byteNALSize)
         {
-          if(m_convertBuffer)
+          // convert demuxer packet from 3 byte NAL sizes to 4 byte, every
+          // NAL unit grows by one byte
+          uint32_t nal_size;
+          uint8_t *end = pData + iSize;
+          uint8_t *nal_start = pData;
+          int nal_count = 0;
+          while (nal_start + 3 <= end)
           {
-            av_free(m_convertBuffer);
-            m_convertBuffer = NULL;
+            nal_size = BS_RB24(nal_start);
+            nal_start += 3 + nal_size;
+            nal_count++;
           }
-          m_convertSize = 0;
 
-          // convert demuxer packet from 3 byte NAL sizes to 4 byte
-          AVIOContext *pb;
-          if (avio_open_dyn_buf(&pb) < 0)
+          m_convertBuffer = GetOutputBuffer(iSize + nal_count);
+          if (!m_convertBuffer)
             return false;
 
-          uint32_t nal_size;
-          uint8_t *end = pData + iSize;
-          uint8_t *nal_start = pData;
-          while (nal_start < end)
+          uint8_t *out = m_convertBuffer;
+          nal_start = pData;
+          while (nal_start + 3 <= end)
           {
-            nal_size = BS_RB24(nal_start);
-            avio_wb32(pb, nal_size);
+            nal_size = std::min<uint32_t>(BS_RB24(nal_start), end - nal_start - 3);
+            BS_WB32(out, nal_size);
             nal_start += 3;
-            avio_write(pb, nal_start, nal_size);
+            memcpy(out + 4, nal_start, nal_size);
             nal_start += nal_size;
+            out += 4 + nal_size;
           }
-
-          m_convertSize = avio_close_dyn_buf(pb, &m_convertBuffer);
+          m_convertSize = out - m_convertBuffer;
         }
         return true;
       }
@@ -622,6 +612,13 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
 
 uint8_t *CBitstreamConverter::GetConvertBuffer() const
 {
+  if (!m_convertBuffer && !m_segments.empty())
+  {
+    m_convertBuffer = GetOutputBuffer(m_convertSize);
+    if (m_convertBuffer)
+      CopyConvertBuffer(m_convertBuffer, m_convertSize);
+  }
+
   if((m_convert_bitstream || m_convert_bytestream || m_convert_3byteTo4byteNALSize) && m_convertBuffer != NULL)
     return m_convertBuffer;
   else
@@ -630,12 +627,53 @@ uint8_t *CBitstreamConverter::GetConvertBuffer() const
 
 int CBitstreamConverter::GetConvertSize() const
 {
-  if((m_convert_bitstream || m_convert_bytestream || m_convert_3byteTo4byteNALSize) && m_convertBuffer != NULL)
+  if((m_convert_bitstream || m_convert_bytestream || m_convert_3byteTo4byteNALSize) &&
+     (m_convertBuffer != NULL || !m_segments.empty()))
     return m_convertSize;
   else
     return m_inputSize;
 }
 
+int CBitstreamConverter::CopyConvertBuffer(uint8_t *dst, int size) const
+{
+  if (m_segments.empty())
+  {
+    size = std::min(size, GetConvertSize());
+    if (size > 0)
+      memcpy(dst, GetConvertBuffer(), size);
+    return std::max(size, 0);
+  }
+
+  int written = 0;
+  for (const auto& segment : m_segments)
+  {
+    int len = std::min(static_cast<int>(segment.size), size - written);
+    memcpy(dst + written, segment.data, len);
+    written += len;
+    if (written == size)
+      break;
+  }
+  return written;
+}
+
+uint8_t *CBitstreamConverter::GetOutputBuffer(int size) const
+{
+  if (size < 0)
+    return NULL;
+
+  // an empty packet still gets a buffer, for the padding
+  if (!m_outputBuffer || size > m_outputBufferSize)
+  {
+    void *tmp = av_realloc(m_outputBuffer, size + AV_INPUT_BUFFER_PADDING_SIZE);
+    if (!tmp)
+      return NULL;
+    m_outputBuffer = (uint8_t*)tmp;
+    m_outputBufferSize = size;
+  }
+  memset(m_outputBuffer + size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+  return m_outputBuffer;
+}
+
 uint8_t *CBitstreamConverter::GetExtraData() const
 {
   if(m_convert_bitstream)
@@ -867,7 +905,7 @@ bool CBitstreamConverter::IsSlice(uint8_t unit_type)
   }
 }
 
-bool CBitstreamConverter::BitstreamConvert(uint8_t* pData, int iSize, uint8_t **poutbuf, int *poutbuf_size)
+bool CBitstreamConverter::BitstreamConvert(uint8_t* pData, int iSize)
 {
   // based on h264_mp4toannexb_bsf.c (ffmpeg)
   // which is Copyright (c) 2007 Benoit Fouet <benoit.fouet@free.fr>
@@ -928,13 +966,12 @@ bool CBitstreamConverter::BitstreamConvert(uint8_t* pData, int iSize, uint8_t **
     // prepend only to the first access unit of an IDR picture, if no sps/pps already present
     if (m_sps_pps_context.first_idr && IsIDR(unit_type) && !m_sps_pps_context.idr_sps_pps_seen)
     {
-      BitstreamAllocAndCopy(poutbuf, poutbuf_size,
-        m_sps_pps_context.sps_pps_data, m_sps_pps_context.size, buf, nal_size);
+      BitstreamAddNalUnit(m_sps_pps_context.sps_pps_data, m_sps_pps_context.size, buf, nal_size);
       m_sps_pps_context.first_idr = 0;
     }
     else
     {
-      BitstreamAllocAndCopy(poutbuf, poutbuf_size, NULL, 0, buf, nal_size);
+      BitstreamAddNalUnit(NULL, 0, buf, nal_size);
       if (!m_sps_pps_context.first_idr && IsSlice(unit_type))
       {
           m_sps_pps_context.first_idr = 1;
@@ -949,41 +986,27 @@ bool CBitstreamConverter::BitstreamConvert(uint8_t* pData, int iSize, uint8_t **
   return true;
 
 fail:
-  av_free(*poutbuf), *poutbuf = NULL;
-  *poutbuf_size = 0;
+  m_segments.clear();
+  m_convertSize = 0;
   return false;
 }
 
-void CBitstreamConverter::BitstreamAllocAndCopy( uint8_t **poutbuf, int *poutbuf_size,
-    const uint8_t *sps_pps, uint32_t sps_pps_size, const uint8_t *in, uint32_t in_size)
+void CBitstreamConverter::BitstreamAddNalUnit(const uint8_t *sps_pps, uint32_t sps_pps_size,
+    const uint8_t *in, uint32_t in_size)
 {
   // based on h264_mp4toannexb_bsf.c (ffmpeg)
   // which is Copyright (c) 2007 Benoit Fouet <benoit.fouet@free.fr>
   // and Licensed GPL 2.1 or greater
 
-  uint32_t offset = *poutbuf_size;
-  uint8_t nal_header_size = offset ? 3 : 4;
-  void *tmp;
-
-  *poutbuf_size += sps_pps_size + in_size + nal_header_size;
-  tmp = av_realloc(*poutbuf, *poutbuf_size);
-  if (!tmp)
-    return;
-  *poutbuf = (uint8_t*)tmp;
-  if (sps_pps)
-    memcpy(*poutbuf + offset, sps_pps, sps_pps_size);
-
-  memcpy(*poutbuf + sps_pps_size + nal_header_size + offset, in, in_size);
-  if (!offset)
-  {
-    BS_WB32(*poutbuf + sps_pps_size, 1);
-  }
-  else
-  {
-    (*poutbuf + offset + sps_pps_size)[0] = 0;
-    (*poutbuf + offset + sps_pps_size)[1] = 0;
-    (*poutbuf + offset + sps_pps_size)[2] = 1;
-  }
+  static const uint8_t nalu_header[4] = {0, 0, 0, 1};
+  // the first unit of a packet gets a 4 byte start code, the others 3 bytes
+  uint8_t nal_header_size = m_segments.empty() ? 4 : 3;
+
+  if (sps_pps && sps_pps_size)
+    m_segments.push_back({sps_pps, sps_pps_size});
+  m_segments.push_back({nalu_header + 4 - nal_header_size, nal_header_size});
+  m_segments.push_back({in, in_size});
+  m_convertSize += sps_pps_size + nal_header_size + in_size;
 }
 
 int CBitstreamConverter::avc_parse_nal_units(AVIOContext *pb, const uint8_t *buf_in, int size)
@@ -1009,6 +1032,33 @@ int CBitstreamConverter::avc_parse_nal_units(AVIOContext *pb, const uint8_t *buf
   return size;
 }
 
+int CBitstreamConverter::avc_write_nal_units(uint8_t *buf_out, const uint8_t *buf_in, int size)
+{
+  // same as avc_parse_nal_units into a buffer, only returns the size if buf_out is NULL
+  const uint8_t *p = buf_in;
+  const uint8_t *end = p + size;
+  const uint8_t *nal_start, *nal_end;
+
+  size = 0;
+  nal_start = avc_find_startcode(p, end);
+
+  for (;;) {
+    while (nal_start < end && !*(nal_start++));
+    if (nal_start == end)
+      break;
+
+    nal_end = avc_find_startcode(nal_start, end);
+    if (buf_out)
+    {
+      BS_WB32(buf_out + size, nal_end - nal_start);
+      memcpy(buf_out + size + 4, nal_start, nal_end - nal_start);
+    }
+    size += 4 + nal_end - nal_start;
+    nal_start = nal_end;
+  }
+  return size;
+}
+
 int CBitstreamConverter::avc_parse_nal_units_buf(const uint8_t *buf_in, uint8_t **buf, int *size)
 {
   AVIOContext *pb;
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <vector>
 
 extern "C" {
 #include <libavutil/avutil.h>
@@ -89,9 +90,23 @@ public:
   bool              Open(enum AVCodecID codec, uint8_t *in_extradata, int in_extrasize, bool to_annexb);
   void              Close(void);
   bool              NeedConvert(void) const { return m_convert_bitstream; };
+  /*!
+   * \brief Convert a packet
+   *
+   * Bitstream to Annex B conversion refers to the NAL units in pData, it has
+   * to stay valid until the converted packet was read.
+   */
   bool              Convert(uint8_t *pData, int iSize);
   uint8_t*          GetConvertBuffer(void) const;
   int               GetConvertSize() const;
+  /*!
+   * \brief Copy the converted packet into a buffer of the caller
+   *
+   * Bitstream to Annex B conversion gathers the NAL units straight into dst,
+   * without the intermediate buffer of GetConvertBuffer().
+   * \return Number of bytes written, at most size
+   */
+  int               CopyConvertBuffer(uint8_t *dst, int size) const;
   uint8_t*          GetExtraData(void) const;
   int               GetExtraSize() const;
   void              ResetStartDecode(void);
@@ -101,6 +116,7 @@ public:
 
 protected:
   static int  avc_parse_nal_units(AVIOContext *pb, const uint8_t *buf_in, int size);
+  static int  avc_write_nal_units(uint8_t *buf_out, const uint8_t *buf_in, int size);
   static int  avc_parse_nal_units_buf(const uint8_t *buf_in, uint8_t **buf, int *size);
   int         isom_write_avcc(AVIOContext *pb, const uint8_t *data, int len);
   // bitstream to bytestream (Annex B) conversion support.
@@ -108,9 +124,9 @@ protected:
   bool              IsSlice(uint8_t unit_type);
   bool              BitstreamConvertInitAVC(void *in_extradata, int in_extrasize);
   bool              BitstreamConvertInitHEVC(void *in_extradata, int in_extrasize);
-  bool              BitstreamConvert(uint8_t* pData, int iSize, uint8_t **poutbuf, int *poutbuf_size);
-  static void       BitstreamAllocAndCopy(uint8_t **poutbuf, int *poutbuf_size,
-                      const uint8_t *sps_pps, uint32_t sps_pps_size, const uint8_t *in, uint32_t in_size);
+  bool              BitstreamConvert(uint8_t* pData, int iSize);
+  void              BitstreamAddNalUnit(const uint8_t *sps_pps, uint32_t sps_pps_size, const uint8_t *in, uint32_t in_size);
+  uint8_t*          GetOutputBuffer(int size) const;
 
   typedef struct omx_bitstream_ctx {
       uint8_t  length_size;
@@ -120,7 +136,18 @@ protected:
       uint32_t size;
   } omx_bitstream_ctx;
 
-  uint8_t          *m_convertBuffer;
+  typedef struct nal_segment {
+      const uint8_t *data;
+      uint32_t size;
+  } nal_segment;
+
+  // converted bitstream packet, start codes and NAL units of the input
+  std::vector<nal_segment> m_segments;
+  // reused for every packet, only grows
+  mutable uint8_t  *m_outputBuffer;
+  mutable int       m_outputBufferSize;
+
+  mutable uint8_t  *m_convertBuffer;
   int               m_convertSize;
   uint8_t          *m_inputBuffer;
   int               m_inputSize;
@@ -10,6 +10,7 @@
 
 #include "dbwrappers/dataset.h"
 #include "music/MusicDatabase.h"
+#include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
@@ -513,6 +514,68 @@ size_t DatabaseUtils::GetLimitCount(int end, int start)
   return 0;
 }
 
+bool DatabaseUtils::BuildOrderClause(const MediaType& mediaType, const SortDescription& sorting, std::string& order)
+{
+  order.clear();
+  if (sorting.sortBy == SortByRandom)
+  {
+    if (sorting.randomSeed == 0)
+      return false;
+    order = BuildRandomOrderClause(GetField(FieldId, mediaType, DatabaseQueryPartOrderBy), sorting.randomSeed);
+    return !order.empty();
+  }
+
+  FieldList fields;
+  SortUtils::GetFieldsForSQLSort(mediaType, sorting.sortBy, fields);
+  // only the id is no sort by columns
+  if (sorting.sortBy != SortByNone && fields.size() < 2)
+    return false;
+
+  // Sorts in memory order equal keys by label, the title of a video after the
+  // season and episode for episodes. Articles aren't ignored here, the rows
+  // are sorted in memory once more.
+  if (sorting.sortBy != SortByNone && sorting.sortBy != SortByDateAdded)
+  {
+    fields.pop_back();
+    if (mediaType == MediaTypeEpisode)
+    {
+      fields.emplace_back(FieldSeason);
+      fields.emplace_back(FieldEpisodeNumber);
+    }
+    fields.emplace_back(FieldTitle);
+    fields.emplace_back(FieldId);
+  }
+
+  std::vector<std::string> orderFields;
+  for (const auto& field : fields)
+  {
+    std::string name = GetField(field, mediaType, field == FieldTitle ? DatabaseQueryPartSelect : DatabaseQueryPartOrderBy);
+    if (name.empty())
+      return false;
+    // numbers stored as text
+    if (field == FieldSeason || field == FieldEpisodeNumber)
+      name += " + 0";
+    if (sorting.sortOrder == SortOrderDescending)
+      name += " DESC";
+    orderFields.emplace_back(name);
+  }
+
+  order = StringUtils::Join(orderFields, ", ");
+  return !order.empty();
+}
+
+std::string DatabaseUtils::BuildRandomOrderClause(const std::string& idField, unsigned int seed)
+{
+  if (idField.empty())
+    return "";
+
+  // Squaring the Lehmer step keeps neighbouring ids apart, all of it fits
+  // into 64 bit integers of SQLite and MySQL. Equal keys keep the id order.
+  seed &= 0x7FFFFFFF;
+  const std::string step = StringUtils::Format("((%s * 48271 + %u) %% 2147483647)", idField.c_str(), seed);
+  return step + " * " + step + " % 2147483647, " + idField;
+}
+
 int DatabaseUtils::GetField(Field field, const MediaType &mediaType, bool asIndex)
 {
   if (field == FieldNone || mediaType == MediaTypeNone)
@@ -159,6 +159,8 @@ typedef enum {
 typedef std::map<Field, CVariant> DatabaseResult;
 typedef std::vector<DatabaseResult> DatabaseResults;
 
+struct SortDescription;
+
 class DatabaseUtils
 {
 public:
@@ -176,6 +178,17 @@ public:
   static std::string BuildLimitClauseOnly(int end, int start = 0);
   static size_t GetLimitCount(int end, int start);
 
+  /*!
+   \brief Build the ORDER BY clause (without "ORDER BY") of a sort by columns of the media type's view
+   \return false if the items have to be sorted in memory, e.g. by label or in a random order without seed
+   */
+  static bool BuildOrderClause(const MediaType& mediaType, const SortDescription& sorting, std::string& order);
+
+  /*!
+   \brief Build an ORDER BY clause that shuffles the rows the same way for the same seed
+   */
+  static std::string BuildRandomOrderClause(const std::string& idField, unsigned int seed);
+
 private:
   static int GetField(Field field, const MediaType &mediaType, bool asIndex);
 };
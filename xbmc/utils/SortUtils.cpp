@@ -923,6 +923,26 @@ void SortUtils::GetFieldsForSQLSort(const MediaType& mediaType,
     else if (sortMethod == SortByDateAdded)
       fields.emplace_back(FieldDateAdded);
   }
+  else if (mediaType == MediaTypeMovie || mediaType == MediaTypeTvShow ||
+           mediaType == MediaTypeEpisode || mediaType == MediaTypeMusicVideo)
+  {
+    // Only the sorts by a single column of the view, labels are sorted
+    // ignoring articles and with natural numbers in memory
+    if (sortMethod == SortByDateAdded)
+      fields.emplace_back(FieldDateAdded);
+    else if (sortMethod == SortByYear && mediaType != MediaTypeEpisode)
+      fields.emplace_back(FieldYear);
+    else if (sortMethod == SortByRating)
+      fields.emplace_back(FieldRating);
+    else if (sortMethod == SortByVotes)
+      fields.emplace_back(FieldVotes);
+    else if (sortMethod == SortByUserRating)
+      fields.emplace_back(FieldUserRating);
+    else if (sortMethod == SortByPlaycount)
+      fields.emplace_back(FieldPlaycount);
+    else if (sortMethod == SortByLastPlayed)
+      fields.emplace_back(FieldLastPlayed);
+  }
 
   // Add sort by id to define order when other fields same or sort none
   fields.emplace_back(FieldId);
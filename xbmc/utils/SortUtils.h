@@ -170,6 +170,7 @@ typedef struct SortDescription {
   SortAttribute sortAttributes = SortAttributeNone;
   int limitStart = 0;
   int limitEnd = -1;
+  unsigned int randomSeed = 0; ///< same order for the same seed with SortByRandom, 0 for a new one
 } SortDescription;
 
 typedef struct GUIViewSortDetails
@@ -0,0 +1,180 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "test/MtTestUtils.h"
+#include "utils/BatchJobQueue.h"
+
+#include <atomic>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+using namespace ConditionPoll;
+
+namespace
+{
+struct Flags
+{
+  std::atomic<bool> lingerAtWork{false};
+  std::atomic<unsigned int> running{0};
+  std::atomic<unsigned int> maxRunning{0};
+  std::atomic<unsigned int> results{0};
+  std::atomic<bool> sawAbort{false};
+};
+
+class CCountingQueue : public CBatchJobQueue
+{
+public:
+  CCountingQueue(Flags& flags, unsigned int jobsAtOnce) : CBatchJobQueue(jobsAtOnce), m_flags(flags)
+  {
+  }
+
+protected:
+  void OnResult(CJob* job, bool success) override
+  {
+    if (success)
+      m_flags.results++;
+  }
+
+private:
+  Flags& m_flags;
+};
+
+class CItemJob : public CJob
+{
+public:
+  CItemJob(std::shared_ptr<CCountingQueue> queue, Flags& flags)
+    : m_queue(std::move(queue)), m_flags(flags)
+  {
+  }
+
+  bool operator==(const CJob* job) const override { return this == job; }
+  bool DoWork() override
+  {
+    unsigned int running = ++m_flags.running;
+    unsigned int max = m_flags.maxRunning;
+    while (running > max && !m_flags.maxRunning.compare_exchange_weak(max, running))
+      ;
+    while (m_flags.lingerAtWork && !m_queue->IsAborted())
+      std::this_thread::yield();
+    if (m_queue->IsAborted())
+      m_flags.sawAbort = true;
+    m_flags.running--;
+    return true;
+  }
+
+private:
+  std::shared_ptr<CCountingQueue> m_queue;
+  Flags& m_flags;
+};
+
+class CRunJob : public CJob
+{
+public:
+  CRunJob(CActiveBatchJob<CRunJob>& run, Flags& flags) : m_run(run), m_flags(flags) {}
+  ~CRunJob() override { m_run.Remove(this); }
+
+  bool DoWork() override
+  {
+    while (m_flags.lingerAtWork)
+      std::this_thread::yield();
+    return true;
+  }
+  void Cancel() { m_flags.sawAbort = true; }
+
+private:
+  CActiveBatchJob<CRunJob>& m_run;
+  Flags& m_flags;
+};
+} // namespace
+
+class TestBatchJobQueue : public testing::Test
+{
+protected:
+  ~TestBatchJobQueue() override
+  {
+    CJobManager::GetInstance().CancelJobs();
+    CJobManager::GetInstance().Restart();
+  }
+};
+
+TEST_F(TestBatchJobQueue, RunsAllJobs)
+{
+  Flags flags;
+  auto queue = std::make_shared<CCountingQueue>(flags, 2);
+  const auto aborted = []() { return false; };
+
+  for (int i = 0; i < 10; i++)
+  {
+    ASSERT_TRUE(queue->WaitForSlot(aborted));
+    EXPECT_TRUE(queue->Add(new CItemJob(queue, flags)));
+  }
+  EXPECT_TRUE(queue->WaitForAll(aborted));
+
+  EXPECT_EQ(10U, queue->GetProcessed());
+  EXPECT_EQ(10U, flags.results);
+  EXPECT_LE(flags.maxRunning, 2U);
+}
+
+TEST_F(TestBatchJobQueue, WaitsForSlot)
+{
+  Flags flags;
+  flags.lingerAtWork = true;
+  auto queue = std::make_shared<CCountingQueue>(flags, 1);
+  const auto never = []() { return false; };
+
+  // one running and one queued job keep the queue full
+  ASSERT_TRUE(queue->WaitForSlot(never));
+  queue->Add(new CItemJob(queue, flags));
+  ASSERT_TRUE(queue->WaitForSlot(never));
+  queue->Add(new CItemJob(queue, flags));
+
+  int waits = 0;
+  EXPECT_FALSE(queue->WaitForSlot([&waits]() { return waits >= 2; }, [&waits]() { waits++; }));
+  EXPECT_EQ(2, waits);
+
+  flags.lingerAtWork = false;
+  EXPECT_TRUE(queue->WaitForSlot(never));
+  EXPECT_TRUE(queue->WaitForAll(never));
+  EXPECT_EQ(2U, queue->GetProcessed());
+}
+
+TEST_F(TestBatchJobQueue, FinishAborts)
+{
+  Flags flags;
+  flags.lingerAtWork = true;
+  auto queue = std::make_shared<CCountingQueue>(flags, 1);
+
+  queue->Add(new CItemJob(queue, flags));
+  ASSERT_TRUE(poll([&flags]() { return flags.running == 1; }));
+
+  // the running job holds on to the queue and sees the abort
+  queue->Finish(true);
+  EXPECT_TRUE(queue->IsAborted());
+  queue.reset();
+  EXPECT_TRUE(poll([&flags]() { return flags.sawAbort && flags.running == 0; }));
+}
+
+TEST_F(TestBatchJobQueue, SingleActiveRun)
+{
+  CActiveBatchJob<CRunJob> run;
+  Flags flags;
+  flags.lingerAtWork = true;
+
+  EXPECT_FALSE(run.IsActive());
+  EXPECT_TRUE(run.Start(new CRunJob(run, flags)));
+  EXPECT_TRUE(run.IsActive());
+  EXPECT_FALSE(run.Start(new CRunJob(run, flags)));
+  EXPECT_TRUE(run.IsActive());
+
+  run.Cancel();
+  EXPECT_TRUE(flags.sawAbort);
+
+  flags.lingerAtWork = false;
+  EXPECT_TRUE(poll([&run]() { return !run.IsActive(); }));
+}
@@ -0,0 +1,244 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "utils/BitstreamConverter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const std::vector<uint8_t> sps = {0x67, 0x64, 0x00, 0x1f, 0xac, 0xd9, 0x40, 0x50};
+const std::vector<uint8_t> pps = {0x68, 0xeb, 0xe3, 0xcb};
+
+std::vector<uint8_t> AvcC()
+{
+  std::vector<uint8_t> avcc = {0x01, sps[1], sps[2], sps[3], 0xff, 0xe1};
+  avcc.push_back(0);
+  avcc.push_back(static_cast<uint8_t>(sps.size()));
+  avcc.insert(avcc.end(), sps.begin(), sps.end());
+  avcc.push_back(1);
+  avcc.push_back(0);
+  avcc.push_back(static_cast<uint8_t>(pps.size()));
+  avcc.insert(avcc.end(), pps.begin(), pps.end());
+  return avcc;
+}
+
+std::vector<uint8_t> Nal(uint8_t header, size_t size)
+{
+  std::vector<uint8_t> nal(size);
+  nal[0] = header;
+  for (size_t i = 1; i < size; i++)
+    nal[i] = static_cast<uint8_t>(i | 0x80);
+  return nal;
+}
+
+void AppendLength(std::vector<uint8_t>& packet, const std::vector<uint8_t>& nal, int lengthSize)
+{
+  for (int i = lengthSize - 1; i >= 0; i--)
+    packet.push_back(static_cast<uint8_t>(nal.size() >> (8 * i)));
+  packet.insert(packet.end(), nal.begin(), nal.end());
+}
+
+void AppendStartCode(std::vector<uint8_t>& packet, const std::vector<uint8_t>& nal, int startCodeSize)
+{
+  for (int i = 1; i < startCodeSize; i++)
+    packet.push_back(0);
+  packet.push_back(1);
+  packet.insert(packet.end(), nal.begin(), nal.end());
+}
+
+/*!
+ * \brief Access units with NAL sizes as seen in broadcast and web H.264:
+ *        an AUD and SEI per picture, large IDR slices, mid sized P and small
+ *        B slices, some pictures split into several slices
+ */
+std::vector<std::vector<uint8_t>> GeneratePackets(unsigned int count)
+{
+  std::mt19937 random(42);
+  std::uniform_int_distribution<size_t> idrSize(40000, 160000);
+  std::uniform_int_distribution<size_t> pSize(4000, 30000);
+  std::uniform_int_distribution<size_t> bSize(300, 6000);
+  std::uniform_int_distribution<size_t> seiSize(20, 700);
+  std::uniform_int_distribution<int> slices(1, 4);
+
+  std::vector<std::vector<uint8_t>> packets;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    std::vector<uint8_t> packet;
+    AppendLength(packet, Nal(0x09, 2), 4);
+    AppendLength(packet, Nal(0x06, seiSize(random)), 4);
+
+    const bool idr = i % 48 == 0;
+    const size_t size = idr ? idrSize(random) : (i % 3 == 0 ? pSize(random) : bSize(random));
+    const int sliceCount = slices(random);
+    for (int slice = 0; slice < sliceCount; slice++)
+      AppendLength(packet, Nal(idr ? 0x65 : 0x41, size / sliceCount), 4);
+
+    packets.push_back(packet);
+  }
+  return packets;
+}
+} // namespace
+
+TEST(TestBitstreamConverter, ToAnnexB)
+{
+  std::vector<uint8_t> avcc = AvcC();
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(AV_CODEC_ID_H264, avcc.data(), avcc.size(), true));
+  EXPECT_TRUE(converter.NeedConvert());
+
+  const std::vector<uint8_t> idr = Nal(0x65, 300);
+  const std::vector<uint8_t> slice = Nal(0x41, 70);
+  std::vector<uint8_t> packet;
+  AppendLength(packet, idr, 4);
+  AppendLength(packet, slice, 4);
+
+  // parameter sets are prepended to the first IDR
+  std::vector<uint8_t> expected;
+  AppendStartCode(expected, sps, 4);
+  AppendStartCode(expected, pps, 4);
+  AppendStartCode(expected, idr, 4);
+  AppendStartCode(expected, slice, 3);
+
+  ASSERT_TRUE(converter.Convert(packet.data(), packet.size()));
+  ASSERT_EQ(static_cast<int>(expected.size()), converter.GetConvertSize());
+
+  std::vector<uint8_t> copied(expected.size());
+  EXPECT_EQ(static_cast<int>(expected.size()), converter.CopyConvertBuffer(copied.data(), copied.size()));
+  EXPECT_EQ(expected, copied);
+
+  const uint8_t* buffer = converter.GetConvertBuffer();
+  EXPECT_EQ(expected, std::vector<uint8_t>(buffer, buffer + converter.GetConvertSize()));
+
+  // a short destination gets what fits
+  EXPECT_EQ(10, converter.CopyConvertBuffer(copied.data(), 10));
+
+  // the next packet without parameter sets
+  expected.clear();
+  AppendStartCode(expected, slice, 4);
+  packet.clear();
+  AppendLength(packet, slice, 4);
+  ASSERT_TRUE(converter.Convert(packet.data(), packet.size()));
+  buffer = converter.GetConvertBuffer();
+  EXPECT_EQ(expected, std::vector<uint8_t>(buffer, buffer + converter.GetConvertSize()));
+}
+
+TEST(TestBitstreamConverter, ToAnnexBTruncated)
+{
+  std::vector<uint8_t> avcc = AvcC();
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(AV_CODEC_ID_H264, avcc.data(), avcc.size(), true));
+
+  std::vector<uint8_t> packet;
+  AppendLength(packet, Nal(0x41, 100), 4);
+  packet.resize(50);
+  EXPECT_FALSE(converter.Convert(packet.data(), packet.size()));
+  EXPECT_EQ(0, converter.GetConvertSize());
+}
+
+TEST(TestBitstreamConverter, ToBitstream)
+{
+  std::vector<uint8_t> extradata;
+  AppendStartCode(extradata, sps, 4);
+  AppendStartCode(extradata, pps, 4);
+
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(AV_CODEC_ID_H264, extradata.data(), extradata.size(), false));
+
+  const std::vector<uint8_t> idr = Nal(0x65, 200);
+  const std::vector<uint8_t> slice = Nal(0x41, 30);
+  std::vector<uint8_t> packet;
+  AppendStartCode(packet, idr, 4);
+  AppendStartCode(packet, slice, 3);
+
+  std::vector<uint8_t> expected;
+  AppendLength(expected, idr, 4);
+  AppendLength(expected, slice, 4);
+
+  ASSERT_TRUE(converter.Convert(packet.data(), packet.size()));
+  const uint8_t* buffer = converter.GetConvertBuffer();
+  EXPECT_EQ(expected, std::vector<uint8_t>(buffer, buffer + converter.GetConvertSize()));
+}
+
+TEST(TestBitstreamConverter, ToBitstreamNoStartCode)
+{
+  std::vector<uint8_t> extradata;
+  AppendStartCode(extradata, sps, 4);
+  AppendStartCode(extradata, pps, 4);
+
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(AV_CODEC_ID_H264, extradata.data(), extradata.size(), false));
+
+  // nothing to write, before any output buffer was allocated
+  std::vector<uint8_t> packet = Nal(0x65, 20);
+  ASSERT_TRUE(converter.Convert(packet.data(), packet.size()));
+  EXPECT_EQ(0, converter.GetConvertSize());
+}
+
+TEST(TestBitstreamConverter, ThreeByteNalSize)
+{
+  std::vector<uint8_t> avcc = AvcC();
+  avcc[4] = 0xfe;
+
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(AV_CODEC_ID_H264, avcc.data(), avcc.size(), false));
+
+  const std::vector<uint8_t> idr = Nal(0x65, 1000);
+  const std::vector<uint8_t> slice = Nal(0x41, 10);
+  std::vector<uint8_t> packet;
+  AppendLength(packet, idr, 3);
+  AppendLength(packet, slice, 3);
+
+  std::vector<uint8_t> expected;
+  AppendLength(expected, idr, 4);
+  AppendLength(expected, slice, 4);
+
+  ASSERT_TRUE(converter.Convert(packet.data(), packet.size()));
+  const uint8_t* buffer = converter.GetConvertBuffer();
+  EXPECT_EQ(expected, std::vector<uint8_t>(buffer, buffer + converter.GetConvertSize()));
+}
+
+TEST(TestBitstreamConverter, DISABLED_Throughput)
+{
+  const std::vector<std::vector<uint8_t>> packets = GeneratePackets(2400);
+  std::vector<uint8_t> avcc = AvcC();
+  std::vector<uint8_t> destination(512 * 1024);
+
+  for (int copy = 0; copy < 2; copy++)
+  {
+    CBitstreamConverter converter;
+    ASSERT_TRUE(converter.Open(AV_CODEC_ID_H264, avcc.data(), avcc.size(), true));
+
+    size_t bytes = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < 10; round++)
+    {
+      for (const auto& packet : packets)
+      {
+        ASSERT_TRUE(converter.Convert(const_cast<uint8_t*>(packet.data()), packet.size()));
+        if (copy)
+          bytes += converter.CopyConvertBuffer(destination.data(), destination.size());
+        else
+        {
+          memcpy(destination.data(), converter.GetConvertBuffer(), converter.GetConvertSize());
+          bytes += converter.GetConvertSize();
+        }
+      }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%s: %.0f packets/s, %.1f MB/s\n", copy ? "CopyConvertBuffer" : "GetConvertBuffer",
+           packets.size() * 10 / seconds, bytes / seconds / (1024 * 1024));
+  }
+}
@@ -25,6 +25,7 @@
 #include "dialogs/GUIDialogProgress.h"
 #include "dialogs/GUIDialogYesNo.h"
 #include "filesystem/Directory.h"
+#include "filesystem/ExistenceChecker.h"
 #include "filesystem/File.h"
 #include "filesystem/MultiPathDirectory.h"
 #include "filesystem/PluginDirectory.h"
@@ -69,6 +70,27 @@ using namespace ADDON;
 using namespace KODI::MESSAGING;
 using namespace KODI::GUILIB;
 
+// Full text indexes used by search, MySQL only matches all columns of an index together
+static const CDatabase::FullTextIndex MovieTitleSearchIndex{
+    "movie_title_fts", "movie", "idMovie", {StringUtils::Format("c%02d", VIDEODB_ID_TITLE)}};
+static const CDatabase::FullTextIndex MoviePlotSearchIndex{
+    "movie_plot_fts", "movie", "idMovie",
+    {StringUtils::Format("c%02d", VIDEODB_ID_PLOT), StringUtils::Format("c%02d", VIDEODB_ID_PLOTOUTLINE),
+     StringUtils::Format("c%02d", VIDEODB_ID_TAGLINE)}};
+static const CDatabase::FullTextIndex TvShowTitleSearchIndex{
+    "tvshow_title_fts", "tvshow", "idShow", {StringUtils::Format("c%02d", VIDEODB_ID_TV_TITLE)}};
+static const CDatabase::FullTextIndex EpisodeTitleSearchIndex{
+    "episode_title_fts", "episode", "idEpisode",
+    {StringUtils::Format("c%02d", VIDEODB_ID_EPISODE_TITLE)}};
+static const CDatabase::FullTextIndex EpisodePlotSearchIndex{
+    "episode_plot_fts", "episode", "idEpisode",
+    {StringUtils::Format("c%02d", VIDEODB_ID_EPISODE_PLOT)}};
+static const CDatabase::FullTextIndex MusicVideoTitleSearchIndex{
+    "musicvideo_title_fts", "musicvideo", "idMVideo",
+    {StringUtils::Format("c%02d", VIDEODB_ID_MUSICVIDEO_TITLE)}};
+static const CDatabase::FullTextIndex ActorSearchIndex{"actor_fts", "actor", "actor_id", {"name"}};
+static const CDatabase::FullTextIndex TagSearchIndex{"tag_fts", "tag", "tag_id", {"name"}};
+
 //********************************************************************************************************************************
 CVideoDatabase::CVideoDatabase(void) = default;
 
@@ -193,6 +215,8 @@ void CVideoDatabase::CreateTables()
 
   CLog::Log(LOGINFO, "create uniqueid table");
   m_pDS->exec("CREATE TABLE uniqueid (uniqueid_id INTEGER PRIMARY KEY, media_id INTEGER, media_type TEXT, value TEXT, type TEXT)");
+
+  CreateChangeCountTable();
 }
 
 void CVideoDatabase::CreateLinkIndex(const char *table)
@@ -276,6 +300,15 @@ void CVideoDatabase::CreateAnalytics()
   CreateLinkIndex("genre");
   CreateLinkIndex("country");
 
+  CreateFullTextIndex(MovieTitleSearchIndex);
+  CreateFullTextIndex(MoviePlotSearchIndex);
+  CreateFullTextIndex(TvShowTitleSearchIndex);
+  CreateFullTextIndex(EpisodeTitleSearchIndex);
+  CreateFullTextIndex(EpisodePlotSearchIndex);
+  CreateFullTextIndex(MusicVideoTitleSearchIndex);
+  CreateFullTextIndex(ActorSearchIndex);
+  CreateFullTextIndex(TagSearchIndex);
+
   CLog::Log(LOGINFO, "%s - creating triggers", __FUNCTION__);
   m_pDS->exec("CREATE TRIGGER delete_movie AFTER DELETE ON movie FOR EACH ROW BEGIN "
               "DELETE FROM genre_link WHERE media_id=old.idMovie AND media_type='movie'; "
@@ -289,6 +322,7 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM tag_link WHERE media_id=old.idMovie AND media_type='movie'; "
               "DELETE FROM rating WHERE media_id=old.idMovie AND media_type='movie'; "
               "DELETE FROM uniqueid WHERE media_id=old.idMovie AND media_type='movie'; "
+              "UPDATE changecount SET iChanges = iChanges + 1; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_tvshow AFTER DELETE ON tvshow FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idShow AND media_type='tvshow'; "
@@ -302,6 +336,7 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM tag_link WHERE media_id=old.idShow AND media_type='tvshow'; "
               "DELETE FROM rating WHERE media_id=old.idShow AND media_type='tvshow'; "
               "DELETE FROM uniqueid WHERE media_id=old.idShow AND media_type='tvshow'; "
+              "UPDATE changecount SET iChanges = iChanges + 1; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_musicvideo AFTER DELETE ON musicvideo FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
@@ -310,6 +345,7 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM studio_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
               "DELETE FROM art WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
               "DELETE FROM tag_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
+              "UPDATE changecount SET iChanges = iChanges + 1; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_episode AFTER DELETE ON episode FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idEpisode AND media_type='episode'; "
@@ -318,26 +354,41 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM art WHERE media_id=old.idEpisode AND media_type='episode'; "
               "DELETE FROM rating WHERE media_id=old.idEpisode AND media_type='episode'; "
               "DELETE FROM uniqueid WHERE media_id=old.idEpisode AND media_type='episode'; "
+              "UPDATE changecount SET iChanges = iChanges + 1; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_season AFTER DELETE ON seasons FOR EACH ROW BEGIN "
               "DELETE FROM art WHERE media_id=old.idSeason AND media_type='season'; "
+              "UPDATE changecount SET iChanges = iChanges + 1; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_set AFTER DELETE ON sets FOR EACH ROW BEGIN "
               "DELETE FROM art WHERE media_id=old.idSet AND media_type='set'; "
+              "UPDATE changecount SET iChanges = iChanges + 1; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_person AFTER DELETE ON actor FOR EACH ROW BEGIN "
               "DELETE FROM art WHERE media_id=old.actor_id AND media_type IN ('actor','artist','writer','director'); "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_tag AFTER DELETE ON tag_link FOR EACH ROW BEGIN "
               "DELETE FROM tag WHERE tag_id=old.tag_id AND tag_id NOT IN (SELECT DISTINCT tag_id FROM tag_link); "
+              "UPDATE changecount SET iChanges = iChanges + 1; "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_file AFTER DELETE ON files FOR EACH ROW BEGIN "
               "DELETE FROM bookmark WHERE idFile=old.idFile; "
               "DELETE FROM settings WHERE idFile=old.idFile; "
               "DELETE FROM stacktimes WHERE idFile=old.idFile; "
               "DELETE FROM streamdetails WHERE idFile=old.idFile; "
+              "UPDATE changecount SET iChanges = iChanges + 1; "
               "END");
 
+  // the cached items of smart playlists are outdated by changes of these, the delete
+  // triggers above count the deletes of their tables
+  for (const char* table : {"movie", "tvshow", "seasons", "episode", "musicvideo", "sets", "files",
+                            "tag_link"})
+    CreateChangeCountTriggers(table, {"INSERT", "UPDATE"});
+  for (const char* table : {"bookmark", "streamdetails", "rating", "uniqueid", "actor_link",
+                            "director_link", "writer_link", "genre_link", "country_link",
+                            "studio_link"})
+    CreateChangeCountTriggers(table);
+
   CreateViews();
 }
 
@@ -4754,6 +4805,80 @@ bool CVideoDatabase::GetArtTypes(const MediaType &mediaType, std::vector<std::st
   return false;
 }
 
+bool CVideoDatabase::GetArtURLs(std::vector<std::string> &urls)
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    int numRows = RunQuery("SELECT DISTINCT url FROM art");
+    if (numRows <= 0)
+      return numRows == 0;
+
+    urls.reserve(urls.size() + numRows);
+    while (!m_pDS->eof())
+    {
+      urls.emplace_back(m_pDS->fv(0).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CVideoDatabase::GetItemsWithoutArt(CFileItemList &items)
+{
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    const std::pair<MediaType, const char*> tables[] = {
+        {MediaTypeMovie, "idMovie"}, {MediaTypeEpisode, "idEpisode"}, {MediaTypeMusicVideo, "idMVideo"}};
+    for (const auto& table : tables)
+    {
+      std::string sql = PrepareSQL("SELECT %s, idFile, strPath, strFileName FROM %s_view "
+                                   "WHERE NOT EXISTS (SELECT 1 FROM art WHERE art.media_id = %s_view.%s AND art.media_type = '%s')",
+                                   table.second, table.first.c_str(), table.first.c_str(),
+                                   table.second, table.first.c_str());
+      if (RunQuery(sql) < 0)
+        return false;
+
+      while (!m_pDS->eof())
+      {
+        std::string path;
+        ConstructPath(path, m_pDS->fv(2).get_asString(), m_pDS->fv(3).get_asString());
+
+        CFileItemPtr item(new CFileItem(path, false));
+        CVideoInfoTag* tag = item->GetVideoInfoTag();
+        tag->m_iDbId = m_pDS->fv(0).get_asInt();
+        tag->m_iFileId = m_pDS->fv(1).get_asInt();
+        tag->m_type = table.first;
+        tag->m_strFileNameAndPath = path;
+        items.Add(item);
+        m_pDS->next();
+      }
+      m_pDS->close();
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
 namespace
 {
 std::vector<std::string> GetBasicItemAvailableArtTypes(int mediaId,
@@ -5666,11 +5791,14 @@ void CVideoDatabase::UpdateTables(int iVersion)
     }
     m_pDS->close();
   }
+
+  if (iVersion < 119)
+    CreateChangeCountTable();
 }
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 117;
+  return 119;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -7258,9 +7386,16 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     if (!CDatabase::BuildSQL(strSQLExtra, extFilter, strSQLExtra))
       return false;
 
+    // Sort directly here if the sort is by columns of the view, the rows are taken as they are
+    std::string order;
+    const bool sortedInSQL = extFilter.order.empty() && extFilter.limit.empty() &&
+                             GetOrderClause(MediaTypeMovie, sorting, order);
+    if (sortedInSQL)
+      strSQLExtra += " ORDER BY " + order;
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
-        sorting.sortBy == SortByNone &&
+        (sorting.sortBy == SortByNone || sortedInSQL) &&
        (sorting.limitStart > 0 || sorting.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
@@ -7281,7 +7416,7 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     DatabaseResults results;
     results.reserve(iRowsFound);
 
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeMovie, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortedInSQL ? GetSortAfterOrderClause(sorting) : sortDescription, MediaTypeMovie, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -7369,9 +7504,16 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
     if (!BuildSQL(strBaseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
+    // Sort directly here if the sort is by columns of the view, the rows are taken as they are
+    std::string order;
+    const bool sortedInSQL = extFilter.order.empty() && extFilter.limit.empty() &&
+                             GetOrderClause(MediaTypeTvShow, sorting, order);
+    if (sortedInSQL)
+      strSQLExtra += " ORDER BY " + order;
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
-        sorting.sortBy == SortByNone &&
+        (sorting.sortBy == SortByNone || sortedInSQL) &&
         (sorting.limitStart > 0 || sorting.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
@@ -7391,7 +7533,7 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
 
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeTvShow, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortedInSQL ? GetSortAfterOrderClause(sorting) : sorting, MediaTypeTvShow, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -7497,9 +7639,16 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
     if (!BuildSQL(strBaseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
+    // Sort directly here if the sort is by columns of the view, the rows are taken as they are
+    std::string order;
+    const bool sortedInSQL = extFilter.order.empty() && extFilter.limit.empty() &&
+                             GetOrderClause(MediaTypeEpisode, sorting, order);
+    if (sortedInSQL)
+      strSQLExtra += " ORDER BY " + order;
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
-      sorting.sortBy == SortByNone &&
+      (sorting.sortBy == SortByNone || sortedInSQL) &&
       (sorting.limitStart > 0 || sorting.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
@@ -7519,7 +7668,7 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
 
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeEpisode, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortedInSQL ? GetSortAfterOrderClause(sorting) : sorting, MediaTypeEpisode, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -7954,6 +8103,55 @@ std::string CVideoDatabase::GetContentForPath(const std::string& strPath)
   return "";
 }
 
+CDatabase::Filter CVideoDatabase::GetSearchFilter(const FullTextIndex& index,
+                                                  const std::string& strSearch,
+                                                  std::string* score /* = nullptr */)
+{
+  Filter filter;
+  if (GetFullTextFilter(index, strSearch, filter, score))
+  {
+    if (score)
+      *score = ", " + *score;
+    return filter;
+  }
+
+  if (score)
+    score->clear();
+
+  // too short for the index or no index, match anywhere in the columns
+  for (const auto& column : index.columns)
+    filter.AppendWhere(PrepareSQL("%s.%s LIKE '%%%s%%'", index.table.c_str(), column.c_str(),
+                                  strSearch.c_str()), false);
+  return filter;
+}
+
+bool CVideoDatabase::GetOrderClause(const MediaType& mediaType, const SortDescription& sorting, std::string& order) const
+{
+  if (sorting.sortBy == SortByNone)
+    return false;
+
+  if (sorting.sortBy == SortByRandom && sorting.randomSeed == 0)
+  {
+    order = PrepareSQL("RANDOM()");
+    return true;
+  }
+
+  return DatabaseUtils::BuildOrderClause(mediaType, sorting, order);
+}
+
+SortDescription CVideoDatabase::GetSortAfterOrderClause(const SortDescription& sorting)
+{
+  // a shuffle is kept as it is, the limit was applied already
+  SortDescription result;
+  if (sorting.sortBy != SortByRandom)
+  {
+    result = sorting;
+    result.limitStart = 0;
+    result.limitEnd = -1;
+  }
+  return result;
+}
+
 void CVideoDatabase::GetMovieGenresByName(const std::string& strSearch, CFileItemList& items)
 {
   std::string strSQL;
@@ -7996,6 +8194,51 @@ void CVideoDatabase::GetMovieGenresByName(const std::string& strSearch, CFileIte
   }
 }
 
+void CVideoDatabase::GetMovieTagsByName(const std::string& strSearch, CFileItemList& items)
+{
+  std::string strSQL;
+
+  try
+  {
+    if (nullptr == m_pDB)
+      return;
+    if (nullptr == m_pDS)
+      return;
+
+    std::string score;
+    Filter filter = GetSearchFilter(TagSearchIndex, strSearch, &score);
+    filter.AppendWhere("tag_link.media_type='movie'");
+    if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
+      BuildSQL("SELECT tag.tag_id, tag.name, path.strPath" + score + " FROM tag INNER JOIN tag_link ON tag_link.tag_id=tag.tag_id INNER JOIN movie ON tag_link.media_id=movie.idMovie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath ", filter, strSQL);
+    else
+      BuildSQL("SELECT DISTINCT tag.tag_id, tag.name" + score + " FROM tag INNER JOIN tag_link ON tag_link.tag_id=tag.tag_id ", filter, strSQL);
+    m_pDS->query( strSQL );
+
+    while (!m_pDS->eof())
+    {
+      if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
+        if (!g_passwordManager.IsDatabasePathUnlocked(m_pDS->fv("path.strPath").get_asString(),
+                                                      *CMediaSourceSettings::GetInstance().GetSources("video")))
+        {
+          m_pDS->next();
+          continue;
+        }
+
+      CFileItemPtr pItem(new CFileItem(m_pDS->fv(1).get_asString()));
+      std::string strDir = StringUtils::Format("%i/", m_pDS->fv(0).get_asInt());
+      pItem->SetPath("videodb://movies/tags/"+ strDir);
+      pItem->m_bIsFolder=true;
+      items.Add(pItem);
+      m_pDS->next();
+    }
+    m_pDS->close();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, strSQL.c_str());
+  }
+}
+
 void CVideoDatabase::GetMovieCountriesByName(const std::string& strSearch, CFileItemList& items)
 {
   std::string strSQL;
@@ -8090,10 +8333,13 @@ void CVideoDatabase::GetMovieActorsByName(const std::string& strSearch, CFileIte
     if (nullptr == m_pDS)
       return;
 
+    std::string score;
+    Filter filter = GetSearchFilter(ActorSearchIndex, strSearch, &score);
+    filter.AppendWhere("actor_link.media_type='movie'");
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL=PrepareSQL("SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN movie ON actor_link.media_id=movie.idMovie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor_link.media_type='movie' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      BuildSQL("SELECT actor.actor_id, actor.name, path.strPath" + score + " FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN movie ON actor_link.media_id=movie.idMovie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath ", filter, strSQL);
     else
-      strSQL=PrepareSQL("SELECT DISTINCT actor.actor_id, actor.name FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN movie ON actor_link.media_id=movie.idMovie WHERE actor_link.media_type='movie' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      BuildSQL("SELECT DISTINCT actor.actor_id, actor.name" + score + " FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN movie ON actor_link.media_id=movie.idMovie ", filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8131,10 +8377,13 @@ void CVideoDatabase::GetTvShowsActorsByName(const std::string& strSearch, CFileI
     if (nullptr == m_pDS)
       return;
 
+    std::string score;
+    Filter filter = GetSearchFilter(ActorSearchIndex, strSearch, &score);
+    filter.AppendWhere("actor_link.media_type='tvshow'");
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL=PrepareSQL("SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN tvshow ON actor_link.media_id=tvshow.idShow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idPath=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE actor_link.media_type='tvshow' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      BuildSQL("SELECT actor.actor_id, actor.name, path.strPath" + score + " FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN tvshow ON actor_link.media_id=tvshow.idShow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idPath=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath ", filter, strSQL);
     else
-      strSQL=PrepareSQL("SELECT DISTINCT actor.actor_id, actor.name FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN tvshow ON actor_link.media_id=tvshow.idShow WHERE actor_link.media_type='tvshow' AND actor.name LIKE '%%%s%%'",strSearch.c_str());
+      BuildSQL("SELECT DISTINCT actor.actor_id, actor.name" + score + " FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN tvshow ON actor_link.media_id=tvshow.idShow ", filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8172,13 +8421,15 @@ void CVideoDatabase::GetMusicVideoArtistsByName(const std::string& strSearch, CF
     if (nullptr == m_pDS)
       return;
 
-    std::string strLike;
+    std::string score;
+    Filter filter;
     if (!strSearch.empty())
-      strLike = "and actor.name like '%%%s%%'";
+      filter = GetSearchFilter(ActorSearchIndex, strSearch, &score);
+    filter.AppendWhere("actor_link.media_type='musicvideo'");
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL=PrepareSQL("SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN musicvideo ON actor_link.media_id=musicvideo.idMVideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor_link.media_type='musicvideo' "+strLike, strSearch.c_str());
+      BuildSQL("SELECT actor.actor_id, actor.name, path.strPath" + score + " FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN musicvideo ON actor_link.media_id=musicvideo.idMVideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath ", filter, strSQL);
     else
-      strSQL=PrepareSQL("SELECT DISTINCT actor.actor_id, actor.name from actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id WHERE actor_link.media_type='musicvideo' "+strLike,strSearch.c_str());
+      BuildSQL("SELECT DISTINCT actor.actor_id, actor.name" + score + " from actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id ", filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8366,9 +8617,16 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
     if (!BuildSQL(baseDir, strSQLExtra, extFilter, strSQLExtra, videoUrl, sorting))
       return false;
 
+    // Sort directly here if the sort is by columns of the view, the rows are taken as they are
+    std::string order;
+    const bool sortedInSQL = extFilter.order.empty() && extFilter.limit.empty() &&
+                             GetOrderClause(MediaTypeMusicVideo, sorting, order);
+    if (sortedInSQL)
+      strSQLExtra += " ORDER BY " + order;
+
     // Apply the limiting directly here if there's no special sorting but limiting
     if (extFilter.limit.empty() &&
-      sorting.sortBy == SortByNone &&
+      (sorting.sortBy == SortByNone || sortedInSQL) &&
       (sorting.limitStart > 0 || sorting.limitEnd > 0))
     {
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
@@ -8388,7 +8646,7 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
 
     DatabaseResults results;
     results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeMusicVideo, m_pDS, results))
+    if (!SortUtils::SortFromDataset(sortedInSQL ? GetSortAfterOrderClause(sorting) : sorting, MediaTypeMusicVideo, m_pDS, results))
       return false;
 
     // get data from returned rows
@@ -8522,10 +8780,11 @@ void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList
     if (nullptr == m_pDS)
       return;
 
+    Filter filter = GetSearchFilter(MovieTitleSearchIndex, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath ", VIDEODB_ID_TITLE), filter, strSQL);
     else
-      strSQL = PrepareSQL("select movie.idMovie,movie.c%02d, movie.idSet from movie where movie.c%02d like '%%%s%%'",VIDEODB_ID_TITLE,VIDEODB_ID_TITLE,strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT movie.idMovie, movie.c%02d, movie.idSet FROM movie ", VIDEODB_ID_TITLE), filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8569,10 +8828,11 @@ void CVideoDatabase::GetTvShowsByName(const std::string& strSearch, CFileItemLis
     if (nullptr == m_pDS)
       return;
 
+    Filter filter = GetSearchFilter(TvShowTitleSearchIndex, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, VIDEODB_ID_TV_TITLE, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath ", VIDEODB_ID_TV_TITLE), filter, strSQL);
     else
-      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where tvshow.c%02d like '%%%s%%'",VIDEODB_ID_TV_TITLE,VIDEODB_ID_TV_TITLE,strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d FROM tvshow ", VIDEODB_ID_TV_TITLE), filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8612,10 +8872,11 @@ void CVideoDatabase::GetEpisodesByName(const std::string& strSearch, CFileItemLi
     if (nullptr == m_pDS)
       return;
 
+    Filter filter = GetSearchFilter(EpisodeTitleSearchIndex, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE), filter, strSQL);
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d like '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE), filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8657,10 +8918,11 @@ void CVideoDatabase::GetMusicVideosByName(const std::string& strSearch, CFileIte
     if (nullptr == m_pDS)
       return;
 
+    Filter filter = GetSearchFilter(MusicVideoTitleSearchIndex, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE, VIDEODB_ID_MUSICVIDEO_TITLE, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath ", VIDEODB_ID_MUSICVIDEO_TITLE), filter, strSQL);
     else
-      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where musicvideo.c%02d like '%%%s%%'",VIDEODB_ID_MUSICVIDEO_TITLE,VIDEODB_ID_MUSICVIDEO_TITLE,strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d FROM musicvideo ", VIDEODB_ID_MUSICVIDEO_TITLE), filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8706,10 +8968,11 @@ void CVideoDatabase::GetEpisodesByPlot(const std::string& strSearch, CFileItemLi
     if (nullptr == m_pDS)
       return;
 
+    Filter filter = GetSearchFilter(EpisodePlotSearchIndex, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE), filter, strSQL);
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE), filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8747,11 +9010,11 @@ void CVideoDatabase::GetMoviesByPlot(const std::string& strSearch, CFileItemList
     if (nullptr == m_pDS)
       return;
 
+    Filter filter = GetSearchFilter(MoviePlotSearchIndex, strSearch);
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE,VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE,strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath ", VIDEODB_ID_TITLE), filter, strSQL);
     else
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE (movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_TITLE, VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str());
-
+      BuildSQL(PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie ", VIDEODB_ID_TITLE), filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8791,11 +9054,13 @@ void CVideoDatabase::GetMovieDirectorsByName(const std::string& strSearch, CFile
     if (nullptr == m_pDS)
       return;
 
+    std::string score;
+    Filter filter = GetSearchFilter(ActorSearchIndex, strSearch, &score);
+    filter.AppendWhere("director_link.media_type='movie'");
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM movie INNER JOIN director_link ON (director_link.media_id=movie.idMovie AND director_link.media_type='movie') INNER JOIN actor ON actor.actor_id=director_link.actor_id INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor.name LIKE '%%%s%%'", strSearch.c_str());
+      BuildSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath" + score + " FROM movie INNER JOIN director_link ON director_link.media_id=movie.idMovie INNER JOIN actor ON actor.actor_id=director_link.actor_id INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath ", filter, strSQL);
     else
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN movie ON director_link.media_id=movie.idMovie WHERE director_link.media_type='movie' AND actor.name like '%%%s%%'", strSearch.c_str());
-
+      BuildSQL("SELECT DISTINCT director_link.actor_id, actor.name" + score + " FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN movie ON director_link.media_id=movie.idMovie ", filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8834,11 +9099,13 @@ void CVideoDatabase::GetTvShowsDirectorsByName(const std::string& strSearch, CFi
     if (nullptr == m_pDS)
       return;
 
+    std::string score;
+    Filter filter = GetSearchFilter(ActorSearchIndex, strSearch, &score);
+    filter.AppendWhere("director_link.media_type='tvshow'");
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN tvshow ON director_link.media_id=tvshow.idShow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE director_link.media_type='tvshow' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      BuildSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath" + score + " FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN tvshow ON director_link.media_id=tvshow.idShow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath ", filter, strSQL);
     else
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN tvshow ON director_link.media_id=tvshow.idShow WHERE director_link.media_type='tvshow' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
-
+      BuildSQL("SELECT DISTINCT director_link.actor_id, actor.name" + score + " FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN tvshow ON director_link.media_id=tvshow.idShow ", filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8877,11 +9144,13 @@ void CVideoDatabase::GetMusicVideoDirectorsByName(const std::string& strSearch,
     if (nullptr == m_pDS)
       return;
 
+    std::string score;
+    Filter filter = GetSearchFilter(ActorSearchIndex, strSearch, &score);
+    filter.AppendWhere("director_link.media_type='musicvideo'");
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN musicvideo ON director_link.media_id=musicvideo.idMVideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE director_link.media_type='musicvideo' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      BuildSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath" + score + " FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN musicvideo ON director_link.media_id=musicvideo.idMVideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath ", filter, strSQL);
     else
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN musicvideo ON director_link.media_id=musicvideo.idMVideo WHERE director_link.media_type='musicvideo' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
-
+      BuildSQL("SELECT DISTINCT director_link.actor_id, actor.name" + score + " FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN musicvideo ON director_link.media_id=musicvideo.idMVideo ", filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8909,7 +9178,7 @@ void CVideoDatabase::GetMusicVideoDirectorsByName(const std::string& strSearch,
   }
 }
 
-void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const std::set<int>& paths, bool showProgress)
+void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const std::set<int>& paths, bool showProgress, bool dryRun /* = false */)
 {
   CGUIDialogProgress *progress=NULL;
   try
@@ -8922,10 +9191,9 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
       return;
 
     unsigned int time = XbmcThreads::SystemClockMillis();
-    CLog::Log(LOGINFO, "%s: Starting videodatabase cleanup ..", __FUNCTION__);
-    CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnCleanStarted");
-
-    BeginTransaction();
+    CLog::Log(LOGINFO, "%s: Starting videodatabase cleanup%s ..", __FUNCTION__, dryRun ? " dry run" : "");
+    if (!dryRun)
+      CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnCleanStarted");
 
     // find all the files
     std::string sql = "SELECT files.idFile, files.strFileName, path.strPath FROM files INNER JOIN path ON path.idPath=files.idPath";
@@ -8937,9 +9205,6 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
       sql += PrepareSQL(" AND path.idPath IN (%s)", strPaths.substr(1).c_str());
     }
 
-    // For directory caching to work properly, we need to sort the files by path
-    sql += " ORDER BY path.strPath";
-
     m_pDS2->query(sql);
     if (m_pDS2->num_rows() == 0) return;
 
@@ -8967,10 +9232,10 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
     VECSOURCES videoSources(*CMediaSourceSettings::GetInstance().GetSources("video"));
     CServiceBroker::GetMediaManager().GetRemovableDrives(videoSources);
 
-    int total = m_pDS2->num_rows();
-    int current = 0;
-    std::string lastDir;
-    bool gotDir = true;
+    // the files on sources are checked together, a folder at a time
+    CExistenceChecker checker;
+    std::vector<std::pair<std::string, std::string>> filesToCheck;
+    std::vector<std::string> filesMissing;
 
     while (!m_pDS2->eof())
     {
@@ -9003,48 +9268,73 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
         if (!URIUtils::IsOnDVD(fullPath) &&
             CUtil::GetMatchingSource(fullPath, videoSources, bIsSource) >= 0)
         {
-          const std::string pathDir = URIUtils::GetDirectory(fullPath);
-
-          // Cache file's directory in case it's different from the previous file
-          if (lastDir != pathDir)
-          {
-            lastDir = pathDir;
-            CFileItemList items; // Dummy list
-            gotDir = CDirectory::GetDirectory(pathDir, items, "", DIR_FLAG_NO_FILE_DIRS |
-                                              DIR_FLAG_NO_FILE_INFO);
-          }
-
-          // Keep existing files
-          if (gotDir && CFile::Exists(fullPath, true))
-            del = false;
+          checker.Add(fullPath);
+          filesToCheck.emplace_back(m_pDS2->fv("files.idFile").get_asString(), fullPath);
+          del = false;
         }
       }
       if (del)
+      {
         filesToTestForDelete += m_pDS2->fv("files.idFile").get_asString() + ",";
+        filesMissing.push_back(fullPath);
+      }
+
+      m_pDS2->next();
+    }
+    m_pDS2->close();
 
+    const bool completed = checker.Check([handle, progress](unsigned int done, unsigned int total) {
       if (handle == NULL && progress != NULL)
       {
-        int percentage = current * 100 / total;
+        int percentage = done * 100 / total;
         if (percentage > progress->GetPercentage())
         {
           progress->SetPercentage(percentage);
           progress->Progress();
         }
-        if (progress->IsCanceled())
-        {
-          progress->Close();
-          m_pDS2->close();
-          CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnCleanFinished");
-          return;
-        }
+        return !progress->IsCanceled();
       }
       else if (handle != NULL)
-        handle->SetPercentage(current * 100 / (float)total);
+        handle->SetPercentage(done * 100 / (float)total);
+      return true;
+    });
+    if (!completed)
+    {
+      if (progress)
+        progress->Close();
+      if (!dryRun)
+        CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnCleanFinished");
+      return;
+    }
 
-      m_pDS2->next();
-      current++;
+    for (const auto& file : filesToCheck)
+    {
+      if (!checker.Exists(file.second))
+      {
+        filesToTestForDelete += file.first + ",";
+        filesMissing.push_back(file.second);
+      }
     }
-    m_pDS2->close();
+
+    const CExistenceChecker::Stats& stats = checker.GetStats();
+    CLog::Log(LOGINFO, "%s: checked %u files in %u folders (%u checked on their own) in %u ms, %u files missing",
+              __FUNCTION__, stats.paths, stats.listings, stats.fallbacks, stats.elapsedMs,
+              static_cast<unsigned int>(filesMissing.size()));
+
+    if (dryRun)
+    {
+      // only report the files that no longer exist, everything else follows from removing them
+      for (const auto& file : filesMissing)
+        CLog::Log(LOGINFO, "%s: would remove %s", __FUNCTION__, CURL::GetRedacted(file).c_str());
+      if (progress)
+        progress->Close();
+      time = XbmcThreads::SystemClockMillis() - time;
+      CLog::Log(LOGINFO, "%s: Cleanup dry run of videodatabase done. Operation took %s", __FUNCTION__,
+                StringUtils::SecondsToTimeString(time / 1000).c_str());
+      return;
+    }
+
+    BeginTransaction();
 
     std::string filesToDelete;
 
@@ -9135,40 +9425,53 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
                    "AND (strHash IS NULL OR strHash = '') "
                    "AND (exclude IS NULL OR exclude != 1))";
     m_pDS2->query(sql);
-    std::string strIds;
+    struct ContentPath
+    {
+      int id;
+      int idParent;
+      std::string path;
+      bool exists;
+    };
+    std::vector<ContentPath> contentPaths;
+    CExistenceChecker pathChecker;
     while (!m_pDS2->eof())
     {
-      auto pathsDeleteDecision = pathsDeleteDecisions.find(m_pDS2->fv(0).get_asInt());
-      // Check if we have a decision for the parent path
-      auto pathsDeleteDecisionByParent = pathsDeleteDecisions.find(m_pDS2->fv(2).get_asInt());
-      std::string path = m_pDS2->fv(1).get_asString();
-
-      bool exists = false;
-      if (URIUtils::IsPlugin(path))
+      ContentPath path{m_pDS2->fv(0).get_asInt(), m_pDS2->fv(2).get_asInt(), m_pDS2->fv(1).get_asString(), false};
+      if (URIUtils::IsPlugin(path.path))
       {
         SScanSettings settings;
         bool foundDirectly = false;
-        ScraperPtr scraper = GetScraperForPath(path, settings, foundDirectly);
-        if (scraper && CPluginDirectory::CheckExists(TranslateContent(scraper->Content()), path))
-          exists = true;
+        ScraperPtr scraper = GetScraperForPath(path.path, settings, foundDirectly);
+        if (scraper && CPluginDirectory::CheckExists(TranslateContent(scraper->Content()), path.path))
+          path.exists = true;
       }
       else
-        exists = CDirectory::Exists(path, false);
+        pathChecker.Add(path.path);
+      contentPaths.push_back(std::move(path));
+
+      m_pDS2->next();
+    }
+    m_pDS2->close();
+    pathChecker.Check();
+
+    std::vector<int> pathIds;
+    for (const auto& path : contentPaths)
+    {
+      auto pathsDeleteDecision = pathsDeleteDecisions.find(path.id);
+      // Check if we have a decision for the parent path
+      auto pathsDeleteDecisionByParent = pathsDeleteDecisions.find(path.idParent);
+      const bool exists = path.exists || (!URIUtils::IsPlugin(path.path) && pathChecker.Exists(path.path));
 
       if (((pathsDeleteDecision != pathsDeleteDecisions.end() && pathsDeleteDecision->second) ||
            (pathsDeleteDecision == pathsDeleteDecisions.end() && !exists)) &&
           ((pathsDeleteDecisionByParent != pathsDeleteDecisions.end() && pathsDeleteDecisionByParent->second) ||
            (pathsDeleteDecisionByParent == pathsDeleteDecisions.end())))
-        strIds += m_pDS2->fv(0).get_asString() + ",";
-
-      m_pDS2->next();
+        pathIds.push_back(path.id);
     }
-    m_pDS2->close();
 
-    if (!strIds.empty())
+    if (!pathIds.empty())
     {
-      sql = PrepareSQL("DELETE FROM path WHERE idPath IN (%s)", StringUtils::TrimRight(strIds, ",").c_str());
-      m_pDS->exec(sql);
+      DeleteByIds("path", "idPath", pathIds);
       sql = "DELETE FROM tvshowlinkpath WHERE NOT EXISTS (SELECT 1 FROM path WHERE path.idPath = tvshowlinkpath.idPath)";
       m_pDS->exec(sql);
     }
@@ -10681,6 +10984,8 @@ bool CVideoDatabase::GetFilter(CDbUrl &videoUrl, Filter &filter, SortDescription
         sorting.limitEnd = xsp.GetLimit();
       if (xsp.GetOrder() != SortByNone)
         sorting.sortBy = xsp.GetOrder();
+      if (xsp.GetOrderSeed() > 0)
+        sorting.randomSeed = xsp.GetOrderSeed();
       if (xsp.GetOrderDirection() != SortOrderNone)
         sorting.sortOrder = xsp.GetOrderDirection();
       if (CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_FILELISTS_IGNORETHEWHENSORTING))
@@ -703,6 +703,8 @@ public:
 
   void GetMovieCountriesByName(const std::string& strSearch, CFileItemList& items);
 
+  void GetMovieTagsByName(const std::string& strSearch, CFileItemList& items);
+
   void GetMusicVideoAlbumsByName(const std::string& strSearch, CFileItemList& items);
 
   void GetMovieActorsByName(const std::string& strSearch, CFileItemList& items);
@@ -752,7 +754,13 @@ public:
   bool HasContent(VIDEODB_CONTENT_TYPE type);
   bool HasSets() const;
 
-  void CleanDatabase(CGUIDialogProgressBarHandle* handle = NULL, const std::set<int>& paths = std::set<int>(), bool showProgress = true);
+  /*! \brief Remove the files that no longer exist and everything only used by them
+   \param handle progress bar to report progress to (optional)
+   \param paths ids of the paths to clean, all paths if empty
+   \param showProgress whether to show a progress dialog if there is no progress bar
+   \param dryRun only log the files that would be removed, the database isn't changed
+   */
+  void CleanDatabase(CGUIDialogProgressBarHandle* handle = NULL, const std::set<int>& paths = std::set<int>(), bool showProgress = true, bool dryRun = false);
 
   /*! \brief Add a file to the database, if necessary
    If the file is already in the database, we simply return its id.
@@ -849,6 +857,18 @@ public:
   bool GetTvShowSeasonArt(int mediaId, std::map<int, std::map<std::string, std::string> > &seasonArt);
   bool GetArtTypes(const MediaType &mediaType, std::vector<std::string> &artTypes);
 
+  /*! \brief Fetch the urls of all art held in the database
+   \param urls [out] the distinct art urls
+   \return true if the query succeeded, false otherwise
+   */
+  bool GetArtURLs(std::vector<std::string> &urls);
+
+  /*! \brief Fetch the movies, episodes and music videos that have no art at all
+   \param items [out] the items, with path, file id, db id and type set in the video info tag
+   \return true if the query succeeded, false otherwise
+   */
+  bool GetItemsWithoutArt(CFileItemList &items);
+
   /*! \brief Fetch the distinct types of available-but-unassigned art held in the
   database for a specific media item.
   \param mediaId the id in the media table.
@@ -977,6 +997,29 @@ private:
    */
   int RunQuery(const std::string &sql);
 
+  /*! \brief Filter for the rows of the table of a full text index matching a search
+   Uses the index if possible, otherwise a LIKE on its columns.
+   \param index the full text index of the searched columns
+   \param strSearch the search string entered by the user
+   \param score if not null, set to the score to append to the selected fields, empty without the index
+   \return the filter, to be built on a query on the table of the index
+   */
+  Filter GetSearchFilter(const FullTextIndex& index,
+                         const std::string& strSearch,
+                         std::string* score = nullptr);
+
+  /*! \brief Get the ORDER BY clause if the items can be sorted in SQL
+   Sorting and limiting in SQL saves retrieving all items, e.g. for the recently
+   added movies of a smart playlist.
+   \return false if the items have to be sorted in memory
+   */
+  bool GetOrderClause(const MediaType& mediaType, const SortDescription& sorting, std::string& order) const;
+
+  /*! \brief Get the sort in memory of rows that were sorted and limited in SQL
+   The rows are sorted once more for the tie-break by label of the sort in memory.
+   */
+  static SortDescription GetSortAfterOrderClause(const SortDescription& sorting);
+
   void AppendIdLinkFilter(const char* field, const char *table, const MediaType& mediaType, const char *view, const char *viewKey, const CUrlOptions::UrlOptions& options, Filter &filter);
   void AppendLinkFilter(const char* field, const char *table, const MediaType& mediaType, const char *view, const char *viewKey, const CUrlOptions::UrlOptions& options, Filter &filter);
 
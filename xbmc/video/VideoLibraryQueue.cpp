@@ -80,9 +80,9 @@ void CVideoLibraryQueue::StopLibraryScanning()
   Refresh();
 }
 
-void CVideoLibraryQueue::CleanLibrary(const std::set<int>& paths /* = std::set<int>() */, bool asynchronous /* = true */, CGUIDialogProgressBarHandle* progressBar /* = NULL */)
+void CVideoLibraryQueue::CleanLibrary(const std::set<int>& paths /* = std::set<int>() */, bool asynchronous /* = true */, CGUIDialogProgressBarHandle* progressBar /* = NULL */, bool dryRun /* = false */)
 {
-  CVideoLibraryCleaningJob* cleaningJob = new CVideoLibraryCleaningJob(paths, progressBar);
+  CVideoLibraryCleaningJob* cleaningJob = new CVideoLibraryCleaningJob(paths, progressBar, dryRun);
 
   if (asynchronous)
     AddJob(cleaningJob);
@@ -99,7 +99,7 @@ void CVideoLibraryQueue::CleanLibrary(const std::set<int>& paths /* = std::set<i
   }
 }
 
-void CVideoLibraryQueue::CleanLibraryModal(const std::set<int>& paths /* = std::set<int>() */)
+void CVideoLibraryQueue::CleanLibraryModal(const std::set<int>& paths /* = std::set<int>() */, bool dryRun /* = false */)
 {
   // we can't perform a modal library cleaning if other jobs are running
   if (IsRunning())
@@ -107,7 +107,7 @@ void CVideoLibraryQueue::CleanLibraryModal(const std::set<int>& paths /* = std::
 
   m_modal = true;
   m_cleaning = true;
-  CVideoLibraryCleaningJob cleaningJob(paths, true);
+  CVideoLibraryCleaningJob cleaningJob(paths, true, dryRun);
   cleaningJob.DoWork();
   m_cleaning = false;
   m_modal = false;
@@ -61,15 +61,17 @@ public:
    \param[in] paths Set with database IDs of paths to be cleaned
    \param[in] asynchronous Run the clean job asynchronously. Defaults to true
    \param[in] progressBar Progress bar to update in GUI. Defaults to NULL (no progress bar to update)
+   \param[in] dryRun Only log what would be removed. Defaults to false
    */
-  void CleanLibrary(const std::set<int>& paths = std::set<int>(), bool asynchronous = true, CGUIDialogProgressBarHandle* progressBar = NULL);
+  void CleanLibrary(const std::set<int>& paths = std::set<int>(), bool asynchronous = true, CGUIDialogProgressBarHandle* progressBar = NULL, bool dryRun = false);
 
   /*!
   \brief Executes a library cleaning with a modal dialog.
 
   \param[in] paths Set with database IDs of paths to be cleaned
+  \param[in] dryRun Only log what would be removed. Defaults to false
   */
-  void CleanLibraryModal(const std::set<int>& paths = std::set<int>());
+  void CleanLibraryModal(const std::set<int>& paths = std::set<int>(), bool dryRun = false);
 
   /*!
    \brief Enqueues a job to refresh the details of the given item.
@@ -0,0 +1,264 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoThumbBatchJob.h"
+
+#include "ServiceBroker.h"
+#include "TextureCache.h"
+#include "URL.h"
+#include "cores/VideoPlayer/DVDThumbExtractor.h"
+#include "dialogs/GUIDialogExtendedProgressBar.h"
+#include "filesystem/File.h"
+#include "filesystem/StackDirectory.h"
+#include "guilib/GUIComponent.h"
+#include "guilib/GUIWindowManager.h"
+#include "guilib/LocalizeStrings.h"
+#include "threads/SingleLock.h"
+#include "utils/Stopwatch.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#include "video/VideoDatabase.h"
+#include "video/VideoInfoTag.h"
+#include "video/VideoThumbLoader.h"
+
+namespace
+{
+CActiveBatchJob<CVideoThumbBatchJob> activeRun;
+}
+
+std::unique_ptr<CDVDThumbExtractor> CVideoThumbBatchJob::CExtractorPool::Acquire()
+{
+  CSingleLock lock(m_section);
+  if (m_extractors.empty())
+    return std::unique_ptr<CDVDThumbExtractor>(new CDVDThumbExtractor());
+
+  std::unique_ptr<CDVDThumbExtractor> extractor = std::move(m_extractors.back());
+  m_extractors.pop_back();
+  return extractor;
+}
+
+void CVideoThumbBatchJob::CExtractorPool::Release(std::unique_ptr<CDVDThumbExtractor> extractor)
+{
+  CSingleLock lock(m_section);
+  m_extractors.push_back(std::move(extractor));
+}
+
+CVideoThumbBatchJob::CFileJob::CFileJob(std::shared_ptr<CBatchQueue> queue,
+                                        std::shared_ptr<CExtractorPool> pool,
+                                        CFileItemPtr item,
+                                        bool chapters)
+  : m_queue(std::move(queue)),
+    m_pool(std::move(pool)),
+    m_item(std::move(item)),
+    m_chapters(chapters)
+{
+}
+
+bool CVideoThumbBatchJob::CFileJob::DoWork()
+{
+  if (m_queue->IsAborted() || !CThumbExtractor::IsExtractable(*m_item))
+    return false;
+
+  const std::string target = CVideoThumbLoader::GetEmbeddedThumbURL(*m_item);
+  std::string path = m_item->GetPath();
+  if (m_item->HasVideoInfoTag() && !m_item->GetVideoInfoTag()->m_strFileNameAndPath.empty())
+    path = m_item->GetVideoInfoTag()->m_strFileNameAndPath;
+  const bool stack = URIUtils::IsStack(path);
+
+  CFileItem item(*m_item);
+  item.SetPath(stack ? XFILE::CStackDirectory::GetFirstStackedFile(path) : path);
+
+  std::unique_ptr<CDVDThumbExtractor> extractor = m_pool->Acquire();
+  if (extractor->Open(item))
+  {
+    CTextureDetails details;
+    details.file = CTextureCache::GetCacheFile(target) + ".jpg";
+    if (extractor->Extract(-1, details))
+    {
+      CTextureCache::GetInstance().AddCachedTexture(target, details);
+      m_extracted = true;
+    }
+
+    // same paths as the bookmarks dialog uses, a part of a stack has its own chapters
+    if (m_chapters && !stack)
+    {
+      for (int i = 1; i <= extractor->GetChapterCount() && !m_queue->IsAborted(); i++)
+      {
+        const std::string chapterPath = StringUtils::Format("chapter://%s/%i", path.c_str(), i);
+        CTextureDetails chapter;
+        chapter.file = CTextureCache::GetCacheFile(chapterPath) + ".jpg";
+        if (XFILE::CFile::Exists(CTextureCache::GetCachedPath(chapter.file)))
+          continue;
+
+        if (extractor->Extract(extractor->GetChapterPos(i), chapter))
+        {
+          CTextureCache::GetInstance().AddCachedTexture(chapterPath, chapter);
+          m_chapterThumbs++;
+        }
+      }
+    }
+    extractor->Close();
+  }
+  m_pool->Release(std::move(extractor));
+
+  if (!m_extracted)
+  {
+    CLog::Log(LOGDEBUG, "%s - no thumb extracted from %s", __FUNCTION__, CURL::GetRedacted(path).c_str());
+    return false;
+  }
+
+  CVideoInfoTag* info = m_item->HasVideoInfoTag() ? m_item->GetVideoInfoTag() : nullptr;
+  if (info && info->m_iDbId > 0 && !info->m_type.empty())
+  {
+    CVideoDatabase db;
+    if (db.Open())
+    {
+      db.SetArtForItem(info->m_iDbId, info->m_type, "thumb", target);
+      db.Close();
+    }
+  }
+  return true;
+}
+
+void CVideoThumbBatchJob::CBatchQueue::OnResult(CJob* job, bool success)
+{
+  const CFileJob* fileJob = static_cast<const CFileJob*>(job);
+  CSingleLock lock(m_resultSection);
+  if (fileJob->m_extracted)
+    m_extracted++;
+  m_chapterThumbs += fileJob->m_chapterThumbs;
+}
+
+CVideoThumbBatchJob::CVideoThumbBatchJob(std::vector<CFileItemPtr> items,
+                                         bool chapters,
+                                         unsigned int parallelism,
+                                         CGUIDialogProgressBarHandle* progressBar /* = nullptr */)
+  : CProgressJob(progressBar),
+    m_items(std::move(items)),
+    m_chapters(chapters),
+    m_parallelism(parallelism > 0 ? parallelism : DefaultParallelism),
+    m_pool(std::make_shared<CExtractorPool>()),
+    m_queue(std::make_shared<CBatchQueue>(m_parallelism))
+{
+}
+
+CVideoThumbBatchJob::~CVideoThumbBatchJob()
+{
+  activeRun.Remove(this);
+}
+
+bool CVideoThumbBatchJob::operator==(const CJob* job) const
+{
+  // only a single run at a time
+  return strcmp(job->GetType(), GetType()) == 0;
+}
+
+bool CVideoThumbBatchJob::ExtractLibraryThumbs(bool chapters, unsigned int parallelism, bool showProgress)
+{
+  if (activeRun.IsActive())
+    return false;
+
+  CFileItemList items;
+  CVideoDatabase db;
+  if (!db.Open())
+    return false;
+  db.GetItemsWithoutArt(items);
+  db.Close();
+
+  std::vector<CFileItemPtr> videos = SelectItems(items);
+
+  CGUIDialogProgressBarHandle* progressBar = nullptr;
+  if (showProgress)
+  {
+    CGUIDialogExtendedProgressBar* dialog = CServiceBroker::GetGUI()->GetWindowManager().GetWindow<CGUIDialogExtendedProgressBar>(WINDOW_DIALOG_EXT_PROGRESS);
+    if (dialog)
+      progressBar = dialog->GetHandle(g_localizeStrings.Get(39122));
+  }
+
+  return activeRun.Start(new CVideoThumbBatchJob(std::move(videos), chapters, parallelism, progressBar));
+}
+
+std::vector<CFileItemPtr> CVideoThumbBatchJob::SelectItems(const CFileItemList& items)
+{
+  std::vector<CFileItemPtr> videos;
+  videos.reserve(items.Size());
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (CThumbExtractor::IsExtractable(*items[i]))
+      videos.push_back(items[i]);
+  }
+  return videos;
+}
+
+void CVideoThumbBatchJob::CancelActive()
+{
+  activeRun.Cancel();
+}
+
+bool CVideoThumbBatchJob::IsAborted() const
+{
+  return m_cancelled || IsCancelled();
+}
+
+unsigned int CVideoThumbBatchJob::GetProcessed() const
+{
+  return m_queue->GetProcessed();
+}
+
+unsigned int CVideoThumbBatchJob::GetExtracted() const
+{
+  CSingleLock lock(m_queue->m_resultSection);
+  return m_queue->m_extracted;
+}
+
+void CVideoThumbBatchJob::UpdateProgress(unsigned int elapsedMs)
+{
+  const unsigned int processed = GetProcessed();
+  const float filesPerSecond = elapsedMs > 0 ? processed * 1000.0f / elapsedMs : 0.0f;
+  SetProgress(processed, m_items.size());
+  SetText(StringUtils::Format(g_localizeStrings.Get(39123).c_str(), processed,
+                              static_cast<unsigned int>(m_items.size()), filesPerSecond));
+}
+
+bool CVideoThumbBatchJob::DoWork()
+{
+  SetTitle(g_localizeStrings.Get(39122));
+
+  CStopWatch timer;
+  timer.StartZero();
+
+  const auto aborted = [this]() { return IsAborted(); };
+  const auto progress = [this, &timer]() {
+    UpdateProgress(static_cast<unsigned int>(timer.GetElapsedMilliseconds()));
+  };
+
+  for (const auto& item : m_items)
+  {
+    if (!m_queue->WaitForSlot(aborted))
+      break;
+    m_queue->Add(new CFileJob(m_queue, m_pool, item, m_chapters));
+    progress();
+  }
+
+  // wait for the remaining files, running ones finish early when cancelled
+  m_queue->WaitForAll(aborted, progress);
+  m_queue->Finish(IsAborted());
+
+  const unsigned int elapsedMs = static_cast<unsigned int>(timer.GetElapsedMilliseconds());
+  UpdateProgress(elapsedMs);
+
+  {
+    CSingleLock lock(m_queue->m_resultSection);
+    CLog::Log(LOGINFO, "%s - extracted %u of %u video thumbs and %u chapter thumbs in %.1fs%s",
+              __FUNCTION__, m_queue->m_extracted, static_cast<unsigned int>(m_items.size()), m_queue->m_chapterThumbs,
+              elapsedMs / 1000.0f, IsAborted() ? " (cancelled)" : "");
+  }
+
+  return !IsAborted();
+}
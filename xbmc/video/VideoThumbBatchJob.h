@@ -0,0 +1,147 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "FileItem.h"
+#include "threads/CriticalSection.h"
+#include "utils/BatchJobQueue.h"
+#include "utils/ProgressJob.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class CDVDThumbExtractor;
+class CGUIDialogProgressBarHandle;
+
+/*!
+ \ingroup thumbs,jobs
+ \brief Job for extracting thumbnails from a large number of videos
+
+ Runs a given number of files concurrently, each on a CDVDThumbExtractor taken
+ from a pool so that decoders are reused from one file to the next. Besides the
+ thumb of the video, thumbs for all chapters can be extracted, which are then
+ picked up by the bookmarks dialog.
+
+ \sa CDVDThumbExtractor, CThumbExtractor
+ */
+class CVideoThumbBatchJob : public CProgressJob
+{
+public:
+  /*!
+   \param items videos to extract thumbs from, with a video info tag for library items
+   \param chapters whether to extract chapter thumbs too
+   \param parallelism number of files processed at once, 0 for the default
+   \param progressBar progress bar to report progress to (optional)
+   */
+  CVideoThumbBatchJob(std::vector<CFileItemPtr> items,
+                      bool chapters,
+                      unsigned int parallelism,
+                      CGUIDialogProgressBarHandle* progressBar = nullptr);
+  ~CVideoThumbBatchJob() override;
+
+  const char* GetType() const override { return "extractvideothumbs"; }
+  bool operator==(const CJob* job) const override;
+  bool DoWork() override;
+
+  /*! \brief Request the job to stop after the files currently being processed
+   */
+  void Cancel() { m_cancelled = true; }
+
+  /*! \brief Number of files processed so far, whether a thumb was extracted or not
+   */
+  unsigned int GetProcessed() const;
+
+  /*! \brief Number of video thumbs extracted so far, not counting chapter thumbs
+   */
+  unsigned int GetExtracted() const;
+
+  /*! \brief Pick the videos a thumb can be extracted from
+   Streams, discs, plugins and the like are left out.
+   \param items the videos without art
+   \return the videos to process, in the same order
+   */
+  static std::vector<CFileItemPtr> SelectItems(const CFileItemList& items);
+
+  /*! \brief Extract thumbs for all library videos without any art
+   Only one run can be active at a time.
+   \return true if the run was started, false if another one is still active
+   */
+  static bool ExtractLibraryThumbs(bool chapters, unsigned int parallelism, bool showProgress);
+
+  /*! \brief Stop the active run, if any
+   */
+  static void CancelActive();
+
+  static const unsigned int DefaultParallelism = 2;
+
+private:
+  /*!
+   \brief Idle extractors, shared with the file jobs which may outlive the batch job when cancelled
+   */
+  class CExtractorPool
+  {
+  public:
+    std::unique_ptr<CDVDThumbExtractor> Acquire();
+    void Release(std::unique_ptr<CDVDThumbExtractor> extractor);
+
+  private:
+    CCriticalSection m_section;
+    std::vector<std::unique_ptr<CDVDThumbExtractor>> m_extractors;
+  };
+
+  class CBatchQueue;
+
+  class CFileJob : public CJob
+  {
+  public:
+    CFileJob(std::shared_ptr<CBatchQueue> queue,
+             std::shared_ptr<CExtractorPool> pool,
+             CFileItemPtr item,
+             bool chapters);
+    const char* GetType() const override { return "extractvideothumb"; }
+    bool operator==(const CJob* job) const override { return this == job; }
+    bool DoWork() override;
+
+    bool m_extracted = false; ///< the thumb of the video was extracted
+    unsigned int m_chapterThumbs = 0; ///< number of chapter thumbs extracted
+
+  private:
+    std::shared_ptr<CBatchQueue> m_queue;
+    std::shared_ptr<CExtractorPool> m_pool;
+    CFileItemPtr m_item;
+    bool m_chapters;
+  };
+
+  /*!
+   \brief Runs the file jobs and collects their results, shared with the file jobs
+   */
+  class CBatchQueue : public CBatchJobQueue
+  {
+  public:
+    explicit CBatchQueue(unsigned int jobsAtOnce) : CBatchJobQueue(jobsAtOnce) {}
+
+    mutable CCriticalSection m_resultSection;
+    unsigned int m_extracted = 0;
+    unsigned int m_chapterThumbs = 0;
+
+  protected:
+    void OnResult(CJob* job, bool success) override;
+  };
+
+  bool IsAborted() const;
+  void UpdateProgress(unsigned int elapsedMs);
+
+  std::vector<CFileItemPtr> m_items;
+  bool m_chapters;
+  unsigned int m_parallelism;
+  std::atomic<bool> m_cancelled{false};
+  std::shared_ptr<CExtractorPool> m_pool;
+  std::shared_ptr<CBatchQueue> m_queue;
+};
@@ -48,6 +48,12 @@ public:
 
   bool operator==(const CJob* job) const override;
 
+  /*!
+   \brief Whether thumbs and stream details can be extracted from an item.
+   Excludes live streams, discs and remote sources that are too slow to read.
+   */
+  static bool IsExtractable(const CFileItem& item);
+
   std::string m_target; ///< thumbpath
   std::string m_listpath; ///< path used in fileitem list
   CFileItem  m_item;
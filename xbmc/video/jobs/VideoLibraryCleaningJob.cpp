@@ -11,16 +11,18 @@
 #include "dialogs/GUIDialogExtendedProgressBar.h"
 #include "video/VideoDatabase.h"
 
-CVideoLibraryCleaningJob::CVideoLibraryCleaningJob(const std::set<int>& paths /* = std::set<int>() */, bool showDialog /* = false */)
+CVideoLibraryCleaningJob::CVideoLibraryCleaningJob(const std::set<int>& paths /* = std::set<int>() */, bool showDialog /* = false */, bool dryRun /* = false */)
   : CVideoLibraryProgressJob(NULL),
     m_paths(paths),
-    m_showDialog(showDialog)
+    m_showDialog(showDialog),
+    m_dryRun(dryRun)
 { }
 
-CVideoLibraryCleaningJob::CVideoLibraryCleaningJob(const std::set<int>& paths, CGUIDialogProgressBarHandle* progressBar)
+CVideoLibraryCleaningJob::CVideoLibraryCleaningJob(const std::set<int>& paths, CGUIDialogProgressBarHandle* progressBar, bool dryRun /* = false */)
   : CVideoLibraryProgressJob(progressBar),
     m_paths(paths),
-    m_showDialog(false)
+    m_showDialog(false),
+    m_dryRun(dryRun)
 { }
 
 CVideoLibraryCleaningJob::~CVideoLibraryCleaningJob() = default;
@@ -35,11 +37,12 @@ bool CVideoLibraryCleaningJob::operator==(const CJob* job) const
     return false;
 
   return m_paths == cleaningJob->m_paths &&
-         m_showDialog == cleaningJob->m_showDialog;
+         m_showDialog == cleaningJob->m_showDialog &&
+         m_dryRun == cleaningJob->m_dryRun;
 }
 
 bool CVideoLibraryCleaningJob::Work(CVideoDatabase &db)
 {
-  db.CleanDatabase(GetProgressBar(), m_paths, m_showDialog);
+  db.CleanDatabase(GetProgressBar(), m_paths, m_showDialog, m_dryRun);
   return true;
 }
@@ -25,16 +25,18 @@ public:
 
    \param[in] paths Set with database IDs of paths to be cleaned
    \param[in] showDialog Whether to show a modal dialog or not
+   \param[in] dryRun Only log what would be removed
   */
-  CVideoLibraryCleaningJob(const std::set<int>& paths = std::set<int>(), bool showDialog = false);
+  CVideoLibraryCleaningJob(const std::set<int>& paths = std::set<int>(), bool showDialog = false, bool dryRun = false);
 
   /*!
   \brief Creates a new video library cleaning job for the given paths.
 
   \param[in] paths Set with database IDs of paths to be cleaned
   \param[in] progressBar Progress bar to be used to display the cleaning progress
+  \param[in] dryRun Only log what would be removed
   */
-  CVideoLibraryCleaningJob(const std::set<int>& paths, CGUIDialogProgressBarHandle* progressBar);
+  CVideoLibraryCleaningJob(const std::set<int>& paths, CGUIDialogProgressBarHandle* progressBar, bool dryRun = false);
   ~CVideoLibraryCleaningJob() override;
 
   // specialization of CJob
@@ -48,4 +50,5 @@ protected:
 private:
   std::set<int> m_paths;
   bool m_showDialog;
+  bool m_dryRun;
 };
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "video/VideoThumbBatchJob.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// items a thumb can't be extracted from, so their file jobs finish without opening anything
+std::vector<CFileItemPtr> MakeStreams(unsigned int count)
+{
+  std::vector<CFileItemPtr> items;
+  for (unsigned int i = 0; i < count; i++)
+    items.push_back(CFileItemPtr(new CFileItem("http://example.com/video" + std::to_string(i) + ".mkv", false)));
+  return items;
+}
+} // namespace
+
+TEST(TestVideoThumbBatchJob, SelectItems)
+{
+  CFileItemList items;
+  items.Add(CFileItemPtr(new CFileItem("/videos/movie.mkv", false)));
+  items.Add(CFileItemPtr(new CFileItem("http://example.com/stream.mkv", false)));
+  items.Add(CFileItemPtr(new CFileItem("/videos/disc.iso", false)));
+  items.Add(CFileItemPtr(new CFileItem("/videos/episode.avi", false)));
+  items.Add(CFileItemPtr(new CFileItem("plugin://plugin.video.example/play", false)));
+
+  const std::vector<CFileItemPtr> videos = CVideoThumbBatchJob::SelectItems(items);
+  ASSERT_EQ(2u, videos.size());
+  EXPECT_EQ("/videos/movie.mkv", videos[0]->GetPath());
+  EXPECT_EQ("/videos/episode.avi", videos[1]->GetPath());
+}
+
+TEST(TestVideoThumbBatchJob, ProcessesAllItems)
+{
+  // more items than are queued at once
+  CVideoThumbBatchJob job(MakeStreams(10), false, 2);
+  EXPECT_TRUE(job.DoWork());
+  EXPECT_EQ(10u, job.GetProcessed());
+  EXPECT_EQ(0u, job.GetExtracted());
+}
+
+TEST(TestVideoThumbBatchJob, Cancel)
+{
+  CVideoThumbBatchJob job(MakeStreams(10), false, 2);
+  job.Cancel();
+  EXPECT_FALSE(job.DoWork());
+  EXPECT_EQ(0u, job.GetProcessed());
+}
@@ -748,6 +748,10 @@ void CGUIWindowVideoNav::DoSearch(const std::string& strSearch, CFileItemList& i
   m_database.GetMusicVideoGenresByName(strSearch, tempItems);
   AppendAndClearSearchItems(tempItems, "[" + strGenre + " - " + g_localizeStrings.Get(20389) + "] ", items);
 
+  // get matching tags
+  m_database.GetMovieTagsByName(strSearch, tempItems);
+  AppendAndClearSearchItems(tempItems, "[" + g_localizeStrings.Get(20459) + " - " + g_localizeStrings.Get(20342) + "] ", items);
+
   //get actors/artists
   m_database.GetMovieActorsByName(strSearch, tempItems);
   AppendAndClearSearchItems(tempItems, "[" + strActor + " - " + g_localizeStrings.Get(20342) + "] ", items);